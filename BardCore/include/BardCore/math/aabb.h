@@ -0,0 +1,246 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+#include <algorithm>
+
+namespace bardcore
+{
+    /**
+     * \brief axis aligned bounding box, described by a minimum and a maximum point
+     * \note a default constructed aabb is empty (minimum = inf, maximum = -inf), expanding it with a point gives that point
+     * \note this class is also constexpr
+     */
+    class aabb
+    {
+    public:
+        point3d minimum{math::inf, math::inf, math::inf};
+        point3d maximum{-math::inf, -math::inf, -math::inf};
+
+    public:
+        /**
+         * \brief default constructor, creates an empty aabb
+         */
+        constexpr aabb() = default;
+
+        /**
+         * \brief constructor with minimum and maximum point
+         * \note the points are not sorted, use from_points if the order is unknown
+         * \param minimum minimum point
+         * \param maximum maximum point
+         */
+        constexpr aabb(const point3d& minimum, const point3d& maximum) : minimum(minimum), maximum(maximum)
+        {
+        }
+
+        /**
+         * \brief creates the smallest aabb containing two points
+         * \param a first point
+         * \param b second point
+         * \return aabb containing both points
+         */
+        NODISCARD constexpr static aabb from_points(const point3d& a, const point3d& b) noexcept
+        {
+            return {
+                {(std::min)(a.x, b.x), (std::min)(a.y, b.y), (std::min)(a.z, b.z)},
+                {(std::max)(a.x, b.x), (std::max)(a.y, b.y), (std::max)(a.z, b.z)}
+            };
+        }
+
+        /**
+         * \brief checks if the aabb is empty, e.g. default constructed
+         * \return true if minimum > maximum on any axis
+         */
+        NODISCARD constexpr bool is_empty() const noexcept
+        {
+            return minimum.x > maximum.x || minimum.y > maximum.y || minimum.z > maximum.z;
+        }
+
+        /**
+         * \brief grows the aabb so it contains a point
+         * \param point point to contain
+         * \return this
+         */
+        constexpr aabb& expand(const point3d& point) noexcept
+        {
+            minimum = {(std::min)(minimum.x, point.x), (std::min)(minimum.y, point.y), (std::min)(minimum.z, point.z)};
+            maximum = {(std::max)(maximum.x, point.x), (std::max)(maximum.y, point.y), (std::max)(maximum.z, point.z)};
+            return *this;
+        }
+
+        /**
+         * \brief grows the aabb so it contains another aabb
+         * \param other aabb to contain
+         * \return this
+         */
+        constexpr aabb& expand(const aabb& other) noexcept
+        {
+            minimum = {
+                (std::min)(minimum.x, other.minimum.x), (std::min)(minimum.y, other.minimum.y),
+                (std::min)(minimum.z, other.minimum.z)
+            };
+            maximum = {
+                (std::max)(maximum.x, other.maximum.x), (std::max)(maximum.y, other.maximum.y),
+                (std::max)(maximum.z, other.maximum.z)
+            };
+            return *this;
+        }
+
+        /**
+         * \brief calculates the center of the aabb
+         * \return center point
+         */
+        NODISCARD constexpr point3d center() const noexcept
+        {
+            return minimum.center(maximum);
+        }
+
+        /**
+         * \brief calculates the size of the aabb on every axis
+         * \return maximum - minimum
+         */
+        NODISCARD constexpr vector3d extent() const noexcept
+        {
+            return minimum.get_vector(maximum);
+        }
+
+        /**
+         * \brief calculates the surface area of the aabb, used for the surface area heuristic
+         * \return surface area, 0 if the aabb is empty
+         */
+        NODISCARD constexpr double surface_area() const noexcept
+        {
+            if (is_empty())
+                return 0;
+
+            const vector3d size = extent();
+            return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        /**
+         * \brief checks if a point is inside the aabb (borders included)
+         * \param point point to check
+         * \return true if the point is inside
+         */
+        NODISCARD constexpr bool contains(const point3d& point) const noexcept
+        {
+            return point.x >= minimum.x && point.x <= maximum.x
+                && point.y >= minimum.y && point.y <= maximum.y
+                && point.z >= minimum.z && point.z <= maximum.z;
+        }
+
+        /**
+         * \brief checks if another aabb is completely inside the aabb (borders included)
+         * \param other other aabb
+         * \return true if other is inside
+         */
+        NODISCARD constexpr bool contains(const aabb& other) const noexcept
+        {
+            return other.minimum.x >= minimum.x && other.maximum.x <= maximum.x
+                && other.minimum.y >= minimum.y && other.maximum.y <= maximum.y
+                && other.minimum.z >= minimum.z && other.maximum.z <= maximum.z;
+        }
+
+        /**
+         * \brief checks if two aabbs overlap (touching borders count as overlap)
+         * \param other other aabb
+         * \return true if they overlap
+         */
+        NODISCARD constexpr bool overlaps(const aabb& other) const noexcept
+        {
+            return minimum.x <= other.maximum.x && maximum.x >= other.minimum.x
+                && minimum.y <= other.maximum.y && maximum.y >= other.minimum.y
+                && minimum.z <= other.maximum.z && maximum.z >= other.minimum.z;
+        }
+
+        /**
+         * \brief calculates the squared distance from a point to the aabb
+         * \param point point
+         * \return squared distance, 0 if the point is inside
+         */
+        NODISCARD constexpr double distance_squared(const point3d& point) const noexcept
+        {
+            const double dx = (std::max)((std::max)(minimum.x - point.x, 0.), point.x - maximum.x);
+            const double dy = (std::max)((std::max)(minimum.y - point.y, 0.), point.y - maximum.y);
+            const double dz = (std::max)((std::max)(minimum.z - point.z, 0.), point.z - maximum.z);
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        /**
+         * \brief intersects a ray, given as origin and inverse direction, with the aabb using the slab method
+         * \note the inverse direction can be calculated once per ray and reused for many aabbs
+         * \note utility::ray::intersect does the same for a ray
+         * \note read more at https://en.wikipedia.org/wiki/Slab_method
+         * \param origin origin of the ray
+         * \param inverse_direction 1 / direction per axis, inf for a zero component
+         * \param t_max maximum distance along the ray
+         * \param t_enter output, distance along the ray where it enters the aabb (0 if it starts inside)
+         * \param t_exit output, distance along the ray where it leaves the aabb (at most t_max)
+         * \return true if the ray intersects the aabb within [0, t_max]
+         */
+        NODISCARD constexpr bool intersect(const point3d& origin, const vector3d& inverse_direction,
+                                           const double t_max, double& t_enter, double& t_exit) const noexcept
+        {
+            double t0 = 0, t1 = t_max;
+
+            const double tx0 = (minimum.x - origin.x) * inverse_direction.x;
+            const double tx1 = (maximum.x - origin.x) * inverse_direction.x;
+            t0 = (std::max)(t0, (std::min)(tx0, tx1));
+            t1 = (std::min)(t1, (std::max)(tx0, tx1));
+
+            const double ty0 = (minimum.y - origin.y) * inverse_direction.y;
+            const double ty1 = (maximum.y - origin.y) * inverse_direction.y;
+            t0 = (std::max)(t0, (std::min)(ty0, ty1));
+            t1 = (std::min)(t1, (std::max)(ty0, ty1));
+
+            const double tz0 = (minimum.z - origin.z) * inverse_direction.z;
+            const double tz1 = (maximum.z - origin.z) * inverse_direction.z;
+            t0 = (std::max)(t0, (std::min)(tz0, tz1));
+            t1 = (std::min)(t1, (std::max)(tz0, tz1));
+
+            t_enter = t0;
+            t_exit = t1;
+            return t0 <= t1;
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief output operator, prints "{minimum: (x, y, z), maximum: (x, y, z)}"
+         * \param os output stream
+         * \param box aabb to output
+         * \return output stream "{minimum: (x, y, z), maximum: (x, y, z)}"
+         */
+        friend std::ostream& operator<<(std::ostream& os, const aabb& box)
+        {
+            return os << "{minimum: " << box.minimum << ", maximum: " << box.maximum << "}";
+        }
+
+        /**
+         * \brief equal operator (minimum and maximum are equal)
+         * \param left left aabb
+         * \param right right aabb
+         * \return true if left == right
+         */
+        NODISCARD constexpr friend bool operator==(const aabb& left, const aabb& right) noexcept
+        {
+            return left.minimum == right.minimum && left.maximum == right.maximum;
+        }
+
+        /**
+         * \brief not equal operator (minimum or maximum is not equal)
+         * \param left left aabb
+         * \param right right aabb
+         * \return true if left != right
+         */
+        NODISCARD constexpr friend bool operator!=(const aabb& left, const aabb& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+} // namespace bardcore
@@ -141,6 +141,59 @@ namespace bardcore
             return {result.y, result.z, result.w};
         }
 
+        /**
+         * \brief identity rotation quaternion (1, 0, 0, 0)
+         * \return identity quaternion
+         */
+        NODISCARD constexpr static quaternion identity() noexcept
+        {
+            return {1, 0, 0, 0};
+        }
+
+        /**
+         * \brief creates the rotation quaternion around a given axis (rotation_vector) with a given angle (theta)
+         * \note rotate_quaternion(a, from_axis_radians(axis, theta)) gives the same result as rotate_radians(a, axis, theta)
+         * \throws zero_exception if length of rotation_vector is zero
+         * \param rotation_vector the axis around which should be rotated
+         * \param theta the angle in radians
+         * \return unit rotation quaternion
+         */
+        NODISCARD constexpr static quaternion from_axis_radians(const vector3d& rotation_vector, double theta)
+        {
+            theta /= 2;
+
+            const vector3d unit_vector = rotation_vector.normalize() * math::sin(theta); //throws zero_exception
+
+            return {math::cos(theta), unit_vector.x, unit_vector.y, unit_vector.z};
+        }
+
+        /**
+         * \brief rotates a 3D object with a unit rotation quaternion, this uses the same convention as rotate_radians
+         * \note unlike rotate_radians this doesn't throw on (0,0,0), it simply stays (0,0,0)
+         * \note rotations can be chained, rotate_quaternion(rotate_quaternion(p, a), b) == rotate_quaternion(p, a.multiply(b))
+         * \tparam T an inherited class of dimension3, e.g. point3d, vector3d, ...
+         * \param to_be_rotated_3d the 3D object that should be rotated
+         * \param rotation unit rotation quaternion, e.g. from from_axis_radians
+         * \return rotated 3D object
+         */
+        template <typename T, ENABLE_IF_DERIVED(dimension3, T)>
+        NODISCARD constexpr static T rotate_quaternion(const T& to_be_rotated_3d, const quaternion& rotation) noexcept
+        {
+            // conjugate(q) * p * q, expanded: p + 2s(u x p) + 2u x (u x p) with s = real and u = -(i, j, k)
+            const double ux = -rotation.y, uy = -rotation.z, uz = -rotation.w, s = rotation.x;
+            const double px = to_be_rotated_3d.x, py = to_be_rotated_3d.y, pz = to_be_rotated_3d.z;
+
+            const double tx = 2 * (uy * pz - uz * py);
+            const double ty = 2 * (uz * px - ux * pz);
+            const double tz = 2 * (ux * py - uy * px);
+
+            return {
+                px + s * tx + (uy * tz - uz * ty),
+                py + s * ty + (uz * tx - ux * tz),
+                pz + s * tz + (ux * ty - uy * tx)
+            };
+        }
+
         /**
          * \brief multiplies two quaternions, this is not a standard multiplication
          * \note for any two quaternions a and b, the order of multiplication is important, i.e. a * b != b * a
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/triangle.h"
+#include "BardCore/math/vector3d.h"
+
+#include <cstddef>
+
+namespace bardcore
+{
+    /**
+     * \brief side of a plane a point is on
+     */
+    enum class plane_side : signed char
+    {
+        back = -1,
+        on = 0,
+        front = 1
+    };
+
+    /**
+     * \brief amount of triangles written by a split
+     */
+    struct split_counts
+    {
+        std::size_t front = 0; // triangles written to the front output
+        std::size_t back = 0; // triangles written to the back output
+    };
+
+    /**
+     * \brief plane described by a unit normal and d, the points p with normal . p + d = 0
+     * \note the normal points to the front side, signed distances are positive in front
+     * \note this class is also constexpr
+     */
+    class plane
+    {
+    protected:
+        vector3d normal_{0, 0, 1};
+        double d_ = 0;
+
+    private:
+        /**
+         * \brief helper function for snapping distances within epsilon to 0
+         */
+        NODISCARD static constexpr double snap(const double distance, const double epsilon) noexcept
+        {
+            return distance <= epsilon && distance >= -epsilon ? 0. : distance;
+        }
+
+        /**
+         * \brief helper function for clipping a triangle to the side where sign * distance >= 0
+         * \return amount of triangles written to output (0, 1 or 2)
+         */
+        static std::size_t clip_side(const triangle& triangle, const double (&distances)[3], const double sign,
+                                     bardcore::triangle* output) noexcept
+        {
+            const point3d* vertices[3] = {&triangle.a, &triangle.b, &triangle.c};
+            point3d polygon[4];
+            std::size_t size = 0;
+
+            // Sutherland-Hodgman against one plane, a triangle gives at most a quad
+            for (unsigned int index = 0; index < 3; ++index)
+            {
+                const unsigned int next = (index + 1) % 3;
+                const double current_distance = sign * distances[index];
+                const double next_distance = sign * distances[next];
+
+                if (current_distance >= 0)
+                    polygon[size++] = *vertices[index];
+
+                if ((current_distance > 0 && next_distance < 0) || (current_distance < 0 && next_distance > 0))
+                {
+                    const double t = current_distance / (current_distance - next_distance);
+                    polygon[size++] = *vertices[index] + vertices[index]->get_vector(*vertices[next]) * t;
+                }
+            }
+
+            if (size < 3)
+                return 0;
+
+            output[0] = bardcore::triangle(polygon[0], polygon[1], polygon[2]);
+            if (size == 3)
+                return 1;
+
+            output[1] = bardcore::triangle(polygon[0], polygon[2], polygon[3]);
+            return 2;
+        }
+
+    public:
+        /**
+         * \brief default constructor, the plane z = 0 facing +z
+         */
+        constexpr plane() = default;
+
+        /**
+         * \brief constructor with a normal and d
+         * \throws zero_exception if the normal has length zero
+         * \param normal normal of the plane, it is normalized (d is scaled with it)
+         * \param d offset, normal . p + d = 0 for points on the plane
+         */
+        constexpr plane(const vector3d& normal, const double d) : normal_(normal.normalize()),
+                                                                  d_(d / normal.length())
+        {
+        }
+
+        /**
+         * \brief creates the plane through a point with a normal
+         * \throws zero_exception if the normal has length zero
+         * \param point point on the plane
+         * \param normal normal of the plane
+         * \return plane
+         */
+        NODISCARD constexpr static plane from_point_normal(const point3d& point, const vector3d& normal)
+        {
+            const vector3d unit = normal.normalize();
+            return {unit, -(unit.x * point.x + unit.y * point.y + unit.z * point.z)};
+        }
+
+        /**
+         * \brief creates the plane through three points, counter clockwise points face the front
+         * \throws zero_exception if the points are collinear
+         * \param a first point
+         * \param b second point
+         * \param c third point
+         * \return plane
+         */
+        NODISCARD constexpr static plane from_points(const point3d& a, const point3d& b, const point3d& c)
+        {
+            return from_point_normal(a, a.get_vector(b).cross(a.get_vector(c)));
+        }
+
+        /**
+         * \brief calculates the signed distance from a point to the plane
+         * \param point point
+         * \return distance, positive in front of the plane
+         */
+        NODISCARD constexpr double distance(const point3d& point) const noexcept
+        {
+            return normal_.x * point.x + normal_.y * point.y + normal_.z * point.z + d_;
+        }
+
+        /**
+         * \brief classifies a point
+         * \param point point
+         * \param epsilon points closer than epsilon are on the plane
+         * \return side of the point
+         */
+        NODISCARD constexpr plane_side classify(const point3d& point, const double epsilon = 1e-9) const noexcept
+        {
+            const double signed_distance = distance(point);
+            return signed_distance > epsilon
+                       ? plane_side::front
+                       : signed_distance < -epsilon
+                       ? plane_side::back
+                       : plane_side::on;
+        }
+
+        /**
+         * \brief projects a point onto the plane
+         * \param point point
+         * \return closest point on the plane
+         */
+        NODISCARD constexpr point3d project(const point3d& point) const noexcept
+        {
+            return point - normal_ * distance(point);
+        }
+
+        /**
+         * \brief gets the same plane facing the other way
+         * \return flipped plane
+         */
+        NODISCARD constexpr plane flip() const noexcept
+        {
+            plane flipped;
+            flipped.normal_ = vector3d(-normal_.x, -normal_.y, -normal_.z);
+            flipped.d_ = -d_;
+            return flipped;
+        }
+
+        /**
+         * \brief splits a triangle by the plane with Sutherland-Hodgman, every side gets at most 2 triangles
+         * \note a triangle in the plane goes to the front, the winding of the triangle is kept
+         * \note utility::plane_batch splits many triangles
+         * \param triangle triangle to split
+         * \param front output for the front part, room for 2 triangles
+         * \param back output for the back part, room for 2 triangles, nullptr to drop the back part
+         * \param epsilon vertices closer than epsilon are on the plane
+         * \return amount of triangles written to front and back
+         */
+        split_counts split(const triangle& triangle, bardcore::triangle* front, bardcore::triangle* back,
+                           const double epsilon = 1e-9) const noexcept
+        {
+            const double distances[3] = {
+                snap(distance(triangle.a), epsilon), snap(distance(triangle.b), epsilon),
+                snap(distance(triangle.c), epsilon)
+            };
+
+            split_counts counts;
+            const bool coplanar = distances[0] == 0 && distances[1] == 0 && distances[2] == 0;
+            if (front != nullptr)
+                counts.front = clip_side(triangle, distances, 1, front);
+            if (back != nullptr && !coplanar)
+                counts.back = clip_side(triangle, distances, -1, back);
+            return counts;
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief output operator, prints "{normal: (x, y, z), d: d}"
+         * \param os output stream
+         * \param plane plane to output
+         * \return output stream "{normal: (x, y, z), d: d}"
+         */
+        friend std::ostream& operator<<(std::ostream& os, const plane& plane)
+        {
+            return os << "{normal: " << plane.normal_ << ", d: " << plane.d_ << "}";
+        }
+
+        /**
+         * \brief equal operator (normal and d are equal)
+         * \param left left plane
+         * \param right right plane
+         * \return true if left == right
+         */
+        NODISCARD constexpr friend bool operator==(const plane& left, const plane& right) noexcept
+        {
+            return left.normal_ == right.normal_ && math::equals(left.d_, right.d_);
+        }
+
+        /**
+         * \brief not equal operator (normal or d is not equal)
+         * \param left left plane
+         * \param right right plane
+         * \return true if left != right
+         */
+        NODISCARD constexpr friend bool operator!=(const plane& left, const plane& right) noexcept
+        {
+            return !(left == right);
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                 getters/setters                 ///
+        ///////////////////////////////////////////////////////
+
+        NODISCARD constexpr const vector3d& get_normal() const noexcept { return normal_; }
+        NODISCARD constexpr double get_d() const noexcept { return d_; }
+    };
+} // namespace bardcore
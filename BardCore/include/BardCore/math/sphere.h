@@ -0,0 +1,353 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    /**
+     * \brief sphere described by a center and a radius, used as bounding volume
+     * \note this class is also constexpr
+     */
+    class sphere
+    {
+    public:
+        point3d center{};
+        double radius = 0;
+
+    private:
+        /**
+         * \brief helper function for checking if a point is inside with a small relative tolerance
+         */
+        NODISCARD static bool encloses(const sphere& sphere, const point3d& point) noexcept
+        {
+            return sphere.center.distance_squared(point) <= sphere.radius * sphere.radius * (1 + 1e-12) + 1e-24;
+        }
+
+        /**
+         * \brief helper function for the smallest sphere through two points
+         */
+        NODISCARD static sphere diameter(const point3d& a, const point3d& b) noexcept
+        {
+            return {a.center(b), a.distance(b) / 2};
+        }
+
+        /**
+         * \brief helper function for the smallest sphere through three points (the circumscribed circle)
+         * \note collinear points give the sphere through the two points farthest apart
+         */
+        NODISCARD static sphere circumsphere(const point3d& a, const point3d& b, const point3d& c) noexcept
+        {
+            const vector3d ab = a.get_vector(b);
+            const vector3d ac = a.get_vector(c);
+            const vector3d normal = ab.cross(ac);
+            const double denominator = 2 * normal.length_squared();
+
+            if (denominator <= 1e-30 * ab.length_squared() * ac.length_squared())
+            {
+                const sphere spheres[3] = {diameter(a, b), diameter(a, c), diameter(b, c)};
+                return *std::max_element(spheres, spheres + 3, [](const sphere& left, const sphere& right)
+                {
+                    return left.radius < right.radius;
+                });
+            }
+
+            const vector3d offset = (ac.cross(normal) * ab.length_squared() + normal.cross(ab) * ac.length_squared()) /
+                denominator;
+            return {a + offset, offset.length()};
+        }
+
+        /**
+         * \brief helper function for the sphere through four points (the circumscribed sphere)
+         * \note coplanar points give the smallest sphere through three of them that contains the fourth
+         */
+        NODISCARD static sphere circumsphere(const point3d& a, const point3d& b, const point3d& c,
+                                             const point3d& d) noexcept
+        {
+            const vector3d ab = a.get_vector(b);
+            const vector3d ac = a.get_vector(c);
+            const vector3d ad = a.get_vector(d);
+
+            // solve 2 * [ab; ac; ad] * x = [|ab|^2; |ac|^2; |ad|^2] with Cramer's rule
+            const vector3d ac_x_ad = ac.cross(ad);
+            const double determinant = 2 * ab.dot(ac_x_ad);
+            const double scale = ab.length() * ac.length() * ad.length();
+
+            if (std::abs(determinant) <= 1e-12 * scale)
+            {
+                const sphere spheres[4] = {
+                    circumsphere(a, b, c), circumsphere(a, b, d), circumsphere(a, c, d), circumsphere(b, c, d)
+                };
+                const point3d others[4] = {d, c, b, a};
+
+                sphere best = spheres[0];
+                best.radius = math::inf;
+                for (unsigned int index = 0; index < 4; ++index)
+                    if (spheres[index].radius < best.radius && encloses(spheres[index], others[index]))
+                        best = spheres[index];
+
+                return best.radius == math::inf ? spheres[0] : best;
+            }
+
+            const vector3d offset = (ac_x_ad * ab.length_squared() + ad.cross(ab) * ac.length_squared() +
+                ab.cross(ac) * ad.length_squared()) / determinant;
+            return {a + offset, offset.length()};
+        }
+
+    public:
+        constexpr sphere() = default;
+
+        /**
+         * \brief constructor with center and radius
+         * \throws negative_exception if radius is negative
+         * \param center center of the sphere
+         * \param radius radius of the sphere
+         */
+        constexpr sphere(const point3d& center, const double radius) : center(center), radius(radius)
+        {
+            if (radius < 0)
+                throw exception::negative_exception("radius can't be negative");
+        }
+
+        /**
+         * \brief checks if a point is inside the sphere (border included)
+         * \param point point to check
+         * \return true if the point is inside
+         */
+        NODISCARD constexpr bool contains(const point3d& point) const noexcept
+        {
+            return center.distance_squared(point) <= radius * radius;
+        }
+
+        /**
+         * \brief checks if another sphere is completely inside the sphere (border included)
+         * \param other other sphere
+         * \return true if other is inside
+         */
+        NODISCARD bool contains(const sphere& other) const noexcept
+        {
+            return other.radius <= radius && center.distance(other.center) + other.radius <= radius;
+        }
+
+        /**
+         * \brief checks if two spheres overlap (touching counts as overlap)
+         * \param other other sphere
+         * \return true if they overlap
+         */
+        NODISCARD constexpr bool overlaps(const sphere& other) const noexcept
+        {
+            return center.distance_squared(other.center) <= (radius + other.radius) * (radius + other.radius);
+        }
+
+        /**
+         * \brief checks if the sphere overlaps an aabb (touching counts as overlap)
+         * \param box aabb
+         * \return true if they overlap
+         */
+        NODISCARD constexpr bool overlaps(const aabb& box) const noexcept
+        {
+            return box.distance_squared(center) <= radius * radius;
+        }
+
+        /**
+         * \brief grows the sphere as little as possible so it contains a point, the opposite side stays in place
+         * \param point point to contain
+         * \return this sphere
+         */
+        sphere& expand(const point3d& point) noexcept
+        {
+            const double distance = center.distance(point);
+            if (distance <= radius)
+                return *this;
+
+            const double new_radius = (radius + distance) / 2;
+            center = center + center.get_vector(point) * ((new_radius - radius) / distance);
+            radius = new_radius;
+            return *this;
+        }
+
+        /**
+         * \brief calculates the bounding box of the sphere
+         * \return aabb around the sphere
+         */
+        NODISCARD constexpr aabb bounds() const noexcept
+        {
+            return {
+                {center.x - radius, center.y - radius, center.z - radius},
+                {center.x + radius, center.y + radius, center.z + radius}
+            };
+        }
+
+        /**
+         * \brief calculates the volume of the sphere
+         * \return 4/3 * pi * r^3
+         */
+        NODISCARD constexpr double volume() const noexcept
+        {
+            return 4. / 3. * math::pi * radius * radius * radius;
+        }
+
+        /**
+         * \brief calculates the surface area of the sphere
+         * \return 4 * pi * r^2
+         */
+        NODISCARD constexpr double surface_area() const noexcept
+        {
+            return 4. * math::pi * radius * radius;
+        }
+
+        /**
+         * \brief calculates an approximate bounding sphere with Ritter's algorithm, typically a few to 20% larger than optimal
+         * \note read more at https://en.wikipedia.org/wiki/Bounding_sphere#Ritter's_bounding_sphere
+         * \note one pass for the extreme points on every axis and one pass growing the sphere
+         * \param points points to bound
+         * \param count amount of points
+         * \return bounding sphere, a zero sphere at the origin if there are no points
+         */
+        NODISCARD static sphere ritter(const point3d* points, const std::size_t count) noexcept
+        {
+            if (count == 0)
+                return {};
+
+            // extreme points on every axis, min x, max x, min y, max y, min z, max z
+            std::size_t extremes[6] = {};
+            for (std::size_t index = 1; index < count; ++index)
+            {
+                const point3d& point = points[index];
+                extremes[0] = point.x < points[extremes[0]].x ? index : extremes[0];
+                extremes[1] = point.x > points[extremes[1]].x ? index : extremes[1];
+                extremes[2] = point.y < points[extremes[2]].y ? index : extremes[2];
+                extremes[3] = point.y > points[extremes[3]].y ? index : extremes[3];
+                extremes[4] = point.z < points[extremes[4]].z ? index : extremes[4];
+                extremes[5] = point.z > points[extremes[5]].z ? index : extremes[5];
+            }
+
+            // start with the pair farthest apart
+            std::size_t axis = 0;
+            for (std::size_t other = 1; other < 3; ++other)
+                if (points[extremes[2 * other]].distance_squared(points[extremes[2 * other + 1]]) >
+                    points[extremes[2 * axis]].distance_squared(points[extremes[2 * axis + 1]]))
+                    axis = other;
+
+            sphere result = diameter(points[extremes[2 * axis]], points[extremes[2 * axis + 1]]);
+            for (std::size_t index = 0; index < count; ++index)
+                result.expand(points[index]);
+
+            return result;
+        }
+
+        /**
+         * \brief calculates an approximate bounding sphere with Ritter's algorithm
+         * \param points points to bound
+         * \return bounding sphere, a zero sphere at the origin if there are no points
+         */
+        NODISCARD static sphere ritter(const std::vector<point3d>& points) noexcept
+        {
+            return ritter(points.data(), points.size());
+        }
+
+        /**
+         * \brief calculates the smallest bounding sphere with Welzl's randomized algorithm, expected linear time
+         * \note read more at https://en.wikipedia.org/wiki/Smallest-circle_problem#Welzl's_algorithm
+         * \note implemented iteratively (move to front) so large inputs don't recurse deeply
+         * \param points points to bound
+         * \param count amount of points
+         * \param seed seed for shuffling the points, the result doesn't depend on it
+         * \return smallest bounding sphere, a zero sphere at the origin if there are no points
+         */
+        NODISCARD static sphere welzl(const point3d* points, const std::size_t count, const unsigned int seed = 0)
+        {
+            if (count == 0)
+                return {};
+
+            std::vector<point3d> shuffled(points, points + count);
+            std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(seed));
+
+            sphere result(shuffled[0], 0);
+            for (std::size_t i = 1; i < count; ++i)
+            {
+                if (encloses(result, shuffled[i]))
+                    continue;
+
+                // shuffled[i] is on the border of the smallest sphere of the first i + 1 points
+                result = sphere(shuffled[i], 0);
+                for (std::size_t j = 0; j < i; ++j)
+                {
+                    if (encloses(result, shuffled[j]))
+                        continue;
+
+                    result = diameter(shuffled[i], shuffled[j]);
+                    for (std::size_t k = 0; k < j; ++k)
+                    {
+                        if (encloses(result, shuffled[k]))
+                            continue;
+
+                        result = circumsphere(shuffled[i], shuffled[j], shuffled[k]);
+                        for (std::size_t l = 0; l < k; ++l)
+                            if (!encloses(result, shuffled[l]))
+                                result = circumsphere(shuffled[i], shuffled[j], shuffled[k], shuffled[l]);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * \brief calculates the smallest bounding sphere with Welzl's randomized algorithm
+         * \param points points to bound
+         * \param seed seed for shuffling the points, the result doesn't depend on it
+         * \return smallest bounding sphere, a zero sphere at the origin if there are no points
+         */
+        NODISCARD static sphere welzl(const std::vector<point3d>& points, const unsigned int seed = 0)
+        {
+            return welzl(points.data(), points.size(), seed);
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief output operator, prints "{center: (x, y, z), radius: r}"
+         * \param os output stream
+         * \param sphere sphere to output
+         * \return output stream "{center: (x, y, z), radius: r}"
+         */
+        friend std::ostream& operator<<(std::ostream& os, const sphere& sphere)
+        {
+            return os << "{center: " << sphere.center << ", radius: " << sphere.radius << "}";
+        }
+
+        /**
+         * \brief equal operator (center and radius are equal)
+         * \param left left sphere
+         * \param right right sphere
+         * \return true if left == right
+         */
+        NODISCARD constexpr friend bool operator==(const sphere& left, const sphere& right) noexcept
+        {
+            return left.center == right.center && math::equals(left.radius, right.radius);
+        }
+
+        /**
+         * \brief not equal operator (center or radius is not equal)
+         * \param left left sphere
+         * \param right right sphere
+         * \return true if left != right
+         */
+        NODISCARD constexpr friend bool operator!=(const sphere& left, const sphere& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+} // namespace bardcore
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/vector3d.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    /**
+     * \brief eigen decomposition of a symmetric 3x3 matrix
+     */
+    struct symmetric_eigen
+    {
+        double values[3]{}; // eigenvalues, ascending
+        vector3d vectors[3]{}; // unit eigenvector per eigenvalue
+    };
+
+    /**
+     * \brief symmetric 3x3 matrix, e.g. a covariance or inertia matrix, only the upper triangle is stored
+     * \note this class is also constexpr
+     */
+    class symmetric_matrix3
+    {
+    public:
+        double xx = 0, xy = 0, xz = 0;
+        double yy = 0, yz = 0;
+        double zz = 0;
+
+        /**
+         * \brief amount of matrices decomposed together by the batch eigen solver
+         */
+        INLINE static constexpr std::size_t packet_size = 4;
+
+        /**
+         * \brief amount of Jacobi sweeps, 3x3 matrices converge to double precision in less
+         */
+        INLINE static constexpr unsigned int sweeps = 8;
+
+    private:
+        /**
+         * \brief helper function for the cyclic Jacobi eigenvalue algorithm on a packet of matrices
+         *
+         * every rotation is done for all lanes in a branch free inner loop,
+         * a is diagonalized in place and the rotations are accumulated in v
+         * \note read more at https://en.wikipedia.org/wiki/Jacobi_eigenvalue_algorithm
+         */
+        template <std::size_t Lanes>
+        static void jacobi(double (&a)[3][3][Lanes], double (&v)[3][3][Lanes]) noexcept
+        {
+            // p, q and the remaining index r of the three off diagonal elements
+            constexpr unsigned int rotations[3][3] = {{0, 1, 2}, {0, 2, 1}, {1, 2, 0}};
+
+            for (unsigned int sweep = 0; sweep < sweeps; ++sweep)
+            {
+                for (const auto& rotation : rotations)
+                {
+                    const unsigned int p = rotation[0], q = rotation[1], r = rotation[2];
+                    for (std::size_t lane = 0; lane < Lanes; ++lane)
+                    {
+                        const double apq = a[p][q][lane];
+                        const double theta = (a[q][q][lane] - a[p][p][lane]) / (2 * (apq != 0 ? apq : 1.));
+                        const double t = apq != 0
+                                             ? (theta >= 0 ? 1. : -1.) / (std::abs(theta) + std::sqrt(
+                                                 theta * theta + 1))
+                                             : 0.;
+                        const double c = 1 / std::sqrt(t * t + 1);
+                        const double s = t * c;
+
+                        a[p][p][lane] -= t * apq;
+                        a[q][q][lane] += t * apq;
+                        a[p][q][lane] = a[q][p][lane] = 0;
+
+                        const double arp = a[r][p][lane], arq = a[r][q][lane];
+                        a[r][p][lane] = a[p][r][lane] = c * arp - s * arq;
+                        a[r][q][lane] = a[q][r][lane] = s * arp + c * arq;
+
+                        for (unsigned int row = 0; row < 3; ++row)
+                        {
+                            const double vrp = v[row][p][lane], vrq = v[row][q][lane];
+                            v[row][p][lane] = c * vrp - s * vrq;
+                            v[row][q][lane] = s * vrp + c * vrq;
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * \brief helper function for decomposing up to packet_size matrices, missing lanes are filled with zero
+         */
+        static void eigen_packet(const symmetric_matrix3* matrices, const std::size_t count,
+                                 symmetric_eigen* results) noexcept
+        {
+            double a[3][3][packet_size] = {};
+            double v[3][3][packet_size] = {};
+
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                const symmetric_matrix3& matrix = matrices[lane];
+                a[0][0][lane] = matrix.xx;
+                a[0][1][lane] = a[1][0][lane] = matrix.xy;
+                a[0][2][lane] = a[2][0][lane] = matrix.xz;
+                a[1][1][lane] = matrix.yy;
+                a[1][2][lane] = a[2][1][lane] = matrix.yz;
+                a[2][2][lane] = matrix.zz;
+            }
+            for (std::size_t lane = 0; lane < packet_size; ++lane)
+                v[0][0][lane] = v[1][1][lane] = v[2][2][lane] = 1;
+
+            jacobi(a, v);
+
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                unsigned int order[3] = {0, 1, 2};
+                const auto swap_if = [&](const unsigned int first, const unsigned int second)
+                {
+                    if (a[order[second]][order[second]][lane] < a[order[first]][order[first]][lane])
+                        std::swap(order[first], order[second]);
+                };
+                swap_if(0, 1);
+                swap_if(1, 2);
+                swap_if(0, 1);
+
+                for (unsigned int index = 0; index < 3; ++index)
+                {
+                    const unsigned int column = order[index];
+                    results[lane].values[index] = a[column][column][lane];
+                    results[lane].vectors[index] = vector3d(v[0][column][lane], v[1][column][lane],
+                                                            v[2][column][lane]);
+                }
+            }
+        }
+
+    public:
+        /**
+         * \brief default constructor, the zero matrix
+         */
+        constexpr symmetric_matrix3() = default;
+
+        /**
+         * \brief constructor with the upper triangle
+         * \param xx row 0, column 0
+         * \param xy row 0, column 1 (and row 1, column 0)
+         * \param xz row 0, column 2 (and row 2, column 0)
+         * \param yy row 1, column 1
+         * \param yz row 1, column 2 (and row 2, column 1)
+         * \param zz row 2, column 2
+         */
+        constexpr symmetric_matrix3(const double xx, const double xy, const double xz, const double yy,
+                                    const double yz, const double zz) : xx(xx), xy(xy), xz(xz), yy(yy), yz(yz),
+                                                                        zz(zz)
+        {
+        }
+
+        /**
+         * \brief creates the identity matrix
+         * \return identity
+         */
+        NODISCARD constexpr static symmetric_matrix3 identity() noexcept
+        {
+            return {1, 0, 0, 1, 0, 1};
+        }
+
+        /**
+         * \brief creates the outer product of a vector with itself
+         * \param vector vector
+         * \return vector * vector^T
+         */
+        NODISCARD constexpr static symmetric_matrix3 outer(const vector3d& vector) noexcept
+        {
+            return {
+                vector.x * vector.x, vector.x * vector.y, vector.x * vector.z,
+                vector.y * vector.y, vector.y * vector.z, vector.z * vector.z
+            };
+        }
+
+        /**
+         * \brief multiplies the matrix with a vector
+         * \param vector vector
+         * \return matrix * vector
+         */
+        NODISCARD constexpr vector3d multiply(const vector3d& vector) const noexcept
+        {
+            return {
+                xx * vector.x + xy * vector.y + xz * vector.z,
+                xy * vector.x + yy * vector.y + yz * vector.z,
+                xz * vector.x + yz * vector.y + zz * vector.z
+            };
+        }
+
+        /**
+         * \brief calculates the trace, the sum of the eigenvalues
+         * \return xx + yy + zz
+         */
+        NODISCARD constexpr double trace() const noexcept
+        {
+            return xx + yy + zz;
+        }
+
+        /**
+         * \brief calculates the determinant, the product of the eigenvalues
+         * \return determinant
+         */
+        NODISCARD constexpr double determinant() const noexcept
+        {
+            return xx * (yy * zz - yz * yz) - xy * (xy * zz - yz * xz) + xz * (xy * yz - yy * xz);
+        }
+
+        /**
+         * \brief calculates the eigenvalues and eigenvectors with the Jacobi eigenvalue algorithm
+         * \return eigen decomposition, eigenvalues ascending
+         */
+        NODISCARD symmetric_eigen eigen() const noexcept
+        {
+            symmetric_eigen result;
+            eigen_packet(this, 1, &result);
+            return result;
+        }
+
+        /**
+         * \brief calculates the eigen decomposition of many matrices, packet_size matrices are decomposed together
+         * \note this runs on the calling thread, utility::pca divides its neighbourhoods over threads
+         * \param matrices matrices
+         * \param count amount of matrices
+         * \param results output, room for count decompositions
+         */
+        static void eigen(const symmetric_matrix3* matrices, const std::size_t count, symmetric_eigen* results)
+        {
+            for (std::size_t first = 0; first < count; first += packet_size)
+            {
+                const std::size_t lanes = count - first < packet_size ? count - first : packet_size;
+                eigen_packet(matrices + first, lanes, results + first);
+            }
+        }
+
+        /**
+         * \brief calculates the eigen decomposition of many matrices
+         * \param matrices matrices
+         * \return eigen decomposition per matrix
+         */
+        NODISCARD static std::vector<symmetric_eigen> eigen(const std::vector<symmetric_matrix3>& matrices)
+        {
+            std::vector<symmetric_eigen> results(matrices.size());
+            eigen(matrices.data(), matrices.size(), results.data());
+            return results;
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief output operator, prints "[[xx, xy, xz], [xy, yy, yz], [xz, yz, zz]]"
+         * \param os output stream
+         * \param matrix matrix to output
+         * \return output stream
+         */
+        friend std::ostream& operator<<(std::ostream& os, const symmetric_matrix3& matrix)
+        {
+            return os << "[[" << matrix.xx << ", " << matrix.xy << ", " << matrix.xz << "], [" << matrix.xy << ", "
+                << matrix.yy << ", " << matrix.yz << "], [" << matrix.xz << ", " << matrix.yz << ", " << matrix.zz
+                << "]]";
+        }
+
+        /**
+         * \brief addition operator
+         * \param other other matrix
+         * \return this + other
+         */
+        NODISCARD constexpr symmetric_matrix3 operator+(const symmetric_matrix3& other) const noexcept
+        {
+            return {xx + other.xx, xy + other.xy, xz + other.xz, yy + other.yy, yz + other.yz, zz + other.zz};
+        }
+
+        /**
+         * \brief addition assignment operator
+         * \param other other matrix
+         * \return this matrix
+         */
+        constexpr symmetric_matrix3& operator+=(const symmetric_matrix3& other) noexcept
+        {
+            xx += other.xx;
+            xy += other.xy;
+            xz += other.xz;
+            yy += other.yy;
+            yz += other.yz;
+            zz += other.zz;
+            return *this;
+        }
+
+        /**
+         * \brief multiplication operator with a scalar
+         * \param n scalar
+         * \return this * n
+         */
+        NODISCARD constexpr symmetric_matrix3 operator*(const double n) const noexcept
+        {
+            return {xx * n, xy * n, xz * n, yy * n, yz * n, zz * n};
+        }
+
+        /**
+         * \brief equal operator (all elements are equal)
+         * \param left left matrix
+         * \param right right matrix
+         * \return true if left == right
+         */
+        NODISCARD constexpr friend bool operator==(const symmetric_matrix3& left,
+                                                   const symmetric_matrix3& right) noexcept
+        {
+            return math::equals(left.xx, right.xx) && math::equals(left.xy, right.xy)
+                && math::equals(left.xz, right.xz) && math::equals(left.yy, right.yy)
+                && math::equals(left.yz, right.yz) && math::equals(left.zz, right.zz);
+        }
+
+        /**
+         * \brief not equal operator (an element is not equal)
+         * \param left left matrix
+         * \param right right matrix
+         * \return true if left != right
+         */
+        NODISCARD constexpr friend bool operator!=(const symmetric_matrix3& left,
+                                                   const symmetric_matrix3& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+} // namespace bardcore
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+namespace bardcore
+{
+    /**
+     * \brief triangle described by three points, counter clockwise winding gives the front face
+     * \note this class is also constexpr
+     */
+    class triangle
+    {
+    public:
+        point3d a{}, b{}, c{};
+
+    public:
+        constexpr triangle() = default;
+
+        /**
+         * \brief constructor with three points
+         * \param a first point
+         * \param b second point
+         * \param c third point
+         */
+        constexpr triangle(const point3d& a, const point3d& b, const point3d& c) : a(a), b(b), c(c)
+        {
+        }
+
+        /**
+         * \brief calculates the bounding box of the triangle
+         * \return aabb containing the three points
+         */
+        NODISCARD constexpr aabb bounds() const noexcept
+        {
+            aabb box = aabb::from_points(a, b);
+            box.expand(c);
+            return box;
+        }
+
+        /**
+         * \brief calculates the centroid of the triangle
+         * \return (a + b + c) / 3
+         */
+        NODISCARD constexpr point3d centroid() const noexcept
+        {
+            return {(a.x + b.x + c.x) / 3., (a.y + b.y + c.y) / 3., (a.z + b.z + c.z) / 3.};
+        }
+
+        /**
+         * \brief calculates the (not normalized) normal of the triangle, its length is twice the area
+         * \return (b - a) x (c - a)
+         */
+        NODISCARD constexpr vector3d normal() const noexcept
+        {
+            return a.get_vector(b).cross(a.get_vector(c));
+        }
+
+        /**
+         * \brief calculates the area of the triangle
+         * \return area
+         */
+        NODISCARD constexpr double area() const noexcept
+        {
+            return normal().length() / 2;
+        }
+
+        /**
+         * \brief calculates the closest point on the triangle to a point
+         * \note read more in Real-Time Collision Detection (Ericson), 5.1.5
+         * \param point point
+         * \return closest point on the triangle (inside, on an edge or a corner)
+         */
+        NODISCARD constexpr point3d closest_point(const point3d& point) const noexcept
+        {
+            const vector3d ab = a.get_vector(b);
+            const vector3d ac = a.get_vector(c);
+            const vector3d ap = a.get_vector(point);
+
+            const double d1 = ab.dot(ap);
+            const double d2 = ac.dot(ap);
+            if (d1 <= 0 && d2 <= 0)
+                return a;
+
+            const vector3d bp = b.get_vector(point);
+            const double d3 = ab.dot(bp);
+            const double d4 = ac.dot(bp);
+            if (d3 >= 0 && d4 <= d3)
+                return b;
+
+            const double vc = d1 * d4 - d3 * d2;
+            if (vc <= 0 && d1 >= 0 && d3 <= 0)
+                return a + ab * (d1 / (d1 - d3));
+
+            const vector3d cp = c.get_vector(point);
+            const double d5 = ab.dot(cp);
+            const double d6 = ac.dot(cp);
+            if (d6 >= 0 && d5 <= d6)
+                return c;
+
+            const double vb = d5 * d2 - d1 * d6;
+            if (vb <= 0 && d2 >= 0 && d6 <= 0)
+                return a + ac * (d2 / (d2 - d6));
+
+            const double va = d3 * d6 - d5 * d4;
+            if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+                return b + b.get_vector(c) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+            const double denominator = 1. / (va + vb + vc);
+            return a + ab * (vb * denominator) + ac * (vc * denominator);
+        }
+
+        /**
+         * \brief intersects a ray with the triangle (both faces), only [0, t_max] of the ray is tested
+         * \note uses the Möller–Trumbore algorithm, read more at https://en.wikipedia.org/wiki/M%C3%B6ller%E2%80%93Trumbore_intersection_algorithm
+         * \note utility::ray::intersect does the same for a ray
+         * \param origin origin of the ray
+         * \param direction normalized direction of the ray
+         * \param t_max maximum distance along the ray
+         * \param t output, distance along the ray of the hit
+         * \param u output, barycentric coordinate of b
+         * \param v output, barycentric coordinate of c
+         * \return true if the ray hits the triangle
+         */
+        NODISCARD constexpr bool intersect(const point3d& origin, const vector3d& direction, const double t_max,
+                                           double& t, double& u, double& v) const noexcept
+        {
+            const vector3d edge1 = a.get_vector(b);
+            const vector3d edge2 = a.get_vector(c);
+
+            const vector3d p = direction.cross(edge2);
+            const double determinant = edge1.dot(p);
+            if (determinant > -1e-12 && determinant < 1e-12) // parallel
+                return false;
+
+            const double inverse_determinant = 1. / determinant;
+            const vector3d s = a.get_vector(origin);
+
+            u = s.dot(p) * inverse_determinant;
+            if (u < 0 || u > 1)
+                return false;
+
+            const vector3d q = s.cross(edge1);
+            v = direction.dot(q) * inverse_determinant;
+            if (v < 0 || u + v > 1)
+                return false;
+
+            t = edge2.dot(q) * inverse_determinant;
+            return t >= 0 && t <= t_max;
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief output operator, prints "{a: (x, y, z), b: (x, y, z), c: (x, y, z)}"
+         * \param os output stream
+         * \param triangle triangle to output
+         * \return output stream "{a: (x, y, z), b: (x, y, z), c: (x, y, z)}"
+         */
+        friend std::ostream& operator<<(std::ostream& os, const triangle& triangle)
+        {
+            return os << "{a: " << triangle.a << ", b: " << triangle.b << ", c: " << triangle.c << "}";
+        }
+
+        /**
+         * \brief equal operator (a, b and c are equal, in order)
+         * \param left left triangle
+         * \param right right triangle
+         * \return true if left == right
+         */
+        NODISCARD constexpr friend bool operator==(const triangle& left, const triangle& right) noexcept
+        {
+            return left.a == right.a && left.b == right.b && left.c == right.c;
+        }
+
+        /**
+         * \brief not equal operator (a, b or c is not equal)
+         * \param left left triangle
+         * \param right right triangle
+         * \return true if left != right
+         */
+        NODISCARD constexpr friend bool operator!=(const triangle& left, const triangle& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+} // namespace bardcore
@@ -0,0 +1,431 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(CXX17) // C++17 or higher (std::pmr)
+#include <memory_resource>
+#endif
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief source of the blocks of an arena, heap() takes them from the heap
+         * \note derive from it to take the blocks from somewhere else, or to count them
+         */
+        class arena_upstream
+        {
+        public:
+            virtual ~arena_upstream() = default;
+
+            /**
+             * \brief allocates a block
+             * \param bytes size of the block
+             * \return pointer to the block, aligned to at least alignof(std::max_align_t)
+             */
+            virtual unsigned char* allocate(std::size_t bytes) = 0;
+
+            /**
+             * \brief gives a block back
+             * \param block pointer returned by allocate
+             * \param bytes size of the block
+             */
+            virtual void deallocate(unsigned char* block, std::size_t bytes) noexcept = 0;
+
+            /**
+             * \brief gets the upstream that allocates the blocks with new[], the default of an arena
+             * \return heap upstream
+             */
+            NODISCARD static arena_upstream& heap() noexcept
+            {
+                struct heap_upstream final : arena_upstream
+                {
+                    unsigned char* allocate(const std::size_t bytes) override { return new unsigned char[bytes]; }
+                    void deallocate(unsigned char* block, std::size_t) noexcept override { delete[] block; }
+                };
+
+                static heap_upstream upstream;
+                return upstream;
+            }
+        };
+
+        /**
+         * \brief monotonic allocator for short lived buffers, e.g. the temporaries of a frame or a bvh build
+         *
+         * memory is carved from large blocks and never freed one by one, reset makes all blocks available again,
+         * so after the first frame the same blocks are reused and no heap allocations are done.
+         * every thread bumps in its own region of region_size bytes taken from the blocks,
+         * so threads only share a lock when their region is full.
+         * a thread keeps a region for up to cached_regions arenas, so switching between arenas keeps their regions
+         * \note allocate can be called from many threads at once, reset and release can't run at the same time
+         * \note memory allocated before a reset must not be used after it
+         */
+        class arena
+        {
+        public:
+            /**
+             * \brief default size of a block taken from the heap
+             */
+            INLINE static constexpr std::size_t default_block_size = std::size_t{1} << 20;
+
+            /**
+             * \brief size of the bump region of a thread, larger allocations are carved from a block directly
+             */
+            INLINE static constexpr std::size_t region_size = std::size_t{1} << 14;
+
+            /**
+             * \brief amount of arenas a thread keeps a region for, the oldest region is dropped for another arena
+             */
+            INLINE static constexpr std::size_t cached_regions = 4;
+
+        protected:
+            /**
+             * \brief region a thread bumps in, it belongs to one arena in one epoch
+             */
+            struct region
+            {
+                std::uint64_t owner = 0; // id of the arena
+                std::uint64_t epoch = 0; // epoch of the arena when the region was taken
+                unsigned char* cursor = nullptr; // next free byte
+                unsigned char* end = nullptr; // end of the region
+            };
+
+            /**
+             * \brief regions of a thread, one per arena
+             */
+            struct region_cache
+            {
+                region regions[cached_regions]{};
+                std::size_t next = 0; // slot that is replaced on a miss
+            };
+
+            /**
+             * \brief block taken from the upstream
+             */
+            struct block
+            {
+                unsigned char* data = nullptr; // memory of the block
+                std::size_t size = 0; // size in bytes
+            };
+
+            std::vector<block> blocks_{};
+            std::size_t current_ = 0; // block that is being carved
+            std::size_t used_ = 0; // bytes carved from the current block
+            std::size_t block_size_ = default_block_size;
+            std::uint64_t id_ = 0;
+            std::atomic<std::uint64_t> epoch_{0}; // read by allocate without the mutex
+            arena_upstream* upstream_;
+            std::mutex mutex_{};
+
+        private:
+            /**
+             * \brief helper function for the region of the calling thread in an arena
+             * \param id id of the arena
+             * \return region of the arena, or an emptied slot if the thread has no region for it
+             */
+            NODISCARD static region& local_region(const std::uint64_t id) noexcept
+            {
+                thread_local region_cache cache;
+
+                for (region& local : cache.regions)
+                    if (local.owner == id)
+                        return local;
+
+                region& local = cache.regions[cache.next];
+                cache.next = (cache.next + 1) % cached_regions;
+                local = region();
+                return local;
+            }
+
+            /**
+             * \brief helper function for giving all blocks back to the upstream
+             */
+            void free_blocks() noexcept
+            {
+                for (const block& block : blocks_)
+                    upstream_->deallocate(block.data, block.size);
+                blocks_.clear();
+            }
+
+            /**
+             * \brief helper function for an id that is never reused, unlike the address of an arena
+             */
+            NODISCARD static std::uint64_t next_id() noexcept
+            {
+                static std::atomic<std::uint64_t> counter{0};
+                return ++counter;
+            }
+
+            /**
+             * \brief helper function for bumping an aligned pointer, nullptr if it doesn't fit before end
+             */
+            NODISCARD static unsigned char* bump(unsigned char*& cursor, unsigned char* end, const std::size_t bytes,
+                                                 const std::size_t alignment) noexcept
+            {
+                const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(cursor);
+                const std::size_t padding = static_cast<std::size_t>((0 - address) & (alignment - 1));
+                if (static_cast<std::size_t>(end - cursor) < padding + bytes)
+                    return nullptr;
+
+                unsigned char* result = cursor + padding;
+                cursor = result + bytes;
+                return result;
+            }
+
+            /**
+             * \brief helper function for carving memory from the blocks, a new block is allocated if none fits
+             */
+            unsigned char* carve(const std::size_t bytes, const std::size_t alignment)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                for (; current_ < blocks_.size(); ++current_, used_ = 0)
+                {
+                    unsigned char* cursor = blocks_[current_].data + used_;
+                    unsigned char* result = bump(cursor, blocks_[current_].data + blocks_[current_].size,
+                                                 bytes, alignment);
+                    if (result != nullptr)
+                    {
+                        used_ = static_cast<std::size_t>(cursor - blocks_[current_].data);
+                        return result;
+                    }
+                }
+
+                block next;
+                next.size = bytes + alignment > block_size_ ? bytes + alignment : block_size_;
+                blocks_.reserve(blocks_.size() + 1);
+                next.data = upstream_->allocate(next.size);
+                blocks_.push_back(next);
+
+                unsigned char* cursor = blocks_.back().data;
+                unsigned char* result = bump(cursor, cursor + blocks_.back().size, bytes, alignment);
+                used_ = static_cast<std::size_t>(cursor - blocks_.back().data);
+                return result;
+            }
+
+        public:
+            /**
+             * \brief constructor for arena, no memory is allocated until the first allocation
+             * \throws out_of_range_exception if block_size is smaller than region_size
+             * \param block_size size of the blocks taken from the upstream
+             * \param upstream source of the blocks, it must outlive the arena
+             */
+            explicit arena(const std::size_t block_size = default_block_size,
+                           arena_upstream& upstream = arena_upstream::heap()) : block_size_(block_size),
+                                                                                id_(next_id()),
+                                                                                upstream_(&upstream)
+            {
+                if (block_size < region_size)
+                    throw exception::out_of_range_exception("block_size must be at least region_size");
+            }
+
+            arena(const arena&) = delete;
+            arena& operator=(const arena&) = delete;
+
+            ~arena() { free_blocks(); }
+
+            /**
+             * \brief allocates memory, it stays valid until reset or release
+             * \throws out_of_range_exception if alignment is not a power of two
+             * \param bytes size in bytes
+             * \param alignment alignment, a power of two
+             * \return pointer to the memory
+             */
+            void* allocate(std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t))
+            {
+                if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+                    throw exception::out_of_range_exception("alignment must be a power of two");
+                if (bytes == 0)
+                    bytes = 1;
+
+                const std::uint64_t epoch = epoch_.load(std::memory_order_acquire);
+                region& local = local_region(id_);
+                if (local.owner == id_ && local.epoch == epoch)
+                {
+                    unsigned char* result = bump(local.cursor, local.end, bytes, alignment);
+                    if (result != nullptr)
+                        return result;
+                }
+
+                // large allocations would waste most of a region
+                if (bytes + alignment > region_size / 4)
+                    return carve(bytes, alignment);
+
+                unsigned char* begin = carve(region_size, alignof(std::max_align_t));
+                local.owner = id_;
+                local.epoch = epoch;
+                local.cursor = begin;
+                local.end = begin + region_size;
+                return bump(local.cursor, local.end, bytes, alignment);
+            }
+
+            /**
+             * \brief makes all memory available again, the blocks are kept for the next frame
+             */
+            void reset() noexcept
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                current_ = 0;
+                used_ = 0;
+                epoch_.fetch_add(1, std::memory_order_release);
+            }
+
+            /**
+             * \brief makes all memory available again and gives the blocks back to the upstream
+             */
+            void release() noexcept
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                free_blocks();
+                current_ = 0;
+                used_ = 0;
+                epoch_.fetch_add(1, std::memory_order_release);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t get_block_size() const noexcept { return block_size_; }
+            NODISCARD std::size_t get_block_count() const noexcept { return blocks_.size(); }
+
+            /**
+             * \brief gets the total size of the blocks taken from the heap
+             * \return capacity in bytes
+             */
+            NODISCARD std::size_t capacity() const noexcept
+            {
+                std::size_t total = 0;
+                for (const block& block : blocks_)
+                    total += block.size;
+                return total;
+            }
+        };
+
+        /**
+         * \brief standard allocator taking its memory from an arena, deallocate does nothing
+         * \tparam T type to allocate
+         */
+        template <typename T>
+        class arena_allocator
+        {
+        public:
+            using value_type = T;
+
+        protected:
+            arena* arena_;
+
+        public:
+            /**
+             * \brief constructor for arena allocator
+             * \param arena arena to allocate from, it must outlive the allocator and its memory
+             */
+            explicit arena_allocator(arena& arena) noexcept : arena_(&arena)
+            {
+            }
+
+            /**
+             * \brief converting constructor, the allocator of a container is rebound to its internal types
+             * \tparam U type of the other allocator
+             * \param other other allocator
+             */
+            template <typename U>
+            arena_allocator(const arena_allocator<U>& other) noexcept : arena_(&other.get_arena())
+            {
+            }
+
+            /**
+             * \brief allocates room for count objects
+             * \throws bad_alloc if the size overflows
+             * \param count amount of objects
+             * \return pointer to the memory
+             */
+            NODISCARD T* allocate(const std::size_t count)
+            {
+                if (count > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+                    throw std::bad_alloc();
+                return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+            }
+
+            /**
+             * \brief does nothing, the memory is made available again by resetting the arena
+             */
+            void deallocate(T*, std::size_t) noexcept
+            {
+            }
+
+            NODISCARD arena& get_arena() const noexcept { return *arena_; }
+
+            template <typename U>
+            NODISCARD friend bool operator==(const arena_allocator& left, const arena_allocator<U>& right) noexcept
+            {
+                return &left.get_arena() == &right.get_arena();
+            }
+
+            template <typename U>
+            NODISCARD friend bool operator!=(const arena_allocator& left, const arena_allocator<U>& right) noexcept
+            {
+                return !(left == right);
+            }
+        };
+
+        /**
+         * \brief vector taking its memory from an arena, returned by the arena overloads of the batch functions
+         * \tparam T type of the elements
+         */
+        template <typename T>
+        using arena_vector = std::vector<T, arena_allocator<T>>;
+
+#if defined(CXX17)
+
+        /**
+         * \brief polymorphic memory resource taking its memory from an arena, e.g. for std::pmr::vector
+         * \note do_deallocate does nothing, the memory is made available again by resetting the arena
+         */
+        class arena_resource : public std::pmr::memory_resource
+        {
+        protected:
+            arena* arena_;
+
+            void* do_allocate(const std::size_t bytes, const std::size_t alignment) override
+            {
+                return arena_->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void*, std::size_t, std::size_t) override
+            {
+            }
+
+            NODISCARD bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                const auto* resource = dynamic_cast<const arena_resource*>(&other);
+                return resource != nullptr && resource->arena_ == arena_;
+            }
+
+        public:
+            /**
+             * \brief constructor for arena resource
+             * \param arena arena to allocate from, it must outlive the resource and its memory
+             */
+            explicit arena_resource(arena& arena) noexcept : arena_(&arena)
+            {
+            }
+
+            NODISCARD arena& get_arena() const noexcept { return *arena_; }
+        };
+
+#endif
+    } // namespace bardcore::utility
+} // namespace bardcore
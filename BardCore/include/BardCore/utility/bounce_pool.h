@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/hit_record.h"
+#include "BardCore/utility/object_pool.h"
+#include "BardCore/utility/ray.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief pools of rays and hit records for recursive tracing, one ray and one hit per bounce
+         *
+         * reserve the maximum amount of bounces once, after that every bounce takes its ray and hit from the pools
+         * and gives them back when it returns, without using the heap
+         * \note a bounce pool is not thread safe, use local() to get the pool of the calling thread
+         */
+        class bounce_pool
+        {
+        protected:
+            object_pool<ray> rays_;
+            object_pool<hit_record> hits_;
+
+        public:
+            /**
+             * \brief constructor for bounce pool
+             * \param bounces amount of bounces to reserve a ray and a hit for
+             */
+            explicit bounce_pool(const std::size_t bounces = 0) : rays_(bounces), hits_(bounces)
+            {
+            }
+
+            /**
+             * \brief gets the pool of the calling thread, it lives as long as the thread
+             * \return pool of the calling thread
+             */
+            NODISCARD static bounce_pool& local()
+            {
+                thread_local bounce_pool pool;
+                return pool;
+            }
+
+            /**
+             * \brief makes sure bounces rays and hits can be in use at once, e.g. the maximum recursion depth
+             * \param bounces amount of bounces
+             */
+            void reserve(const std::size_t bounces)
+            {
+                rays_.reserve(bounces);
+                hits_.reserve(bounces);
+            }
+
+            /**
+             * \brief takes a ray from the pool, it is given back when the handle goes out of scope
+             * \throws out_of_range_exception if all rays are in use
+             * \throws zero_exception if the direction has length zero
+             * \throws negative_exception if distance is negative
+             * \param position position of the ray
+             * \param direction direction of the ray
+             * \param distance distance of the ray
+             * \return handle to the ray
+             */
+            NODISCARD object_pool<ray>::handle make_ray(const point3d& position, const vector3d& direction,
+                                                        const double distance)
+            {
+                return rays_.make(position, direction, distance);
+            }
+
+            /**
+             * \brief takes an empty hit record (a miss) from the pool, it is given back when the handle goes out of scope
+             * \throws out_of_range_exception if all hit records are in use
+             * \param depth bounce the hit belongs to
+             * \return handle to the hit record
+             */
+            NODISCARD object_pool<hit_record>::handle make_hit(const unsigned int depth = 0)
+            {
+                object_pool<hit_record>::handle hit = hits_.make();
+                hit->depth = depth;
+                return hit;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD object_pool<ray>& get_rays() noexcept { return rays_; }
+            NODISCARD object_pool<hit_record>& get_hits() noexcept { return hits_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
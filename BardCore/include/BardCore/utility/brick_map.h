@@ -0,0 +1,353 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/voxel_grid.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief result of intersecting a ray with a brick map
+         */
+        struct voxel_intersection
+        {
+            bool hit = false; // true if an occupied voxel was found
+            voxel_hit voxel{}; // first occupied voxel along the ray, in voxel coordinates of the whole map
+        };
+
+        /**
+         * \brief throughput of intersecting rays with a brick map
+         */
+        struct voxel_statistics
+        {
+            std::size_t rays = 0; // amount of rays intersected
+            std::size_t hits = 0; // amount of rays that found an occupied voxel
+            double seconds = 0; // time spent intersecting
+
+            /**
+             * \brief amount of rays intersected per second
+             * \return rays per second, 0 if no time was measured
+             */
+            NODISCARD double rays_per_second() const noexcept
+            {
+                return seconds <= 0 ? 0. : static_cast<double>(rays) / seconds;
+            }
+
+            /**
+             * \brief measures intersecting rays
+             * \tparam Intersect callable with signature std::vector<voxel_intersection>()
+             * \param intersect intersection to measure, e.g. [&] { return map.intersect(rays); }
+             * \param results output, intersections found by intersect
+             * \return statistics of the intersection
+             */
+            template <typename Intersect>
+            NODISCARD static voxel_statistics measure(Intersect&& intersect, std::vector<voxel_intersection>& results)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                results = intersect();
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                voxel_statistics statistics;
+                statistics.rays = results.size();
+                statistics.hits = static_cast<std::size_t>(std::count_if(
+                    results.begin(), results.end(), [](const voxel_intersection& result) { return result.hit; }));
+                statistics.seconds = elapsed.count();
+                return statistics;
+            }
+        };
+
+        /**
+         * \brief sparse two level voxel structure for large volumes
+         *
+         * the coarse level is a dense grid of brick indices, only bricks containing occupied voxels are stored,
+         * a brick is 8x8x8 voxels encoded as a 512 bit occupancy mask (8 words of 64 bits),
+         * ray traversal walks the coarse grid and only descends into non empty bricks
+         * \note voxel coordinates go from 0 to bricks * brick_size on every axis
+         */
+        class brick_map
+        {
+        public:
+            /**
+             * \brief amount of voxels per brick on every axis
+             */
+            INLINE static constexpr unsigned int brick_size = 8;
+
+            /**
+             * \brief amount of 64 bit words per brick
+             */
+            INLINE static constexpr std::size_t words_per_brick = brick_size * brick_size * brick_size / 64;
+
+            /**
+             * \brief brick index of an empty coarse cell
+             */
+            INLINE static constexpr std::uint32_t empty_brick = 0xFFFFFFFFu;
+
+        protected:
+            voxel_grid<std::uint32_t> coarse_; // brick index per coarse cell, empty_brick if there is no brick
+            std::vector<std::uint64_t> occupancy_{}; // words_per_brick words per brick
+            double voxel_size_; // size of a voxel
+
+        private:
+            /**
+             * \brief helper function for the bit of a voxel inside its brick
+             * \return bit index in [0, 512)
+             */
+            NODISCARD static unsigned int local_bit(const unsigned int x, const unsigned int y,
+                                                    const unsigned int z) noexcept
+            {
+                return x % brick_size + brick_size * (y % brick_size + brick_size * (z % brick_size));
+            }
+
+            /**
+             * \brief helper function for checking a bit of a brick
+             */
+            NODISCARD bool test_bit(const std::uint32_t brick, const unsigned int bit) const noexcept
+            {
+                return (occupancy_[brick * words_per_brick + (bit >> 6)] >> (bit & 63)) & 1u;
+            }
+
+        public:
+            /**
+             * \brief constructor for an empty brick map
+             * \throws zero_exception if width, height or depth is zero
+             * \throws negative_exception if voxel_size is zero or negative
+             * \param origin minimum corner of the map
+             * \param voxel_size size of a voxel
+             * \param width amount of bricks in x
+             * \param height amount of bricks in y
+             * \param depth amount of bricks in z
+             */
+            brick_map(const point3d& origin, const double voxel_size, const unsigned int width,
+                      const unsigned int height, const unsigned int depth) :
+                coarse_(origin, voxel_size * brick_size, width, height, depth, std::uint32_t{empty_brick}),
+                voxel_size_(voxel_size)
+            {
+                if (voxel_size <= 0)
+                    throw exception::negative_exception("voxel_size must be greater than 0");
+            }
+
+            /**
+             * \brief rebuilds the map from point samples, every sample marks the voxel it lies in as occupied
+             * \note samples outside the map are ignored
+             * \note the voxels of the samples are calculated, sorted, bucketed per brick and filled in parallel
+             * \param samples point samples
+             */
+            void build(const std::vector<point3d>& samples)
+            {
+                constexpr std::uint64_t outside = ~std::uint64_t{0};
+                const unsigned int voxels[3] = {
+                    coarse_.get_width() * brick_size, coarse_.get_height() * brick_size,
+                    coarse_.get_depth() * brick_size
+                };
+                const point3d& origin = coarse_.get_origin();
+
+                // key = coarse cell << 9 | bit inside the brick, sorting groups the samples per brick
+                std::vector<std::uint64_t> keys(samples.size());
+                parallel::for_each_index(samples.size(), [&](const std::size_t index)
+                {
+                    const point3d& sample = samples[index];
+                    const double fx = std::floor((sample.x - origin.x) / voxel_size_);
+                    const double fy = std::floor((sample.y - origin.y) / voxel_size_);
+                    const double fz = std::floor((sample.z - origin.z) / voxel_size_);
+
+                    if (!(fx >= 0 && fy >= 0 && fz >= 0 && fx < voxels[0] && fy < voxels[1] && fz < voxels[2]))
+                    {
+                        keys[index] = outside;
+                        return;
+                    }
+
+                    const auto x = static_cast<unsigned int>(fx);
+                    const auto y = static_cast<unsigned int>(fy);
+                    const auto z = static_cast<unsigned int>(fz);
+                    const std::size_t cell = coarse_.index(x / brick_size, y / brick_size, z / brick_size);
+
+                    keys[index] = static_cast<std::uint64_t>(cell) << 9 | local_bit(x, y, z);
+                });
+
+                parallel::sort(keys.begin(), keys.end());
+                keys.erase(std::lower_bound(keys.begin(), keys.end(), outside), keys.end());
+
+                // one brick per distinct coarse cell, a brick starts where the cell of the sorted keys changes
+                const auto starts_brick = [&keys](const std::size_t index)
+                {
+                    return index == 0 || keys[index] >> 9 != keys[index - 1] >> 9;
+                };
+
+                std::vector<std::uint32_t>& cells = coarse_.get_cells();
+                std::fill(cells.begin(), cells.end(), std::uint32_t{empty_brick});
+
+                // count the bricks per chunk of keys, a prefix sum gives the first brick of every chunk
+                const std::size_t chunks = (std::min)(static_cast<std::size_t>(parallel::thread_count()),
+                                                      keys.size() / parallel::default_grain + 1);
+                const std::size_t chunk_size = (keys.size() + chunks - 1) / chunks;
+
+                std::vector<std::size_t> first_brick(chunks + 1, 0);
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    const std::size_t end = (std::min)(keys.size(), (chunk + 1) * chunk_size);
+                    for (std::size_t index = chunk * chunk_size; index < end; ++index)
+                        first_brick[chunk + 1] += starts_brick(index);
+                }, 1);
+
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                    first_brick[chunk + 1] += first_brick[chunk];
+
+                std::vector<std::size_t> brick_starts(first_brick[chunks] + 1, keys.size());
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    std::size_t brick = first_brick[chunk];
+                    const std::size_t end = (std::min)(keys.size(), (chunk + 1) * chunk_size);
+                    for (std::size_t index = chunk * chunk_size; index < end; ++index)
+                    {
+                        if (!starts_brick(index))
+                            continue;
+
+                        cells[static_cast<std::size_t>(keys[index] >> 9)] = static_cast<std::uint32_t>(brick);
+                        brick_starts[brick++] = index;
+                    }
+                }, 1);
+
+                occupancy_.assign((brick_starts.size() - 1) * words_per_brick, 0);
+                parallel::for_each_index(brick_starts.size() - 1, [&](const std::size_t brick)
+                {
+                    std::uint64_t* words = occupancy_.data() + brick * words_per_brick;
+                    for (std::size_t index = brick_starts[brick]; index < brick_starts[brick + 1]; ++index)
+                    {
+                        const unsigned int bit = static_cast<unsigned int>(keys[index] & 511u);
+                        words[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+                    }
+                }, 256);
+            }
+
+            /**
+             * \brief checks if a voxel is occupied
+             * \throws out_of_range_exception if the voxel is outside the map
+             * \param x voxel x
+             * \param y voxel y
+             * \param z voxel z
+             * \return true if the voxel is occupied
+             */
+            NODISCARD bool is_occupied(const unsigned int x, const unsigned int y, const unsigned int z) const
+            {
+                const std::uint32_t brick = coarse_.at(x / brick_size, y / brick_size, z / brick_size);
+                return brick != empty_brick && test_bit(brick, local_bit(x, y, z));
+            }
+
+            /**
+             * \brief finds the first occupied voxel along a ray, between 0 and the ray distance
+             * \note empty coarse cells are skipped without looking at their voxels
+             * \param ray ray to intersect
+             * \return intersection, hit is false if there is no occupied voxel along the ray
+             */
+            NODISCARD voxel_intersection intersect(const ray& ray) const
+            {
+                voxel_intersection result;
+                const point3d& origin = coarse_.get_origin();
+                const double brick_length = coarse_.get_cell_size();
+
+                coarse_.traverse(ray, [&](const voxel_hit& cell)
+                {
+                    const std::uint32_t brick = coarse_.get_cells()[cell.index];
+                    if (brick == empty_brick)
+                        return true;
+
+                    const point3d brick_origin = {
+                        origin.x + cell.x * brick_length, origin.y + cell.y * brick_length,
+                        origin.z + cell.z * brick_length
+                    };
+
+                    grid_traversal::traverse(brick_origin, voxel_size_, brick_size, brick_size, brick_size,
+                                             ray.get_position(), ray.get_direction(), cell.t_enter, cell.t_exit,
+                                             [&](const voxel_hit& voxel)
+                                             {
+                                                 if (!test_bit(brick, static_cast<unsigned int>(voxel.index)))
+                                                     return true;
+
+                                                 result.hit = true;
+                                                 result.voxel = voxel;
+                                                 result.voxel.x += cell.x * brick_size;
+                                                 result.voxel.y += cell.y * brick_size;
+                                                 result.voxel.z += cell.z * brick_size;
+                                                 result.voxel.index = result.voxel.x + static_cast<std::size_t>(
+                                                     coarse_.get_width() * brick_size) * (result.voxel.y +
+                                                     static_cast<std::size_t>(coarse_.get_height() * brick_size) *
+                                                     result.voxel.z);
+                                                 return false;
+                                             });
+
+                    return !result.hit;
+                });
+
+                return result;
+            }
+
+            /**
+             * \brief intersects many rays, the rays are intersected in parallel
+             * \param rays rays to intersect
+             * \return one intersection per ray
+             */
+            NODISCARD std::vector<voxel_intersection> intersect(const std::vector<ray>& rays) const
+            {
+                std::vector<voxel_intersection> results(rays.size());
+
+                parallel::for_each_index(rays.size(), [&](const std::size_t index)
+                {
+                    results[index] = intersect(rays[index]);
+                }, 64);
+
+                return results;
+            }
+
+            /**
+             * \brief counts the occupied voxels
+             * \return amount of occupied voxels
+             */
+            NODISCARD std::size_t occupied_voxels() const noexcept
+            {
+                std::size_t count = 0;
+                for (const std::uint64_t word : occupancy_)
+                    count += std::bitset<64>(word).count();
+                return count;
+            }
+
+            /**
+             * \brief calculates the memory used by the coarse grid and the bricks
+             * \return memory in bytes
+             */
+            NODISCARD std::size_t memory_usage() const noexcept
+            {
+                return coarse_.size() * sizeof(std::uint32_t) + occupancy_.size() * sizeof(std::uint64_t);
+            }
+
+            /**
+             * \brief calculates the memory used per occupied voxel, a measure of how well the volume compresses
+             * \return bytes per occupied voxel, 0 if there are no occupied voxels
+             */
+            NODISCARD double bytes_per_occupied_voxel() const noexcept
+            {
+                const std::size_t occupied = occupied_voxels();
+                return occupied == 0 ? 0. : static_cast<double>(memory_usage()) / static_cast<double>(occupied);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t brick_count() const noexcept { return occupancy_.size() / words_per_brick; }
+            NODISCARD double get_voxel_size() const noexcept { return voxel_size_; }
+            NODISCARD const point3d& get_origin() const noexcept { return coarse_.get_origin(); }
+            NODISCARD aabb get_bounds() const noexcept { return coarse_.get_bounds(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,807 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief pair of overlapping ids found by a broad phase, first is always the smallest id
+         */
+        struct collision_pair
+        {
+            std::uint32_t first = 0; // smallest id
+            std::uint32_t second = 0; // largest id
+
+            constexpr collision_pair() = default;
+
+            /**
+             * \brief constructor for collision pair, the ids are ordered
+             * \param a first id
+             * \param b second id
+             */
+            constexpr collision_pair(const std::uint32_t a, const std::uint32_t b) : first(a < b ? a : b),
+                                                                                      second(a < b ? b : a)
+            {
+            }
+
+            NODISCARD constexpr friend bool operator==(const collision_pair& left, const collision_pair& right) noexcept
+            {
+                return left.first == right.first && left.second == right.second;
+            }
+
+            NODISCARD constexpr friend bool operator!=(const collision_pair& left, const collision_pair& right) noexcept
+            {
+                return !(left == right);
+            }
+
+            NODISCARD constexpr friend bool operator<(const collision_pair& left, const collision_pair& right) noexcept
+            {
+                return left.first < right.first || (left.first == right.first && left.second < right.second);
+            }
+        };
+
+        /**
+         * \brief throughput of a pair search
+         */
+        struct pair_statistics
+        {
+            std::size_t pairs = 0; // amount of pairs found
+            double seconds = 0; // time spent finding the pairs
+
+            /**
+             * \brief amount of pairs found per second
+             * \return pairs per second, 0 if no time was measured
+             */
+            NODISCARD double pairs_per_second() const noexcept
+            {
+                return seconds <= 0 ? 0. : static_cast<double>(pairs) / seconds;
+            }
+
+            /**
+             * \brief measures a pair search
+             * \tparam Find callable with signature std::vector<collision_pair>()
+             * \param find pair search to measure, e.g. [&] { return tree.find_pairs_parallel(); }
+             * \param pairs output, pairs found by find
+             * \return statistics of the search
+             */
+            template <typename Find>
+            NODISCARD static pair_statistics measure(Find&& find, std::vector<collision_pair>& pairs)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                pairs = find();
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                pair_statistics statistics;
+                statistics.pairs = pairs.size();
+                statistics.seconds = elapsed.count();
+                return statistics;
+            }
+        };
+
+        /**
+         * \brief helper for emitting pairs from a range of indices, serial or in parallel
+         * \note this class only has static functions, it can't be constructed
+         */
+        class pair_emitter final
+        {
+        public:
+            pair_emitter() = delete;
+
+            /**
+             * \brief minimum amount of indices per thread
+             */
+            INLINE static constexpr std::size_t grain = 256;
+
+            /**
+             * \brief calls emit(begin, end, pairs) for chunks of [0, count) and concatenates the pairs of the chunks
+             * \note in parallel every chunk writes to its own buffer, so the order of the pairs is the same as serial
+             * \tparam Emit callable with signature void(std::size_t begin, std::size_t end, std::vector<collision_pair>& pairs)
+             * \param count amount of indices
+             * \param emit function emitting the pairs of a chunk
+             * \param in_parallel true to execute the chunks in parallel
+             * \return pairs of all chunks
+             */
+            template <typename Emit>
+            NODISCARD static std::vector<collision_pair> emit(const std::size_t count, Emit&& emit,
+                                                              const bool in_parallel)
+            {
+                std::vector<collision_pair> pairs;
+                if (!in_parallel || count <= grain)
+                {
+                    emit(std::size_t{0}, count, pairs);
+                    return pairs;
+                }
+
+                const std::size_t chunks = (std::min)(static_cast<std::size_t>(parallel::thread_count()) * 4,
+                                                      (count + grain - 1) / grain);
+                std::vector<std::vector<collision_pair>> chunk_pairs(chunks);
+
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    emit(count * chunk / chunks, count * (chunk + 1) / chunks, chunk_pairs[chunk]);
+                }, 1);
+
+                std::size_t total = 0;
+                for (const std::vector<collision_pair>& chunk : chunk_pairs)
+                    total += chunk.size();
+
+                pairs.reserve(total);
+                for (const std::vector<collision_pair>& chunk : chunk_pairs)
+                    pairs.insert(pairs.end(), chunk.begin(), chunk.end());
+
+                return pairs;
+            }
+        };
+
+        /**
+         * \brief incremental sweep and prune broad phase on the x axis
+         *
+         * the boxes are kept sorted on their minimum x, after moving the boxes a little the order is nearly sorted
+         * and insertion sort restores it in close to linear time, the sweep then only compares boxes
+         * whose x intervals overlap
+         * \note read more at https://en.wikipedia.org/wiki/Sweep_and_prune
+         * \note ids are given out in order of adding, starting at 0
+         */
+        class sweep_and_prune
+        {
+        protected:
+            /**
+             * \brief box with its id, stored sorted so the sweep reads contiguous memory
+             */
+            struct entry
+            {
+                aabb bounds{};
+                std::uint32_t id = 0;
+            };
+
+            std::vector<entry> entries_{}; // boxes, sorted on minimum x after sort
+            std::vector<std::uint32_t> positions_{}; // position in entries_ per id
+            std::size_t swaps_ = 0; // amount of swaps of the last sort
+
+        private:
+            /**
+             * \brief helper function for sweeping a range of the sorted boxes
+             */
+            void sweep(const std::size_t begin, const std::size_t end, std::vector<collision_pair>& pairs) const
+            {
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    const entry& current = entries_[index];
+                    for (std::size_t other = index + 1;
+                         other < entries_.size() && entries_[other].bounds.minimum.x <= current.bounds.maximum.x;
+                         ++other)
+                    {
+                        if (current.bounds.overlaps(entries_[other].bounds))
+                            pairs.emplace_back(current.id, entries_[other].id);
+                    }
+                }
+            }
+
+        public:
+            sweep_and_prune() = default;
+
+            /**
+             * \brief constructor with boxes, box i gets id i
+             * \param bounds boxes to add
+             */
+            explicit sweep_and_prune(const std::vector<aabb>& bounds)
+            {
+                entries_.reserve(bounds.size());
+                positions_.reserve(bounds.size());
+                for (const aabb& box : bounds)
+                    (void)add(box);
+            }
+
+            /**
+             * \brief adds a box
+             * \param bounds box to add
+             * \return id of the box
+             */
+            std::uint32_t add(const aabb& bounds)
+            {
+                const auto id = static_cast<std::uint32_t>(positions_.size());
+                positions_.push_back(static_cast<std::uint32_t>(entries_.size()));
+                entries_.push_back({bounds, id});
+                return id;
+            }
+
+            /**
+             * \brief updates a box, the order is restored by the next sort
+             * \throws out_of_range_exception if id is not in the sweep and prune
+             * \param id id of the box
+             * \param bounds new box
+             */
+            void update(const std::uint32_t id, const aabb& bounds)
+            {
+                if (id >= positions_.size())
+                    throw exception::out_of_range_exception("id is not in the sweep and prune");
+
+                entries_[positions_[id]].bounds = bounds;
+            }
+
+            /**
+             * \brief updates all boxes, box i is the new box of id i
+             * \throws out_of_range_exception if the amount of boxes is not the amount of ids
+             * \param bounds new boxes
+             */
+            void update(const std::vector<aabb>& bounds)
+            {
+                if (bounds.size() != positions_.size())
+                    throw exception::out_of_range_exception("amount of boxes must be the amount of ids");
+
+                parallel::for_each_index(bounds.size(), [&](const std::size_t id)
+                {
+                    entries_[positions_[id]].bounds = bounds[id];
+                });
+            }
+
+            /**
+             * \brief restores the order of the boxes with insertion sort, fast when the boxes moved a little
+             * \return amount of swaps, 0 if the boxes were still sorted
+             */
+            std::size_t sort() noexcept
+            {
+                swaps_ = 0;
+                for (std::size_t index = 1; index < entries_.size(); ++index)
+                {
+                    if (entries_[index - 1].bounds.minimum.x <= entries_[index].bounds.minimum.x)
+                        continue;
+
+                    const entry current = entries_[index];
+                    std::size_t position = index;
+                    while (position > 0 && entries_[position - 1].bounds.minimum.x > current.bounds.minimum.x)
+                    {
+                        entries_[position] = entries_[position - 1];
+                        positions_[entries_[position].id] = static_cast<std::uint32_t>(position);
+                        --position;
+                    }
+
+                    entries_[position] = current;
+                    positions_[current.id] = static_cast<std::uint32_t>(position);
+                    swaps_ += index - position;
+                }
+
+                return swaps_;
+            }
+
+            /**
+             * \brief sorts the boxes and finds all overlapping pairs
+             * \return overlapping pairs, in order of the sweep
+             */
+            NODISCARD std::vector<collision_pair> find_pairs()
+            {
+                (void)sort();
+                return pair_emitter::emit(entries_.size(),
+                                          [this](const std::size_t begin, const std::size_t end,
+                                                 std::vector<collision_pair>& pairs) { sweep(begin, end, pairs); },
+                                          false);
+            }
+
+            /**
+             * \brief sorts the boxes and finds all overlapping pairs, the sweep is done in parallel
+             * \return overlapping pairs, in the same order as find_pairs
+             */
+            NODISCARD std::vector<collision_pair> find_pairs_parallel()
+            {
+                (void)sort();
+                return pair_emitter::emit(entries_.size(),
+                                          [this](const std::size_t begin, const std::size_t end,
+                                                 std::vector<collision_pair>& pairs) { sweep(begin, end, pairs); },
+                                          true);
+            }
+
+            /**
+             * \brief gets a box
+             * \throws out_of_range_exception if id is not in the sweep and prune
+             * \param id id of the box
+             * \return box
+             */
+            NODISCARD const aabb& get_bounds(const std::uint32_t id) const
+            {
+                if (id >= positions_.size())
+                    throw exception::out_of_range_exception("id is not in the sweep and prune");
+
+                return entries_[positions_[id]].bounds;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return entries_.size(); }
+            NODISCARD std::size_t get_last_swaps() const noexcept { return swaps_; }
+        };
+
+        /**
+         * \brief node of a dynamic aabb tree
+         */
+        struct aabb_tree_node
+        {
+            aabb bounds{}; // fat bounds for leaves, union of the children for inner nodes
+            std::uint32_t parent = 0xFFFFFFFFu; // parent node, next free node for free nodes
+            std::uint32_t left = 0xFFFFFFFFu; // left child, null_node for leaves
+            std::uint32_t right = 0xFFFFFFFFu; // right child, null_node for leaves
+            int height = 0; // 0 for leaves, -1 for free nodes
+
+            NODISCARD bool is_leaf() const noexcept { return left == 0xFFFFFFFFu; }
+        };
+
+        /**
+         * \brief dynamic bounding volume tree for moving boxes
+         *
+         * leaves store a fat box (the box grown by a margin), moving a box inside its fat box doesn't change the tree,
+         * leaves are inserted next to the sibling with the lowest surface area cost and the tree is kept balanced
+         * with rotations, so the height stays logarithmic
+         * \note read more at https://box2d.org/files/ErinCatto_DynamicBVH_GDC2019.pdf
+         * \note a proxy is the node index of its leaf, proxies stay valid until removed
+         */
+        class dynamic_aabb_tree
+        {
+        public:
+            /**
+             * \brief index of no node
+             */
+            INLINE static constexpr std::uint32_t null_node = 0xFFFFFFFFu;
+
+        protected:
+            std::vector<aabb_tree_node> nodes_{}; // node pool, free nodes form a list through parent
+            std::vector<aabb> bounds_{}; // exact box per leaf
+            std::uint32_t root_ = null_node; // root node
+            std::uint32_t free_ = null_node; // first free node
+            std::size_t proxy_count_ = 0; // amount of leaves
+            double margin_ = 0.1; // margin of the fat boxes
+
+        private:
+            /**
+             * \brief helper function for the union of two boxes
+             */
+            NODISCARD static aabb merge(const aabb& left, const aabb& right) noexcept
+            {
+                aabb box = left;
+                box.expand(right);
+                return box;
+            }
+
+            /**
+             * \brief helper function for checking if a proxy is a leaf of the tree
+             */
+            NODISCARD bool is_proxy(const std::uint32_t proxy) const noexcept
+            {
+                return proxy < nodes_.size() && nodes_[proxy].height == 0;
+            }
+
+            /**
+             * \brief helper function for taking a node from the free list or growing the pool
+             */
+            std::uint32_t allocate_node()
+            {
+                std::uint32_t index = free_;
+                if (index == null_node)
+                {
+                    index = static_cast<std::uint32_t>(nodes_.size());
+                    nodes_.emplace_back();
+                    bounds_.emplace_back();
+                }
+                else
+                {
+                    free_ = nodes_[index].parent;
+                    nodes_[index] = aabb_tree_node();
+                }
+
+                return index;
+            }
+
+            /**
+             * \brief helper function for returning a node to the free list
+             */
+            void free_node(const std::uint32_t index) noexcept
+            {
+                nodes_[index].height = -1;
+                nodes_[index].parent = free_;
+                free_ = index;
+            }
+
+            /**
+             * \brief helper function for recalculating the bounds and height of an inner node from its children
+             */
+            void refresh(const std::uint32_t index) noexcept
+            {
+                aabb_tree_node& node = nodes_[index];
+                node.bounds = merge(nodes_[node.left].bounds, nodes_[node.right].bounds);
+                node.height = 1 + (std::max)(nodes_[node.left].height, nodes_[node.right].height);
+            }
+
+            /**
+             * \brief helper function for replacing a child in the parent of a node (or the root)
+             */
+            void replace_child(const std::uint32_t parent, const std::uint32_t old_child,
+                               const std::uint32_t new_child) noexcept
+            {
+                if (parent == null_node)
+                    root_ = new_child;
+                else if (nodes_[parent].left == old_child)
+                    nodes_[parent].left = new_child;
+                else
+                    nodes_[parent].right = new_child;
+            }
+
+            /**
+             * \brief helper function for rotating a child up, the child becomes the parent of index
+             * \return new root of the subtree (up)
+             */
+            std::uint32_t rotate(const std::uint32_t index, const std::uint32_t up) noexcept
+            {
+                const std::uint32_t up_left = nodes_[up].left;
+                const std::uint32_t up_right = nodes_[up].right;
+
+                // the highest grandchild stays under up, the other one moves to index
+                const std::uint32_t kept = nodes_[up_left].height > nodes_[up_right].height ? up_left : up_right;
+                const std::uint32_t moved = kept == up_left ? up_right : up_left;
+
+                nodes_[up].parent = nodes_[index].parent;
+                replace_child(nodes_[index].parent, index, up);
+                nodes_[index].parent = up;
+
+                if (nodes_[index].left == up)
+                    nodes_[index].left = moved;
+                else
+                    nodes_[index].right = moved;
+                nodes_[moved].parent = index;
+
+                nodes_[up].left = index;
+                nodes_[up].right = kept;
+
+                refresh(index);
+                refresh(up);
+                return up;
+            }
+
+            /**
+             * \brief helper function for balancing a node with a rotation if its children differ more than 1 in height
+             * \return new root of the subtree
+             */
+            std::uint32_t balance(const std::uint32_t index) noexcept
+            {
+                const aabb_tree_node& node = nodes_[index];
+                if (node.is_leaf() || node.height < 2)
+                    return index;
+
+                const int difference = nodes_[node.right].height - nodes_[node.left].height;
+                if (difference > 1)
+                    return rotate(index, node.right);
+                if (difference < -1)
+                    return rotate(index, node.left);
+
+                return index;
+            }
+
+            /**
+             * \brief helper function for refitting and balancing all ancestors starting at index
+             */
+            void refit(std::uint32_t index) noexcept
+            {
+                while (index != null_node)
+                {
+                    index = balance(index);
+                    refresh(index);
+                    index = nodes_[index].parent;
+                }
+            }
+
+            /**
+             * \brief helper function for the cost of pushing a leaf down into a child
+             */
+            NODISCARD double descend_cost(const std::uint32_t child, const aabb& leaf_bounds) const noexcept
+            {
+                const double area = merge(nodes_[child].bounds, leaf_bounds).surface_area();
+                return nodes_[child].is_leaf() ? area : area - nodes_[child].bounds.surface_area();
+            }
+
+            /**
+             * \brief helper function for inserting a leaf next to the sibling with the lowest surface area cost
+             */
+            void insert_leaf(const std::uint32_t leaf)
+            {
+                if (root_ == null_node)
+                {
+                    root_ = leaf;
+                    nodes_[leaf].parent = null_node;
+                    return;
+                }
+
+                const aabb leaf_bounds = nodes_[leaf].bounds;
+                std::uint32_t sibling = root_;
+                while (!nodes_[sibling].is_leaf())
+                {
+                    const aabb_tree_node& node = nodes_[sibling];
+                    const double combined_area = merge(node.bounds, leaf_bounds).surface_area();
+
+                    // cost of a new parent for this node and the leaf, descending costs at least the growth of this node
+                    const double cost = 2 * combined_area;
+                    const double inheritance = 2 * (combined_area - node.bounds.surface_area());
+                    const double cost_left = descend_cost(node.left, leaf_bounds) + inheritance;
+                    const double cost_right = descend_cost(node.right, leaf_bounds) + inheritance;
+
+                    if (cost < cost_left && cost < cost_right)
+                        break;
+
+                    sibling = cost_left < cost_right ? node.left : node.right;
+                }
+
+                const std::uint32_t old_parent = nodes_[sibling].parent;
+                const std::uint32_t new_parent = allocate_node();
+
+                nodes_[new_parent].parent = old_parent;
+                nodes_[new_parent].left = sibling;
+                nodes_[new_parent].right = leaf;
+                replace_child(old_parent, sibling, new_parent);
+
+                nodes_[sibling].parent = new_parent;
+                nodes_[leaf].parent = new_parent;
+
+                refit(new_parent);
+            }
+
+            /**
+             * \brief helper function for removing a leaf, its parent is replaced by its sibling
+             */
+            void remove_leaf(const std::uint32_t leaf) noexcept
+            {
+                if (leaf == root_)
+                {
+                    root_ = null_node;
+                    return;
+                }
+
+                const std::uint32_t parent = nodes_[leaf].parent;
+                const std::uint32_t grandparent = nodes_[parent].parent;
+                const std::uint32_t sibling = nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+
+                replace_child(grandparent, parent, sibling);
+                nodes_[sibling].parent = grandparent;
+                free_node(parent);
+
+                refit(grandparent);
+            }
+
+            /**
+             * \brief helper function for growing a box with the margin
+             */
+            NODISCARD aabb fatten(const aabb& bounds) const noexcept
+            {
+                return {
+                    {bounds.minimum.x - margin_, bounds.minimum.y - margin_, bounds.minimum.z - margin_},
+                    {bounds.maximum.x + margin_, bounds.maximum.y + margin_, bounds.maximum.z + margin_}
+                };
+            }
+
+            /**
+             * \brief helper function for a query with a reusable stack
+             */
+            template <typename Callback>
+            void query(const aabb& bounds, Callback&& callback, std::vector<std::uint32_t>& stack) const
+            {
+                if (root_ == null_node)
+                    return;
+
+                stack.clear();
+                stack.push_back(root_);
+
+                while (!stack.empty())
+                {
+                    const aabb_tree_node& node = nodes_[stack.back()];
+                    const std::uint32_t index = stack.back();
+                    stack.pop_back();
+
+                    if (!node.bounds.overlaps(bounds))
+                        continue;
+
+                    if (node.is_leaf())
+                    {
+                        if (!callback(index))
+                            return;
+                    }
+                    else
+                    {
+                        stack.push_back(node.left);
+                        stack.push_back(node.right);
+                    }
+                }
+            }
+
+            /**
+             * \brief helper function for emitting the pairs of a range of leaves, only pairs with a larger proxy are emitted
+             */
+            void emit_pairs(const std::vector<std::uint32_t>& leaves, const std::size_t begin, const std::size_t end,
+                            std::vector<collision_pair>& pairs) const
+            {
+                std::vector<std::uint32_t> stack;
+                stack.reserve(64);
+
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    const std::uint32_t proxy = leaves[index];
+                    const aabb& bounds = bounds_[proxy];
+
+                    query(bounds, [&](const std::uint32_t other)
+                    {
+                        if (other > proxy && bounds.overlaps(bounds_[other]))
+                            pairs.emplace_back(proxy, other);
+                        return true;
+                    }, stack);
+                }
+            }
+
+            /**
+             * \brief helper function for collecting all leaves in order of their proxy
+             */
+            NODISCARD std::vector<std::uint32_t> leaves() const
+            {
+                std::vector<std::uint32_t> leaves;
+                leaves.reserve(proxy_count_);
+                for (std::size_t index = 0; index < nodes_.size(); ++index)
+                    if (nodes_[index].height == 0)
+                        leaves.push_back(static_cast<std::uint32_t>(index));
+                return leaves;
+            }
+
+        public:
+            /**
+             * \brief constructor for dynamic aabb tree
+             * \throws negative_exception if margin is negative
+             * \param margin margin added to every side of the boxes, larger margins mean less updates but more pairs to check
+             */
+            explicit dynamic_aabb_tree(const double margin = 0.1) : margin_(margin)
+            {
+                if (margin < 0)
+                    throw exception::negative_exception("margin can't be negative");
+            }
+
+            /**
+             * \brief inserts a box
+             * \param bounds box to insert
+             * \return proxy of the box
+             */
+            std::uint32_t insert(const aabb& bounds)
+            {
+                const std::uint32_t proxy = allocate_node();
+                nodes_[proxy].bounds = fatten(bounds);
+                bounds_[proxy] = bounds;
+
+                insert_leaf(proxy);
+                ++proxy_count_;
+                return proxy;
+            }
+
+            /**
+             * \brief removes a box
+             * \throws out_of_range_exception if proxy is not in the tree
+             * \param proxy proxy of the box
+             */
+            void remove(const std::uint32_t proxy)
+            {
+                if (!is_proxy(proxy))
+                    throw exception::out_of_range_exception("proxy is not in the tree");
+
+                remove_leaf(proxy);
+                free_node(proxy);
+                --proxy_count_;
+            }
+
+            /**
+             * \brief moves a box, the tree only changes if the box left its fat box
+             * \throws out_of_range_exception if proxy is not in the tree
+             * \param proxy proxy of the box
+             * \param bounds new box
+             * \return true if the leaf was reinserted
+             */
+            bool move(const std::uint32_t proxy, const aabb& bounds)
+            {
+                if (!is_proxy(proxy))
+                    throw exception::out_of_range_exception("proxy is not in the tree");
+
+                bounds_[proxy] = bounds;
+                if (nodes_[proxy].bounds.contains(bounds))
+                    return false;
+
+                remove_leaf(proxy);
+                nodes_[proxy].bounds = fatten(bounds);
+                insert_leaf(proxy);
+                return true;
+            }
+
+            /**
+             * \brief calls callback(proxy) for every proxy whose fat box overlaps a box
+             * \tparam Callback callable with signature bool(std::uint32_t proxy), returning false stops the query
+             * \param bounds box to query
+             * \param callback function to call per proxy
+             */
+            template <typename Callback>
+            void query(const aabb& bounds, Callback&& callback) const
+            {
+                std::vector<std::uint32_t> stack;
+                stack.reserve(64);
+                query(bounds, callback, stack);
+            }
+
+            /**
+             * \brief finds all pairs of overlapping boxes (exact boxes, not the fat boxes)
+             * \return overlapping pairs, in order of the first proxy
+             */
+            NODISCARD std::vector<collision_pair> find_pairs() const
+            {
+                const std::vector<std::uint32_t> all = leaves();
+                return pair_emitter::emit(all.size(),
+                                          [this, &all](const std::size_t begin, const std::size_t end,
+                                                       std::vector<collision_pair>& pairs)
+                                          {
+                                              emit_pairs(all, begin, end, pairs);
+                                          }, false);
+            }
+
+            /**
+             * \brief finds all pairs of overlapping boxes, the leaves are queried in parallel
+             * \return overlapping pairs, in the same order as find_pairs
+             */
+            NODISCARD std::vector<collision_pair> find_pairs_parallel() const
+            {
+                const std::vector<std::uint32_t> all = leaves();
+                return pair_emitter::emit(all.size(),
+                                          [this, &all](const std::size_t begin, const std::size_t end,
+                                                       std::vector<collision_pair>& pairs)
+                                          {
+                                              emit_pairs(all, begin, end, pairs);
+                                          }, true);
+            }
+
+            /**
+             * \brief gets the exact box of a proxy
+             * \throws out_of_range_exception if proxy is not in the tree
+             * \param proxy proxy of the box
+             * \return box
+             */
+            NODISCARD const aabb& get_bounds(const std::uint32_t proxy) const
+            {
+                if (!is_proxy(proxy))
+                    throw exception::out_of_range_exception("proxy is not in the tree");
+
+                return bounds_[proxy];
+            }
+
+            /**
+             * \brief gets the fat box of a proxy
+             * \throws out_of_range_exception if proxy is not in the tree
+             * \param proxy proxy of the box
+             * \return fat box
+             */
+            NODISCARD const aabb& get_fat_bounds(const std::uint32_t proxy) const
+            {
+                if (!is_proxy(proxy))
+                    throw exception::out_of_range_exception("proxy is not in the tree");
+
+                return nodes_[proxy].bounds;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return proxy_count_; }
+            NODISCARD bool is_empty() const noexcept { return proxy_count_ == 0; }
+            NODISCARD int height() const noexcept { return root_ == null_node ? 0 : nodes_[root_].height; }
+            NODISCARD double get_margin() const noexcept { return margin_; }
+            NODISCARD const std::vector<aabb_tree_node>& get_nodes() const noexcept { return nodes_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
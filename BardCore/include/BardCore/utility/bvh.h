@@ -0,0 +1,823 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/arena.h"
+#include "BardCore/utility/hit_record.h"
+#include "BardCore/utility/page_memory.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#if defined(BARDCORE_BVH_PREFETCH) && defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) // _mm_prefetch
+#include <xmmintrin.h>
+#endif
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief node of a bvh, inner nodes have two children stored next to each other (first and first + 1)
+         */
+        struct bvh_node
+        {
+            aabb bounds{}; // bounds of everything below this node
+            std::uint32_t first = 0; // left child for inner nodes, first primitive (in bvh::get_primitives) for leaves
+            std::uint32_t count = 0; // amount of primitives, 0 for inner nodes
+
+            NODISCARD bool is_leaf() const noexcept { return count > 0; }
+        };
+
+        /**
+         * \brief work done by a traversal, see bvh::closest_hit with counters
+         */
+        struct traversal_counters
+        {
+            std::size_t node_visits = 0; // nodes popped from the stack, leaves included
+            std::size_t primitive_tests = 0; // primitives in the visited leaves
+
+            void visit_node() noexcept { ++node_visits; }
+            void test_primitives(const std::uint32_t count) noexcept { primitive_tests += count; }
+        };
+
+        /**
+         * \brief order of the nodes in memory, chosen when the bvh is built
+         *
+         * siblings always stay next to each other, a layout only orders the sibling pairs
+         */
+        enum class bvh_layout
+        {
+            depth_first, // build order, the left subtree is stored before the right subtree
+            hot_first, // depth first, the subtree with the larger surface area (most likely hit) is stored first
+            breadth_first, // level by level
+            van_emde_boas, // cache oblivious, subtrees of half the height are stored together recursively
+        };
+
+        /**
+         * \brief bounding volume hierarchy over primitives given by their bounding boxes
+         *
+         * the bvh only knows the bounds of the primitives, queries take a callable that tests a primitive,
+         * so any kind of primitive can be used, e.g. triangles in triangle_mesh
+         * \note built top down with the binned surface area heuristic
+         * \note read more at https://en.wikipedia.org/wiki/Bounding_volume_hierarchy
+         */
+        class bvh
+        {
+        public:
+            /**
+             * \brief amount of bins per axis in the surface area heuristic
+             */
+            INLINE static constexpr unsigned int bin_count = 12;
+
+            /**
+             * \brief primitive index returned when nothing was found, same as utility::no_primitive
+             */
+            INLINE static constexpr std::uint32_t no_primitive = utility::no_primitive;
+
+            /**
+             * \brief maximum depth of the bvh, the traversal stack is this size
+             */
+            INLINE static constexpr std::size_t max_depth = 64;
+
+            /**
+             * \brief node storage, large node arrays are taken from page_memory
+             */
+            using node_vector = std::vector<bvh_node, page_allocator<bvh_node>>;
+
+            /**
+             * \brief default page options of the nodes: huge pages from 2 MiB of nodes on, smaller bvhs stay on the heap
+             * \return options
+             */
+            NODISCARD static page_options default_node_options() noexcept
+            {
+                page_options options;
+                options.min_bytes = std::size_t{2} << 20;
+                return options;
+            }
+
+        protected:
+            node_vector nodes_{page_allocator<bvh_node>(default_node_options())}; // nodes, the root is at index 0
+            std::vector<std::uint32_t> primitives_{}; // primitive indices, leaves reference a range
+            bvh_layout layout_ = bvh_layout::depth_first;
+
+        private:
+            /**
+             * \brief helper function for calculating the bounds of a range of primitives
+             */
+            NODISCARD aabb range_bounds(const std::vector<aabb>& bounds, const std::uint32_t first,
+                                        const std::uint32_t count) const noexcept
+            {
+                aabb box;
+                for (std::uint32_t index = first; index < first + count; ++index)
+                    box.expand(bounds[primitives_[index]]);
+                return box;
+            }
+
+            /**
+             * \brief helper function for splitting a node with the binned surface area heuristic
+             * \return amount of primitives in the left child, 0 if the node should stay a leaf
+             */
+            std::uint32_t split(const std::vector<aabb>& bounds, const point3d* centroids,
+                                const bvh_node& node, const unsigned int max_leaf_size,
+                                const unsigned int min_leaf_size)
+            {
+                if (node.count <= min_leaf_size)
+                    return 0;
+
+                aabb centroid_bounds;
+                for (std::uint32_t index = node.first; index < node.first + node.count; ++index)
+                    centroid_bounds.expand(centroids[primitives_[index]]);
+
+                const vector3d extent = centroid_bounds.extent();
+                const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+                const double axis_minimum = axis == 0
+                                                ? centroid_bounds.minimum.x
+                                                : (axis == 1 ? centroid_bounds.minimum.y : centroid_bounds.minimum.z);
+                const double axis_extent = axis == 0 ? extent.x : (axis == 1 ? extent.y : extent.z);
+
+                const auto centroid_axis = [axis](const point3d& point)
+                {
+                    return axis == 0 ? point.x : (axis == 1 ? point.y : point.z);
+                };
+
+                auto* const begin = primitives_.data() + node.first;
+                auto* const end = begin + node.count;
+
+                // fallback when the heuristic doesn't find a split but the node is too big for a leaf
+                const auto median_split = [&]() -> std::uint32_t
+                {
+                    if (node.count <= max_leaf_size)
+                        return 0;
+
+                    std::nth_element(begin, begin + node.count / 2, end,
+                                     [&](const std::uint32_t left, const std::uint32_t right)
+                                     {
+                                         return centroid_axis(centroids[left]) < centroid_axis(centroids[right]);
+                                     });
+                    return node.count / 2;
+                };
+
+                if (axis_extent <= 0)
+                    return median_split();
+
+                const double scale = bin_count / axis_extent;
+                const auto bin_of = [&](const std::uint32_t primitive)
+                {
+                    const auto bin = static_cast<unsigned int>((centroid_axis(centroids[primitive]) - axis_minimum) *
+                        scale);
+                    return bin < bin_count ? bin : bin_count - 1;
+                };
+
+                aabb bin_bounds[bin_count];
+                std::uint32_t bin_counts[bin_count] = {};
+                for (auto* primitive = begin; primitive != end; ++primitive)
+                {
+                    const unsigned int bin = bin_of(*primitive);
+                    bin_bounds[bin].expand(bounds[*primitive]);
+                    ++bin_counts[bin];
+                }
+
+                // sweep from the right to get the right side cost of every split plane
+                double right_costs[bin_count] = {};
+                aabb right_box;
+                std::uint32_t right_count = 0;
+                for (unsigned int bin = bin_count - 1; bin > 0; --bin)
+                {
+                    right_box.expand(bin_bounds[bin]);
+                    right_count += bin_counts[bin];
+                    right_costs[bin] = right_box.surface_area() * right_count;
+                }
+
+                double best_cost = math::inf;
+                unsigned int best_split = 0;
+                aabb left_box;
+                std::uint32_t left_count = 0;
+                for (unsigned int bin = 0; bin + 1 < bin_count; ++bin)
+                {
+                    left_box.expand(bin_bounds[bin]);
+                    left_count += bin_counts[bin];
+
+                    const double cost = left_box.surface_area() * left_count + right_costs[bin + 1];
+                    if (left_count > 0 && left_count < node.count && cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_split = bin + 1;
+                    }
+                }
+
+                const double leaf_cost = node.bounds.surface_area() * node.count;
+                if (best_split == 0 || (best_cost >= leaf_cost && node.count <= max_leaf_size))
+                    return median_split();
+
+                auto* const middle = std::partition(begin, end, [&](const std::uint32_t primitive)
+                {
+                    return bin_of(primitive) < best_split;
+                });
+
+                return static_cast<std::uint32_t>(middle - begin);
+            }
+
+            /**
+             * \brief helper function for the bounds accessor of traverse, the bounds stored in the nodes
+             */
+            NODISCARD auto stored_bounds() const noexcept
+            {
+                return [this](const std::uint32_t node) -> const aabb& { return nodes_[node].bounds; };
+            }
+
+            /**
+             * \brief helper function for loading the memory a node points to (children or primitives) into the cache
+             * before it is visited
+             * \note opt in, only done when BARDCORE_BVH_PREFETCH is defined, measure before turning it on
+             */
+            void prefetch(const bvh_node& node) const noexcept
+            {
+#if defined(BARDCORE_BVH_PREFETCH)
+                const void* address = node.is_leaf()
+                                          ? static_cast<const void*>(primitives_.data() + node.first)
+                                          : static_cast<const void*>(nodes_.data() + node.first);
+#if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+                _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+                (void)address;
+#endif
+#else
+                (void)node;
+#endif
+            }
+
+            /**
+             * \brief helper function for the van emde boas order of the sibling pairs below pair,
+             * the top half of the levels is stored first, then every subtree below it, each ordered the same way
+             * \param pair index of the first node of the pair
+             * \param levels amount of levels below pair (including it) to order
+             * \param order output, pairs in their new order
+             * \param frontier scratch space, the pairs below the top half are appended and removed again
+             */
+            template <typename Vector>
+            void van_emde_boas(const std::uint32_t pair, const std::size_t levels, Vector& order,
+                               Vector& frontier) const
+            {
+                if (levels == 1)
+                {
+                    order.push_back(pair);
+                    return;
+                }
+
+                const std::size_t top = levels / 2;
+                van_emde_boas(pair, top, order, frontier);
+
+                // collect the pairs exactly top levels below pair, level by level
+                const std::size_t base = frontier.size();
+                std::size_t begin = base;
+                frontier.push_back(pair);
+                for (std::size_t level = 0; level < top; ++level)
+                {
+                    const std::size_t end = frontier.size();
+                    for (std::size_t index = begin; index < end; ++index)
+                        for (std::uint32_t child = frontier[index]; child < frontier[index] + 2; ++child)
+                            if (!nodes_[child].is_leaf())
+                                frontier.push_back(nodes_[child].first);
+                    begin = end;
+                }
+
+                // indices instead of iterators, the recursion appends to frontier
+                const std::size_t end = frontier.size();
+                for (std::size_t index = begin; index < end; ++index)
+                    van_emde_boas(frontier[index], levels - top, order, frontier);
+
+                frontier.resize(base);
+            }
+
+            /**
+             * \brief helper function for storing the sibling pairs in the order of layout, the root stays at index 0
+             */
+            template <typename Allocator>
+            void reorder(const bvh_layout layout, const Allocator& allocator)
+            {
+                using index_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<
+                    std::uint32_t>;
+                using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<bvh_node>;
+
+                // only the depth first order of the build, or a single pair
+                if (layout == bvh_layout::depth_first || nodes_.size() <= 3)
+                    return;
+
+                // a pair is identified by the index of its first node
+                const std::size_t pair_count = nodes_.size() / 2;
+                std::vector<std::uint32_t, index_allocator> order{index_allocator(allocator)};
+                order.reserve(pair_count);
+                std::vector<std::uint32_t, index_allocator> work{index_allocator(allocator)};
+                work.reserve(pair_count);
+
+                if (layout == bvh_layout::breadth_first)
+                {
+                    // order is its own queue
+                    order.push_back(nodes_[0].first);
+                    for (std::size_t head = 0; head < order.size(); ++head)
+                        for (std::uint32_t child = order[head]; child < order[head] + 2; ++child)
+                            if (!nodes_[child].is_leaf())
+                                order.push_back(nodes_[child].first);
+                }
+                else if (layout == bvh_layout::hot_first)
+                {
+                    work.push_back(nodes_[0].first);
+                    while (!work.empty())
+                    {
+                        const std::uint32_t pair = work.back();
+                        work.pop_back();
+                        order.push_back(pair);
+
+                        // push the cold child first, so the pair below the hot child is stored right after this one
+                        const bool left_hot = nodes_[pair].bounds.surface_area() >=
+                            nodes_[pair + 1].bounds.surface_area();
+                        const bvh_node& hot = nodes_[left_hot ? pair : pair + 1];
+                        const bvh_node& cold = nodes_[left_hot ? pair + 1 : pair];
+                        if (!cold.is_leaf())
+                            work.push_back(cold.first);
+                        if (!hot.is_leaf())
+                            work.push_back(hot.first);
+                    }
+                }
+                else
+                {
+                    // height of the tree of pairs, breadth first with order as queue, the last pair is the deepest
+                    std::size_t levels = 0;
+                    std::vector<std::uint32_t, index_allocator> depth(nodes_.size(), 0u, index_allocator(allocator));
+                    order.push_back(nodes_[0].first);
+                    depth[nodes_[0].first] = 1;
+                    for (std::size_t head = 0; head < order.size(); ++head)
+                    {
+                        levels = depth[order[head]];
+                        for (std::uint32_t child = order[head]; child < order[head] + 2; ++child)
+                        {
+                            if (!nodes_[child].is_leaf())
+                            {
+                                depth[nodes_[child].first] = depth[order[head]] + 1;
+                                order.push_back(nodes_[child].first);
+                            }
+                        }
+                    }
+
+                    order.clear();
+                    van_emde_boas(nodes_[0].first, levels, order, work);
+                }
+
+                // new index of the first node of every pair
+                std::vector<std::uint32_t, index_allocator> position(nodes_.size(), 0u, index_allocator(allocator));
+                for (std::size_t index = 0; index < order.size(); ++index)
+                    position[order[index]] = static_cast<std::uint32_t>(1 + 2 * index);
+
+                const std::vector<bvh_node, node_allocator> old(nodes_.begin(), nodes_.end(),
+                                                                node_allocator(allocator));
+                for (std::size_t index = 0; index < order.size(); ++index)
+                {
+                    nodes_[1 + 2 * index] = old[order[index]];
+                    nodes_[2 + 2 * index] = old[order[index] + 1];
+                }
+
+                for (bvh_node& node : nodes_)
+                    if (!node.is_leaf())
+                        node.first = position[node.first];
+            }
+
+            /**
+             * \brief helper function for building, the temporaries are allocated with allocator
+             */
+            template <typename Allocator>
+            void build_nodes(const std::vector<aabb>& bounds, const unsigned int max_leaf_size,
+                             const bvh_layout layout, const unsigned int min_leaf_size, const Allocator& allocator)
+            {
+                using point_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<point3d>;
+                using entry = std::pair<std::uint32_t, std::size_t>;
+                using entry_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<entry>;
+
+                if (max_leaf_size == 0)
+                    throw exception::zero_exception("max_leaf_size must be greater than 0");
+                if (min_leaf_size > max_leaf_size)
+                    throw exception::out_of_range_exception("min_leaf_size can't be greater than max_leaf_size");
+
+                layout_ = layout;
+                nodes_.clear();
+                primitives_.resize(bounds.size());
+                std::iota(primitives_.begin(), primitives_.end(), 0u);
+
+                if (bounds.empty())
+                    return;
+
+                std::vector<point3d, point_allocator> centroids{point_allocator(allocator)};
+                centroids.reserve(bounds.size());
+                for (const aabb& box : bounds)
+                    centroids.push_back(box.center());
+
+                nodes_.reserve(2 * bounds.size());
+
+                bvh_node root;
+                root.first = 0;
+                root.count = static_cast<std::uint32_t>(bounds.size());
+                root.bounds = range_bounds(bounds, root.first, root.count);
+                nodes_.push_back(root);
+
+                // depth first, the left child is always built before the right child
+                // nodes at max_depth stay leaves, so the fixed size traversal stacks can't overflow
+                std::vector<entry, entry_allocator> stack{entry_allocator(allocator)};
+                stack.reserve(2 * max_depth);
+                stack.emplace_back(0u, std::size_t{1});
+                while (!stack.empty())
+                {
+                    const std::uint32_t node_index = stack.back().first;
+                    const std::size_t depth = stack.back().second;
+                    stack.pop_back();
+
+                    const bvh_node node = nodes_[node_index];
+                    const std::uint32_t left_count = depth < max_depth
+                                                         ? split(bounds, centroids.data(), node, max_leaf_size,
+                                                                 min_leaf_size)
+                                                         : 0;
+                    if (left_count == 0)
+                        continue;
+
+                    const auto left_index = static_cast<std::uint32_t>(nodes_.size());
+
+                    bvh_node left;
+                    left.first = node.first;
+                    left.count = left_count;
+                    left.bounds = range_bounds(bounds, left.first, left.count);
+
+                    bvh_node right;
+                    right.first = node.first + left_count;
+                    right.count = node.count - left_count;
+                    right.bounds = range_bounds(bounds, right.first, right.count);
+
+                    nodes_.push_back(left);
+                    nodes_.push_back(right);
+
+                    nodes_[node_index].first = left_index;
+                    nodes_[node_index].count = 0;
+
+                    stack.emplace_back(left_index + 1, depth + 1);
+                    stack.emplace_back(left_index, depth + 1);
+                }
+
+                reorder(layout, allocator);
+            }
+
+        public:
+            bvh() = default;
+
+            /**
+             * \brief constructor, builds the bvh
+             * \throws zero_exception if max_leaf_size is zero
+             * \throws out_of_range_exception if min_leaf_size is greater than max_leaf_size
+             * \param bounds bounding box per primitive
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             * \param min_leaf_size nodes with at most this amount of primitives are never split,
+             *                      e.g. the width of a triangle_pack that tests them at once
+             */
+            explicit bvh(const std::vector<aabb>& bounds, const unsigned int max_leaf_size = 4,
+                         const bvh_layout layout = bvh_layout::depth_first, const unsigned int min_leaf_size = 1)
+            {
+                build(bounds, max_leaf_size, layout, min_leaf_size);
+            }
+
+            /**
+             * \brief builds the bvh, the old content is replaced
+             * \throws zero_exception if max_leaf_size is zero
+             * \throws out_of_range_exception if min_leaf_size is greater than max_leaf_size
+             * \param bounds bounding box per primitive
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             * \param min_leaf_size nodes with at most this amount of primitives are never split
+             */
+            void build(const std::vector<aabb>& bounds, const unsigned int max_leaf_size = 4,
+                       const bvh_layout layout = bvh_layout::depth_first, const unsigned int min_leaf_size = 1)
+            {
+                build_nodes(bounds, max_leaf_size, layout, min_leaf_size, std::allocator<char>());
+            }
+
+            /**
+             * \brief builds the bvh with the temporaries in an arena, the old content is replaced
+             * \note the nodes keep their capacity, so rebuilding with the same amount of primitives doesn't use the heap
+             * \throws zero_exception if max_leaf_size is zero
+             * \throws out_of_range_exception if min_leaf_size is greater than max_leaf_size
+             * \param bounds bounding box per primitive
+             * \param arena arena for the temporaries, e.g. reset every frame
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             * \param min_leaf_size nodes with at most this amount of primitives are never split
+             */
+            void build(const std::vector<aabb>& bounds, arena& arena, const unsigned int max_leaf_size = 4,
+                       const bvh_layout layout = bvh_layout::depth_first, const unsigned int min_leaf_size = 1)
+            {
+                build_nodes(bounds, max_leaf_size, layout, min_leaf_size, arena_allocator<char>(arena));
+            }
+
+            /**
+             * \brief recomputes the node bounds bottom up for moved primitives, the tree itself is kept
+             * \note much cheaper than a build, but the tree gets slower to traverse the further the primitives
+             *       move from where they were at build time, rebuild now and then
+             * \note children are always stored after their parent, in every layout
+             * \throws out_of_range_exception if the amount of bounds is not the amount of primitives
+             * \param bounds new bounding box per primitive
+             */
+            void refit(const std::vector<aabb>& bounds)
+            {
+                if (bounds.size() != primitives_.size())
+                    throw exception::out_of_range_exception("amount of bounds must be the amount of primitives");
+
+                for (std::size_t node_index = nodes_.size(); node_index-- > 0;)
+                {
+                    bvh_node& node = nodes_[node_index];
+                    if (node.is_leaf())
+                    {
+                        node.bounds = range_bounds(bounds, node.first, node.count);
+                    }
+                    else
+                    {
+                        node.bounds = nodes_[node.first].bounds;
+                        node.bounds.expand(nodes_[node.first + 1].bounds);
+                    }
+                }
+            }
+
+            /**
+             * \brief finds the closest primitive hit by a ray, children are visited front to back
+             * \tparam Intersect callable with signature bool(std::uint32_t primitive, double& t_max),
+             *                   returns true and lowers t_max if the primitive is hit closer than t_max
+             * \param ray ray to trace, its distance is the initial t_max
+             * \param intersect function testing a primitive
+             * \return primitive that was hit, no_primitive if nothing was hit
+             */
+            template <typename Intersect>
+            NODISCARD std::uint32_t closest_hit(const ray& ray, Intersect&& intersect) const
+            {
+                return closest_hit_leaves(ray, [&](const bvh_node& leaf, double& t_max)
+                {
+                    std::uint32_t closest = no_primitive;
+                    for (std::uint32_t index = leaf.first; index < leaf.first + leaf.count; ++index)
+                        if (intersect(primitives_[index], t_max))
+                            closest = primitives_[index];
+                    return closest;
+                });
+            }
+
+            /**
+             * \brief closest_hit that also counts the visited nodes and tested primitives, e.g. for a heatmap
+             * \tparam Intersect callable with signature bool(std::uint32_t primitive, double& t_max)
+             * \param ray ray to trace, its distance is the initial t_max
+             * \param intersect function testing a primitive
+             * \param counters counters to add to, they are not reset
+             * \return primitive that was hit, no_primitive if nothing was hit
+             */
+            template <typename Intersect>
+            NODISCARD std::uint32_t closest_hit(const ray& ray, Intersect&& intersect,
+                                                traversal_counters& counters) const
+            {
+                return closest_hit_leaves(ray, [&](const bvh_node& leaf, double& t_max)
+                {
+                    std::uint32_t closest = no_primitive;
+                    for (std::uint32_t index = leaf.first; index < leaf.first + leaf.count; ++index)
+                        if (intersect(primitives_[index], t_max))
+                            closest = primitives_[index];
+                    return closest;
+                }, counters);
+            }
+
+            /**
+             * \brief counters that count nothing, so a traversal without counters has no overhead
+             */
+            struct no_counters
+            {
+                void visit_node() noexcept
+                {
+                }
+
+                void test_primitives(std::uint32_t) noexcept
+                {
+                }
+            };
+
+            /**
+             * \brief traversal of closest_hit_leaves with the bounds of the nodes given by a callable,
+             * e.g. bounds interpolated in time by motion_bvh, children are visited front to back
+             * \tparam IntersectLeaf callable with signature std::uint32_t(const bvh_node& leaf, double& t_max)
+             * \tparam NodeBounds callable with signature aabb(std::uint32_t node), bounds of a node of get_nodes
+             * \tparam Counters traversal_counters or no_counters
+             * \param ray ray to trace, its distance is the initial t_max
+             * \param intersect_leaf function testing the primitives of a leaf
+             * \param node_bounds function giving the bounds of a node
+             * \param counters counters to add to, they are not reset
+             * \return primitive that was hit, no_primitive if nothing was hit
+             */
+            template <typename IntersectLeaf, typename NodeBounds, typename Counters>
+            NODISCARD std::uint32_t traverse(const ray& ray, IntersectLeaf&& intersect_leaf, NodeBounds&& node_bounds,
+                                             Counters& counters) const
+            {
+                if (nodes_.empty())
+                    return no_primitive;
+
+                const point3d& origin = ray.get_position();
+                const vector3d& direction = ray.get_direction();
+                const vector3d inverse_direction = {1. / direction.x, 1. / direction.y, 1. / direction.z};
+
+                double t_max = ray.get_distance();
+                std::uint32_t closest = no_primitive;
+
+                double t_enter = 0, t_exit = 0;
+                if (!node_bounds(0).intersect(origin, inverse_direction, t_max, t_enter, t_exit))
+                    return no_primitive;
+
+                // node index and entry distance, nodes entered beyond a closer hit are skipped when popped
+                std::uint32_t stack[max_depth];
+                double stack_t[max_depth];
+                std::size_t stack_size = 0;
+                stack[stack_size] = 0;
+                stack_t[stack_size++] = t_enter;
+
+                while (stack_size > 0)
+                {
+                    --stack_size;
+                    if (stack_t[stack_size] > t_max)
+                        continue;
+
+                    const bvh_node& node = nodes_[stack[stack_size]];
+                    counters.visit_node();
+
+                    if (node.is_leaf())
+                    {
+                        counters.test_primitives(node.count);
+                        const std::uint32_t hit = intersect_leaf(node, t_max);
+                        if (hit != no_primitive)
+                            closest = hit;
+                        continue;
+                    }
+
+                    double t_left = 0, t_right = 0, exit = 0;
+                    const bool hit_left = node_bounds(node.first).intersect(
+                        origin, inverse_direction, t_max, t_left, exit);
+                    const bool hit_right = node_bounds(node.first + 1).intersect(
+                        origin, inverse_direction, t_max, t_right, exit);
+
+                    // push the farthest child first so the nearest is visited first,
+                    // what the pushed children point to can be prefetched while the nearest is processed
+                    if (hit_left && hit_right)
+                    {
+                        const bool left_first = t_left <= t_right;
+                        prefetch(nodes_[left_first ? node.first : node.first + 1]);
+                        prefetch(nodes_[left_first ? node.first + 1 : node.first]);
+                        stack[stack_size] = left_first ? node.first + 1 : node.first;
+                        stack_t[stack_size++] = left_first ? t_right : t_left;
+                        stack[stack_size] = left_first ? node.first : node.first + 1;
+                        stack_t[stack_size++] = left_first ? t_left : t_right;
+                    }
+                    else if (hit_left || hit_right)
+                    {
+                        prefetch(nodes_[hit_left ? node.first : node.first + 1]);
+                        stack[stack_size] = hit_left ? node.first : node.first + 1;
+                        stack_t[stack_size++] = hit_left ? t_left : t_right;
+                    }
+                }
+
+                return closest;
+            }
+
+            /**
+             * \brief finds the closest primitive hit by a ray like closest_hit, but a whole leaf is tested at once,
+             * e.g. with a triangle_pack holding the triangles of the leaf
+             * \tparam IntersectLeaf callable with signature std::uint32_t(const bvh_node& leaf, double& t_max),
+             *                       returns the primitive of the leaf hit closest and closer than t_max and lowers t_max,
+             *                       or no_primitive
+             * \param ray ray to trace, its distance is the initial t_max
+             * \param intersect_leaf function testing the primitives of a leaf, see get_primitives
+             * \return primitive that was hit, no_primitive if nothing was hit
+             */
+            template <typename IntersectLeaf>
+            NODISCARD std::uint32_t closest_hit_leaves(const ray& ray, IntersectLeaf&& intersect_leaf) const
+            {
+                no_counters counters;
+                return traverse(ray, intersect_leaf, stored_bounds(), counters);
+            }
+
+            /**
+             * \brief closest_hit_leaves that also counts the visited nodes and tested primitives, e.g. for a heatmap
+             * \tparam IntersectLeaf callable with signature std::uint32_t(const bvh_node& leaf, double& t_max)
+             * \param ray ray to trace, its distance is the initial t_max
+             * \param intersect_leaf function testing the primitives of a leaf
+             * \param counters counters to add to, they are not reset
+             * \return primitive that was hit, no_primitive if nothing was hit
+             */
+            template <typename IntersectLeaf>
+            NODISCARD std::uint32_t closest_hit_leaves(const ray& ray, IntersectLeaf&& intersect_leaf,
+                                                       traversal_counters& counters) const
+            {
+                return traverse(ray, intersect_leaf, stored_bounds(), counters);
+            }
+
+            /**
+             * \brief finds the nearest primitive to a point, children are visited nearest first
+             * and nodes farther away than the current best distance are skipped
+             * \tparam Distance callable with signature double(std::uint32_t primitive), squared distance to the primitive
+             * \param point query point
+             * \param distance_squared function calculating the squared distance to a primitive
+             * \param best_distance_squared input: maximum squared search distance, output: squared distance to the nearest primitive
+             * \return nearest primitive, no_primitive if nothing is within the maximum distance
+             */
+            template <typename Distance>
+            NODISCARD std::uint32_t nearest(const point3d& point, Distance&& distance_squared,
+                                            double& best_distance_squared) const
+            {
+                if (nodes_.empty() || nodes_[0].bounds.distance_squared(point) > best_distance_squared)
+                    return no_primitive;
+
+                std::uint32_t nearest_primitive = no_primitive;
+
+                // node index and squared distance, nodes farther than a closer primitive are skipped when popped
+                std::uint32_t stack[max_depth];
+                double stack_distance[max_depth];
+                std::size_t stack_size = 0;
+                stack[stack_size] = 0;
+                stack_distance[stack_size++] = 0;
+
+                while (stack_size > 0)
+                {
+                    --stack_size;
+                    if (stack_distance[stack_size] >= best_distance_squared)
+                        continue;
+
+                    const bvh_node& node = nodes_[stack[stack_size]];
+
+                    if (node.is_leaf())
+                    {
+                        for (std::uint32_t index = node.first; index < node.first + node.count; ++index)
+                        {
+                            const double distance = distance_squared(primitives_[index]);
+                            if (distance < best_distance_squared)
+                            {
+                                best_distance_squared = distance;
+                                nearest_primitive = primitives_[index];
+                            }
+                        }
+                        continue;
+                    }
+
+                    const double left = nodes_[node.first].bounds.distance_squared(point);
+                    const double right = nodes_[node.first + 1].bounds.distance_squared(point);
+
+                    // push the farthest child first so the nearest is visited first
+                    const bool left_first = left <= right;
+                    const double near_distance = left_first ? left : right;
+                    const double far_distance = left_first ? right : left;
+
+                    if (near_distance < best_distance_squared)
+                        prefetch(nodes_[left_first ? node.first : node.first + 1]);
+
+                    if (far_distance < best_distance_squared)
+                    {
+                        prefetch(nodes_[left_first ? node.first + 1 : node.first]);
+                        stack[stack_size] = left_first ? node.first + 1 : node.first;
+                        stack_distance[stack_size++] = far_distance;
+                    }
+                    if (near_distance < best_distance_squared)
+                    {
+                        stack[stack_size] = left_first ? node.first : node.first + 1;
+                        stack_distance[stack_size++] = near_distance;
+                    }
+                }
+
+                return nearest_primitive;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief sets the huge pages and NUMA placement of the nodes, the nodes are copied to the new storage
+             * \note e.g. page_placement::interleaved when threads on every NUMA node traverse the bvh
+             * \param options page options of the nodes
+             */
+            void set_node_options(const page_options& options)
+            {
+                nodes_ = node_vector(nodes_.begin(), nodes_.end(), page_allocator<bvh_node>(options));
+            }
+
+            NODISCARD const node_vector& get_nodes() const noexcept { return nodes_; }
+            NODISCARD page_options get_node_options() const noexcept { return nodes_.get_allocator().get_options(); }
+            NODISCARD const std::vector<std::uint32_t>& get_primitives() const noexcept { return primitives_; }
+            NODISCARD bvh_layout get_layout() const noexcept { return layout_; }
+            NODISCARD bool is_empty() const noexcept { return nodes_.empty(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/utility/bvh.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief quality of a bvh, see bvh_diagnostics::collect
+         */
+        struct bvh_statistics
+        {
+            std::size_t nodes = 0;
+            std::size_t leaves = 0;
+            std::size_t primitives = 0;
+            std::size_t max_depth = 0; // depth of the deepest leaf, the root has depth 1
+            double average_leaf_depth = 0;
+            double sah_cost = 0; // expected cost of a random ray, relative to the surface area of the root
+            double overlap = 0; // summed surface area of the overlap of siblings, relative to the surface area of the root
+            std::vector<std::size_t> leaf_sizes{}; // histogram, leaf_sizes[n] is the amount of leaves with n primitives
+
+            /**
+             * \brief average amount of primitives per leaf
+             * \return average leaf size, 0 if there are no leaves
+             */
+            NODISCARD double average_leaf_size() const noexcept
+            {
+                return leaves == 0 ? 0. : static_cast<double>(primitives) / static_cast<double>(leaves);
+            }
+        };
+
+        /**
+         * \brief traversal counters of every pixel of a camera view, see bvh_diagnostics::trace
+         */
+        struct traversal_image
+        {
+            unsigned int width = 0;
+            unsigned int height = 0;
+            std::vector<traversal_counters> pixels{}; // row major (index = y * width + x)
+
+            NODISCARD std::size_t max_node_visits() const noexcept
+            {
+                std::size_t maximum = 0;
+                for (const traversal_counters& pixel : pixels)
+                    maximum = (std::max)(maximum, pixel.node_visits);
+                return maximum;
+            }
+
+            NODISCARD std::size_t max_primitive_tests() const noexcept
+            {
+                std::size_t maximum = 0;
+                for (const traversal_counters& pixel : pixels)
+                    maximum = (std::max)(maximum, pixel.primitive_tests);
+                return maximum;
+            }
+        };
+
+        /**
+         * \brief counter shown by a heatmap
+         */
+        enum class heatmap_channel
+        {
+            node_visits,
+            primitive_tests,
+        };
+
+        /**
+         * \brief diagnostics for tuning bvh builds: tree statistics and per pixel traversal cost heatmaps
+         *
+         * the counters are only recorded by trace, the normal traversal functions of bvh don't count anything,
+         * so the diagnostics cost nothing when they are not used
+         * \note this class only has static functions, it can't be constructed
+         */
+        class bvh_diagnostics final
+        {
+        private:
+            /**
+             * \brief helper function for the color of a heat in [0, 1], black, red, yellow, white
+             */
+            static void heat_color(const double heat, unsigned char (&color)[3]) noexcept
+            {
+                const auto channel = [heat](const double offset)
+                {
+                    const double value = (std::min)((std::max)(3 * heat - offset, 0.), 1.);
+                    return static_cast<unsigned char>(value * 255 + 0.5);
+                };
+
+                color[0] = channel(0);
+                color[1] = channel(1);
+                color[2] = channel(2);
+            }
+
+        public:
+            bvh_diagnostics() = delete;
+
+            /**
+             * \brief calculates the statistics of a bvh
+             * \param bvh bvh to inspect
+             * \param traversal_cost cost of visiting an inner node in the sah cost
+             * \param intersection_cost cost of testing a primitive in the sah cost
+             * \return statistics, all zero for an empty bvh
+             */
+            NODISCARD static bvh_statistics collect(const bvh& bvh, const double traversal_cost = 1,
+                                                    const double intersection_cost = 1)
+            {
+                bvh_statistics statistics;
+                const bvh::node_vector& nodes = bvh.get_nodes();
+                if (nodes.empty())
+                    return statistics;
+
+                // a flat root (e.g. coplanar primitives) has no area, then areas are used as they are
+                const double root_area = nodes[0].bounds.surface_area();
+                const double scale = root_area > 0 ? 1 / root_area : 1;
+
+                std::size_t depth_sum = 0;
+                std::vector<std::pair<std::uint32_t, std::size_t>> stack;
+                stack.emplace_back(0u, std::size_t{1});
+                while (!stack.empty())
+                {
+                    const bvh_node& node = nodes[stack.back().first];
+                    const std::size_t depth = stack.back().second;
+                    stack.pop_back();
+
+                    ++statistics.nodes;
+                    const double area = node.bounds.surface_area() * scale;
+
+                    if (node.is_leaf())
+                    {
+                        ++statistics.leaves;
+                        statistics.primitives += node.count;
+                        statistics.max_depth = (std::max)(statistics.max_depth, depth);
+                        depth_sum += depth;
+                        statistics.sah_cost += intersection_cost * node.count * area;
+
+                        if (statistics.leaf_sizes.size() <= node.count)
+                            statistics.leaf_sizes.resize(node.count + 1, 0);
+                        ++statistics.leaf_sizes[node.count];
+                        continue;
+                    }
+
+                    statistics.sah_cost += traversal_cost * area;
+
+                    const aabb& left = nodes[node.first].bounds;
+                    const aabb& right = nodes[node.first + 1].bounds;
+                    const aabb overlap(
+                        {
+                            (std::max)(left.minimum.x, right.minimum.x), (std::max)(left.minimum.y, right.minimum.y),
+                            (std::max)(left.minimum.z, right.minimum.z)
+                        },
+                        {
+                            (std::min)(left.maximum.x, right.maximum.x), (std::min)(left.maximum.y, right.maximum.y),
+                            (std::min)(left.maximum.z, right.maximum.z)
+                        });
+                    statistics.overlap += overlap.surface_area() * scale;
+
+                    stack.emplace_back(node.first, depth + 1);
+                    stack.emplace_back(node.first + 1, depth + 1);
+                }
+
+                statistics.average_leaf_depth = static_cast<double>(depth_sum) / static_cast<double>(statistics.leaves);
+                return statistics;
+            }
+
+            /**
+             * \brief traces a ray through every pixel of a camera and records the traversal counters, rows run in parallel
+             * \tparam Intersect callable with signature bool(std::uint32_t primitive, double& t_max), see bvh::closest_hit
+             * \param camera camera to shoot the rays with
+             * \param distance distance (tmax) of every ray
+             * \param bvh bvh to traverse
+             * \param intersect function testing a primitive, called from many threads at once
+             * \return counters per pixel
+             */
+            template <typename Intersect>
+            NODISCARD static traversal_image trace(const camera& camera, const double distance, const bvh& bvh,
+                                                   Intersect&& intersect)
+            {
+                traversal_image image;
+                image.width = camera.get_screen_width();
+                image.height = camera.get_screen_height();
+                image.pixels.resize(static_cast<std::size_t>(image.width) * image.height);
+
+                parallel::for_each_index(image.height, [&](const std::size_t y)
+                {
+                    for (unsigned int x = 0; x < image.width; ++x)
+                    {
+                        const ray ray = camera.shoot_ray(x, static_cast<unsigned int>(y), distance);
+                        (void)bvh.closest_hit(ray, intersect, image.pixels[y * image.width + x]);
+                    }
+                }, 1);
+
+                return image;
+            }
+
+            /**
+             * \brief writes a heatmap of a traversal image as a binary ppm (P6) image, black is no work, white is most work
+             * \param os output stream, opened in binary mode
+             * \param image traversal counters per pixel
+             * \param channel counter to show
+             * \param maximum counter value shown as white, 0 to use the maximum of the image,
+             *                a fixed value makes heatmaps of different builds comparable
+             */
+            static void write_heatmap(std::ostream& os, const traversal_image& image,
+                                      const heatmap_channel channel = heatmap_channel::node_visits,
+                                      std::size_t maximum = 0)
+            {
+                if (maximum == 0)
+                    maximum = channel == heatmap_channel::node_visits
+                                  ? image.max_node_visits()
+                                  : image.max_primitive_tests();
+
+                os << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+
+                for (const traversal_counters& pixel : image.pixels)
+                {
+                    const std::size_t value = channel == heatmap_channel::node_visits
+                                                  ? pixel.node_visits
+                                                  : pixel.primitive_tests;
+                    const double heat = maximum == 0
+                                            ? 0.
+                                            : static_cast<double>(value) / static_cast<double>(maximum);
+
+                    unsigned char color[3];
+                    heat_color(heat, color);
+                    os.write(reinterpret_cast<const char*>(color), 3);
+                }
+            }
+
+            /**
+             * \brief writes a heatmap of a traversal image to a ppm file
+             * \param path path of the file, e.g. "node_visits.ppm"
+             * \param image traversal counters per pixel
+             * \param channel counter to show
+             * \param maximum counter value shown as white, 0 to use the maximum of the image
+             * \return true if the file was written
+             */
+            static bool write_heatmap(const std::string& path, const traversal_image& image,
+                                      const heatmap_channel channel = heatmap_channel::node_visits,
+                                      const std::size_t maximum = 0)
+            {
+                std::ofstream file(path, std::ios::binary);
+                if (!file)
+                    return false;
+
+                write_heatmap(file, image, channel, maximum);
+                return static_cast<bool>(file);
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
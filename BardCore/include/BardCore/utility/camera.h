@@ -5,10 +5,24 @@
 #include <BardCore/math/point3d.h>
 #include <BardCore/utility/ray.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace bardcore
 {
     namespace utility
     {
+        /**
+         * \brief how a camera maps pixels to rays
+         */
+        enum class camera_projection
+        {
+            perspective, // pinhole through a screen at distance 1, fov is the horizontal angle
+            orthographic, // parallel rays from the screen, the screen is as large as the perspective screen
+            fisheye, // equidistant, the angle to the direction grows linearly to fov / 2 at the left and right edge
+            equirectangular, // the whole sphere, x is the longitude and y the latitude, fov is not used
+        };
+
         /**
          * \brief camera class, used for creating rays through a screen
          * \note this class is final, you can't inherit from it
@@ -26,6 +40,11 @@ namespace bardcore
 
             unsigned int fov_ = 90; // field of view
 
+            double aperture_ = 0; // diameter of the lens, 0 for a pinhole
+            double focal_distance_ = 1; // distance along the direction to the plane that is in focus
+
+            camera_projection projection_ = camera_projection::perspective;
+
         private:
             /**
              * \brief this is a helper function to calculate the screen topleft and horizontal and vertical vectors
@@ -53,6 +72,46 @@ namespace bardcore
                 top_left_ = center - half_horizontal_ + half_vertical_;
             }
 
+            /**
+             * \brief helper function for checking that a pixel is on the screen
+             * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
+             */
+            constexpr void check_pixel(const unsigned int x, const unsigned int y) const
+            {
+                if (x >= screen_width_ || y >= screen_height_)
+                    throw bardcore::exception::out_of_range_exception(
+                        "x and y must be smaller than the screen width and height");
+            }
+
+            /**
+             * \brief helper function for the vector from the position to a pixel on the screen (at distance 1)
+             * \note no bounds check, see check_pixel
+             */
+            NODISCARD constexpr vector3d pixel_vector(const unsigned int x, const unsigned int y) const
+            {
+                //calculate the position on the screen
+                const double ratio_width = static_cast<double>(x) / static_cast<double>(screen_width_);
+                const double ratio_height = static_cast<double>(y) / static_cast<double>(screen_height_);
+
+                //calculate the position on the screen
+                const vector3d horizontal = half_horizontal_ * 2 * ratio_width;
+                const vector3d vertical = half_vertical_ * 2 * ratio_height;
+
+                return position_.get_vector(top_left_ + horizontal - vertical);
+            }
+
+            /**
+             * \brief helper function for sin and cos of an angle in [-pi / 4, pi / 4], polynomials without branches
+             */
+            constexpr static void sin_cos_quarter(const double angle, double& sine, double& cosine) noexcept
+            {
+                const double a2 = angle * angle;
+                sine = angle * (1 + a2 * (-1. / 6 + a2 * (1. / 120 + a2 * (-1. / 5040 + a2 * (1. / 362880 + a2 *
+                    (-1. / 39916800 + a2 * (1. / 6227020800)))))));
+                cosine = 1 + a2 * (-1. / 2 + a2 * (1. / 24 + a2 * (-1. / 720 + a2 * (1. / 40320 + a2 * (-1. / 3628800
+                    + a2 * (1. / 479001600 + a2 * (-1. / 87178291200)))))));
+            }
+
         public:
             /**
              * \brief constructor for camera (position, direction, width, height)
@@ -88,7 +147,10 @@ namespace bardcore
                                                     half_horizontal_(other.half_horizontal_),
                                                     half_vertical_(other.half_vertical_),
                                                     screen_width_(other.screen_width_),
-                                                    screen_height_(other.screen_height_), fov_(other.fov_)
+                                                    screen_height_(other.screen_height_), fov_(other.fov_),
+                                                    aperture_(other.aperture_),
+                                                    focal_distance_(other.focal_distance_),
+                                                    projection_(other.projection_)
             {
             }
 
@@ -103,14 +165,18 @@ namespace bardcore
                                                         half_vertical_(std::move(other.half_vertical_)),
                                                         screen_width_(std::move(other.screen_width_)),
                                                         screen_height_(std::move(other.screen_height_)),
-                                                        fov_(std::move(other.fov_))
+                                                        fov_(std::move(other.fov_)),
+                                                        aperture_(std::move(other.aperture_)),
+                                                        focal_distance_(std::move(other.focal_distance_)),
+                                                        projection_(std::move(other.projection_))
             {
             }
 
             ~camera() = default;
 
             /**
-             * \brief shoot a ray from the camera through a pixel on the screen
+             * \brief shoot a ray from the camera through a pixel on the screen, with the projection of the camera
+             * \note see projection_lut for the rays of every pixel at once
              * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
              * \param x x position on the screen
              * \param y y position on the screen
@@ -118,20 +184,179 @@ namespace bardcore
              */
             NODISCARD constexpr ray shoot_ray(const unsigned int x, const unsigned int y, const double distance) const
             {
-                if (x >= screen_width_ || y >= screen_height_)
-                    throw bardcore::exception::out_of_range_exception(
-                        "x and y must be smaller than the screen width and height");
+                check_pixel(x, y);
+
+                if (projection_ == camera_projection::perspective)
+                    return {position_, pixel_vector(x, y), distance};
+                if (projection_ == camera_projection::orthographic)
+                    return {position_ + pixel_vector(x, y) - direction_, direction_, distance};
+
+                // -1 at the left and bottom edge, 1 at the right and top edge
+                const double u = 2 * static_cast<double>(x) / static_cast<double>(screen_width_) - 1;
+                const double v = 1 - 2 * static_cast<double>(y) / static_cast<double>(screen_height_);
+
+                if (projection_ == camera_projection::fisheye)
+                {
+                    const double radius = math::sqrt(u * u + v * v);
+                    if (radius == 0)
+                        return {position_, direction_, distance};
+
+                    const double angle = radius * math::degrees_to_radians(static_cast<double>(fov_) / 2);
+                    const double scale = math::sin(angle) / radius;
+                    return {
+                        position_,
+                        direction_ * math::cos(angle) + get_right() * (u * scale) + get_up() * (v * scale),
+                        distance
+                    };
+                }
+
+                const double longitude = math::pi * u;
+                const double latitude = math::pi_2 * v;
+                return {
+                    position_,
+                    get_right() * (math::cos(latitude) * math::sin(longitude)) + get_up() * math::sin(latitude) +
+                    direction_ * (math::cos(latitude) * math::cos(longitude)),
+                    distance
+                };
+            }
 
-                //calculate the position on the screen
-                const double ratio_width = static_cast<double>(x) / static_cast<double>(screen_width_);
-                const double ratio_height = static_cast<double>(y) / static_cast<double>(screen_height_);
+            /**
+             * \brief shoot a ray from a point on the lens through the focal point of a pixel (thin lens, depth of field)
+             * \note with an aperture of 0 this is the same ray as shoot_ray, see lens_sampler for many samples at once
+             * \note only the perspective projection has a lens, other projections ignore the lens samples
+             * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
+             * \throws out_of_range_exception if lens_u or lens_v is not in [0, 1]
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \param distance distance of the ray
+             * \param lens_u first coordinate of the lens sample, in [0, 1]
+             * \param lens_v second coordinate of the lens sample, in [0, 1]
+             */
+            NODISCARD constexpr ray shoot_ray(const unsigned int x, const unsigned int y, const double distance,
+                                              const double lens_u, const double lens_v) const
+            {
+                if (lens_u < 0 || lens_u > 1 || lens_v < 0 || lens_v > 1)
+                    throw exception::out_of_range_exception("lens samples must be between 0 and 1");
+                if (projection_ != camera_projection::perspective)
+                    return shoot_ray(x, y, distance);
 
-                //calculate the position on the screen
-                const vector3d horizontal = half_horizontal_ * 2 * ratio_width;
-                const vector3d vertical = half_vertical_ * 2 * ratio_height;
+                const point3d focal_point = get_focal_point(x, y);
+
+                double disk_x = 0, disk_y = 0;
+                concentric_disk(lens_u, lens_v, disk_x, disk_y);
+                const point3d origin = position_ + get_lens_horizontal() * disk_x + get_lens_vertical() * disk_y;
 
-                // return ray
-                return {position_, position_.get_vector(top_left_ + horizontal - vertical), distance};
+                return {origin, origin.get_vector(focal_point), distance};
+            }
+
+            /**
+             * \brief projects a point onto the screen, the inverse of shoot_ray
+             * \note pixel (x, y) is at screen position (x, y), a point is on the screen if the nearest pixel is,
+             *       e.g. for reprojecting points of a previous frame
+             * \param point point to project
+             * \param x output, horizontal screen position, e.g. 12.3 is near pixel 12
+             * \param y output, vertical screen position
+             * \return true if the point can be seen (in front of the camera) and the nearest pixel is on the screen
+             */
+            NODISCARD bool project(const point3d& point, double& x, double& y) const
+            {
+                const vector3d offset = position_.get_vector(point);
+                const vector3d right = get_right(), up = get_up();
+                const double local_x = offset.dot(right), local_y = offset.dot(up), local_z = offset.dot(direction_);
+                const double half_fov = math::degrees_to_radians(static_cast<double>(fov_) / 2);
+
+                // -1 at the left and bottom edge, 1 at the right and top edge, like shoot_ray
+                double u = 0, v = 0;
+                if (projection_ == camera_projection::perspective)
+                {
+                    if (local_z <= 0)
+                        return false;
+
+                    const double half_fov_tan = std::tan(half_fov);
+                    u = local_x / (local_z * half_fov_tan);
+                    v = local_y / (local_z * half_fov_tan);
+                }
+                else if (projection_ == camera_projection::orthographic)
+                {
+                    if (local_z < 0)
+                        return false;
+
+                    const double half_fov_tan = std::tan(half_fov);
+                    u = local_x / half_fov_tan;
+                    v = local_y / half_fov_tan;
+                }
+                else
+                {
+                    const double length = offset.length();
+                    if (length == 0)
+                        return false;
+
+                    if (projection_ == camera_projection::fisheye)
+                    {
+                        // the radius on the screen grows linearly with the angle to the direction
+                        const double planar = std::sqrt(local_x * local_x + local_y * local_y);
+                        const double radius = std::acos((std::min)((std::max)(local_z / length, -1.), 1.)) / half_fov;
+                        u = planar == 0 ? 0 : local_x / planar * radius;
+                        v = planar == 0 ? 0 : local_y / planar * radius;
+                    }
+                    else
+                    {
+                        u = std::atan2(local_x, local_z) / math::pi;
+                        v = std::asin((std::min)((std::max)(local_y / length, -1.), 1.)) / math::pi_2;
+                    }
+                }
+
+                x = (u + 1) / 2 * static_cast<double>(screen_width_);
+                y = (1 - v) / 2 * static_cast<double>(screen_height_);
+
+                // the longitude wraps around, straight behind is the left edge
+                if (projection_ == camera_projection::equirectangular && x >= static_cast<double>(screen_width_) - 0.5)
+                    x -= static_cast<double>(screen_width_);
+                return x > -0.5 && x < static_cast<double>(screen_width_) - 0.5
+                    && y > -0.5 && y < static_cast<double>(screen_height_) - 0.5;
+            }
+
+            /**
+             * \brief gets the point a pixel is focused on by the perspective projection, every ray through the pixel passes it
+             * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \return point on the plane at focal distance
+             */
+            NODISCARD constexpr point3d get_focal_point(const unsigned int x, const unsigned int y) const
+            {
+                check_pixel(x, y);
+
+                // the screen is at distance 1 along the direction, so the focal plane is focal_distance times further
+                return position_ + pixel_vector(x, y) * focal_distance_;
+            }
+
+            /**
+             * \brief maps a point of the unit square to the unit disk, keeping the distribution uniform
+             *
+             * the concentric mapping of Shirley and Chiu, squares around the center become circles. the angle
+             * inside every octant is in [-pi / 4, pi / 4], so it is calculated with polynomials and selects instead
+             * of branches and trigonometry calls
+             * \param u first coordinate, in [0, 1]
+             * \param v second coordinate, in [0, 1]
+             * \param x output, x on the disk
+             * \param y output, y on the disk
+             */
+            constexpr static void concentric_disk(const double u, const double v, double& x, double& y) noexcept
+            {
+                const double a = 2 * u - 1;
+                const double b = 2 * v - 1;
+
+                // the coordinate with the largest magnitude is the radius, the other one gives the angle
+                const bool horizontal = a * a > b * b;
+                const double radius = horizontal ? a : b;
+                const double other = horizontal ? b : a;
+                const double angle = math::pi_4 * other / (radius == 0 ? 1 : radius);
+
+                double sine = 0, cosine = 0;
+                sin_cos_quarter(angle, sine, cosine);
+                x = radius * (horizontal ? cosine : sine);
+                y = radius * (horizontal ? sine : cosine);
             }
 
             ///////////////////////////////////////////////////////
@@ -144,6 +369,39 @@ namespace bardcore
             NODISCARD constexpr const point3d& get_position() const noexcept { return position_; }
             NODISCARD constexpr const vector3d& get_direction() const noexcept { return direction_; }
             NODISCARD constexpr unsigned int get_fov() const noexcept { return fov_; }
+            NODISCARD constexpr double get_aperture() const noexcept { return aperture_; }
+            NODISCARD constexpr double get_focal_distance() const noexcept { return focal_distance_; }
+            NODISCARD constexpr camera_projection get_projection() const noexcept { return projection_; }
+
+            /**
+             * \brief gets the normalized vector to the right of the screen
+             * \return right vector, perpendicular to the direction
+             */
+            NODISCARD constexpr vector3d get_right() const { return half_horizontal_.normalize(); }
+
+            /**
+             * \brief gets the normalized vector to the top of the screen
+             * \return up vector, perpendicular to the direction and the right vector
+             */
+            NODISCARD constexpr vector3d get_up() const { return half_vertical_.normalize(); }
+
+            /**
+             * \brief gets the horizontal axis of the lens, its length is the radius of the lens
+             * \return horizontal lens vector, zero for a pinhole
+             */
+            NODISCARD constexpr vector3d get_lens_horizontal() const
+            {
+                return get_right() * (aperture_ / 2);
+            }
+
+            /**
+             * \brief gets the vertical axis of the lens, its length is the radius of the lens
+             * \return vertical lens vector, zero for a pinhole
+             */
+            NODISCARD constexpr vector3d get_lens_vertical() const
+            {
+                return get_up() * (aperture_ / 2);
+            }
 
             /**
              * \brief sets the position of the camera
@@ -212,6 +470,44 @@ namespace bardcore
                 calculate_screen();
             }
 
+            /**
+             * \brief sets the aperture of the camera, the diameter of the lens
+             * \throws negative_exception if aperture is negative
+             * \param aperture new aperture, 0 for a pinhole (everything in focus)
+             */
+            constexpr void set_aperture(const double aperture)
+            {
+                if (aperture < 0)
+                    throw exception::negative_exception("aperture can't be negative");
+
+                aperture_ = aperture;
+            }
+
+            /**
+             * \brief sets the focal distance of the camera, the distance along the direction that is in focus
+             * \throws zero_exception if focal distance is zero
+             * \throws negative_exception if focal distance is negative
+             * \param focal_distance new focal distance
+             */
+            constexpr void set_focal_distance(const double focal_distance)
+            {
+                if (focal_distance == 0)
+                    throw exception::zero_exception("focal distance must be greater than 0");
+                if (focal_distance < 0)
+                    throw exception::negative_exception("focal distance can't be negative");
+
+                focal_distance_ = focal_distance;
+            }
+
+            /**
+             * \brief sets the projection of the camera
+             * \param projection new projection
+             */
+            constexpr void set_projection(const camera_projection projection) noexcept
+            {
+                projection_ = projection;
+            }
+
             ///////////////////////////////////////////////////////
             ///                    operators                    ///
             ///////////////////////////////////////////////////////
@@ -245,10 +541,12 @@ namespace bardcore
             camera& operator=(camera&&) noexcept = default;
 
             /**
-             * \brief equal operator (position, direction, screen width, height and fov are equal)
+             * \brief equal operator (position, direction, screen width, height, fov, aperture, focal distance and
+             *        projection are equal)
              * \param left left camera
              * \param right right camera
-             * \return true if left == right (position, direction, screen width, height and fov are equal)
+             * \return true if left == right (position, direction, screen width, height, fov, aperture, focal distance
+             *         and projection are equal)
              */
             NODISCARD constexpr friend bool operator==(const camera& left, const camera& right) noexcept
             {
@@ -256,7 +554,10 @@ namespace bardcore
                     && left.direction_ == right.direction_
                     && left.screen_width_ == right.screen_width_
                     && left.screen_height_ == right.screen_height_
-                    && left.fov_ == right.fov_;
+                    && left.fov_ == right.fov_
+                    && math::equals(left.aperture_, right.aperture_)
+                    && math::equals(left.focal_distance_, right.focal_distance_)
+                    && left.projection_ == right.projection_;
             }
 
             /**
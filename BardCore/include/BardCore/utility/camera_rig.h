@@ -0,0 +1,196 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/exception/zero_exception.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/projection_lut.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief several nearby cameras rendered together, e.g. the two eyes of a stereo pair or a light field grid
+         *
+         * every view has the same projection, fov and screen size, so the direction of a pixel relative to a camera is
+         * the same for every view and is looked up once in a shared projection_lut, views that also have the same
+         * orientation rotate it once and only differ in their origin. the rays of a pixel are stored
+         * next to each other (interleaved), so the views of a pixel can be traced together as a coherent packet
+         */
+        class camera_rig
+        {
+        public:
+            /**
+             * \brief amount of pixels per thread when generating rays
+             */
+            INLINE static constexpr std::size_t grain = 2048;
+
+        protected:
+            std::vector<camera> views_{};
+            projection_lut lut_{}; // shared by every view
+
+        private:
+            /**
+             * \brief helper function for checking that views can share a table
+             */
+            static void check_views(const std::vector<camera>& views)
+            {
+                if (views.empty())
+                    throw exception::zero_exception("a rig needs at least one view");
+
+                const camera& first = views[0];
+                if (std::any_of(views.begin(), views.end(), [&first](const camera& view)
+                {
+                    return view.get_projection() != first.get_projection()
+                        || view.get_fov() != first.get_fov()
+                        || view.get_screen_width() != first.get_screen_width()
+                        || view.get_screen_height() != first.get_screen_height();
+                }))
+                    throw exception::out_of_range_exception(
+                        "every view must have the same projection, fov and screen size");
+            }
+
+        public:
+            camera_rig() = default;
+
+            /**
+             * \brief constructor with views
+             * \throws zero_exception if there are no views
+             * \throws out_of_range_exception if the views don't have the same projection, fov and screen size
+             * \param views cameras of the rig
+             */
+            explicit camera_rig(const std::vector<camera>& views)
+            {
+                set_views(views);
+            }
+
+            /**
+             * \brief creates a stereo rig, two parallel cameras next to each other
+             * \throws negative_exception if eye_distance is negative
+             * \param center camera between the eyes
+             * \param eye_distance distance between the eyes, e.g. 0.064 in meters
+             * \return rig with the left eye as view 0 and the right eye as view 1
+             */
+            NODISCARD static camera_rig stereo(const camera& center, const double eye_distance)
+            {
+                if (eye_distance < 0)
+                    throw exception::negative_exception("eye distance can't be negative");
+
+                const vector3d offset = center.get_right() * (eye_distance / 2);
+                camera left = center;
+                camera right = center;
+                left.set_position(center.get_position() - offset);
+                right.set_position(center.get_position() + offset);
+                return camera_rig({left, right});
+            }
+
+            /**
+             * \brief replaces the views, e.g. every frame with the tracked head, the table is kept if it still matches
+             * \throws zero_exception if there are no views
+             * \throws out_of_range_exception if the views don't have the same projection, fov and screen size
+             * \param views cameras of the rig
+             */
+            void set_views(const std::vector<camera>& views)
+            {
+                check_views(views);
+                views_ = views;
+                (void)lut_.update(views_[0]);
+            }
+
+            /**
+             * \brief generates the rays of every pixel of every view, interleaved, pixels run in parallel
+             * \note ray (y * width + x) * view_count() + view goes through pixel (x, y) of the view
+             * \throws negative_exception if distance is negative
+             * \param distance distance of every ray
+             * \param rays output, room for pixel_count() * view_count() rays
+             */
+            void generate(const double distance, ray* rays) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                // the basis of every view, the per pixel direction is shared
+                const std::size_t count = views_.size();
+                std::vector<projection_lut::basis> bases;
+                bases.reserve(count);
+                for (const camera& view : views_)
+                    bases.emplace_back(view);
+
+                // views with exactly the same axes (e.g. stereo) reuse the ray of the first such view, moved by
+                // their offset, operator== compares with an epsilon, which is too coarse for far away hits
+                const auto same = [](const vector3d& left, const vector3d& right)
+                {
+                    return left.x == right.x && left.y == right.y && left.z == right.z;
+                };
+
+                std::vector<std::size_t> shared(count);
+                std::vector<vector3d> offsets(count);
+                for (std::size_t view = 0; view < count; ++view)
+                {
+                    shared[view] = view;
+                    for (std::size_t other = 0; other < view; ++other)
+                    {
+                        if (shared[other] != other || !same(bases[other].right, bases[view].right) ||
+                            !same(bases[other].up, bases[view].up) || !same(bases[other].forward, bases[view].forward))
+                            continue;
+
+                        shared[view] = other;
+                        offsets[view] = bases[other].position.get_vector(bases[view].position);
+                        break;
+                    }
+                }
+
+                parallel::for_each_chunk(pixel_count(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                    {
+                        ray* const pixel_rays = rays + pixel * count;
+                        for (std::size_t view = 0; view < count; ++view)
+                        {
+                            if (shared[view] == view)
+                            {
+                                pixel_rays[view] = lut_.pixel_ray(pixel, bases[view], distance);
+                                continue;
+                            }
+
+                            pixel_rays[view] = pixel_rays[shared[view]];
+                            pixel_rays[view].set_position(pixel_rays[view].get_position() + offsets[view]);
+                        }
+                    }
+                }, grain);
+            }
+
+            /**
+             * \brief generates the rays of every pixel of every view, interleaved
+             * \throws negative_exception if distance is negative
+             * \param distance distance of every ray
+             * \return pixel_count() * view_count() rays, see the pointer version for the order
+             */
+            NODISCARD std::vector<ray> generate(const double distance) const
+            {
+                std::vector<ray> rays(pixel_count() * views_.size(), ray(vector3d::forward()));
+                generate(distance, rays.data());
+                return rays;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const std::vector<camera>& get_views() const noexcept { return views_; }
+            NODISCARD const projection_lut& get_lut() const noexcept { return lut_; }
+            NODISCARD std::size_t view_count() const noexcept { return views_.size(); }
+            NODISCARD std::size_t pixel_count() const noexcept { return lut_.pixel_count(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
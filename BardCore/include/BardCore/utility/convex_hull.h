@@ -0,0 +1,531 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief 3D convex hull of a point cloud, stored as a compact indexed triangle mesh
+         *
+         * built with quickhull: an initial tetrahedron of extreme points, then the farthest point in front of a face
+         * is added until no point is in front of any face, the extreme point search and the partitioning of all
+         * points over the tetrahedron (the passes over the whole cloud) run in parallel
+         * \note read more at https://en.wikipedia.org/wiki/Quickhull
+         * \note triangles are counter clockwise seen from outside, coplanar faces are not merged
+         * \note the hull is empty if the cloud has less than 4 points or all points lie in a plane
+         */
+        class convex_hull
+        {
+        public:
+            /**
+             * \brief minimum amount of points per thread in the parallel passes
+             */
+            INLINE static constexpr std::size_t grain = 4096;
+
+        protected:
+            std::vector<point3d> vertices_{}; // hull vertices
+            std::vector<std::uint32_t> indices_{}; // three vertex indices per triangle
+            std::vector<std::uint32_t> point_indices_{}; // index in the input cloud per hull vertex
+
+        private:
+            /**
+             * \brief face of the hull while building
+             */
+            struct face
+            {
+                std::uint32_t vertices[3]{}; // input point indices, counter clockwise seen from outside
+                std::uint32_t neighbors[3]{}; // face across the edge (vertices[i], vertices[(i + 1) % 3])
+                vector3d normal{}; // outward unit normal
+                double offset = 0; // normal dot a point of the plane
+                std::vector<std::uint32_t> outside{}; // points in front of the face
+                bool visible = false; // removed from the hull
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return normal.x * point.x + normal.y * point.y + normal.z * point.z - offset;
+                }
+            };
+
+            /**
+             * \brief edge of the horizon, (from, to) as seen in the removed face, neighbor is the face that stays
+             */
+            struct horizon_edge
+            {
+                std::uint32_t from = 0;
+                std::uint32_t to = 0;
+                std::uint32_t neighbor = 0;
+            };
+
+            /**
+             * \brief helper function for creating a face with its plane
+             */
+            NODISCARD static face make_face(const std::vector<point3d>& points, const std::uint32_t a,
+                                            const std::uint32_t b, const std::uint32_t c) noexcept
+            {
+                face result;
+                result.vertices[0] = a;
+                result.vertices[1] = b;
+                result.vertices[2] = c;
+
+                const vector3d normal = points[a].get_vector(points[b]).cross(points[a].get_vector(points[c]));
+                const double length = normal.length();
+                if (length > 0)
+                    result.normal = vector3d(normal.x / length, normal.y / length, normal.z / length);
+
+                result.offset = result.normal.x * points[a].x + result.normal.y * points[a].y +
+                    result.normal.z * points[a].z;
+                return result;
+            }
+
+            /**
+             * \brief helper function for the edge of a face going from a to b
+             * \return edge index in [0, 3), 3 if the face has no such edge
+             */
+            NODISCARD static unsigned int edge_of(const face& face, const std::uint32_t a,
+                                                  const std::uint32_t b) noexcept
+            {
+                for (unsigned int edge = 0; edge < 3; ++edge)
+                    if (face.vertices[edge] == a && face.vertices[(edge + 1) % 3] == b)
+                        return edge;
+                return 3;
+            }
+
+            /**
+             * \brief helper function for a parallel arg max over the points
+             * \return index with the largest score
+             */
+            template <typename Score>
+            NODISCARD static std::uint32_t arg_max(const std::size_t count, Score&& score)
+            {
+                const std::size_t chunks = (std::max)(std::size_t{1},
+                                                      (std::min)(static_cast<std::size_t>(parallel::thread_count()),
+                                                                 count / grain));
+                std::vector<std::uint32_t> best(chunks, 0);
+                std::vector<double> best_score(chunks, -std::numeric_limits<double>::infinity());
+
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    for (std::size_t index = count * chunk / chunks; index < count * (chunk + 1) / chunks; ++index)
+                    {
+                        const double value = score(index);
+                        if (value > best_score[chunk])
+                        {
+                            best_score[chunk] = value;
+                            best[chunk] = static_cast<std::uint32_t>(index);
+                        }
+                    }
+                }, 1);
+
+                std::size_t winner = 0;
+                for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+                    if (best_score[chunk] > best_score[winner])
+                        winner = chunk;
+
+                return best[winner];
+            }
+
+            /**
+             * \brief helper function for finding the minimum and maximum point on every axis in one parallel pass
+             * \param points point cloud
+             * \param extremes output, index of min x, max x, min y, max y, min z, max z
+             */
+            static void find_extremes(const std::vector<point3d>& points, std::uint32_t (&extremes)[6])
+            {
+                const std::size_t count = points.size();
+                const std::size_t chunks = (std::max)(std::size_t{1},
+                                                      (std::min)(static_cast<std::size_t>(parallel::thread_count()),
+                                                                 count / grain));
+                std::vector<std::uint32_t> chunk_extremes(chunks * 6, 0);
+
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    const std::size_t begin = count * chunk / chunks;
+                    std::uint32_t* result = chunk_extremes.data() + chunk * 6;
+                    std::fill(result, result + 6, static_cast<std::uint32_t>(begin));
+
+                    for (std::size_t index = begin; index < count * (chunk + 1) / chunks; ++index)
+                    {
+                        const point3d& point = points[index];
+                        const auto i = static_cast<std::uint32_t>(index);
+                        if (point.x < points[result[0]].x)
+                            result[0] = i;
+                        if (point.x > points[result[1]].x)
+                            result[1] = i;
+                        if (point.y < points[result[2]].y)
+                            result[2] = i;
+                        if (point.y > points[result[3]].y)
+                            result[3] = i;
+                        if (point.z < points[result[4]].z)
+                            result[4] = i;
+                        if (point.z > points[result[5]].z)
+                            result[5] = i;
+                    }
+                }, 1);
+
+                std::copy(chunk_extremes.begin(), chunk_extremes.begin() + 6, extremes);
+                for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+                {
+                    const std::uint32_t* result = chunk_extremes.data() + chunk * 6;
+                    if (points[result[0]].x < points[extremes[0]].x)
+                        extremes[0] = result[0];
+                    if (points[result[1]].x > points[extremes[1]].x)
+                        extremes[1] = result[1];
+                    if (points[result[2]].y < points[extremes[2]].y)
+                        extremes[2] = result[2];
+                    if (points[result[3]].y > points[extremes[3]].y)
+                        extremes[3] = result[3];
+                    if (points[result[4]].z < points[extremes[4]].z)
+                        extremes[4] = result[4];
+                    if (points[result[5]].z > points[extremes[5]].z)
+                        extremes[5] = result[5];
+                }
+            }
+
+            /**
+             * \brief helper function for creating the initial tetrahedron
+             * \return false if the points are (nearly) coplanar
+             */
+            static bool initial_tetrahedron(const std::vector<point3d>& points, const double epsilon,
+                                            const std::uint32_t (&extremes)[6], std::vector<face>& faces)
+            {
+                // the two extremes farthest apart
+                std::uint32_t v0 = extremes[0], v1 = extremes[1];
+                for (unsigned int axis = 1; axis < 3; ++axis)
+                {
+                    if (points[extremes[2 * axis]].distance_squared(points[extremes[2 * axis + 1]]) >
+                        points[v0].distance_squared(points[v1]))
+                    {
+                        v0 = extremes[2 * axis];
+                        v1 = extremes[2 * axis + 1];
+                    }
+                }
+
+                const vector3d line = points[v0].get_vector(points[v1]);
+                if (line.length() <= epsilon)
+                    return false;
+
+                // farthest from the line
+                const std::uint32_t v2 = arg_max(points.size(), [&](const std::size_t index)
+                {
+                    return points[v0].get_vector(points[index]).cross(line).length_squared();
+                });
+                if (points[v0].get_vector(points[v2]).cross(line).length() / line.length() <= epsilon)
+                    return false;
+
+                // farthest from the plane
+                const face base = make_face(points, v0, v1, v2);
+                const std::uint32_t v3 = arg_max(points.size(), [&](const std::size_t index)
+                {
+                    return std::abs(base.distance(points[index]));
+                });
+                if (std::abs(base.distance(points[v3])) <= epsilon)
+                    return false;
+
+                // faces opposite of every vertex, flipped so the opposite vertex is behind them
+                const std::uint32_t tetrahedron[4] = {v0, v1, v2, v3};
+                for (unsigned int opposite = 0; opposite < 4; ++opposite)
+                {
+                    std::uint32_t corners[3];
+                    for (unsigned int vertex = 0, corner = 0; vertex < 4; ++vertex)
+                        if (vertex != opposite)
+                            corners[corner++] = tetrahedron[vertex];
+
+                    face tetrahedron_face = make_face(points, corners[0], corners[1], corners[2]);
+                    if (tetrahedron_face.distance(points[tetrahedron[opposite]]) > 0)
+                        tetrahedron_face = make_face(points, corners[0], corners[2], corners[1]);
+                    faces.push_back(tetrahedron_face);
+                }
+
+                for (std::uint32_t index = 0; index < 4; ++index)
+                {
+                    for (unsigned int edge = 0; edge < 3; ++edge)
+                    {
+                        const std::uint32_t a = faces[index].vertices[edge];
+                        const std::uint32_t b = faces[index].vertices[(edge + 1) % 3];
+                        for (std::uint32_t other = 0; other < 4; ++other)
+                            if (other != index && edge_of(faces[other], b, a) != 3)
+                                faces[index].neighbors[edge] = other;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief helper function for assigning every point to the face it is farthest in front of, in parallel
+             */
+            static void partition(const std::vector<point3d>& points, const double epsilon, std::vector<face>& faces)
+            {
+                constexpr std::uint8_t no_face = 0xFF;
+                double nx[4], ny[4], nz[4], offset[4];
+                for (unsigned int index = 0; index < 4; ++index)
+                {
+                    nx[index] = faces[index].normal.x;
+                    ny[index] = faces[index].normal.y;
+                    nz[index] = faces[index].normal.z;
+                    offset[index] = faces[index].offset;
+                }
+
+                std::vector<std::uint8_t> assignment(points.size());
+                parallel::for_each_index(points.size(), [&](const std::size_t index)
+                {
+                    const point3d& point = points[index];
+                    double distances[4];
+                    for (unsigned int plane = 0; plane < 4; ++plane)
+                        distances[plane] = nx[plane] * point.x + ny[plane] * point.y + nz[plane] * point.z -
+                            offset[plane];
+
+                    std::uint8_t best = no_face;
+                    double best_distance = epsilon;
+                    for (std::uint8_t plane = 0; plane < 4; ++plane)
+                    {
+                        if (distances[plane] > best_distance)
+                        {
+                            best_distance = distances[plane];
+                            best = plane;
+                        }
+                    }
+                    assignment[index] = best;
+                }, grain);
+
+                for (std::size_t index = 0; index < points.size(); ++index)
+                    if (assignment[index] != no_face)
+                        faces[assignment[index]].outside.push_back(static_cast<std::uint32_t>(index));
+            }
+
+            /**
+             * \brief helper function for adding the farthest outside point of a face to the hull
+             */
+            static void add_point(const std::vector<point3d>& points, const double epsilon,
+                                  const std::uint32_t start, std::vector<face>& faces,
+                                  std::vector<std::uint32_t>& visible, std::vector<horizon_edge>& horizon)
+            {
+                const std::vector<std::uint32_t>& candidates = faces[start].outside;
+                std::uint32_t eye = candidates[0];
+                for (const std::uint32_t candidate : candidates)
+                    if (faces[start].distance(points[candidate]) > faces[start].distance(points[eye]))
+                        eye = candidate;
+                const point3d& eye_point = points[eye];
+
+                // depth first search over the visible faces, the edges to faces that aren't visible form the horizon
+                // in counter clockwise order
+                struct frame
+                {
+                    std::uint32_t face;
+                    unsigned int start;
+                    unsigned int done;
+                    unsigned int count;
+                };
+
+                visible.assign(1, start);
+                horizon.clear();
+                faces[start].visible = true;
+
+                std::vector<frame> stack{{start, 0, 0, 3}};
+                while (!stack.empty())
+                {
+                    frame& top = stack.back();
+                    if (top.done == top.count)
+                    {
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    const unsigned int edge = (top.start + top.done++) % 3;
+                    const std::uint32_t from = top.face;
+                    const std::uint32_t neighbor = faces[from].neighbors[edge];
+                    if (faces[neighbor].visible)
+                        continue;
+
+                    const std::uint32_t a = faces[from].vertices[edge];
+                    const std::uint32_t b = faces[from].vertices[(edge + 1) % 3];
+                    if (faces[neighbor].distance(eye_point) > epsilon)
+                    {
+                        faces[neighbor].visible = true;
+                        visible.push_back(neighbor);
+                        stack.push_back({neighbor, edge_of(faces[neighbor], b, a) + 1, 0, 2});
+                    }
+                    else
+                    {
+                        horizon.push_back({a, b, neighbor});
+                    }
+                }
+
+                // a cone of new faces from the horizon to the eye
+                const auto first = static_cast<std::uint32_t>(faces.size());
+                const auto count = static_cast<std::uint32_t>(horizon.size());
+                for (std::uint32_t index = 0; index < count; ++index)
+                {
+                    const horizon_edge& edge = horizon[index];
+                    faces.push_back(make_face(points, edge.from, edge.to, eye));
+
+                    face& created = faces.back();
+                    created.neighbors[0] = edge.neighbor;
+                    created.neighbors[1] = first + (index + 1) % count;
+                    created.neighbors[2] = first + (index + count - 1) % count;
+
+                    face& neighbor = faces[edge.neighbor];
+                    neighbor.neighbors[edge_of(neighbor, edge.to, edge.from)] = first + index;
+                }
+
+                // points in front of the removed faces move to the new face they are farthest in front of
+                for (const std::uint32_t removed : visible)
+                {
+                    for (const std::uint32_t point : faces[removed].outside)
+                    {
+                        if (point == eye)
+                            continue;
+
+                        std::uint32_t best = first;
+                        double best_distance = epsilon;
+                        bool found = false;
+                        for (std::uint32_t index = first; index < first + count; ++index)
+                        {
+                            const double distance = faces[index].distance(points[point]);
+                            if (distance > best_distance)
+                            {
+                                best_distance = distance;
+                                best = index;
+                                found = true;
+                            }
+                        }
+
+                        if (found)
+                            faces[best].outside.push_back(point);
+                    }
+
+                    std::vector<std::uint32_t>().swap(faces[removed].outside);
+                }
+            }
+
+        public:
+            convex_hull() = default;
+
+            /**
+             * \brief constructor for convex hull
+             * \param points point cloud
+             */
+            explicit convex_hull(const std::vector<point3d>& points)
+            {
+                build(points);
+            }
+
+            /**
+             * \brief rebuilds the hull from a point cloud
+             * \param points point cloud, at most 2^32 - 1 points
+             */
+            void build(const std::vector<point3d>& points)
+            {
+                vertices_.clear();
+                indices_.clear();
+                point_indices_.clear();
+
+                if (points.size() < 4)
+                    return;
+
+                std::uint32_t extremes[6];
+                find_extremes(points, extremes);
+
+                // tolerance relative to the size of the coordinates
+                const double scale = (std::max)(std::abs(points[extremes[0]].x), std::abs(points[extremes[1]].x)) +
+                    (std::max)(std::abs(points[extremes[2]].y), std::abs(points[extremes[3]].y)) +
+                    (std::max)(std::abs(points[extremes[4]].z), std::abs(points[extremes[5]].z));
+                const double epsilon = 3 * std::numeric_limits<double>::epsilon() * scale;
+
+                std::vector<face> faces;
+                if (!initial_tetrahedron(points, epsilon, extremes, faces))
+                    return;
+
+                partition(points, epsilon, faces);
+
+                // new faces are appended, so one pass handles them too
+                std::vector<std::uint32_t> visible;
+                std::vector<horizon_edge> horizon;
+                for (std::uint32_t index = 0; index < faces.size(); ++index)
+                    if (!faces[index].visible && !faces[index].outside.empty())
+                        add_point(points, epsilon, index, faces, visible, horizon);
+
+                // compact the used points
+                constexpr std::uint32_t unused = 0xFFFFFFFFu;
+                std::vector<std::uint32_t> remap(points.size(), unused);
+                for (const face& hull_face : faces)
+                {
+                    if (hull_face.visible)
+                        continue;
+
+                    for (const std::uint32_t vertex : hull_face.vertices)
+                    {
+                        if (remap[vertex] == unused)
+                        {
+                            remap[vertex] = static_cast<std::uint32_t>(vertices_.size());
+                            vertices_.push_back(points[vertex]);
+                            point_indices_.push_back(vertex);
+                        }
+                        indices_.push_back(remap[vertex]);
+                    }
+                }
+            }
+
+            /**
+             * \brief checks if a point is inside the hull (borders included)
+             * \param point point to check
+             * \param epsilon distance in front of a face that still counts as inside
+             * \return true if the point is inside, false for an empty hull
+             */
+            NODISCARD bool contains(const point3d& point, const double epsilon = 1e-9) const noexcept
+            {
+                if (is_empty())
+                    return false;
+
+                for (std::size_t index = 0; index < indices_.size(); index += 3)
+                {
+                    const point3d& a = vertices_[indices_[index]];
+                    const vector3d normal = a.get_vector(vertices_[indices_[index + 1]])
+                                             .cross(a.get_vector(vertices_[indices_[index + 2]]));
+                    if (normal.dot(a.get_vector(point)) > epsilon * normal.length())
+                        return false;
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief calculates the volume of the hull
+             * \return volume, 0 for an empty hull
+             */
+            NODISCARD double volume() const noexcept
+            {
+                double volume = 0;
+                for (std::size_t index = 0; index < indices_.size(); index += 3)
+                {
+                    const point3d& a = vertices_[indices_[index]];
+                    const point3d& b = vertices_[indices_[index + 1]];
+                    const point3d& c = vertices_[indices_[index + 2]];
+                    volume += vector3d(a.x, a.y, a.z).dot(vector3d(b.x, b.y, b.z).cross(vector3d(c.x, c.y, c.z)));
+                }
+                return volume / 6;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD bool is_empty() const noexcept { return indices_.empty(); }
+            NODISCARD std::size_t face_count() const noexcept { return indices_.size() / 3; }
+            NODISCARD const std::vector<point3d>& get_vertices() const noexcept { return vertices_; }
+            NODISCARD const std::vector<std::uint32_t>& get_indices() const noexcept { return indices_; }
+            NODISCARD const std::vector<std::uint32_t>& get_point_indices() const noexcept { return point_indices_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief hash map with open addressing and linear probing in flat arrays
+         *
+         * keys, values and the occupancy are stored in separate arrays with a power of two capacity,
+         * a lookup is a hash and a short linear scan instead of following pointers like std::unordered_map
+         * \note erase shifts the following entries back, so there are no tombstones
+         * \note pointers to values are invalidated when the map grows or an entry is erased
+         * \tparam Key key, default constructible
+         * \tparam Value value, default constructible
+         * \tparam Hash hasher, the hash is mixed again so a weak hash like std::hash<int> is fine
+         * \tparam KeyEqual key comparison
+         */
+        template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+        class flat_hash_map
+        {
+        public:
+            /**
+             * \brief the map grows when more than max_load_numerator / max_load_denominator of the slots are used
+             */
+            INLINE static constexpr std::size_t max_load_numerator = 3;
+            INLINE static constexpr std::size_t max_load_denominator = 4;
+
+        protected:
+            std::vector<Key> keys_;
+            std::vector<Value> values_;
+            std::vector<std::uint8_t> used_;
+            std::size_t size_ = 0;
+            unsigned int shift_ = 64;
+            Hash hash_;
+            KeyEqual equal_;
+
+        private:
+            /**
+             * \brief helper function for the home slot of a key, Fibonacci hashing on the top bits
+             */
+            NODISCARD std::size_t slot(const Key& key) const
+            {
+                return static_cast<std::size_t>(
+                    (static_cast<std::uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ULL) >> shift_);
+            }
+
+            /**
+             * \brief helper function for finding the slot of a key
+             * \return slot of the key, or the empty slot where it would be inserted
+             */
+            NODISCARD std::size_t probe(const Key& key) const
+            {
+                const std::size_t mask = used_.size() - 1;
+                std::size_t index = slot(key);
+                while (used_[index] && !equal_(keys_[index], key))
+                    index = (index + 1) & mask;
+                return index;
+            }
+
+            /**
+             * \brief helper function for resizing to a power of two capacity and inserting all entries again
+             */
+            void rehash(const std::size_t capacity)
+            {
+                std::vector<Key> keys(capacity);
+                std::vector<Value> values(capacity);
+                std::vector<std::uint8_t> used(capacity, 0);
+                keys.swap(keys_);
+                values.swap(values_);
+                used.swap(used_);
+
+                shift_ = 64;
+                for (std::size_t size = capacity; size > 1; size >>= 1)
+                    --shift_;
+
+                for (std::size_t index = 0; index < used.size(); ++index)
+                {
+                    if (!used[index])
+                        continue;
+
+                    const std::size_t target = probe(keys[index]);
+                    keys_[target] = std::move(keys[index]);
+                    values_[target] = std::move(values[index]);
+                    used_[target] = 1;
+                }
+            }
+
+        public:
+            /**
+             * \brief constructor for flat hash map
+             * \param count amount of entries to reserve room for
+             * \param hash hasher
+             * \param equal key comparison
+             */
+            explicit flat_hash_map(const std::size_t count = 0, const Hash& hash = Hash(),
+                                   const KeyEqual& equal = KeyEqual()) : hash_(hash), equal_(equal)
+            {
+                reserve(count);
+            }
+
+            /**
+             * \brief makes sure count entries fit without growing
+             * \param count amount of entries
+             */
+            void reserve(const std::size_t count)
+            {
+                std::size_t capacity = 16;
+                while (capacity * max_load_numerator < count * max_load_denominator)
+                    capacity *= 2;
+
+                if (capacity > used_.size())
+                    rehash(capacity);
+            }
+
+            /**
+             * \brief inserts a key with a value, an existing value is kept
+             * \param key key
+             * \param value value to insert if the key is new
+             * \return pointer to the value in the map and true if the key was inserted
+             */
+            std::pair<Value*, bool> insert(const Key& key, const Value& value)
+            {
+                if ((size_ + 1) * max_load_denominator > used_.size() * max_load_numerator)
+                    reserve(size_ + 1);
+
+                const std::size_t index = probe(key);
+                if (used_[index])
+                    return {&values_[index], false};
+
+                keys_[index] = key;
+                values_[index] = value;
+                used_[index] = 1;
+                ++size_;
+                return {&values_[index], true};
+            }
+
+            /**
+             * \brief gets the value of a key, a default value is inserted if the key is new
+             * \param key key
+             * \return value in the map
+             */
+            Value& operator[](const Key& key)
+            {
+                return *insert(key, Value()).first;
+            }
+
+            /**
+             * \brief finds the value of a key
+             * \param key key
+             * \return pointer to the value, nullptr if the key is not in the map
+             */
+            NODISCARD Value* find(const Key& key)
+            {
+                if (size_ == 0)
+                    return nullptr;
+
+                const std::size_t index = probe(key);
+                return used_[index] ? &values_[index] : nullptr;
+            }
+
+            /**
+             * \brief finds the value of a key
+             * \param key key
+             * \return pointer to the value, nullptr if the key is not in the map
+             */
+            NODISCARD const Value* find(const Key& key) const
+            {
+                if (size_ == 0)
+                    return nullptr;
+
+                const std::size_t index = probe(key);
+                return used_[index] ? &values_[index] : nullptr;
+            }
+
+            /**
+             * \brief checks if a key is in the map
+             * \param key key
+             * \return true if the key is in the map
+             */
+            NODISCARD bool contains(const Key& key) const
+            {
+                return find(key) != nullptr;
+            }
+
+            /**
+             * \brief erases a key
+             * \param key key
+             * \return true if the key was in the map
+             */
+            bool erase(const Key& key)
+            {
+                if (size_ == 0)
+                    return false;
+
+                const std::size_t mask = used_.size() - 1;
+                std::size_t hole = probe(key);
+                if (!used_[hole])
+                    return false;
+
+                // backward shift: move every following entry whose home slot is not between the hole and it
+                for (std::size_t index = (hole + 1) & mask; used_[index]; index = (index + 1) & mask)
+                {
+                    const std::size_t home = slot(keys_[index]);
+                    if (((index - home) & mask) < ((index - hole) & mask))
+                        continue;
+
+                    keys_[hole] = std::move(keys_[index]);
+                    values_[hole] = std::move(values_[index]);
+                    hole = index;
+                }
+
+                keys_[hole] = Key();
+                values_[hole] = Value();
+                used_[hole] = 0;
+                --size_;
+                return true;
+            }
+
+            /**
+             * \brief erases all entries, the capacity is kept
+             */
+            void clear()
+            {
+                for (std::size_t index = 0; index < used_.size(); ++index)
+                {
+                    if (!used_[index])
+                        continue;
+
+                    keys_[index] = Key();
+                    values_[index] = Value();
+                    used_[index] = 0;
+                }
+                size_ = 0;
+            }
+
+            /**
+             * \brief calls function(key, value) for every entry, in slot order
+             * \tparam Function callable with signature void(const Key&, const Value&)
+             * \param function function to call per entry
+             */
+            template <typename Function>
+            void for_each(Function&& function) const
+            {
+                for (std::size_t index = 0; index < used_.size(); ++index)
+                    if (used_[index])
+                        function(keys_[index], values_[index]);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return size_; }
+            NODISCARD bool empty() const noexcept { return size_ == 0; }
+            NODISCARD std::size_t capacity() const noexcept { return used_.size(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/hit_record.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/light.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief primary hits of every pixel of a camera (a g-buffer), traced once and shaded many times
+         *
+         * the hits only depend on the camera and the geometry, so when only lights change (e.g. an artist tweaking
+         * the intensity or position of a light) the camera rays don't have to be traced again, only the shading and
+         * the shadow rays run. update traces again when the camera is not the cached camera, call invalidate when
+         * the geometry changes
+         * \note the rays are the pinhole rays of camera::shoot_ray, the lens of the camera is ignored
+         */
+        class hit_cache
+        {
+        public:
+            /**
+             * \brief amount of pixels per thread when tracing and shading
+             */
+            INLINE static constexpr std::size_t grain = 1024;
+
+            /**
+             * \brief default offset of a shadow ray along the normal, so it doesn't hit the surface it starts on
+             */
+            INLINE static constexpr double default_shadow_bias = 1e-6;
+
+        protected:
+            camera camera_; // camera of the cached hits
+            double distance_ = 0; // distance of the camera rays
+            bool valid_ = false; // false until traced and after invalidate
+            std::vector<hit_record> hits_{}; // per pixel, row major
+
+        private:
+            /**
+             * \brief helper function for checking that there are hits to shade
+             */
+            void check_valid() const
+            {
+                if (!valid_)
+                    throw exception::out_of_range_exception("the hits must be traced with update before shading");
+            }
+
+        public:
+            /**
+             * \brief constructor, nothing is traced until the first update
+             * \throws negative_exception if distance is negative
+             * \param camera camera to cache the hits of
+             * \param distance distance of the camera rays
+             */
+            hit_cache(const camera& camera, const double distance) : camera_(camera), distance_(distance)
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+            }
+
+            /**
+             * \brief marks the hits as outdated, e.g. when the geometry changed, the next update traces again
+             */
+            void invalidate() noexcept
+            {
+                valid_ = false;
+            }
+
+            /**
+             * \brief checks if the cached hits belong to a camera, only what changes the pinhole rays is compared:
+             *        the aperture and focal distance are ignored, and the fov for the equirectangular projection
+             * \param camera camera to check
+             * \return true if the hits are traced and the camera shoots the same rays as the cached camera
+             */
+            NODISCARD bool matches(const camera& camera) const noexcept
+            {
+                return valid_
+                    && camera.get_position() == camera_.get_position()
+                    && camera.get_direction() == camera_.get_direction()
+                    && camera.get_screen_width() == camera_.get_screen_width()
+                    && camera.get_screen_height() == camera_.get_screen_height()
+                    && camera.get_projection() == camera_.get_projection()
+                    && (camera.get_fov() == camera_.get_fov()
+                        || camera.get_projection() == camera_projection::equirectangular);
+            }
+
+            /**
+             * \brief traces the ray of every pixel again if the hits don't match a camera, e.g. once per frame,
+             *        pixels run in parallel
+             * \tparam Trace callable with signature hit_record(const ray& ray), primitive is no_primitive for a miss
+             * \param camera camera of the frame
+             * \param trace finds the closest hit of a ray
+             * \return true if the rays were traced
+             */
+            template <typename Trace>
+            bool update(const camera& camera, Trace&& trace)
+            {
+                if (matches(camera))
+                    return false;
+
+                camera_ = camera;
+                hits_.resize(pixel_count());
+
+                const unsigned int width = camera_.get_screen_width();
+                parallel::for_each_chunk(pixel_count(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                    {
+                        hits_[pixel] = trace(camera_.shoot_ray(static_cast<unsigned int>(pixel % width),
+                                                               static_cast<unsigned int>(pixel / width), distance_));
+                        hits_[pixel].depth = 0;
+                    }
+                }, grain);
+
+                valid_ = true;
+                return true;
+            }
+
+            /**
+             * \brief shades every pixel from its cached hit, pixels run in parallel
+             * \throws out_of_range_exception if the hits aren't traced, see update
+             * \tparam Shade callable with signature T(const hit_record& hit), is also called for misses
+             * \tparam T type of the output, e.g. double or a color
+             * \param shade shades a hit
+             * \param output output, room for pixel_count() values
+             */
+            template <typename Shade, typename T>
+            void shade(Shade&& shade, T* output) const
+            {
+                check_valid();
+
+                parallel::for_each_chunk(pixel_count(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                        output[pixel] = shade(hits_[pixel]);
+                }, grain);
+            }
+
+            /**
+             * \brief calculates the light arriving at every hit (lambert cosine and inverse square law), with a shadow
+             *        ray per light, misses get 0, pixels run in parallel
+             * \throws out_of_range_exception if the hits aren't traced, see update
+             * \tparam Occluded callable with signature bool(const ray& ray), true if anything is hit along the ray
+             * \param lights lights of the scene
+             * \param occluded tests a shadow ray, it goes from the hit to the light
+             * \param irradiance output, room for pixel_count() values
+             * \param shadow_bias offset of the shadow rays along the normal
+             */
+            template <typename Occluded>
+            void relight(const std::vector<light>& lights, Occluded&& occluded, double* irradiance,
+                         const double shadow_bias = default_shadow_bias) const
+            {
+                shade([&](const hit_record& hit)
+                {
+                    if (hit.primitive == no_primitive)
+                        return 0.;
+
+                    double sum = 0;
+                    for (const light& light : lights)
+                    {
+                        const vector3d to_light = hit.point.get_vector(light.position);
+                        const double distance_squared = to_light.length_squared();
+                        const double cosine = hit.normal.dot(to_light);
+                        if (distance_squared <= 0 || cosine <= 0)
+                            continue;
+
+                        const double distance = std::sqrt(distance_squared);
+                        if (occluded(ray(hit.point + hit.normal * shadow_bias, to_light,
+                                         distance > shadow_bias ? distance - shadow_bias : 0)))
+                            continue;
+
+                        sum += cosine / distance * light.inverse_square_law_squared(distance_squared);
+                    }
+                    return sum;
+                }, irradiance);
+            }
+
+            /**
+             * \brief calculates the light arriving at every hit, see the pointer version
+             * \throws out_of_range_exception if the hits aren't traced, see update
+             * \tparam Occluded callable with signature bool(const ray& ray), true if anything is hit along the ray
+             * \param lights lights of the scene
+             * \param occluded tests a shadow ray, it goes from the hit to the light
+             * \param shadow_bias offset of the shadow rays along the normal
+             * \return irradiance per pixel, row major
+             */
+            template <typename Occluded>
+            NODISCARD std::vector<double> relight(const std::vector<light>& lights, Occluded&& occluded,
+                                                  const double shadow_bias = default_shadow_bias) const
+            {
+                std::vector<double> irradiance(pixel_count());
+                relight(lights, occluded, irradiance.data(), shadow_bias);
+                return irradiance;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const camera& get_camera() const noexcept { return camera_; }
+            NODISCARD double get_distance() const noexcept { return distance_; }
+            NODISCARD bool is_valid() const noexcept { return valid_; }
+            NODISCARD const std::vector<hit_record>& get_hits() const noexcept { return hits_; }
+            NODISCARD std::size_t pixel_count() const noexcept
+            {
+                return static_cast<std::size_t>(camera_.get_screen_width()) * camera_.get_screen_height();
+            }
+
+            /**
+             * \brief sets the distance of the camera rays, the hits are invalidated if it changes
+             * \throws negative_exception if distance is negative
+             * \param distance distance of the camera rays
+             */
+            void set_distance(const double distance)
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                if (distance != distance_)
+                    valid_ = false;
+                distance_ = distance;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+#include <cstdint>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief primitive index returned when nothing was found
+         */
+        INLINE static constexpr std::uint32_t no_primitive = 0xFFFFFFFFu;
+
+        /**
+         * \brief intersection found while tracing a ray
+         */
+        struct hit_record
+        {
+            point3d point{}; // point that was hit
+            vector3d normal{}; // surface normal at point
+            double distance = math::inf; // distance along the ray
+            std::uint32_t primitive = no_primitive; // primitive that was hit, no_primitive for a miss
+            unsigned int depth = 0; // bounce the hit belongs to, 0 for the primary ray
+        };
+    } // namespace utility
+} // namespace bardcore
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief generates thin lens rays of a camera for many samples per pixel at once (depth of field)
+         *
+         * the focal point of every pixel is calculated once when the sampler is constructed and stored as a structure
+         * of arrays, the lens samples of a pixel are mapped to the lens in one batch, so a ray only costs the mapping,
+         * a subtraction and the normalization of its direction. gives the same rays as camera::shoot_ray with lens
+         * samples
+         * \note the sampler is a snapshot, construct a new one when the camera changes
+         * \note only the perspective projection has a lens
+         */
+        class lens_sampler
+        {
+        public:
+            /**
+             * \brief amount of pixels per thread in generate_image
+             */
+            INLINE static constexpr std::size_t grain = 256;
+
+        protected:
+            point3d position_{}; // center of the lens
+            vector3d lens_horizontal_{}, lens_vertical_{}; // axes of the lens, their length is the radius
+            unsigned int screen_width_ = 0, screen_height_ = 0;
+            std::vector<double> focal_x_{}, focal_y_{}, focal_z_{}; // focal point per pixel, row major
+
+        private:
+            /**
+             * \brief helper function for mapping lens samples to points on the lens, stored as a structure of arrays
+             */
+            void lens_points(const double* u, const double* v, const std::size_t count, double* x, double* y,
+                             double* z) const
+            {
+                concentric_disk(u, v, x, y, count);
+
+                // x and y hold the disk coordinates until they are overwritten by the point
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double disk_x = x[index], disk_y = y[index];
+                    x[index] = position_.x + lens_horizontal_.x * disk_x + lens_vertical_.x * disk_y;
+                    y[index] = position_.y + lens_horizontal_.y * disk_x + lens_vertical_.y * disk_y;
+                    z[index] = position_.z + lens_horizontal_.z * disk_x + lens_vertical_.z * disk_y;
+                }
+            }
+
+            /**
+             * \brief helper function for checking lens samples and the distance, before any work is done
+             */
+            static void check_samples(const double* u, const double* v, const std::size_t count, const double distance)
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                for (std::size_t index = 0; index < count; ++index)
+                    if (u[index] < 0 || u[index] > 1 || v[index] < 0 || v[index] > 1)
+                        throw exception::out_of_range_exception("lens samples must be between 0 and 1");
+            }
+
+            /**
+             * \brief helper function for the rays from lens points through the focal point of a pixel
+             */
+            void pixel_rays(const std::size_t pixel, const double* x, const double* y, const double* z,
+                            const std::size_t count, const double distance, ray* rays) const
+            {
+                const double focal_x = focal_x_[pixel], focal_y = focal_y_[pixel], focal_z = focal_z_[pixel];
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    rays[index] = ray(point3d(x[index], y[index], z[index]),
+                                      vector3d(focal_x - x[index], focal_y - y[index], focal_z - z[index]), distance);
+                }
+            }
+
+        public:
+            lens_sampler() = default;
+
+            /**
+             * \brief constructor, calculates the focal point of every pixel of a camera
+             * \throws out_of_range_exception if the camera doesn't have the perspective projection
+             * \param camera camera to sample, with its aperture and focal distance
+             */
+            explicit lens_sampler(const camera& camera) : position_(camera.get_position()),
+                                                          lens_horizontal_(camera.get_lens_horizontal()),
+                                                          lens_vertical_(camera.get_lens_vertical()),
+                                                          screen_width_(camera.get_screen_width()),
+                                                          screen_height_(camera.get_screen_height())
+            {
+                if (camera.get_projection() != camera_projection::perspective)
+                    throw exception::out_of_range_exception("only the perspective projection has a lens");
+
+                const std::size_t pixels = pixel_count();
+                focal_x_.resize(pixels);
+                focal_y_.resize(pixels);
+                focal_z_.resize(pixels);
+
+                parallel::for_each_chunk(screen_height_, [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t y = begin; y < end; ++y)
+                    {
+                        for (unsigned int x = 0; x < screen_width_; ++x)
+                        {
+                            const point3d focal_point = camera.get_focal_point(x, static_cast<unsigned int>(y));
+                            focal_x_[y * screen_width_ + x] = focal_point.x;
+                            focal_y_[y * screen_width_ + x] = focal_point.y;
+                            focal_z_[y * screen_width_ + x] = focal_point.z;
+                        }
+                    }
+                }, 16);
+            }
+
+            /**
+             * \brief maps many points of the unit square to the unit disk, see camera::concentric_disk
+             * \param u first coordinates, in [0, 1]
+             * \param v second coordinates, in [0, 1]
+             * \param x output, x on the disk, room for count values
+             * \param y output, y on the disk, room for count values
+             * \param count amount of points
+             */
+            static void concentric_disk(const double* u, const double* v, double* x, double* y,
+                                        const std::size_t count) noexcept
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                    camera::concentric_disk(u[index], v[index], x[index], y[index]);
+            }
+
+            /**
+             * \brief gets the offset of the lens samples of a pixel in generate_image (a Cranley-Patterson rotation),
+             * so neighbouring pixels don't use the same points on the lens
+             * \param pixel index of the pixel, y * width + x
+             * \param offset_u output, offset of the first coordinates, in [0, 1)
+             * \param offset_v output, offset of the second coordinates, in [0, 1)
+             */
+            static void pixel_offset(const std::size_t pixel, double& offset_u, double& offset_v) noexcept
+            {
+                // splitmix64 finalizer, 24 bits per offset
+                std::uint64_t hash = (static_cast<std::uint64_t>(pixel) + 1) * 0x9E3779B97F4A7C15ULL;
+                hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+                hash ^= hash >> 31;
+
+                offset_u = static_cast<double>(hash >> 40) / 16777216.;
+                offset_v = static_cast<double>((hash >> 16) & 0xFFFFFFu) / 16777216.;
+            }
+
+            /**
+             * \brief rotates a lens sample by an offset, wrapping around at 1
+             * \param sample coordinate of a lens sample, in [0, 1]
+             * \param offset offset, in [0, 1)
+             * \return rotated coordinate, in [0, 1)
+             */
+            NODISCARD constexpr static double rotate(const double sample, const double offset) noexcept
+            {
+                return sample + offset >= 1 ? sample + offset - 1 : sample + offset;
+            }
+
+            /**
+             * \brief generates the rays of one pixel, one per lens sample
+             * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
+             * \throws out_of_range_exception if a lens sample is not in [0, 1]
+             * \throws negative_exception if distance is negative
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \param u first coordinates of the lens samples, in [0, 1]
+             * \param v second coordinates of the lens samples, in [0, 1]
+             * \param count amount of lens samples
+             * \param distance distance of every ray
+             * \param rays output, room for count rays
+             */
+            void generate(const unsigned int x, const unsigned int y, const double* u, const double* v,
+                          const std::size_t count, const double distance, ray* rays) const
+            {
+                if (x >= screen_width_ || y >= screen_height_)
+                    throw exception::out_of_range_exception("x and y must be smaller than the screen width and height");
+                check_samples(u, v, count, distance);
+
+                std::vector<double> lens_x(count), lens_y(count), lens_z(count);
+                lens_points(u, v, count, lens_x.data(), lens_y.data(), lens_z.data());
+                pixel_rays(static_cast<std::size_t>(y) * screen_width_ + x, lens_x.data(), lens_y.data(),
+                           lens_z.data(), count, distance, rays);
+            }
+
+            /**
+             * \brief generates the rays of one pixel, one per lens sample
+             * \throws out_of_range_exception if u and v don't have the same size
+             * \throws out_of_range_exception if x or y is greater or equal to the screen width or height
+             * \throws out_of_range_exception if a lens sample is not in [0, 1]
+             * \throws negative_exception if distance is negative
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \param u first coordinates of the lens samples, in [0, 1]
+             * \param v second coordinates of the lens samples, in [0, 1]
+             * \param distance distance of every ray
+             * \return one ray per lens sample
+             */
+            NODISCARD std::vector<ray> generate(const unsigned int x, const unsigned int y,
+                                                const std::vector<double>& u, const std::vector<double>& v,
+                                                const double distance) const
+            {
+                if (u.size() != v.size())
+                    throw exception::out_of_range_exception("u and v must have the same size");
+
+                std::vector<ray> rays(u.size(), ray(vector3d::forward()));
+                generate(x, y, u.data(), v.data(), u.size(), distance, rays.data());
+                return rays;
+            }
+
+            /**
+             * \brief generates the rays of every pixel, the lens samples are rotated by the offset of every pixel,
+             * pixels run in parallel
+             * \note ray (y * width + x) * samples_per_pixel + sample goes through pixel (x, y), it is the ray of
+             *       generate with the sample rotated by pixel_offset of the pixel
+             * \throws out_of_range_exception if a lens sample is not in [0, 1]
+             * \throws negative_exception if distance is negative
+             * \param u first coordinates of the lens samples, in [0, 1]
+             * \param v second coordinates of the lens samples, in [0, 1]
+             * \param samples_per_pixel amount of lens samples
+             * \param distance distance of every ray
+             * \param rays output, room for pixel_count() * samples_per_pixel rays
+             */
+            void generate_image(const double* u, const double* v, const std::size_t samples_per_pixel,
+                                const double distance, ray* rays) const
+            {
+                check_samples(u, v, samples_per_pixel, distance);
+
+                parallel::for_each_chunk(pixel_count(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    // the same samples in every pixel would show the same lens pattern in every pixel
+                    std::vector<double> pixel_u(samples_per_pixel), pixel_v(samples_per_pixel);
+                    std::vector<double> lens_x(samples_per_pixel), lens_y(samples_per_pixel),
+                                        lens_z(samples_per_pixel);
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                    {
+                        double offset_u = 0, offset_v = 0;
+                        pixel_offset(pixel, offset_u, offset_v);
+                        for (std::size_t sample = 0; sample < samples_per_pixel; ++sample)
+                        {
+                            pixel_u[sample] = rotate(u[sample], offset_u);
+                            pixel_v[sample] = rotate(v[sample], offset_v);
+                        }
+
+                        lens_points(pixel_u.data(), pixel_v.data(), samples_per_pixel, lens_x.data(), lens_y.data(),
+                                    lens_z.data());
+                        pixel_rays(pixel, lens_x.data(), lens_y.data(), lens_z.data(), samples_per_pixel, distance,
+                                   rays + pixel * samples_per_pixel);
+                    }
+                }, grain);
+            }
+
+            /**
+             * \brief generates the rays of every pixel, the lens samples are rotated by the offset of every pixel
+             * \throws out_of_range_exception if u and v don't have the same size
+             * \throws out_of_range_exception if a lens sample is not in [0, 1]
+             * \throws negative_exception if distance is negative
+             * \param u first coordinates of the lens samples, in [0, 1]
+             * \param v second coordinates of the lens samples, in [0, 1]
+             * \param distance distance of every ray
+             * \return pixel_count() * u.size() rays, see the pointer version for the order
+             */
+            NODISCARD std::vector<ray> generate_image(const std::vector<double>& u, const std::vector<double>& v,
+                                                      const double distance) const
+            {
+                if (u.size() != v.size())
+                    throw exception::out_of_range_exception("u and v must have the same size");
+
+                std::vector<ray> rays(pixel_count() * u.size(), ray(vector3d::forward()));
+                generate_image(u.data(), v.data(), u.size(), distance, rays.data());
+                return rays;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_screen_width() const noexcept { return screen_width_; }
+            NODISCARD unsigned int get_screen_height() const noexcept { return screen_height_; }
+            NODISCARD std::size_t pixel_count() const noexcept
+            {
+                return static_cast<std::size_t>(screen_width_) * screen_height_;
+            }
+
+            NODISCARD const std::vector<double>& get_focal_x() const noexcept { return focal_x_; }
+            NODISCARD const std::vector<double>& get_focal_y() const noexcept { return focal_y_; }
+            NODISCARD const std::vector<double>& get_focal_z() const noexcept { return focal_z_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
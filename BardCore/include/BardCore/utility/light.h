@@ -51,9 +51,8 @@ namespace bardcore
 
             ~light() = default;
 
-        private:
             /**
-             * \brief this is a helper function for calculating the inverse square law
+             * \brief inverse square law from a squared distance, e.g. when the squared distance is already known
              * \note read more at: https://en.wikipedia.org/wiki/Inverse-square_law
              * \throws zero_exception if length is zero
              * \param length_squared length squared, e.g. length * length
@@ -67,7 +66,6 @@ namespace bardcore
                 return intensity / length_squared;
             }
 
-        public:
             /**
              * \brief inverse square law
              * \note read more at: https://en.wikipedia.org/wiki/Inverse-square_law
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/exception/zero_exception.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/bvh.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief bvh over moving primitives, one structure serves the whole shutter interval
+         *
+         * every primitive has bounds at two or more time keys, evenly spaced over the shutter [0, 1]
+         * (key k is at time k / (keys - 1)). the tree is built once over the bounds of the whole interval,
+         * every node stores bounds per key and the traversal interpolates them at the time of the ray
+         * \note a primitive moving linearly between two keys stays inside the interpolated bounds,
+         *       curved motion needs more keys, or bounds that contain the motion between the keys
+         * \note the time of a ray is clamped to the shutter [0, 1]
+         */
+        class motion_bvh
+        {
+        protected:
+            bvh bvh_{}; // topology, the node bounds contain the whole shutter interval
+            std::vector<aabb> key_bounds_{}; // bounds of node n at key k are at n * key_count_ + k
+            std::size_t key_count_ = 0;
+
+        private:
+            /**
+             * \brief helper function for the first key and the weight of the next key at a time
+             */
+            void key_at(const double time, std::size_t& key, double& weight) const noexcept
+            {
+                if (key_count_ < 2)
+                {
+                    key = 0;
+                    weight = 0;
+                    return;
+                }
+
+                const double s = (std::min)((std::max)(time, 0.), 1.) * static_cast<double>(key_count_ - 1);
+                key = (std::min)(static_cast<std::size_t>(std::floor(s)), key_count_ - 2);
+                weight = s - static_cast<double>(key);
+            }
+
+            /**
+             * \brief helper function for interpolating the bounds of a node between key and key + 1
+             */
+            NODISCARD aabb interpolate(const std::uint32_t node, const std::size_t key,
+                                       const double weight) const noexcept
+            {
+                const aabb& a = key_bounds_[node * key_count_ + key];
+                if (weight == 0)
+                    return a;
+
+                const aabb& b = key_bounds_[node * key_count_ + key + 1];
+                return {
+                    a.minimum + (b.minimum - a.minimum) * weight,
+                    a.maximum + (b.maximum - a.maximum) * weight
+                };
+            }
+
+            /**
+             * \brief helper function for computing the bounds per key of every node, bottom up
+             * \note children are always stored after their parent, in every layout
+             */
+            void refit(const std::vector<std::vector<aabb>>& keyed_bounds)
+            {
+                const bvh::node_vector& nodes = bvh_.get_nodes();
+                const std::vector<std::uint32_t>& primitives = bvh_.get_primitives();
+                key_bounds_.assign(nodes.size() * key_count_, aabb());
+
+                for (std::size_t node_index = nodes.size(); node_index-- > 0;)
+                {
+                    const bvh_node& node = nodes[node_index];
+                    for (std::size_t key = 0; key < key_count_; ++key)
+                    {
+                        aabb& bounds = key_bounds_[node_index * key_count_ + key];
+                        if (node.is_leaf())
+                        {
+                            for (std::uint32_t index = node.first; index < node.first + node.count; ++index)
+                                bounds.expand(keyed_bounds[key][primitives[index]]);
+                        }
+                        else
+                        {
+                            bounds.expand(key_bounds_[node.first * key_count_ + key]);
+                            bounds.expand(key_bounds_[(node.first + 1) * key_count_ + key]);
+                        }
+                    }
+                }
+            }
+
+        public:
+            motion_bvh() = default;
+
+            /**
+             * \brief constructor, builds the bvh
+             * \throws zero_exception if there are no keys or max_leaf_size is zero
+             * \throws out_of_range_exception if the keys don't have the same amount of primitives
+             * \param keyed_bounds bounds per key per primitive (keyed_bounds[key][primitive])
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             */
+            explicit motion_bvh(const std::vector<std::vector<aabb>>& keyed_bounds,
+                                const unsigned int max_leaf_size = 4,
+                                const bvh_layout layout = bvh_layout::depth_first)
+            {
+                build(keyed_bounds, max_leaf_size, layout);
+            }
+
+            /**
+             * \brief builds the bvh, the old content is replaced
+             * \throws zero_exception if there are no keys or max_leaf_size is zero
+             * \throws out_of_range_exception if the keys don't have the same amount of primitives
+             * \param keyed_bounds bounds per key per primitive (keyed_bounds[key][primitive])
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             */
+            void build(const std::vector<std::vector<aabb>>& keyed_bounds, const unsigned int max_leaf_size = 4,
+                       const bvh_layout layout = bvh_layout::depth_first)
+            {
+                if (keyed_bounds.empty())
+                    throw exception::zero_exception("there must be at least one key");
+
+                const std::size_t count = keyed_bounds[0].size();
+                if (std::any_of(keyed_bounds.begin(), keyed_bounds.end(),
+                                [count](const std::vector<aabb>& key) { return key.size() != count; }))
+                    throw exception::out_of_range_exception("every key must have the same amount of primitives");
+
+                // the topology is built over the bounds of the whole interval
+                std::vector<aabb> bounds(keyed_bounds[0]);
+                for (std::size_t key = 1; key < keyed_bounds.size(); ++key)
+                    for (std::size_t primitive = 0; primitive < count; ++primitive)
+                        bounds[primitive].expand(keyed_bounds[key][primitive]);
+
+                bvh_.build(bounds, max_leaf_size, layout);
+                key_count_ = keyed_bounds.size();
+                refit(keyed_bounds);
+            }
+
+            /**
+             * \brief finds the closest primitive hit by a ray at its time, children are visited front to back
+             * \tparam Intersect callable with signature bool(std::uint32_t primitive, double& t_max),
+             *                   tests the primitive at the time of the ray, returns true and lowers t_max if it is hit
+             *                   closer than t_max
+             * \param ray ray to trace, its distance is the initial t_max and its time selects the bounds
+             * \param intersect function testing a primitive
+             * \return primitive that was hit, bvh::no_primitive if nothing was hit
+             */
+            template <typename Intersect>
+            NODISCARD std::uint32_t closest_hit(const ray& ray, Intersect&& intersect) const
+            {
+                std::size_t key = 0;
+                double weight = 0;
+                key_at(ray.get_time(), key, weight);
+
+                const std::vector<std::uint32_t>& primitives = bvh_.get_primitives();
+                bvh::no_counters counters;
+                return bvh_.traverse(ray, [&](const bvh_node& leaf, double& t_max)
+                {
+                    std::uint32_t closest = bvh::no_primitive;
+                    for (std::uint32_t index = leaf.first; index < leaf.first + leaf.count; ++index)
+                        if (intersect(primitives[index], t_max))
+                            closest = primitives[index];
+                    return closest;
+                }, [&](const std::uint32_t node)
+                {
+                    return interpolate(node, key, weight);
+                }, counters);
+            }
+
+            /**
+             * \brief gets the bounds of a node at a time
+             * \throws out_of_range_exception if node is past the end
+             * \param node index of the node in get_bvh().get_nodes()
+             * \param time time in the shutter, clamped to [0, 1]
+             * \return interpolated bounds
+             */
+            NODISCARD aabb get_bounds(const std::uint32_t node, const double time) const
+            {
+                if (node >= bvh_.get_nodes().size())
+                    throw exception::out_of_range_exception("node is past the end of the bvh");
+
+                std::size_t key = 0;
+                double weight = 0;
+                key_at(time, key, weight);
+                return interpolate(node, key, weight);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const bvh& get_bvh() const noexcept { return bvh_; }
+            NODISCARD const std::vector<aabb>& get_key_bounds() const noexcept { return key_bounds_; }
+            NODISCARD std::size_t key_count() const noexcept { return key_count_; }
+            NODISCARD bool is_empty() const noexcept { return bvh_.is_empty(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
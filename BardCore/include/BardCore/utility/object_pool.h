@@ -0,0 +1,195 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief pool of objects with a fixed capacity, acquire and release never use the heap
+         *
+         * slots are allocated up front by reserve, in blocks, so objects never move when the pool grows.
+         * released slots are handed out again last in first out, like a stack, so recursive code
+         * (e.g. a ray per bounce) keeps reusing the same few slots that are still in the cache
+         * \note objects are not destroyed on release, so T must be trivially destructible, e.g. ray
+         * \note a pool is not thread safe, use one pool per thread
+         * \tparam T type of the objects
+         */
+        template <typename T>
+        class object_pool
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "T must be trivially destructible");
+
+        public:
+            /**
+             * \brief object that is released to its pool when it goes out of scope
+             */
+            class handle
+            {
+            protected:
+                object_pool* pool_ = nullptr;
+                T* object_ = nullptr;
+
+            public:
+                handle() = default;
+
+                /**
+                 * \brief constructor for handle
+                 * \param pool pool the object belongs to
+                 * \param object object to release on destruction
+                 */
+                handle(object_pool& pool, T* object) noexcept : pool_(&pool), object_(object)
+                {
+                }
+
+                handle(const handle&) = delete;
+                handle& operator=(const handle&) = delete;
+
+                handle(handle&& other) noexcept : pool_(other.pool_), object_(other.object_)
+                {
+                    other.object_ = nullptr;
+                }
+
+                handle& operator=(handle&& other) noexcept
+                {
+                    if (this != &other)
+                    {
+                        reset();
+                        pool_ = other.pool_;
+                        object_ = other.object_;
+                        other.object_ = nullptr;
+                    }
+                    return *this;
+                }
+
+                ~handle()
+                {
+                    reset();
+                }
+
+                /**
+                 * \brief releases the object to its pool now
+                 */
+                void reset() noexcept
+                {
+                    if (object_ != nullptr)
+                        pool_->release(object_);
+                    object_ = nullptr;
+                }
+
+                NODISCARD T* get() const noexcept { return object_; }
+                NODISCARD T& operator*() const noexcept { return *object_; }
+                NODISCARD T* operator->() const noexcept { return object_; }
+                NODISCARD explicit operator bool() const noexcept { return object_ != nullptr; }
+            };
+
+        protected:
+            /**
+             * \brief uninitialized storage for one object
+             */
+            struct slot
+            {
+                alignas(T) unsigned char storage[sizeof(T)];
+            };
+
+            std::vector<std::unique_ptr<slot[]>> blocks_{};
+            std::vector<T*> free_{}; // free slots, the back is handed out first
+            std::size_t capacity_ = 0;
+
+        public:
+            /**
+             * \brief constructor for object pool
+             * \param capacity amount of objects to reserve slots for
+             */
+            explicit object_pool(const std::size_t capacity = 0)
+            {
+                reserve(capacity);
+            }
+
+            object_pool(const object_pool&) = delete;
+            object_pool& operator=(const object_pool&) = delete;
+
+            /**
+             * \brief makes sure capacity objects can be acquired at once, this is the only function that uses the heap
+             * \note acquired objects stay valid, the new slots are allocated as a new block
+             * \param capacity amount of objects
+             */
+            void reserve(const std::size_t capacity)
+            {
+                if (capacity <= capacity_)
+                    return;
+
+                const std::size_t count = capacity - capacity_;
+                std::unique_ptr<slot[]> block(new slot[count]);
+                free_.reserve(capacity);
+                blocks_.reserve(blocks_.size() + 1);
+
+                // reversed, so the slots are handed out in address order
+                for (std::size_t index = count; index > 0; --index)
+                    free_.push_back(reinterpret_cast<T*>(block[index - 1].storage));
+
+                blocks_.push_back(std::move(block));
+                capacity_ = capacity;
+            }
+
+            /**
+             * \brief constructs an object in a free slot
+             * \throws out_of_range_exception if all slots are in use
+             * \tparam Args types of the constructor arguments
+             * \param args constructor arguments
+             * \return object, to be given back with release
+             */
+            template <typename... Args>
+            NODISCARD T* acquire(Args&&... args)
+            {
+                if (free_.empty())
+                    throw exception::out_of_range_exception("all slots of the pool are in use, reserve more");
+
+                // the slot is only taken when the constructor didn't throw
+                T* object = new(free_.back()) T(std::forward<Args>(args)...);
+                free_.pop_back();
+                return object;
+            }
+
+            /**
+             * \brief constructs an object in a free slot that is released when the handle goes out of scope
+             * \throws out_of_range_exception if all slots are in use
+             * \tparam Args types of the constructor arguments
+             * \param args constructor arguments
+             * \return handle to the object
+             */
+            template <typename... Args>
+            NODISCARD handle make(Args&&... args)
+            {
+                return handle(*this, acquire(std::forward<Args>(args)...));
+            }
+
+            /**
+             * \brief gives an object back to the pool, it must not be used anymore
+             * \param object object acquired from this pool
+             */
+            void release(T* object) noexcept
+            {
+                free_.push_back(object);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t capacity() const noexcept { return capacity_; }
+            NODISCARD std::size_t available() const noexcept { return free_.size(); }
+            NODISCARD std::size_t size() const noexcept { return capacity_ - free_.size(); }
+            NODISCARD bool empty() const noexcept { return free_.size() == capacity_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
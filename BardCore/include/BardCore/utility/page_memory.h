@@ -0,0 +1,617 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX // keep std::min and std::max usable
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief where the pages of a large buffer are placed on a machine with several NUMA nodes
+         */
+        enum class page_placement : unsigned char
+        {
+            local = 0, // the operating system default, the node of the thread that touches a page first
+            interleaved = 1, // pages are spread round robin over all nodes, for buffers every node reads
+            node = 2 // pages are placed on page_options::node
+        };
+
+        /**
+         * \brief options for allocating a large buffer
+         */
+        struct page_options
+        {
+            bool huge_pages = true; // use huge pages (2 MiB) to reduce TLB misses, if the system allows it
+            page_placement placement = page_placement::local; // NUMA placement of the pages
+            unsigned int node = 0; // node for page_placement::node
+            std::size_t min_bytes = 0; // page_allocator takes smaller allocations from the heap, pages would waste them
+
+            NODISCARD constexpr friend bool operator==(const page_options& left, const page_options& right) noexcept
+            {
+                return left.huge_pages == right.huge_pages && left.placement == right.placement
+                    && left.node == right.node && left.min_bytes == right.min_bytes;
+            }
+
+            NODISCARD constexpr friend bool operator!=(const page_options& left, const page_options& right) noexcept
+            {
+                return !(left == right);
+            }
+        };
+
+        /**
+         * \brief page allocation for large buffers (e.g. bvh nodes or vertices of big meshes) and NUMA helpers
+         *
+         * memory is taken from the operating system directly, on linux huge pages are requested with
+         * madvise(MADV_HUGEPAGE) and the placement is set with mbind, on windows large pages need the
+         * lock pages in memory privilege and placement uses VirtualAllocExNuma.
+         * huge pages and placement are hints: when the system doesn't support them normal pages are used
+         * \note on other systems the memory comes from malloc and all NUMA functions act like a single node
+         * \note this class only has static functions, it can't be constructed
+         */
+        class page_memory final
+        {
+        public:
+            /**
+             * \brief amount of cached_node calls after which a thread looks up its node again
+             */
+            INLINE static constexpr unsigned int node_refresh = 1024;
+
+        private:
+#if defined(__linux__)
+            INLINE static constexpr int mpol_preferred = 1; // MPOL_PREFERRED of numaif.h
+            INLINE static constexpr int mpol_interleave = 3; // MPOL_INTERLEAVE of numaif.h
+#endif
+
+            /**
+             * \brief node of a thread, looked up again every node_refresh calls
+             */
+            struct node_cache
+            {
+                unsigned int node = 0;
+                unsigned int calls = 0; // 0 when the node must be looked up
+            };
+
+            /**
+             * \brief helper function for the node cache of the calling thread
+             */
+            NODISCARD static node_cache& local_node_cache() noexcept
+            {
+                thread_local node_cache cache;
+                return cache;
+            }
+
+            /**
+             * \brief helper function for rounding a size up to whole pages
+             */
+            NODISCARD static std::size_t round_up(const std::size_t bytes, const std::size_t page) noexcept
+            {
+                return (bytes + page - 1) / page * page;
+            }
+
+            /**
+             * \brief helper function for reading the first line of a file, empty if it can't be read
+             */
+            NODISCARD static std::string read_line(const std::string& path)
+            {
+                std::ifstream file(path);
+                std::string line;
+                std::getline(file, line);
+                return line;
+            }
+
+        public:
+            page_memory() = delete;
+
+            /**
+             * \brief gets the size of a normal page
+             * \return page size in bytes
+             */
+            NODISCARD static std::size_t page_size() noexcept
+            {
+#if defined(_WIN32)
+                SYSTEM_INFO info;
+                GetSystemInfo(&info);
+                return info.dwPageSize;
+#elif defined(__linux__)
+                const long size = sysconf(_SC_PAGESIZE);
+                return size > 0 ? static_cast<std::size_t>(size) : 4096;
+#else
+                return 4096;
+#endif
+            }
+
+            /**
+             * \brief gets the size of a huge page, allocations with huge pages are rounded up to it
+             * \return huge page size in bytes
+             */
+            NODISCARD static std::size_t huge_page_size() noexcept
+            {
+#if defined(_WIN32)
+                const std::size_t size = GetLargePageMinimum();
+                return size > 0 ? size : page_size();
+#else
+                return std::size_t{2} << 20;
+#endif
+            }
+
+            /**
+             * \brief gets the size an allocation really takes
+             * \param bytes requested size
+             * \param options options of the allocation
+             * \return size rounded up to whole (huge) pages
+             */
+            NODISCARD static std::size_t allocation_size(const std::size_t bytes, const page_options& options) noexcept
+            {
+                return round_up(bytes == 0 ? 1 : bytes, options.huge_pages ? huge_page_size() : page_size());
+            }
+
+            /**
+             * \brief allocates a large buffer, it is aligned to a (huge) page
+             * \throws bad_alloc if the system is out of memory
+             * \param bytes size in bytes
+             * \param options huge pages and NUMA placement
+             * \return pointer to the buffer, to be given back with deallocate and the same size and options
+             */
+            NODISCARD static void* allocate(const std::size_t bytes, const page_options& options = {})
+            {
+                const std::size_t size = allocation_size(bytes, options);
+
+#if defined(_WIN32)
+                void* memory = nullptr;
+                if (options.huge_pages && options.placement != page_placement::interleaved)
+                {
+                    memory = options.placement == page_placement::node
+                                 ? VirtualAllocExNuma(GetCurrentProcess(), nullptr, size,
+                                                      MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE,
+                                                      options.node)
+                                 : VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                                PAGE_READWRITE);
+                }
+
+                if (memory == nullptr && options.placement == page_placement::interleaved)
+                {
+                    // reserve the range, then commit chunks on the nodes round robin
+                    memory = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE);
+                    const std::size_t chunk = std::size_t{2} << 20;
+                    const unsigned int nodes = node_count();
+                    for (std::size_t offset = 0; memory != nullptr && offset < size; offset += chunk)
+                    {
+                        const std::size_t length = size - offset < chunk ? size - offset : chunk;
+                        if (VirtualAllocExNuma(GetCurrentProcess(), static_cast<char*>(memory) + offset, length,
+                                               MEM_COMMIT, PAGE_READWRITE,
+                                               static_cast<DWORD>(offset / chunk % nodes)) == nullptr)
+                        {
+                            VirtualFree(memory, 0, MEM_RELEASE);
+                            memory = nullptr;
+                        }
+                    }
+                }
+                else if (memory == nullptr)
+                {
+                    memory = options.placement == page_placement::node
+                                 ? VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                                                      PAGE_READWRITE, options.node)
+                                 : VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+                }
+
+                if (memory == nullptr)
+                    throw std::bad_alloc();
+                return memory;
+#elif defined(__linux__)
+                // transparent huge pages need a 2 MiB aligned range, so map more and cut off the ends
+                const std::size_t alignment = options.huge_pages ? huge_page_size() : page_size();
+                const std::size_t mapped = size + alignment - page_size();
+                void* mapping = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapping == MAP_FAILED)
+                    throw std::bad_alloc();
+
+                char* const begin = static_cast<char*>(mapping);
+                char* const memory = begin + (alignment - reinterpret_cast<std::uintptr_t>(begin) % alignment) %
+                    alignment;
+                if (memory != begin)
+                    munmap(begin, static_cast<std::size_t>(memory - begin));
+                if (memory + size != begin + mapped)
+                    munmap(memory + size, static_cast<std::size_t>(begin + mapped - (memory + size)));
+
+#if defined(MADV_HUGEPAGE)
+                if (options.huge_pages)
+                    madvise(memory, size, MADV_HUGEPAGE);
+#endif
+
+                if (options.placement != page_placement::local)
+                {
+                    unsigned long mask[16] = {};
+                    const unsigned int bits = 8 * sizeof(unsigned long);
+                    if (options.placement == page_placement::interleaved)
+                    {
+                        const unsigned int nodes = node_count();
+                        for (unsigned int node = 0; node < nodes && node < 16 * bits; ++node)
+                            mask[node / bits] |= 1UL << (node % bits);
+                    }
+                    else if (options.node < 16 * bits)
+                        mask[options.node / bits] |= 1UL << (options.node % bits);
+
+                    // best effort: the pages are still usable when the policy is refused
+                    const int policy = options.placement == page_placement::interleaved
+                                           ? mpol_interleave
+                                           : mpol_preferred;
+                    syscall(SYS_mbind, memory, size, policy, mask, 16UL * bits, 0U);
+                }
+
+                return memory;
+#else
+                void* memory = std::malloc(size);
+                if (memory == nullptr)
+                    throw std::bad_alloc();
+                return memory;
+#endif
+            }
+
+            /**
+             * \brief gives a buffer back to the system
+             * \param memory buffer returned by allocate, nullptr does nothing
+             * \param bytes size given to allocate
+             * \param options options given to allocate
+             */
+            static void deallocate(void* memory, const std::size_t bytes, const page_options& options = {}) noexcept
+            {
+                if (memory == nullptr)
+                    return;
+
+#if defined(_WIN32)
+                (void)bytes;
+                (void)options;
+                VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+                munmap(memory, allocation_size(bytes, options));
+#else
+                (void)bytes;
+                (void)options;
+                std::free(memory);
+#endif
+            }
+
+            /**
+             * \brief parses a linux cpu list like "0-3,8,10-11"
+             * \param list cpu list
+             * \return cpus in the list
+             */
+            NODISCARD static std::vector<unsigned int> parse_cpu_list(const std::string& list)
+            {
+                std::vector<unsigned int> cpus;
+                std::size_t position = 0;
+                while (position < list.size())
+                {
+                    std::size_t end = list.find(',', position);
+                    if (end == std::string::npos)
+                        end = list.size();
+
+                    const std::string range = list.substr(position, end - position);
+                    const std::size_t dash = range.find('-');
+                    if (!range.empty() && range.find_first_not_of("0123456789-") == std::string::npos)
+                    {
+                        const unsigned long first = std::strtoul(range.c_str(), nullptr, 10);
+                        const unsigned long last = dash == std::string::npos
+                                                       ? first
+                                                       : std::strtoul(range.c_str() + dash + 1, nullptr, 10);
+                        for (unsigned long cpu = first; cpu <= last; ++cpu)
+                            cpus.push_back(static_cast<unsigned int>(cpu));
+                    }
+
+                    position = end + 1;
+                }
+                return cpus;
+            }
+
+            /**
+             * \brief gets the amount of NUMA nodes
+             * \return amount of nodes, at least 1
+             */
+            NODISCARD static unsigned int node_count()
+            {
+#if defined(_WIN32)
+                ULONG highest = 0;
+                return GetNumaHighestNodeNumber(&highest) ? static_cast<unsigned int>(highest) + 1 : 1;
+#elif defined(__linux__)
+                const std::vector<unsigned int> nodes = parse_cpu_list(read_line("/sys/devices/system/node/online"));
+                return nodes.empty() ? 1 : nodes.back() + 1;
+#else
+                return 1;
+#endif
+            }
+
+            /**
+             * \brief gets the NUMA node of the cpu the calling thread runs on
+             * \return node, 0 if it can't be determined
+             */
+            NODISCARD static unsigned int current_node() noexcept
+            {
+#if defined(_WIN32)
+                PROCESSOR_NUMBER processor;
+                GetCurrentProcessorNumberEx(&processor);
+                USHORT node = 0;
+                return GetNumaProcessorNodeEx(&processor, &node) ? node : 0;
+#elif defined(__linux__)
+                unsigned int cpu = 0, node = 0;
+                return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? node : 0;
+#else
+                return 0;
+#endif
+            }
+
+            /**
+             * \brief gets the NUMA node of the calling thread without a system call on most calls,
+             *        the node is looked up again every node_refresh calls and after pin_current_thread
+             * \return node, 0 if it can't be determined
+             */
+            NODISCARD static unsigned int cached_node() noexcept
+            {
+                node_cache& cache = local_node_cache();
+                if (cache.calls == 0)
+                    cache.node = current_node();
+                cache.calls = (cache.calls + 1) % node_refresh;
+                return cache.node;
+            }
+
+            /**
+             * \brief pins the calling thread to the cpus of a NUMA node, so it runs near the data placed there
+             * \param node node
+             * \return true if the thread was pinned
+             */
+            static bool pin_current_thread(const unsigned int node)
+            {
+#if defined(_WIN32)
+                GROUP_AFFINITY affinity;
+                std::memset(&affinity, 0, sizeof(affinity));
+                if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)
+                    || !SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr))
+                    return false;
+
+                local_node_cache().calls = 0;
+                return true;
+#elif defined(__linux__)
+                const std::vector<unsigned int> cpus = parse_cpu_list(
+                    read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+                if (cpus.empty())
+                    return false;
+
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (const unsigned int cpu : cpus)
+                    if (cpu < CPU_SETSIZE)
+                        CPU_SET(cpu, &set);
+                if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                    return false;
+
+                local_node_cache().calls = 0;
+                return true;
+#else
+                (void)node;
+                return false;
+#endif
+            }
+        };
+
+        /**
+         * \brief standard allocator taking whole pages from page_memory, for large vectors
+         * \note every allocation takes at least one (huge) page, unless it is smaller than page_options::min_bytes
+         * \note the allocator moves and swaps along with its container, so the options follow the buffer
+         * \tparam T type to allocate
+         */
+        template <typename T>
+        class page_allocator
+        {
+        public:
+            using value_type = T;
+            using propagate_on_container_copy_assignment = std::true_type;
+            using propagate_on_container_move_assignment = std::true_type;
+            using propagate_on_container_swap = std::true_type;
+
+        protected:
+            page_options options_{};
+
+        public:
+            /**
+             * \brief constructor for page allocator
+             * \param options huge pages and NUMA placement of the allocations
+             */
+            explicit page_allocator(const page_options& options = {}) noexcept : options_(options)
+            {
+            }
+
+            /**
+             * \brief converting constructor, the allocator of a container is rebound to its internal types
+             * \tparam U type of the other allocator
+             * \param other other allocator
+             */
+            template <typename U>
+            page_allocator(const page_allocator<U>& other) noexcept : options_(other.get_options())
+            {
+            }
+
+            /**
+             * \brief allocates room for count objects
+             * \throws bad_alloc if the size overflows or the system is out of memory
+             * \param count amount of objects
+             * \return pointer to the memory
+             */
+            NODISCARD T* allocate(const std::size_t count)
+            {
+                if (count > static_cast<std::size_t>(-1) / sizeof(T))
+                    throw std::bad_alloc();
+                if (count * sizeof(T) < options_.min_bytes)
+                    return static_cast<T*>(::operator new(count * sizeof(T)));
+                return static_cast<T*>(page_memory::allocate(count * sizeof(T), options_));
+            }
+
+            /**
+             * \brief gives memory back to the system
+             * \param memory memory returned by allocate
+             * \param count amount given to allocate
+             */
+            void deallocate(T* memory, const std::size_t count) noexcept
+            {
+                if (count * sizeof(T) < options_.min_bytes)
+                    ::operator delete(memory);
+                else
+                    page_memory::deallocate(memory, count * sizeof(T), options_);
+            }
+
+            NODISCARD const page_options& get_options() const noexcept { return options_; }
+
+            template <typename U>
+            NODISCARD friend bool operator==(const page_allocator& left, const page_allocator<U>& right) noexcept
+            {
+                return left.get_options() == right.get_options();
+            }
+
+            template <typename U>
+            NODISCARD friend bool operator!=(const page_allocator& left, const page_allocator<U>& right) noexcept
+            {
+                return !(left == right);
+            }
+        };
+
+        /**
+         * \brief read only buffer with a copy on every NUMA node, threads read the copy of their own node
+         *
+         * for data every render thread reads randomly (e.g. bvh nodes), so no thread reads remote memory,
+         * costs one copy of the buffer per node
+         * \tparam T type of the elements, trivially copyable
+         */
+        template <typename T>
+        class replicated_buffer
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+        protected:
+            std::vector<T*> copies_{}; // copy per node
+            std::size_t size_ = 0;
+            bool huge_pages_ = true;
+
+        private:
+            /**
+             * \brief helper function for the options of the copy of a node
+             */
+            NODISCARD page_options node_options(const unsigned int node) const noexcept
+            {
+                page_options options;
+                options.huge_pages = huge_pages_;
+                options.placement = page_placement::node;
+                options.node = node;
+                return options;
+            }
+
+            /**
+             * \brief helper function for giving the copies back to the system
+             */
+            void release() noexcept
+            {
+                for (unsigned int node = 0; node < copies_.size(); ++node)
+                    page_memory::deallocate(copies_[node], size_ * sizeof(T), node_options(node));
+                copies_.clear();
+            }
+
+        public:
+            /**
+             * \brief constructor for replicated buffer, the data is copied to every node
+             * \throws bad_alloc if the system is out of memory
+             * \param data elements to copy
+             * \param size amount of elements
+             * \param huge_pages use huge pages for the copies
+             */
+            replicated_buffer(const T* data, const std::size_t size, const bool huge_pages = true) : size_(size),
+                huge_pages_(huge_pages)
+            {
+                const unsigned int nodes = page_memory::node_count();
+                copies_.reserve(nodes);
+                try
+                {
+                    for (unsigned int node = 0; node < nodes; ++node)
+                    {
+                        T* copy = static_cast<T*>(page_memory::allocate(size * sizeof(T), node_options(node)));
+                        if (size > 0)
+                            std::memcpy(copy, data, size * sizeof(T));
+                        copies_.push_back(copy);
+                    }
+                }
+                catch (...)
+                {
+                    release();
+                    throw;
+                }
+            }
+
+            /**
+             * \brief constructor for replicated buffer, the data is copied to every node
+             * \param data elements to copy
+             * \param huge_pages use huge pages for the copies
+             */
+            explicit replicated_buffer(const std::vector<T>& data, const bool huge_pages = true)
+                : replicated_buffer(data.data(), data.size(), huge_pages)
+            {
+            }
+
+            replicated_buffer(const replicated_buffer&) = delete;
+            replicated_buffer& operator=(const replicated_buffer&) = delete;
+
+            ~replicated_buffer()
+            {
+                release();
+            }
+
+            /**
+             * \brief gets the copy of the node the calling thread runs on, see page_memory::cached_node
+             * \return elements
+             */
+            NODISCARD const T* get() const noexcept
+            {
+                const unsigned int node = page_memory::cached_node();
+                return copies_[node < copies_.size() ? node : 0];
+            }
+
+            /**
+             * \brief gets the copy of a node
+             * \throws out_of_range_exception if node is not a node
+             * \param node node
+             * \return elements
+             */
+            NODISCARD const T* get(const unsigned int node) const
+            {
+                if (node >= copies_.size())
+                    throw exception::out_of_range_exception("node is not a NUMA node");
+                return copies_[node];
+            }
+
+            NODISCARD std::size_t size() const noexcept { return size_; }
+            NODISCARD std::size_t copy_count() const noexcept { return copies_.size(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief small helper for splitting index ranges over threads, used by the batch functions of BardCore
+         * \note this class only has static functions, it can't be constructed
+         * \note small ranges (count <= grain) are executed on the calling thread
+         */
+        class parallel final
+        {
+        public:
+            parallel() = delete;
+
+            /**
+             * \brief default amount of indices per thread before it's worth spawning one
+             */
+            INLINE static constexpr std::size_t default_grain = 1024;
+
+            /**
+             * \brief gets the amount of threads that will be used, at least 1
+             * \return amount of hardware threads
+             */
+            NODISCARD static unsigned int thread_count() noexcept
+            {
+                const unsigned int count = std::thread::hardware_concurrency();
+                return count == 0 ? 1 : count;
+            }
+
+            /**
+             * \brief calls function(begin, end) for contiguous chunks of [0, count), chunks are executed in parallel
+             * \note the calling thread executes the last chunk itself, this function returns when all chunks are done
+             * \note function must not throw, an exception on a worker thread terminates the program
+             * \tparam Function callable with signature void(std::size_t begin, std::size_t end)
+             * \param count amount of indices
+             * \param function function to call per chunk
+             * \param grain minimum amount of indices per chunk
+             */
+            template <typename Function>
+            static void for_each_chunk(const std::size_t count, Function&& function,
+                                       const std::size_t grain = default_grain)
+            {
+                if (count == 0)
+                    return;
+
+                const std::size_t max_chunks = (count + (std::max)(grain, std::size_t{1}) - 1) /
+                    (std::max)(grain, std::size_t{1});
+                const std::size_t chunks = (std::min)(static_cast<std::size_t>(thread_count()), max_chunks);
+
+                if (chunks <= 1)
+                {
+                    function(std::size_t{0}, count);
+                    return;
+                }
+
+                const std::size_t chunk_size = (count + chunks - 1) / chunks;
+
+                std::vector<std::thread> threads;
+                threads.reserve(chunks - 1);
+
+                std::size_t begin = 0;
+                for (std::size_t chunk = 0; chunk + 1 < chunks && begin < count; ++chunk, begin += chunk_size)
+                {
+                    const std::size_t end = (std::min)(begin + chunk_size, count);
+                    threads.emplace_back([&function, begin, end] { function(begin, end); });
+                }
+
+                if (begin < count)
+                    function(begin, count);
+
+                for (std::thread& thread : threads)
+                    thread.join();
+            }
+
+            /**
+             * \brief calls function(index) for every index in [0, count), indices are executed in parallel
+             * \tparam Function callable with signature void(std::size_t index)
+             * \param count amount of indices
+             * \param function function to call per index
+             * \param grain minimum amount of indices per thread
+             */
+            template <typename Function>
+            static void for_each_index(const std::size_t count, Function&& function,
+                                       const std::size_t grain = default_grain)
+            {
+                for_each_chunk(count, [&function](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                        function(index);
+                }, grain);
+            }
+
+            /**
+             * \brief sorts a range, chunks are sorted in parallel and then merged pairwise, every round in parallel
+             * \note the sort is not stable, like std::sort
+             * \tparam Iterator random access iterator
+             * \tparam Compare callable with signature bool(const T&, const T&)
+             * \param first begin of the range
+             * \param last end of the range
+             * \param compare less than comparison
+             * \param grain minimum amount of elements per chunk
+             */
+            template <typename Iterator, typename Compare = std::less<>>
+            static void sort(const Iterator first, const Iterator last, Compare compare = Compare(),
+                             const std::size_t grain = default_grain)
+            {
+                const std::size_t count = static_cast<std::size_t>(last - first);
+                const std::size_t chunks = (std::min)(static_cast<std::size_t>(thread_count()),
+                                                      (count + (std::max)(grain, std::size_t{1}) - 1) /
+                                                      (std::max)(grain, std::size_t{1}));
+
+                if (chunks <= 1)
+                {
+                    std::sort(first, last, compare);
+                    return;
+                }
+
+                const std::size_t chunk_size = (count + chunks - 1) / chunks;
+                const auto bound = [first, last, count, chunk_size](const std::size_t chunk)
+                {
+                    return chunk * chunk_size >= count ? last : first + static_cast<std::ptrdiff_t>(chunk * chunk_size);
+                };
+
+                for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    std::sort(bound(chunk), bound(chunk + 1), compare);
+                }, 1);
+
+                for (std::size_t width = 1; width < chunks; width *= 2)
+                {
+                    for_each_index((chunks + 2 * width - 1) / (2 * width), [&](const std::size_t pair)
+                    {
+                        const std::size_t chunk = pair * 2 * width;
+                        if (chunk + width < chunks)
+                            std::inplace_merge(bound(chunk), bound(chunk + width),
+                                               bound((std::min)(chunk + 2 * width, chunks)), compare);
+                    }, 1);
+                }
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/symmetric_matrix3.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/parallel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief principal component analysis of point neighbourhoods, e.g. for normal estimation of scanned clouds
+         *
+         * neighbourhoods are given in compressed form: neighbourhood i is
+         * neighbours[offsets[i]] until neighbours[offsets[i + 1]], indices into the points
+         * \note this class only has static functions, it can't be constructed
+         */
+        class pca final
+        {
+        private:
+            /**
+             * \brief helper function for checking the neighbourhoods
+             */
+            static void check_neighbourhoods(const std::vector<point3d>& points,
+                                             const std::vector<std::uint32_t>& neighbours,
+                                             const std::vector<std::size_t>& offsets)
+            {
+                if (offsets.empty())
+                    throw exception::out_of_range_exception("offsets needs at least one offset");
+
+                for (std::size_t index = 0; index < offsets.size(); ++index)
+                {
+                    if (offsets[index] > neighbours.size())
+                        throw exception::out_of_range_exception("offset is past the end of neighbours");
+                    if (index > 0 && offsets[index] < offsets[index - 1])
+                        throw exception::out_of_range_exception("offsets must not decrease");
+                }
+
+                for (const std::uint32_t neighbour : neighbours)
+                    if (neighbour >= points.size())
+                        throw exception::out_of_range_exception("neighbour is not a point");
+            }
+
+        public:
+            pca() = delete;
+
+            /**
+             * \brief calculates the covariance matrix of points around their centroid
+             * \note two passes (centroid, then deviations) so large coordinates don't lose precision
+             * \param points points
+             * \param indices indices of the points to use
+             * \param count amount of indices
+             * \return covariance matrix, zero if count is zero
+             */
+            NODISCARD static symmetric_matrix3 covariance(const point3d* points, const std::uint32_t* indices,
+                                                          const std::size_t count) noexcept
+            {
+                if (count == 0)
+                    return {};
+
+                double cx = 0, cy = 0, cz = 0;
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    cx += points[indices[index]].x;
+                    cy += points[indices[index]].y;
+                    cz += points[indices[index]].z;
+                }
+
+                const double inverse_count = 1. / static_cast<double>(count);
+                cx *= inverse_count;
+                cy *= inverse_count;
+                cz *= inverse_count;
+
+                symmetric_matrix3 covariance;
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const point3d& point = points[indices[index]];
+                    covariance += symmetric_matrix3::outer({point.x - cx, point.y - cy, point.z - cz});
+                }
+
+                return covariance * inverse_count;
+            }
+
+            /**
+             * \brief calculates the covariance matrix of all points around their centroid
+             * \param points points
+             * \return covariance matrix, zero if there are no points
+             */
+            NODISCARD static symmetric_matrix3 covariance(const std::vector<point3d>& points)
+            {
+                std::vector<std::uint32_t> indices(points.size());
+                for (std::size_t index = 0; index < indices.size(); ++index)
+                    indices[index] = static_cast<std::uint32_t>(index);
+                return covariance(points.data(), indices.data(), indices.size());
+            }
+
+            /**
+             * \brief calculates the covariance matrix of every neighbourhood, the neighbourhoods are calculated in parallel
+             * \throws out_of_range_exception if offsets is empty, decreasing or past the end of neighbours
+             * \throws out_of_range_exception if a neighbour is not a point
+             * \param points points
+             * \param neighbours indices of the points of all neighbourhoods
+             * \param offsets one more offset than neighbourhoods
+             * \return covariance matrix per neighbourhood
+             */
+            NODISCARD static std::vector<symmetric_matrix3> covariances(const std::vector<point3d>& points,
+                                                                        const std::vector<std::uint32_t>& neighbours,
+                                                                        const std::vector<std::size_t>& offsets)
+            {
+                check_neighbourhoods(points, neighbours, offsets);
+
+                std::vector<symmetric_matrix3> matrices(offsets.size() - 1);
+                parallel::for_each_index(matrices.size(), [&](const std::size_t index)
+                {
+                    matrices[index] = covariance(points.data(), neighbours.data() + offsets[index],
+                                                 offsets[index + 1] - offsets[index]);
+                }, 256);
+
+                return matrices;
+            }
+
+            /**
+             * \brief estimates the normal of every neighbourhood, the direction of least variance
+             * \note covariances and eigen decompositions are calculated per packet of neighbourhoods, in parallel
+             * \note normals are unit vectors with an arbitrary sign, neighbourhoods of less than 3 points give a zero vector
+             * \throws out_of_range_exception if offsets is empty, decreasing or past the end of neighbours
+             * \throws out_of_range_exception if a neighbour is not a point
+             * \param points points
+             * \param neighbours indices of the points of all neighbourhoods
+             * \param offsets one more offset than neighbourhoods
+             * \return normal per neighbourhood
+             */
+            NODISCARD static std::vector<vector3d> normals(const std::vector<point3d>& points,
+                                                           const std::vector<std::uint32_t>& neighbours,
+                                                           const std::vector<std::size_t>& offsets)
+            {
+                check_neighbourhoods(points, neighbours, offsets);
+
+                constexpr std::size_t packet = symmetric_matrix3::packet_size;
+                const std::size_t count = offsets.size() - 1;
+                std::vector<vector3d> normals(count);
+
+                parallel::for_each_chunk(count, [&](const std::size_t begin, const std::size_t end)
+                {
+                    symmetric_matrix3 matrices[packet];
+                    symmetric_eigen eigens[packet];
+
+                    for (std::size_t first = begin; first < end; first += packet)
+                    {
+                        const std::size_t lanes = end - first < packet ? end - first : packet;
+                        for (std::size_t lane = 0; lane < lanes; ++lane)
+                        {
+                            const std::size_t index = first + lane;
+                            matrices[lane] = covariance(points.data(), neighbours.data() + offsets[index],
+                                                        offsets[index + 1] - offsets[index]);
+                        }
+
+                        symmetric_matrix3::eigen(matrices, lanes, eigens);
+
+                        for (std::size_t lane = 0; lane < lanes; ++lane)
+                        {
+                            const std::size_t index = first + lane;
+                            normals[index] = offsets[index + 1] - offsets[index] < 3
+                                                 ? vector3d(0, 0, 0)
+                                                 : eigens[lane].vectors[0];
+                        }
+                    }
+                }, 256);
+
+                return normals;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
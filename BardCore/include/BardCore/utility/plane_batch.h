@@ -0,0 +1,202 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/plane.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/triangle.h"
+#include "BardCore/utility/arena.h"
+#include "BardCore/utility/parallel.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief distances, classification and splitting of many points or triangles against a plane
+         * \note large batches are divided over threads, outputs are in the order of the inputs
+         * \note this class only has static functions, it can't be constructed
+         */
+        class plane_batch final
+        {
+        public:
+            plane_batch() = delete;
+
+            /**
+             * \brief minimum amount of points or triangles per thread
+             */
+            INLINE static constexpr std::size_t grain = 4096;
+
+            /**
+             * \brief calculates the signed distance of many points
+             * \param plane plane
+             * \param points points
+             * \param count amount of points
+             * \param distances output, room for count distances
+             */
+            static void distances(const plane& plane, const point3d* points, const std::size_t count,
+                                  double* distances)
+            {
+                const vector3d& normal = plane.get_normal();
+                const double nx = normal.x, ny = normal.y, nz = normal.z, d = plane.get_d();
+                parallel::for_each_chunk(count, [=](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                        distances[index] = nx * points[index].x + ny * points[index].y + nz * points[index].z + d;
+                }, grain);
+            }
+
+            /**
+             * \brief calculates the signed distance of many points
+             * \param plane plane
+             * \param points points
+             * \return distance per point
+             */
+            NODISCARD static std::vector<double> distances(const plane& plane, const std::vector<point3d>& points)
+            {
+                std::vector<double> result(points.size());
+                distances(plane, points.data(), points.size(), result.data());
+                return result;
+            }
+
+            /**
+             * \brief calculates the signed distance of many points, the result is allocated in an arena
+             * \param plane plane
+             * \param points points
+             * \param arena arena for the result
+             * \return distance per point
+             */
+            NODISCARD static arena_vector<double> distances(const plane& plane, const std::vector<point3d>& points,
+                                                            arena& arena)
+            {
+                arena_vector<double> result(points.size(), arena_allocator<double>(arena));
+                distances(plane, points.data(), points.size(), result.data());
+                return result;
+            }
+
+            /**
+             * \brief classifies many points
+             * \param plane plane
+             * \param points points
+             * \param count amount of points
+             * \param sides output, room for count sides
+             * \param epsilon points closer than epsilon are on the plane
+             */
+            static void classify(const plane& plane, const point3d* points, const std::size_t count,
+                                 plane_side* sides, const double epsilon = 1e-9)
+            {
+                const vector3d& normal = plane.get_normal();
+                const double nx = normal.x, ny = normal.y, nz = normal.z, d = plane.get_d();
+                parallel::for_each_chunk(count, [=](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        const double distance = nx * points[index].x + ny * points[index].y + nz * points[index].z +
+                            d;
+                        sides[index] = static_cast<plane_side>((distance > epsilon) - (distance < -epsilon));
+                    }
+                }, grain);
+            }
+
+            /**
+             * \brief classifies many points
+             * \param plane plane
+             * \param points points
+             * \param epsilon points closer than epsilon are on the plane
+             * \return side per point
+             */
+            NODISCARD static std::vector<plane_side> classify(const plane& plane, const std::vector<point3d>& points,
+                                                              const double epsilon = 1e-9)
+            {
+                std::vector<plane_side> result(points.size());
+                classify(plane, points.data(), points.size(), result.data(), epsilon);
+                return result;
+            }
+
+            /**
+             * \brief classifies many points, the result is allocated in an arena
+             * \param plane plane
+             * \param points points
+             * \param arena arena for the result
+             * \param epsilon points closer than epsilon are on the plane
+             * \return side per point
+             */
+            NODISCARD static arena_vector<plane_side> classify(const plane& plane, const std::vector<point3d>& points,
+                                                               arena& arena, const double epsilon = 1e-9)
+            {
+                arena_vector<plane_side> result(points.size(), arena_allocator<plane_side>(arena));
+                classify(plane, points.data(), points.size(), result.data(), epsilon);
+                return result;
+            }
+
+            /**
+             * \brief splits triangles by a plane, every triangle gives at most 2 triangles per side, see plane::split
+             * \note large batches first count the output per triangle, then write at the prefix sum in parallel
+             * \param plane plane
+             * \param triangles triangles to split
+             * \param count amount of triangles
+             * \param front output for the front parts, room for 2 * count triangles
+             * \param back output for the back parts, room for 2 * count triangles, nullptr to drop the back parts
+             * \param epsilon vertices closer than epsilon are on the plane
+             * \return amount of triangles written to front and back
+             */
+            static split_counts split(const plane& plane, const triangle* triangles, const std::size_t count,
+                                      triangle* front, triangle* back, const double epsilon = 1e-9)
+            {
+                if (count <= grain)
+                {
+                    split_counts total;
+                    for (std::size_t index = 0; index < count; ++index)
+                    {
+                        const split_counts counts = plane.split(triangles[index], front + total.front,
+                                                                back == nullptr ? nullptr : back + total.back,
+                                                                epsilon);
+                        total.front += counts.front;
+                        total.back += counts.back;
+                    }
+                    return total;
+                }
+
+                // count the output per triangle, then every triangle writes at its prefix sum
+                std::vector<split_counts> offsets(count + 1);
+                parallel::for_each_index(count, [&](const std::size_t index)
+                {
+                    triangle scratch[4];
+                    offsets[index + 1] = plane.split(triangles[index], scratch,
+                                                     back == nullptr ? nullptr : scratch + 2, epsilon);
+                }, grain);
+
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    offsets[index + 1].front += offsets[index].front;
+                    offsets[index + 1].back += offsets[index].back;
+                }
+
+                parallel::for_each_index(count, [&](const std::size_t index)
+                {
+                    (void)plane.split(triangles[index], front + offsets[index].front,
+                                      back == nullptr ? nullptr : back + offsets[index].back, epsilon);
+                }, grain);
+
+                return offsets[count];
+            }
+
+            /**
+             * \brief clips triangles to the front of a plane
+             * \param plane plane
+             * \param triangles triangles to clip
+             * \param count amount of triangles
+             * \param output output for the front parts, room for 2 * count triangles
+             * \param epsilon vertices closer than epsilon are on the plane
+             * \return amount of triangles written to output
+             */
+            static std::size_t clip(const plane& plane, const triangle* triangles, const std::size_t count,
+                                    triangle* output, const double epsilon = 1e-9)
+            {
+                return split(plane, triangles, count, output, nullptr, epsilon).front;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/zero_exception.h"
+#include "BardCore/interfaces/dimension3.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief integer cell coordinates of a quantized point or vector
+         */
+        struct quantized_point
+        {
+            std::int64_t x = 0, y = 0, z = 0;
+
+            NODISCARD constexpr friend bool operator==(const quantized_point& left, const quantized_point& right) noexcept
+            {
+                return left.x == right.x && left.y == right.y && left.z == right.z;
+            }
+
+            NODISCARD constexpr friend bool operator!=(const quantized_point& left, const quantized_point& right) noexcept
+            {
+                return !(left == right);
+            }
+        };
+
+        /**
+         * \brief hash for points and vectors, coordinates are rounded to a grid of cell_size first
+         *
+         * dimension3::operator== compares with an epsilon, so it can't be used as a key of a hash map,
+         * quantizing gives an exact key: coordinates in the same cell get the same key and hash
+         * \note two coordinates closer than cell_size can still be in neighbouring cells
+         * \note coordinates / cell_size must fit in a 64 bit integer
+         */
+        class point_hash
+        {
+        protected:
+            double inverse_cell_size_ = 1;
+
+        private:
+            /**
+             * \brief helper function for mixing the bits of a 64 bit value (splitmix64 finalizer)
+             */
+            NODISCARD static constexpr std::uint64_t mix(std::uint64_t value) noexcept
+            {
+                value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+                return value ^ (value >> 31);
+            }
+
+        public:
+            /**
+             * \brief default constructor, quantizes to whole units
+             */
+            constexpr point_hash() = default;
+
+            /**
+             * \brief constructor with the size of a cell
+             * \throws zero_exception if cell_size is zero
+             * \throws negative_exception if cell_size is negative
+             * \param cell_size size of the quantization grid, e.g. the welding epsilon
+             */
+            explicit point_hash(const double cell_size)
+            {
+                if (cell_size == 0)
+                    throw exception::zero_exception("cell_size can't be zero");
+                if (cell_size < 0)
+                    throw exception::negative_exception("cell_size can't be negative");
+
+                inverse_cell_size_ = 1 / cell_size;
+            }
+
+            /**
+             * \brief rounds a point or vector to the nearest grid position
+             * \tparam T implementation of dimension3, e.g. point3d
+             * \param dimension point or vector
+             * \return cell coordinates
+             */
+            template <typename T>
+            NODISCARD quantized_point quantize(const dimension3<T>& dimension) const noexcept
+            {
+                return {
+                    std::llround(dimension.x * inverse_cell_size_), std::llround(dimension.y * inverse_cell_size_),
+                    std::llround(dimension.z * inverse_cell_size_)
+                };
+            }
+
+            /**
+             * \brief hashes cell coordinates, all bits of the hash are well mixed
+             * \param point cell coordinates
+             * \return 64 bit hash
+             */
+            NODISCARD constexpr std::uint64_t hash(const quantized_point& point) const noexcept
+            {
+                return mix(static_cast<std::uint64_t>(point.x) * 0x9e3779b97f4a7c15ULL
+                    ^ mix(static_cast<std::uint64_t>(point.y) + 0x632be59bd9b4e019ULL)
+                    ^ mix(static_cast<std::uint64_t>(point.z) + 0x8cb92ba72f3d8dd7ULL));
+            }
+
+            /**
+             * \brief hashes cell coordinates, for use as hasher of a hash map
+             * \param point cell coordinates
+             * \return hash
+             */
+            NODISCARD constexpr std::size_t operator()(const quantized_point& point) const noexcept
+            {
+                return static_cast<std::size_t>(hash(point));
+            }
+
+            /**
+             * \brief quantizes and hashes a point or vector
+             * \tparam T implementation of dimension3, e.g. point3d
+             * \param dimension point or vector
+             * \return hash, the same for every point in the same cell
+             */
+            template <typename T>
+            NODISCARD std::size_t operator()(const dimension3<T>& dimension) const noexcept
+            {
+                return static_cast<std::size_t>(hash(quantize(dimension)));
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD constexpr double get_cell_size() const noexcept { return 1 / inverse_cell_size_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,356 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/sphere.h"
+#include "BardCore/math/triangle.h"
+#include "BardCore/utility/bvh.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/sdf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief signed distance function with bounds, so it can be put in a bvh, the ray is marched inside the bounds
+         * \tparam Sdf shape with a distance(point3d) function, see sdf
+         */
+        template <typename Sdf>
+        struct bounded_sdf
+        {
+            Sdf shape{}; // shape to march against
+            aabb bounds{}; // box containing the surface of the shape
+            sphere_tracer tracer{}; // marcher used inside the bounds
+        };
+
+        /**
+         * \brief how a primitive kind is put in a primitive_bvh, specialize it for other kinds
+         *
+         * a specialization has two static functions:
+         * aabb bounds(const T&) and bool intersect(const T&, const ray&, double t_max, double& t),
+         * which returns true and sets t if the primitive is hit in [0, t_max], like triangle::intersect
+         * \note unbounded primitives like plane have no bounds, test them next to the bvh
+         * \tparam T kind of primitive
+         */
+        template <typename T>
+        struct primitive_traits;
+
+        template <>
+        struct primitive_traits<triangle>
+        {
+            NODISCARD static aabb bounds(const triangle& triangle) noexcept { return triangle.bounds(); }
+
+            NODISCARD static bool intersect(const triangle& triangle, const ray& ray, const double t_max,
+                                            double& t) noexcept
+            {
+                double u = 0, v = 0;
+                return triangle.intersect(ray.get_position(), ray.get_direction(), t_max, t, u, v);
+            }
+        };
+
+        template <>
+        struct primitive_traits<sphere>
+        {
+            NODISCARD static aabb bounds(const sphere& sphere) noexcept { return sphere.bounds(); }
+
+            NODISCARD static bool intersect(const sphere& sphere, const ray& ray, const double t_max,
+                                            double& t) noexcept
+            {
+                // |position + direction * t - center| = radius, direction is normalized
+                const vector3d offset = sphere.center.get_vector(ray.get_position());
+                const double half_b = offset.dot(ray.get_direction());
+                const double c = offset.length_squared() - sphere.radius * sphere.radius;
+                const double discriminant = half_b * half_b - c;
+                if (discriminant < 0)
+                    return false;
+
+                // the far intersection when the ray starts inside
+                const double root = std::sqrt(discriminant);
+                t = -half_b - root >= 0 ? -half_b - root : -half_b + root;
+                return t >= 0 && t <= t_max;
+            }
+        };
+
+        template <typename Sdf>
+        struct primitive_traits<bounded_sdf<Sdf>>
+        {
+            NODISCARD static aabb bounds(const bounded_sdf<Sdf>& primitive) noexcept { return primitive.bounds; }
+
+            NODISCARD static bool intersect(const bounded_sdf<Sdf>& primitive, const ray& ray, const double t_max,
+                                            double& t) noexcept
+            {
+                double t_enter = 0, t_exit = 0;
+                if (!ray.intersect(primitive.bounds, t_enter, t_exit) || t_enter > t_max)
+                    return false;
+
+                const march_result result = primitive.tracer.march(
+                    utility::ray(ray.get_position() + ray.get_direction() * t_enter, ray.get_direction(),
+                                 (std::min)(t_exit, t_max) - t_enter), primitive.shape);
+                t = t_enter + result.distance;
+                return result.hit && t <= t_max;
+            }
+        };
+
+        /**
+         * \brief result of intersecting a ray with a primitive_bvh
+         */
+        struct primitive_hit
+        {
+            bool hit = false; // true if a primitive was hit
+            double distance = 0; // distance along the ray
+            std::uint32_t handle = bvh::no_primitive; // handle of the primitive that was hit, see primitive_bvh::add
+        };
+
+        /**
+         * \brief bvh over primitives of several kinds, e.g. triangles, spheres and signed distance functions
+         *
+         * every kind is stored in its own vector, a primitive is referenced by a handle, its kind (tag) in the top
+         * bits and its index in the vector in the other bits. the handles of a leaf are grouped by kind, so a leaf is
+         * tested as a few runs of one kind. the kind of a run is found with a chain of compares generated from Types,
+         * a switch at compile time, and the intersection of each kind is inlined, there are no virtual calls
+         * \note add doesn't change the bvh, call build after adding primitives
+         * \tparam Types kinds of primitives, each with a primitive_traits specialization
+         */
+        template <typename... Types>
+        class primitive_bvh
+        {
+        public:
+            /**
+             * \brief amount of bits of a handle used for the kind
+             */
+            INLINE static constexpr unsigned int tag_bits = 4;
+
+            /**
+             * \brief amount of bits of a handle used for the index
+             */
+            INLINE static constexpr unsigned int index_bits = 32 - tag_bits;
+
+            static_assert(sizeof...(Types) > 0, "a primitive bvh needs at least one kind of primitive");
+            static_assert(sizeof...(Types) < (1u << tag_bits), "too many kinds of primitives");
+
+        protected:
+            std::tuple<std::vector<Types>...> primitives_{}; // primitives per kind
+            std::vector<std::uint32_t> handles_{}; // handle per primitive of the bvh, in the order they were added
+            std::vector<std::uint32_t> leaf_handles_{}; // handles in leaf order, grouped by kind within a leaf
+            bvh bvh_{};
+
+        private:
+            /**
+             * \brief helper function for the kind of T, sizeof...(Types) if T is not one of Types
+             */
+            template <typename T>
+            NODISCARD static constexpr std::size_t kind_of() noexcept
+            {
+                constexpr bool matches[] = {std::is_same<T, Types>::value...};
+                for (std::size_t position = 0; position < sizeof...(Types); ++position)
+                    if (matches[position])
+                        return position;
+                return sizeof...(Types);
+            }
+
+            /**
+             * \brief helper function for calling function with the vector of the kind, end of the chain
+             */
+            template <typename Function>
+            static void visit(const std::tuple<std::vector<Types>...>&, const std::size_t, Function&&,
+                              std::integral_constant<std::size_t, sizeof...(Types)>) noexcept
+            {
+            }
+
+            /**
+             * \brief helper function for calling function with the vector of the kind, one compare per kind
+             */
+            template <std::size_t Kind, typename Function>
+            static void visit(const std::tuple<std::vector<Types>...>& primitives, const std::size_t kind,
+                              Function&& function, std::integral_constant<std::size_t, Kind>)
+            {
+                if (kind == Kind)
+                    function(std::get<Kind>(primitives));
+                else
+                    visit(primitives, kind, function, std::integral_constant<std::size_t, Kind + 1>());
+            }
+
+            /**
+             * \brief helper function for calling function(const std::vector<T>&) with the vector of kind
+             */
+            template <typename Function>
+            static void visit(const std::tuple<std::vector<Types>...>& primitives, const std::size_t kind,
+                              Function&& function)
+            {
+                visit(primitives, kind, function, std::integral_constant<std::size_t, 0>());
+            }
+
+        public:
+            /**
+             * \brief makes a handle
+             * \param kind index of the kind in Types
+             * \param index index in the vector of the kind
+             * \return handle
+             */
+            NODISCARD static constexpr std::uint32_t make_handle(const std::size_t kind,
+                                                                 const std::size_t index) noexcept
+            {
+                return static_cast<std::uint32_t>(kind << index_bits | index);
+            }
+
+            /**
+             * \brief gets the kind of a handle, the index of the kind in Types
+             * \param handle handle of a primitive
+             * \return kind
+             */
+            NODISCARD static constexpr std::size_t kind(const std::uint32_t handle) noexcept
+            {
+                return handle >> index_bits;
+            }
+
+            /**
+             * \brief gets the index of a handle in the vector of its kind, see get_primitives
+             * \param handle handle of a primitive
+             * \return index
+             */
+            NODISCARD static constexpr std::size_t index(const std::uint32_t handle) noexcept
+            {
+                return handle & ((1u << index_bits) - 1);
+            }
+
+            /**
+             * \brief adds a primitive, it is found after the next build
+             * \throws out_of_range_exception if there are too many primitives of this kind for a handle
+             * \tparam T kind of the primitive, one of Types
+             * \param primitive primitive to add
+             * \return handle of the primitive
+             */
+            template <typename T>
+            std::uint32_t add(const T& primitive)
+            {
+                constexpr std::size_t kind_index = kind_of<T>();
+                static_assert(kind_index < sizeof...(Types), "T is not a kind of this primitive bvh");
+
+                std::vector<T>& primitives = std::get<kind_index>(primitives_);
+                if (primitives.size() >= (std::size_t{1} << index_bits))
+                    throw exception::out_of_range_exception("too many primitives of this kind");
+
+                const std::uint32_t handle = make_handle(kind_index, primitives.size());
+                primitives.push_back(primitive);
+                handles_.push_back(handle);
+                return handle;
+            }
+
+            /**
+             * \brief builds the bvh over all added primitives, the old bvh is replaced
+             * \throws zero_exception if max_leaf_size is zero
+             * \param max_leaf_size maximum amount of primitives per leaf
+             * \param layout order of the nodes in memory
+             */
+            void build(const unsigned int max_leaf_size = 4, const bvh_layout layout = bvh_layout::depth_first)
+            {
+                std::vector<aabb> bounds;
+                bounds.reserve(handles_.size());
+                for (const std::uint32_t handle : handles_)
+                {
+                    visit(primitives_, kind(handle), [&](const auto& primitives)
+                    {
+                        using type = typename std::decay_t<decltype(primitives)>::value_type;
+                        bounds.push_back(primitive_traits<type>::bounds(primitives[index(handle)]));
+                    });
+                }
+
+                bvh_.build(bounds, max_leaf_size, layout);
+
+                // leaf order, stable so primitives of a kind keep the order of the bvh
+                leaf_handles_.resize(handles_.size());
+                for (std::size_t position = 0; position < handles_.size(); ++position)
+                    leaf_handles_[position] = handles_[bvh_.get_primitives()[position]];
+
+                for (const bvh_node& node : bvh_.get_nodes())
+                {
+                    if (node.is_leaf())
+                        std::stable_sort(leaf_handles_.begin() + node.first,
+                                         leaf_handles_.begin() + node.first + node.count,
+                                         [](const std::uint32_t left, const std::uint32_t right)
+                                         {
+                                             return kind(left) < kind(right);
+                                         });
+                }
+            }
+
+            /**
+             * \brief finds the closest primitive hit by a ray
+             * \param ray ray to intersect, only [0, distance] is tested
+             * \return hit, hit is false if nothing was hit
+             */
+            NODISCARD primitive_hit intersect(const ray& ray) const
+            {
+                primitive_hit result;
+
+                result.handle = bvh_.closest_hit_leaves(ray, [&](const bvh_node& leaf, double& t_max)
+                {
+                    std::uint32_t closest = bvh::no_primitive;
+                    const std::uint32_t* run = leaf_handles_.data() + leaf.first;
+                    const std::uint32_t* const end = run + leaf.count;
+                    while (run != end)
+                    {
+                        // a run of one kind, dispatched once
+                        const std::size_t run_kind = kind(*run);
+                        const std::uint32_t* run_end = run + 1;
+                        while (run_end != end && kind(*run_end) == run_kind)
+                            ++run_end;
+
+                        visit(primitives_, run_kind, [&](const auto& primitives)
+                        {
+                            using type = typename std::decay_t<decltype(primitives)>::value_type;
+                            for (const std::uint32_t* handle = run; handle != run_end; ++handle)
+                            {
+                                double t = 0;
+                                if (primitive_traits<type>::intersect(primitives[index(*handle)], ray, t_max, t))
+                                {
+                                    t_max = t;
+                                    result.distance = t;
+                                    closest = *handle;
+                                }
+                            }
+                        });
+                        run = run_end;
+                    }
+                    return closest;
+                });
+
+                result.hit = result.handle != bvh::no_primitive;
+                return result;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief gets the primitives of a kind
+             * \tparam T kind, one of Types
+             * \return primitives, indexed by index(handle)
+             */
+            template <typename T>
+            NODISCARD const std::vector<T>& get_primitives() const noexcept
+            {
+                constexpr std::size_t kind_index = kind_of<T>();
+                static_assert(kind_index < sizeof...(Types), "T is not a kind of this primitive bvh");
+                return std::get<kind_index>(primitives_);
+            }
+
+            NODISCARD std::size_t size() const noexcept { return handles_.size(); }
+            NODISCARD bool empty() const noexcept { return handles_.empty(); }
+            NODISCARD const std::vector<std::uint32_t>& get_handles() const noexcept { return handles_; }
+            NODISCARD const bvh& get_bvh() const noexcept { return bvh_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
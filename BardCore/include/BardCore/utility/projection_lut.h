@@ -0,0 +1,288 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief directions of every pixel of a camera projection, calculated once and reused for every frame
+         *
+         * the directions are stored relative to the camera (right, up and direction), so they only depend on the
+         * projection, the fov and the screen size, not on the position or direction of the camera. generating the
+         * rays of a frame then only rotates the stored directions, without trigonometry, so every projection is as
+         * fast as the perspective projection. the trigonometry is done in batches when the table is built:
+         * equirectangular needs it once per column and once per row, fisheye once per pixel
+         * \note gives the same rays as camera::shoot_ray
+         */
+        class projection_lut
+        {
+        public:
+            /**
+             * \brief amount of pixels per thread when generating rays
+             */
+            INLINE static constexpr std::size_t grain = 4096;
+
+            /**
+             * \brief position and axes of a camera, the stored directions are rotated into them
+             */
+            struct basis
+            {
+                point3d position{};
+                vector3d right{}, up{}, forward{};
+
+                basis() = default;
+
+                /**
+                 * \brief constructor with the position and axes of a camera as they are now
+                 * \param camera camera
+                 */
+                explicit basis(const camera& camera) : position(camera.get_position()), right(camera.get_right()),
+                                                       up(camera.get_up()), forward(camera.get_direction())
+                {
+                }
+            };
+
+        protected:
+            camera_projection projection_ = camera_projection::perspective;
+            unsigned int fov_ = 0;
+            unsigned int screen_width_ = 0, screen_height_ = 0;
+
+            // per pixel, row major, the direction in (right, up, direction) coordinates,
+            // for orthographic the offset of the origin on the screen in (right, up) and local_z_ is 0
+            std::vector<double> local_x_{}, local_y_{}, local_z_{};
+
+        private:
+            /**
+             * \brief helper function for the sine and cosine of many angles
+             */
+            static void sin_cos(const double* angles, double* sine, double* cosine, const std::size_t count) noexcept
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                    sine[index] = std::sin(angles[index]);
+                for (std::size_t index = 0; index < count; ++index)
+                    cosine[index] = std::cos(angles[index]);
+            }
+
+            /**
+             * \brief helper function for building the table of a row, like camera::shoot_ray
+             */
+            void build_row(const std::size_t y, const std::vector<double>& u, const std::vector<double>& sin_longitude,
+                           const std::vector<double>& cos_longitude, const double sin_latitude,
+                           const double cos_latitude, std::vector<double>& angles, std::vector<double>& sine,
+                           std::vector<double>& cosine)
+            {
+                double* local_x = local_x_.data() + y * screen_width_;
+                double* local_y = local_y_.data() + y * screen_width_;
+                double* local_z = local_z_.data() + y * screen_width_;
+                const double v = 1 - 2 * static_cast<double>(y) / static_cast<double>(screen_height_);
+                const double half_fov = math::degrees_to_radians(static_cast<double>(fov_) / 2);
+
+                if (projection_ == camera_projection::perspective || projection_ == camera_projection::orthographic)
+                {
+                    const double half_fov_tan = std::tan(half_fov);
+                    const double z = projection_ == camera_projection::perspective ? 1. : 0.;
+                    for (unsigned int x = 0; x < screen_width_; ++x)
+                    {
+                        local_x[x] = u[x] * half_fov_tan;
+                        local_y[x] = v * half_fov_tan;
+                        local_z[x] = z;
+                    }
+                }
+                else if (projection_ == camera_projection::fisheye)
+                {
+                    for (unsigned int x = 0; x < screen_width_; ++x)
+                        angles[x] = std::sqrt(u[x] * u[x] + v * v) * half_fov;
+                    sin_cos(angles.data(), sine.data(), cosine.data(), screen_width_);
+
+                    // sin(radius * half_fov) / radius goes to half_fov in the center
+                    for (unsigned int x = 0; x < screen_width_; ++x)
+                    {
+                        const double radius = angles[x] / half_fov;
+                        const double scale = radius == 0 ? half_fov : sine[x] / radius;
+                        local_x[x] = u[x] * scale;
+                        local_y[x] = v * scale;
+                        local_z[x] = cosine[x];
+                    }
+                }
+                else
+                {
+                    for (unsigned int x = 0; x < screen_width_; ++x)
+                    {
+                        local_x[x] = cos_latitude * sin_longitude[x];
+                        local_y[x] = sin_latitude;
+                        local_z[x] = cos_latitude * cos_longitude[x];
+                    }
+                }
+            }
+
+            /**
+             * \brief helper function for building the table of a camera
+             */
+            void build(const camera& camera)
+            {
+                projection_ = camera.get_projection();
+                fov_ = camera.get_fov();
+                screen_width_ = camera.get_screen_width();
+                screen_height_ = camera.get_screen_height();
+
+                const std::size_t pixels = pixel_count();
+                local_x_.resize(pixels);
+                local_y_.resize(pixels);
+                local_z_.resize(pixels);
+
+                // -1 at the left edge and 1 at the right edge, the longitude is a function of it
+                std::vector<double> u(screen_width_), longitude(screen_width_);
+                std::vector<double> sin_longitude(screen_width_), cos_longitude(screen_width_);
+                for (unsigned int x = 0; x < screen_width_; ++x)
+                {
+                    u[x] = 2 * static_cast<double>(x) / static_cast<double>(screen_width_) - 1;
+                    longitude[x] = math::pi * u[x];
+                }
+
+                std::vector<double> latitude(screen_height_), sin_latitude(screen_height_), cos_latitude(screen_height_);
+                for (unsigned int y = 0; y < screen_height_; ++y)
+                    latitude[y] = math::pi_2 * (1 - 2 * static_cast<double>(y) / static_cast<double>(screen_height_));
+
+                if (projection_ == camera_projection::equirectangular)
+                {
+                    sin_cos(longitude.data(), sin_longitude.data(), cos_longitude.data(), screen_width_);
+                    sin_cos(latitude.data(), sin_latitude.data(), cos_latitude.data(), screen_height_);
+                }
+
+                parallel::for_each_chunk(screen_height_, [&](const std::size_t begin, const std::size_t end)
+                {
+                    std::vector<double> angles(screen_width_), sine(screen_width_), cosine(screen_width_);
+                    for (std::size_t y = begin; y < end; ++y)
+                        build_row(y, u, sin_longitude, cos_longitude, sin_latitude[y], cos_latitude[y], angles, sine,
+                                  cosine);
+                }, 16);
+            }
+
+        public:
+            projection_lut() = default;
+
+            /**
+             * \brief constructor, builds the table of a camera
+             * \param camera camera to build the table for
+             */
+            explicit projection_lut(const camera& camera)
+            {
+                build(camera);
+            }
+
+            /**
+             * \brief checks if the table belongs to the projection, fov and screen size of a camera
+             * \param camera camera to check
+             * \return true if the table can generate the rays of the camera
+             */
+            NODISCARD bool matches(const camera& camera) const noexcept
+            {
+                return !local_x_.empty()
+                    && projection_ == camera.get_projection()
+                    && fov_ == camera.get_fov()
+                    && screen_width_ == camera.get_screen_width()
+                    && screen_height_ == camera.get_screen_height();
+            }
+
+            /**
+             * \brief rebuilds the table if it doesn't match a camera, e.g. once per frame
+             * \param camera camera to build the table for
+             * \return true if the table was rebuilt
+             */
+            bool update(const camera& camera)
+            {
+                if (matches(camera))
+                    return false;
+
+                build(camera);
+                return true;
+            }
+
+            /**
+             * \brief gets the ray of a pixel by rotating its stored direction into the basis of a camera
+             * \note no bounds check, distance is not checked
+             * \param pixel index of the pixel, y * width + x
+             * \param view basis of a camera matching the table
+             * \param distance distance of the ray
+             * \return ray through the pixel
+             */
+            NODISCARD ray pixel_ray(const std::size_t pixel, const basis& view, const double distance) const
+            {
+                const vector3d local = view.right * local_x_[pixel] + view.up * local_y_[pixel] +
+                    view.forward * local_z_[pixel];
+                return projection_ == camera_projection::orthographic
+                           ? ray(view.position + local, view.forward, distance)
+                           : ray(view.position, local, distance);
+            }
+
+            /**
+             * \brief generates the ray of every pixel of a camera, rows run in parallel
+             * \note ray y * width + x goes through pixel (x, y)
+             * \throws out_of_range_exception if the table doesn't match the camera, see update
+             * \throws negative_exception if distance is negative
+             * \param camera camera to generate the rays of, its position and direction are used as they are now
+             * \param distance distance of every ray
+             * \param rays output, room for pixel_count() rays
+             */
+            void generate(const camera& camera, const double distance, ray* rays) const
+            {
+                if (!matches(camera))
+                    throw exception::out_of_range_exception("the table doesn't match the camera");
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                const basis view(camera);
+                parallel::for_each_chunk(pixel_count(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                        rays[pixel] = pixel_ray(pixel, view, distance);
+                }, grain);
+            }
+
+            /**
+             * \brief generates the ray of every pixel of a camera
+             * \throws out_of_range_exception if the table doesn't match the camera, see update
+             * \throws negative_exception if distance is negative
+             * \param camera camera to generate the rays of
+             * \param distance distance of every ray
+             * \return pixel_count() rays, row major
+             */
+            NODISCARD std::vector<ray> generate(const camera& camera, const double distance) const
+            {
+                std::vector<ray> rays(pixel_count(), ray(vector3d::forward()));
+                generate(camera, distance, rays.data());
+                return rays;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD camera_projection get_projection() const noexcept { return projection_; }
+            NODISCARD unsigned int get_screen_width() const noexcept { return screen_width_; }
+            NODISCARD unsigned int get_screen_height() const noexcept { return screen_height_; }
+            NODISCARD std::size_t pixel_count() const noexcept
+            {
+                return static_cast<std::size_t>(screen_width_) * screen_height_;
+            }
+
+            NODISCARD const std::vector<double>& get_local_x() const noexcept { return local_x_; }
+            NODISCARD const std::vector<double>& get_local_y() const noexcept { return local_y_; }
+            NODISCARD const std::vector<double>& get_local_z() const noexcept { return local_z_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "BardCore/math/aabb.h"
 #include "BardCore/math/point3d.h"
+#include "BardCore/math/triangle.h"
 #include "BardCore/math/vector3d.h"
 
 namespace bardcore
@@ -29,6 +31,11 @@ namespace bardcore
              */
             double distance_{};
 
+            /**
+             * \brief time the ray is traced at, e.g. in the shutter interval for motion blur, 0 by default
+             */
+            double time_{};
+
         public:
             /**
              * \brief default constructor, only direction needs to be set
@@ -57,9 +64,11 @@ namespace bardcore
              * \param position position of the ray
              * \param direction direction of the ray
              * \param distance distance of the ray
+             * \param time time the ray is traced at, see motion_bvh
              */
-            constexpr ray(const point3d& position, const vector3d& direction, const double distance) :
-                position_(position), direction_(direction.normalize()), distance_(distance)
+            constexpr ray(const point3d& position, const vector3d& direction, const double distance,
+                          const double time = 0) : position_(position), direction_(direction.normalize()),
+                                                   distance_(distance), time_(time)
             {
                 if (distance < 0)
                     throw exception::negative_exception("distance can't be negative");
@@ -70,7 +79,7 @@ namespace bardcore
              * \param ray ray to copy
              */
             constexpr ray(const ray& ray) noexcept : position_(ray.position_), direction_(ray.direction_),
-                                                     distance_(ray.distance_)
+                                                     distance_(ray.distance_), time_(ray.time_)
             {
             }
 
@@ -80,7 +89,8 @@ namespace bardcore
              */
             constexpr ray(ray&& ray) noexcept : position_(std::move(ray.position_)),
                                                 direction_(std::move(ray.direction_)),
-                                                distance_(std::move(ray.distance_))
+                                                distance_(std::move(ray.distance_)),
+                                                time_(std::move(ray.time_))
             {
             }
 
@@ -140,6 +150,49 @@ namespace bardcore
             }
 #endif
 
+            /**
+             * \brief calculates the point on the ray at the given distance without allocating, also in C++14
+             * \throws negative_exception if distance is negative
+             * \param distance distance from the position to the point
+             * \param point output, the point on the ray, only written if distance is in range
+             * \return true if distance is in range
+             */
+            NODISCARD constexpr bool try_get_point(const double distance, point3d& point) const
+            {
+                if (!within_range(distance))
+                    return false;
+
+                point = position_ + direction_ * distance;
+                return true;
+            }
+
+            /**
+             * \brief intersects the ray with an aabb using the slab method, only [0, distance] of the ray is tested
+             * \param box aabb to intersect
+             * \param t_enter output, distance along the ray where it enters the aabb (0 if it starts inside)
+             * \param t_exit output, distance along the ray where it leaves the aabb (at most the ray distance)
+             * \return true if the ray intersects the aabb
+             */
+            NODISCARD constexpr bool intersect(const aabb& box, double& t_enter, double& t_exit) const noexcept
+            {
+                return box.intersect(position_, {1. / direction_.x, 1. / direction_.y, 1. / direction_.z},
+                                     distance_, t_enter, t_exit);
+            }
+
+            /**
+             * \brief intersects the ray with a triangle (both faces), only [0, distance] of the ray is tested
+             * \param triangle triangle to intersect
+             * \param t output, distance along the ray of the hit
+             * \param u output, barycentric coordinate of b
+             * \param v output, barycentric coordinate of c
+             * \return true if the ray hits the triangle
+             */
+            NODISCARD constexpr bool intersect(const triangle& triangle, double& t, double& u,
+                                               double& v) const noexcept
+            {
+                return triangle.intersect(position_, direction_, distance_, t, u, v);
+            }
+
             ///////////////////////////////////////////////////////
             ///                 getters/setters                 ///
             ///////////////////////////////////////////////////////
@@ -162,6 +215,12 @@ namespace bardcore
              */
             NODISCARD constexpr double get_distance() const noexcept { return distance_; }
 
+            /**
+             * \brief gets the time the ray is traced at
+             * \return time of the ray
+             */
+            NODISCARD constexpr double get_time() const noexcept { return time_; }
+
             /**
              * \brief sets a new position of the ray
              * \param position new position of the ray
@@ -194,6 +253,12 @@ namespace bardcore
              */
             constexpr void set_distance(const point3d& point) noexcept { set_distance(position_.distance(point)); }
 
+            /**
+             * \brief sets the time the ray is traced at
+             * \param time time of the ray
+             */
+            constexpr void set_time(const double time) noexcept { this->time_ = time; }
+
             ///////////////////////////////////////////////////////
             ///                    operators                    ///
             ///////////////////////////////////////////////////////
@@ -201,15 +266,15 @@ namespace bardcore
             // operators like (+,-,*,/,<,>, etc) are not implemented because they don't make sense for a ray
 
             /**
-             * \brief output operator, prints "{position: (x, y, z), direction: (x, y, z), distance: d}"
+             * \brief output operator, prints "{position: (x, y, z), direction: (x, y, z), distance: d, time: t}"
              * \param os output stream
              * \param ray ray to output
-             * \return output stream "{position: (x, y, z), direction: (x, y, z), distance: d}"
+             * \return output stream "{position: (x, y, z), direction: (x, y, z), distance: d, time: t}"
              */
             friend std::ostream& operator<<(std::ostream& os, const ray& ray)
             {
                 return os << "{position: " << ray.position_ << ", direction: " << ray.direction_ << ", distance: "
-                    << ray.distance_ << "}";
+                    << ray.distance_ << ", time: " << ray.time_ << "}";
             }
 
             /**
@@ -227,23 +292,24 @@ namespace bardcore
             ray& operator=(ray&& ray) noexcept = default;
 
             /**
-             * \brief equal operator (position, direction and distance are equal)
+             * \brief equal operator (position, direction, distance and time are equal)
              * \param left left ray
              * \param right right ray
-             * \return true if left == right (position, direction and distance are equal)
+             * \return true if left == right (position, direction, distance and time are equal)
              */
             NODISCARD constexpr friend bool operator==(const ray& left, const ray& right) noexcept
             {
                 return left.position_ == right.position_
                     && left.direction_ == right.direction_
-                    && math::equals(left.distance_, right.distance_);
+                    && math::equals(left.distance_, right.distance_)
+                    && math::equals(left.time_, right.time_);
             }
 
             /**
-             * \brief not equal operator (position, direction or distance is not equal)
+             * \brief not equal operator (position, direction, distance or time is not equal)
              * \param left left ray
              * \param right right ray
-             * \return true if left != right (position, direction or distance is not equal)
+             * \return true if left != right (position, direction, distance or time is not equal)
              */
             NODISCARD constexpr friend bool operator!=(const ray& left, const ray& right) noexcept
             {
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/negative_exception.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief many rays stored as a structure of arrays, one array per coordinate
+         *
+         * batch kernels read the coordinates they need as contiguous arrays instead of gathering them from rays,
+         * so their loops can be vectorized. every ray has an interval [t_min, t_max], an active flag and an id,
+         * the index it was added with, which stays with the ray when terminated rays are compacted away
+         * \note a ray of the stream is the part of a ray between t_min and t_max, ray::get_distance is t_max
+         */
+        class ray_stream
+        {
+        public:
+            /**
+             * \brief amount of rays per thread in the batch functions
+             */
+            INLINE static constexpr std::size_t grain = 4096;
+
+        protected:
+            std::vector<double> origin_x_{}, origin_y_{}, origin_z_{};
+            std::vector<double> direction_x_{}, direction_y_{}, direction_z_{}; // normalized
+            std::vector<double> t_min_{}, t_max_{};
+            std::vector<double> time_{}; // time of the ray, see ray::get_time
+            std::vector<std::uint8_t> active_{}; // 1 for active rays, 0 for terminated rays
+            std::vector<std::uint32_t> ids_{};
+            std::uint32_t next_id_ = 0;
+
+        private:
+            /**
+             * \brief helper function for checking the size of a batch argument
+             */
+            void check_size(const std::size_t size) const
+            {
+                if (size != ids_.size())
+                    throw exception::out_of_range_exception("amount of values must equal the amount of rays");
+            }
+
+            /**
+             * \brief helper function for throwing if a length is negative, like ray::within_range
+             */
+            void check_lengths(const double* lengths) const
+            {
+                if (std::any_of(lengths, lengths + ids_.size(), [](const double length) { return length < 0; }))
+                    throw exception::negative_exception("length can't be negative");
+            }
+
+        public:
+            ray_stream() = default;
+
+            /**
+             * \brief constructs a stream from rays, t_min is 0 and t_max is the distance of the ray
+             * \param rays rays to add, all active
+             */
+            explicit ray_stream(const std::vector<ray>& rays)
+            {
+                reserve(rays.size());
+                for (const ray& ray : rays)
+                    push_back(ray);
+            }
+
+            /**
+             * \brief reserves room for rays
+             * \param capacity amount of rays
+             */
+            void reserve(const std::size_t capacity)
+            {
+                origin_x_.reserve(capacity);
+                origin_y_.reserve(capacity);
+                origin_z_.reserve(capacity);
+                direction_x_.reserve(capacity);
+                direction_y_.reserve(capacity);
+                direction_z_.reserve(capacity);
+                t_min_.reserve(capacity);
+                t_max_.reserve(capacity);
+                time_.reserve(capacity);
+                active_.reserve(capacity);
+                ids_.reserve(capacity);
+            }
+
+            /**
+             * \brief removes all rays, the capacity and the ids are kept, ids continue counting
+             */
+            void clear() noexcept
+            {
+                origin_x_.clear();
+                origin_y_.clear();
+                origin_z_.clear();
+                direction_x_.clear();
+                direction_y_.clear();
+                direction_z_.clear();
+                t_min_.clear();
+                t_max_.clear();
+                time_.clear();
+                active_.clear();
+                ids_.clear();
+            }
+
+            /**
+             * \brief adds an active ray
+             * \throws negative_exception if t_min is negative
+             * \throws out_of_range_exception if t_min is greater than the distance of the ray
+             * \param ray ray to add, its distance becomes t_max
+             * \param t_min start of the interval, e.g. a small offset to leave a surface
+             * \return id of the ray
+             */
+            std::uint32_t push_back(const ray& ray, const double t_min = 0)
+            {
+                if (t_min < 0)
+                    throw exception::negative_exception("t_min can't be negative");
+                if (t_min > ray.get_distance())
+                    throw exception::out_of_range_exception("t_min can't be greater than the distance of the ray");
+
+                origin_x_.push_back(ray.get_position().x);
+                origin_y_.push_back(ray.get_position().y);
+                origin_z_.push_back(ray.get_position().z);
+                direction_x_.push_back(ray.get_direction().x);
+                direction_y_.push_back(ray.get_direction().y);
+                direction_z_.push_back(ray.get_direction().z);
+                t_min_.push_back(t_min);
+                t_max_.push_back(ray.get_distance());
+                time_.push_back(ray.get_time());
+                active_.push_back(1);
+                ids_.push_back(next_id_);
+                return next_id_++;
+            }
+
+            /**
+             * \brief gets a ray of the stream, its distance is t_max
+             * \throws out_of_range_exception if index is past the end
+             * \param index index in the stream (not the id)
+             * \return ray
+             */
+            NODISCARD ray get_ray(const std::size_t index) const
+            {
+                if (index >= ids_.size())
+                    throw exception::out_of_range_exception("index is past the end of the stream");
+
+                return {
+                    point3d(origin_x_[index], origin_y_[index], origin_z_[index]),
+                    vector3d(direction_x_[index], direction_y_[index], direction_z_[index]), t_max_[index],
+                    time_[index]
+                };
+            }
+
+            /**
+             * \brief converts the stream back to rays, in stream order, see get_ids for the id per ray
+             * \return rays, their distance is t_max
+             */
+            NODISCARD std::vector<ray> to_rays() const
+            {
+                std::vector<ray> rays;
+                rays.reserve(ids_.size());
+                for (std::size_t index = 0; index < ids_.size(); ++index)
+                    rays.push_back(get_ray(index));
+                return rays;
+            }
+
+            /**
+             * \brief checks per ray if a length is within [t_min, t_max] of an active ray, large batches run in parallel
+             * \note the batch equivalent of ray::within_range, terminated rays are never within range
+             * \throws negative_exception if a length is negative
+             * \param lengths one length per ray
+             * \param result output, room for size() values, 1 if within range, otherwise 0
+             */
+            void within_range(const double* lengths, std::uint8_t* result) const
+            {
+                check_lengths(lengths);
+
+                const double* t_min = t_min_.data();
+                const double* t_max = t_max_.data();
+                const std::uint8_t* active = active_.data();
+                parallel::for_each_chunk(ids_.size(), [=](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                        result[index] = static_cast<std::uint8_t>(
+                            active[index] & (t_min[index] <= lengths[index]) & (lengths[index] <= t_max[index]));
+                }, grain);
+            }
+
+            /**
+             * \brief checks per ray if a length is within [t_min, t_max] of an active ray
+             * \throws negative_exception if a length is negative
+             * \throws out_of_range_exception if the amount of lengths isn't the amount of rays
+             * \param lengths one length per ray
+             * \return 1 if within range, otherwise 0, per ray
+             */
+            NODISCARD std::vector<std::uint8_t> within_range(const std::vector<double>& lengths) const
+            {
+                check_size(lengths.size());
+
+                std::vector<std::uint8_t> result(lengths.size());
+                within_range(lengths.data(), result.data());
+                return result;
+            }
+
+            /**
+             * \brief calculates the point on every ray at a distance, large batches run in parallel
+             * \note the batch equivalent of ray::get_point, points out of range are calculated as well but not valid
+             * \throws negative_exception if a distance is negative
+             * \param distances one distance per ray
+             * \param points output, room for size() points
+             * \param valid output, room for size() values, 1 if the distance is within range (see within_range)
+             */
+            void get_points(const double* distances, point3d* points, std::uint8_t* valid) const
+            {
+                within_range(distances, valid);
+
+                const double* ox = origin_x_.data();
+                const double* oy = origin_y_.data();
+                const double* oz = origin_z_.data();
+                const double* dx = direction_x_.data();
+                const double* dy = direction_y_.data();
+                const double* dz = direction_z_.data();
+                parallel::for_each_chunk(ids_.size(), [=](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        points[index].x = ox[index] + dx[index] * distances[index];
+                        points[index].y = oy[index] + dy[index] * distances[index];
+                        points[index].z = oz[index] + dz[index] * distances[index];
+                    }
+                }, grain);
+            }
+
+            /**
+             * \brief calculates the point on every ray at a distance
+             * \throws negative_exception if a distance is negative
+             * \throws out_of_range_exception if the amount of distances isn't the amount of rays
+             * \param distances one distance per ray
+             * \param valid output, 1 per ray if the distance is within range, otherwise 0
+             * \return point per ray, points out of range are calculated as well
+             */
+            NODISCARD std::vector<point3d> get_points(const std::vector<double>& distances,
+                                                      std::vector<std::uint8_t>& valid) const
+            {
+                check_size(distances.size());
+
+                std::vector<point3d> points(distances.size());
+                valid.resize(distances.size());
+                get_points(distances.data(), points.data(), valid.data());
+                return points;
+            }
+
+            /**
+             * \brief terminates a ray, it is removed by the next compact
+             * \throws out_of_range_exception if index is past the end
+             * \param index index in the stream
+             */
+            void terminate(const std::size_t index)
+            {
+                if (index >= ids_.size())
+                    throw exception::out_of_range_exception("index is past the end of the stream");
+
+                active_[index] = 0;
+            }
+
+            /**
+             * \brief removes the terminated rays in place, the active rays keep their order and their ids
+             * \return amount of rays that are left
+             */
+            std::size_t compact() noexcept
+            {
+                std::size_t size = 0;
+                for (std::size_t index = 0; index < ids_.size(); ++index)
+                {
+                    // branch free, every ray is written and the write position only moves for active rays
+                    origin_x_[size] = origin_x_[index];
+                    origin_y_[size] = origin_y_[index];
+                    origin_z_[size] = origin_z_[index];
+                    direction_x_[size] = direction_x_[index];
+                    direction_y_[size] = direction_y_[index];
+                    direction_z_[size] = direction_z_[index];
+                    t_min_[size] = t_min_[index];
+                    t_max_[size] = t_max_[index];
+                    time_[size] = time_[index];
+                    ids_[size] = ids_[index];
+                    size += active_[index];
+                }
+
+                origin_x_.resize(size);
+                origin_y_.resize(size);
+                origin_z_.resize(size);
+                direction_x_.resize(size);
+                direction_y_.resize(size);
+                direction_z_.resize(size);
+                t_min_.resize(size);
+                t_max_.resize(size);
+                time_.resize(size);
+                ids_.resize(size);
+                active_.assign(size, 1);
+                return size;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return ids_.size(); }
+            NODISCARD bool empty() const noexcept { return ids_.empty(); }
+
+            /**
+             * \brief gets the amount of rays that are not terminated
+             * \return amount of active rays
+             */
+            NODISCARD std::size_t active_count() const noexcept
+            {
+                std::size_t count = 0;
+                for (const std::uint8_t active : active_)
+                    count += active;
+                return count;
+            }
+
+            NODISCARD const std::vector<double>& get_origin_x() const noexcept { return origin_x_; }
+            NODISCARD const std::vector<double>& get_origin_y() const noexcept { return origin_y_; }
+            NODISCARD const std::vector<double>& get_origin_z() const noexcept { return origin_z_; }
+            NODISCARD const std::vector<double>& get_direction_x() const noexcept { return direction_x_; }
+            NODISCARD const std::vector<double>& get_direction_y() const noexcept { return direction_y_; }
+            NODISCARD const std::vector<double>& get_direction_z() const noexcept { return direction_z_; }
+            NODISCARD const std::vector<double>& get_t_min() const noexcept { return t_min_; }
+            NODISCARD const std::vector<double>& get_t_max() const noexcept { return t_max_; }
+            NODISCARD const std::vector<double>& get_time() const noexcept { return time_; }
+            NODISCARD const std::vector<std::uint8_t>& get_active() const noexcept { return active_; }
+            NODISCARD const std::vector<std::uint32_t>& get_ids() const noexcept { return ids_; }
+
+            /**
+             * \brief sets the end of the interval of a ray, e.g. to the distance of a hit
+             * \throws out_of_range_exception if index is past the end or t_max is smaller than t_min
+             * \param index index in the stream
+             * \param t_max new end of the interval
+             */
+            void set_t_max(const std::size_t index, const double t_max)
+            {
+                if (index >= ids_.size())
+                    throw exception::out_of_range_exception("index is past the end of the stream");
+                if (t_max < t_min_[index])
+                    throw exception::out_of_range_exception("t_max can't be smaller than t_min");
+
+                t_max_[index] = t_max;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
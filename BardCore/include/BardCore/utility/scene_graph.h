@@ -0,0 +1,438 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/math/imaginary/quaternion.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief flat, array based scene graph, every node has a local rotation and position relative to its parent
+         *
+         * nodes are stored in topological order (a parent always has a smaller index than its children),
+         * dirty nodes are kept in a list, update() only walks the subtrees below dirty nodes,
+         * the nodes of those subtrees are grouped by depth and every depth is updated in parallel
+         * \note rotations are expected to be unit quaternions, e.g. from quaternion::from_axis_radians
+         * \note update_instance_bounds turns the local bounds of the instances into world bounds after an update,
+         *       only for the updated nodes, and bvh::refit takes them to move the instances in a bvh
+         */
+        class scene_graph final
+        {
+        public:
+            /**
+             * \brief parent index of root nodes
+             */
+            INLINE static constexpr std::size_t no_parent = static_cast<std::size_t>(-1);
+
+            /**
+             * \brief minimum amount of nodes of one depth per thread in update()
+             */
+            INLINE static constexpr std::size_t level_grain = 256;
+
+        protected:
+            std::vector<std::size_t> parents_{}; // parent index per node, no_parent for roots
+            std::vector<std::size_t> depths_{}; // depth per node, 0 for roots
+            std::vector<std::vector<std::size_t>> children_{}; // child indices per node
+
+            std::vector<quaternion> local_rotations_{}; // rotation relative to the parent
+            std::vector<point3d> local_positions_{}; // offset relative to the parent, in parent space
+
+            std::vector<quaternion> world_rotations_{}; // cached rotation in world space
+            std::vector<point3d> world_positions_{}; // cached position in world space
+
+            std::vector<unsigned char> dirty_{}; // local transform changed since the last update
+
+            std::vector<std::size_t> dirty_nodes_{}; // node indices that became dirty since the last update
+            std::vector<std::size_t> updated_nodes_{}; // node indices recalculated in the last update
+            std::vector<std::vector<std::size_t>> levels_{}; // nodes to recalculate per depth, kept between updates
+
+            std::size_t depth_count_ = 0; // amount of depths, the deepest node has depth depth_count_ - 1
+
+        private:
+            /**
+             * \brief helper function for checking the index of a node
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             */
+            void check_index(const std::size_t index) const
+            {
+                if (index >= parents_.size())
+                    throw exception::out_of_range_exception("node index is out of range");
+            }
+
+            /**
+             * \brief helper function for flagging a node as dirty
+             * \param index index of the node
+             */
+            void mark_dirty(const std::size_t index)
+            {
+                if (dirty_[index])
+                    return;
+
+                dirty_[index] = 1;
+                dirty_nodes_.push_back(index);
+            }
+
+            /**
+             * \brief helper function for checking if a node is below a dirty node
+             * \param index index of the node
+             * \return true if the parent, grandparent, etc. of the node is dirty
+             */
+            NODISCARD bool has_dirty_ancestor(std::size_t index) const noexcept
+            {
+                while ((index = parents_[index]) != no_parent)
+                    if (dirty_[index])
+                        return true;
+                return false;
+            }
+
+            /**
+             * \brief helper function for recalculating the world transform of a node from its parent
+             * \param index index of the node
+             */
+            void update_node(const std::size_t index) noexcept
+            {
+                const std::size_t parent = parents_[index];
+
+                if (parent == no_parent)
+                {
+                    world_rotations_[index] = local_rotations_[index];
+                    world_positions_[index] = local_positions_[index];
+                }
+                else
+                {
+                    const quaternion& parent_rotation = world_rotations_[parent];
+
+                    // child rotation first, then the parent rotation
+                    world_rotations_[index] = local_rotations_[index].multiply(parent_rotation);
+                    world_positions_[index] = world_positions_[parent] +
+                        quaternion::rotate_quaternion(local_positions_[index], parent_rotation);
+                }
+
+                dirty_[index] = 0;
+            }
+
+            /**
+             * \brief helper function for adding a node and all of its descendants to the level of their depth
+             * \param root index of the first node
+             * \param stack reused stack of nodes to visit
+             */
+            void collect_subtree(const std::size_t root, std::vector<std::size_t>& stack)
+            {
+                stack.assign(1, root);
+                while (!stack.empty())
+                {
+                    const std::size_t index = stack.back();
+                    stack.pop_back();
+
+                    levels_[depths_[index]].push_back(index);
+                    stack.insert(stack.end(), children_[index].begin(), children_[index].end());
+                }
+            }
+
+        public:
+            scene_graph() = default;
+
+            /**
+             * \brief reserves memory for an amount of nodes
+             * \param count amount of nodes
+             */
+            void reserve(const std::size_t count)
+            {
+                parents_.reserve(count);
+                depths_.reserve(count);
+                children_.reserve(count);
+                local_rotations_.reserve(count);
+                local_positions_.reserve(count);
+                world_rotations_.reserve(count);
+                world_positions_.reserve(count);
+                dirty_.reserve(count);
+            }
+
+            /**
+             * \brief adds a node to the scene graph, the node is dirty until the next update
+             * \throws out_of_range_exception if parent is not no_parent and not an existing node
+             * \param local_rotation rotation relative to the parent
+             * \param local_position offset relative to the parent (in the space of the parent)
+             * \param parent index of the parent node, no_parent for a root node
+             * \return index of the new node
+             */
+            std::size_t add_node(const quaternion& local_rotation, const point3d& local_position,
+                                 const std::size_t parent = no_parent)
+            {
+                if (parent != no_parent)
+                    check_index(parent);
+
+                const std::size_t index = parents_.size();
+                const std::size_t depth = parent == no_parent ? 0 : depths_[parent] + 1;
+
+                parents_.push_back(parent);
+                depths_.push_back(depth);
+                children_.emplace_back();
+                local_rotations_.push_back(local_rotation);
+                local_positions_.push_back(local_position);
+                world_rotations_.push_back(local_rotation);
+                world_positions_.push_back(local_position);
+                dirty_.push_back(0);
+
+                if (parent != no_parent)
+                    children_[parent].push_back(index);
+                depth_count_ = (std::max)(depth_count_, depth + 1);
+
+                mark_dirty(index);
+                return index;
+            }
+
+            /**
+             * \brief recalculates the world transforms of all dirty nodes and their descendants
+             * \note only the subtrees below dirty nodes are visited, the depths are processed one after another
+             * (parents before children), the nodes of one depth in parallel
+             * \return amount of nodes that were recalculated
+             */
+            std::size_t update()
+            {
+                updated_nodes_.clear();
+
+                if (dirty_nodes_.empty())
+                    return 0;
+
+                // a dirty node below another dirty node is recalculated as part of that node's subtree
+                std::vector<std::size_t> roots;
+                for (const std::size_t index : dirty_nodes_)
+                    if (!has_dirty_ancestor(index))
+                        roots.push_back(index);
+
+                levels_.resize(depth_count_);
+                for (std::vector<std::size_t>& level : levels_)
+                    level.clear();
+
+                std::vector<std::size_t> stack;
+                for (const std::size_t root : roots)
+                    collect_subtree(root, stack);
+
+                // every node of a level only reads its parent, which was finished in the previous level
+                for (const std::vector<std::size_t>& level : levels_)
+                {
+                    parallel::for_each_index(level.size(), [this, &level](const std::size_t position)
+                    {
+                        update_node(level[position]);
+                    }, level_grain);
+
+                    updated_nodes_.insert(updated_nodes_.end(), level.begin(), level.end());
+                }
+                std::sort(updated_nodes_.begin(), updated_nodes_.end());
+
+                dirty_nodes_.clear();
+                return updated_nodes_.size();
+            }
+
+            /**
+             * \brief calculates the world bounds of an instance per node, e.g. for bvh::refit
+             * \note only the nodes of the last update are recalculated, unless world_bounds has the wrong size,
+             *       then it is resized and every node is calculated
+             * \throws out_of_range_exception if the amount of local bounds is not the amount of nodes
+             * \param local_bounds bounds of the instance of every node in its local space
+             * \param world_bounds bounds of the instance of every node in world space, updated in place
+             */
+            void update_instance_bounds(const std::vector<aabb>& local_bounds, std::vector<aabb>& world_bounds) const
+            {
+                if (local_bounds.size() != size())
+                    throw exception::out_of_range_exception("amount of local bounds must be the amount of nodes");
+
+                const auto transform = [this, &local_bounds, &world_bounds](const std::size_t index)
+                {
+                    const aabb& local = local_bounds[index];
+                    aabb& world = world_bounds[index] = aabb();
+                    if (local.is_empty())
+                        return;
+
+                    // a rotated box is contained by the box around its 8 corners
+                    for (int corner = 0; corner < 8; ++corner)
+                    {
+                        const point3d point((corner & 1) ? local.maximum.x : local.minimum.x,
+                                            (corner & 2) ? local.maximum.y : local.minimum.y,
+                                            (corner & 4) ? local.maximum.z : local.minimum.z);
+                        world.expand(world_positions_[index] +
+                            quaternion::rotate_quaternion(point, world_rotations_[index]));
+                    }
+                };
+
+                if (world_bounds.size() != size())
+                {
+                    world_bounds.resize(size());
+                    for (std::size_t index = 0; index < size(); ++index)
+                        transform(index);
+                    return;
+                }
+
+                for (const std::size_t index : updated_nodes_)
+                    transform(index);
+            }
+
+            /**
+             * \brief transforms a point from the local space of a node to world space
+             * \note uses the world transform of the last update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \param point point in the local space of the node
+             * \return point in world space
+             */
+            NODISCARD point3d to_world(const std::size_t index, const point3d& point) const
+            {
+                check_index(index);
+                return world_positions_[index] + quaternion::rotate_quaternion(point, world_rotations_[index]);
+            }
+
+            /**
+             * \brief transforms a direction from the local space of a node to world space
+             * \note uses the world transform of the last update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \param vector direction in the local space of the node
+             * \return direction in world space
+             */
+            NODISCARD vector3d to_world(const std::size_t index, const vector3d& vector) const
+            {
+                check_index(index);
+                return quaternion::rotate_quaternion(vector, world_rotations_[index]);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return parents_.size(); }
+            NODISCARD std::size_t get_depth_count() const noexcept { return depth_count_; }
+
+            /**
+             * \brief gets the parent of a node
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return parent index, no_parent for a root node
+             */
+            NODISCARD std::size_t get_parent(const std::size_t index) const
+            {
+                check_index(index);
+                return parents_[index];
+            }
+
+            /**
+             * \brief gets the world rotation of a node, calculated in the last update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return world rotation
+             */
+            NODISCARD const quaternion& get_world_rotation(const std::size_t index) const
+            {
+                check_index(index);
+                return world_rotations_[index];
+            }
+
+            /**
+             * \brief gets the world position of a node, calculated in the last update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return world position
+             */
+            NODISCARD const point3d& get_world_position(const std::size_t index) const
+            {
+                check_index(index);
+                return world_positions_[index];
+            }
+
+            /**
+             * \brief gets the world rotations of all nodes, indexed by node
+             * \return contiguous world rotations
+             */
+            NODISCARD const std::vector<quaternion>& get_world_rotations() const noexcept
+            {
+                return world_rotations_;
+            }
+
+            /**
+             * \brief gets the world positions of all nodes, indexed by node
+             * \return contiguous world positions
+             */
+            NODISCARD const std::vector<point3d>& get_world_positions() const noexcept { return world_positions_; }
+
+            /**
+             * \brief gets the nodes that were recalculated in the last update, in ascending order
+             * \note acceleration structures only have to refit the instances in this list
+             * \return indices of the recalculated nodes
+             */
+            NODISCARD const std::vector<std::size_t>& get_updated_nodes() const noexcept { return updated_nodes_; }
+
+            /**
+             * \brief gets the local rotation of a node
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return local rotation
+             */
+            NODISCARD const quaternion& get_local_rotation(const std::size_t index) const
+            {
+                check_index(index);
+                return local_rotations_[index];
+            }
+
+            /**
+             * \brief gets the local position of a node
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return local position
+             */
+            NODISCARD const point3d& get_local_position(const std::size_t index) const
+            {
+                check_index(index);
+                return local_positions_[index];
+            }
+
+            /**
+             * \brief sets the local rotation of a node, the node is dirty until the next update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \param rotation new local rotation
+             */
+            void set_local_rotation(const std::size_t index, const quaternion& rotation)
+            {
+                check_index(index);
+                local_rotations_[index] = rotation;
+                mark_dirty(index);
+            }
+
+            /**
+             * \brief sets the local position of a node, the node is dirty until the next update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \param position new local position
+             */
+            void set_local_position(const std::size_t index, const point3d& position)
+            {
+                check_index(index);
+                local_positions_[index] = position;
+                mark_dirty(index);
+            }
+
+            /**
+             * \brief checks if a node is dirty, i.e. changed since the last update
+             * \throws out_of_range_exception if index is not a node
+             * \param index index of the node
+             * \return true if the node is dirty
+             */
+            NODISCARD bool is_dirty(const std::size_t index) const
+            {
+                check_index(index);
+                return dirty_[index] != 0;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
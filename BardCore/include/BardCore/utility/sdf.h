@@ -0,0 +1,537 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/arena.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief signed distance functions, every shape has a distance(point3d) function
+         *
+         * the distance is negative inside the shape, zero on the surface and positive outside,
+         * shapes are plain structs and can be combined with the csg templates (make_union, make_difference, ...)
+         * \note there is no virtual dispatch, so the whole shape is inlined in the marcher
+         */
+        namespace sdf
+        {
+            /**
+             * \brief sphere with a center and a radius
+             */
+            struct sphere
+            {
+                point3d center{};
+                double radius{};
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    const double dx = point.x - center.x, dy = point.y - center.y, dz = point.z - center.z;
+                    return std::sqrt(dx * dx + dy * dy + dz * dz) - radius;
+                }
+            };
+
+            /**
+             * \brief axis aligned box with a center and half extents
+             */
+            struct box
+            {
+                point3d center{};
+                vector3d half_extents{};
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    const double qx = std::fabs(point.x - center.x) - half_extents.x;
+                    const double qy = std::fabs(point.y - center.y) - half_extents.y;
+                    const double qz = std::fabs(point.z - center.z) - half_extents.z;
+
+                    const double ox = (std::max)(qx, 0.), oy = (std::max)(qy, 0.), oz = (std::max)(qz, 0.);
+                    const double inside = (std::min)((std::max)(qx, (std::max)(qy, qz)), 0.);
+
+                    return std::sqrt(ox * ox + oy * oy + oz * oz) + inside;
+                }
+            };
+
+            /**
+             * \brief infinite plane, the normal side is outside
+             * \note normal has to be normalized
+             */
+            struct plane
+            {
+                vector3d normal{0, 1, 0};
+                double offset{}; // signed distance from the origin along the normal
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return point.x * normal.x + point.y * normal.y + point.z * normal.z - offset;
+                }
+            };
+
+            /**
+             * \brief torus around the y axis
+             */
+            struct torus
+            {
+                point3d center{};
+                double major_radius{}; // radius of the ring
+                double minor_radius{}; // radius of the tube
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    const double dx = point.x - center.x, dy = point.y - center.y, dz = point.z - center.z;
+                    const double ring = std::sqrt(dx * dx + dz * dz) - major_radius;
+                    return std::sqrt(ring * ring + dy * dy) - minor_radius;
+                }
+            };
+
+            /**
+             * \brief union of two shapes, min(a, b)
+             */
+            template <typename A, typename B>
+            struct csg_union
+            {
+                A a;
+                B b;
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return (std::min)(a.distance(point), b.distance(point));
+                }
+            };
+
+            /**
+             * \brief intersection of two shapes, max(a, b)
+             */
+            template <typename A, typename B>
+            struct csg_intersection
+            {
+                A a;
+                B b;
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return (std::max)(a.distance(point), b.distance(point));
+                }
+            };
+
+            /**
+             * \brief difference of two shapes (a without b), max(a, -b)
+             */
+            template <typename A, typename B>
+            struct csg_difference
+            {
+                A a;
+                B b;
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return (std::max)(a.distance(point), -b.distance(point));
+                }
+            };
+
+            /**
+             * \brief smooth union of two shapes, blends the surfaces within the smoothness distance
+             * \note polynomial smooth min, read more at https://iquilezles.org/articles/smin/
+             */
+            template <typename A, typename B>
+            struct csg_smooth_union
+            {
+                A a;
+                B b;
+                double smoothness{};
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    const double da = a.distance(point), db = b.distance(point);
+                    const double h = (std::max)(smoothness - std::fabs(da - db), 0.) / smoothness;
+                    return (std::min)(da, db) - h * h * smoothness * 0.25;
+                }
+            };
+
+            /**
+             * \brief moves a shape by an offset
+             */
+            template <typename A>
+            struct translation
+            {
+                A a;
+                vector3d offset{};
+
+                NODISCARD double distance(const point3d& point) const noexcept
+                {
+                    return a.distance(point3d(point.x - offset.x, point.y - offset.y, point.z - offset.z));
+                }
+            };
+
+            template <typename A, typename B>
+            NODISCARD constexpr csg_union<A, B> make_union(const A& a, const B& b) { return {a, b}; }
+
+            template <typename A, typename B>
+            NODISCARD constexpr csg_intersection<A, B> make_intersection(const A& a, const B& b) { return {a, b}; }
+
+            template <typename A, typename B>
+            NODISCARD constexpr csg_difference<A, B> make_difference(const A& a, const B& b) { return {a, b}; }
+
+            /**
+             * \brief creates a smooth union of two shapes
+             * \throws zero_exception if smoothness is zero or negative
+             */
+            template <typename A, typename B>
+            NODISCARD csg_smooth_union<A, B> make_smooth_union(const A& a, const B& b, const double smoothness)
+            {
+                if (smoothness <= 0)
+                    throw exception::zero_exception("smoothness must be greater than 0");
+
+                return {a, b, smoothness};
+            }
+
+            template <typename A>
+            NODISCARD constexpr translation<A> make_translation(const A& a, const vector3d& offset)
+            {
+                return {a, offset};
+            }
+        } // namespace bardcore::utility::sdf
+
+        /**
+         * \brief result of marching a single ray
+         */
+        struct march_result
+        {
+            bool hit = false; // true if the surface was found before the end of the ray
+            double distance = 0; // distance along the ray of the hit, or where the march stopped
+            unsigned int steps = 0; // amount of distance evaluations
+        };
+
+        /**
+         * \brief aggregated step statistics of many march results
+         */
+        struct march_statistics
+        {
+            std::size_t rays = 0;
+            std::size_t hits = 0;
+            std::size_t total_steps = 0;
+            unsigned int max_steps = 0;
+
+            /**
+             * \brief average amount of steps per ray
+             * \return average steps, 0 if there are no rays
+             */
+            NODISCARD double average_steps() const noexcept
+            {
+                return rays == 0 ? 0. : static_cast<double>(total_steps) / static_cast<double>(rays);
+            }
+
+            /**
+             * \brief collects the statistics of march results
+             * \param results results of the marcher
+             * \return statistics
+             */
+            NODISCARD static march_statistics collect(const std::vector<march_result>& results) noexcept
+            {
+                march_statistics statistics;
+                statistics.rays = results.size();
+                for (const march_result& result : results)
+                {
+                    statistics.hits += result.hit ? 1 : 0;
+                    statistics.total_steps += result.steps;
+                    statistics.max_steps = (std::max)(statistics.max_steps, result.steps);
+                }
+                return statistics;
+            }
+        };
+
+        /**
+         * \brief sphere tracer for signed distance functions, it marches rays from their position up to their distance
+         *
+         * it uses over-relaxation (enhanced sphere tracing), steps are omega * distance and when the unbounding
+         * spheres of two steps don't overlap it steps back and continues with omega = 1
+         * \note read more at https://erleben.github.io/fluid_course/misc/Enhanced_Sphere_Tracing.pdf
+         * \note the ray distance is used as the maximum distance (tmax) of the march
+         */
+        class sphere_tracer final
+        {
+        protected:
+            unsigned int max_steps_ = 128; // maximum distance evaluations per ray
+            double hit_epsilon_ = 0.0001; // distance to the surface that counts as a hit
+            double relaxation_ = 1.6; // over-relaxation factor (omega), 1 is plain sphere tracing
+
+        public:
+            /**
+             * \brief packet width of the batched marcher
+             */
+            INLINE static constexpr std::size_t packet_size = 8;
+
+            /**
+             * \brief constructor for sphere tracer
+             * \throws zero_exception if max_steps is zero
+             * \throws negative_exception if hit_epsilon is zero or negative
+             * \throws out_of_range_exception if relaxation is not in [1, 2)
+             * \param max_steps maximum distance evaluations per ray
+             * \param hit_epsilon distance to the surface that counts as a hit
+             * \param relaxation over-relaxation factor, 1 disables over-relaxation
+             */
+            explicit sphere_tracer(const unsigned int max_steps = 128, const double hit_epsilon = 0.0001,
+                                   const double relaxation = 1.6) : max_steps_(max_steps), hit_epsilon_(hit_epsilon),
+                                                                    relaxation_(relaxation)
+            {
+                if (max_steps == 0)
+                    throw exception::zero_exception("max_steps must be greater than 0");
+                if (hit_epsilon <= 0)
+                    throw exception::negative_exception("hit_epsilon must be greater than 0");
+                if (relaxation < 1 || relaxation >= 2)
+                    throw exception::out_of_range_exception("relaxation must be in [1, 2)");
+            }
+
+            /**
+             * \brief marches a single ray against a shape
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param ray ray to march, its distance is the maximum distance
+             * \param shape shape to march against
+             * \return result of the march
+             */
+            template <typename Sdf>
+            NODISCARD march_result march(const ray& ray, const Sdf& shape) const noexcept
+            {
+                const point3d& origin = ray.get_position();
+                const vector3d& direction = ray.get_direction();
+                const double t_max = ray.get_distance();
+
+                march_result result;
+
+                const double function_sign = shape.distance(origin) < 0 ? -1. : 1.;
+                double omega = relaxation_;
+                double t = 0, previous_radius = 0, step_length = 0;
+
+                for (unsigned int step = 0; step < max_steps_ && t <= t_max; ++step)
+                {
+                    const double signed_radius = function_sign * shape.distance(
+                        point3d(origin.x + direction.x * t, origin.y + direction.y * t, origin.z + direction.z * t));
+                    const double radius = std::fabs(signed_radius);
+                    ++result.steps;
+
+                    const bool relaxation_failed = omega > 1 && radius + previous_radius < step_length;
+                    if (relaxation_failed)
+                    {
+                        // step back to the last safe point, continue without over-relaxation
+                        step_length = -(step_length - step_length / omega);
+                        omega = 1;
+                    }
+                    else
+                    {
+                        if (radius < hit_epsilon_)
+                        {
+                            result.hit = true;
+                            result.distance = t;
+                            return result;
+                        }
+                        step_length = signed_radius * omega;
+                    }
+
+                    previous_radius = radius;
+                    t += step_length;
+                }
+
+                result.distance = (std::min)(t, t_max);
+                return result;
+            }
+
+            /**
+             * \brief marches a packet of at most packet_size rays against a shape, lane by lane in lockstep
+             * \note every iteration runs plain loops over the lanes, so the compiler can vectorize them
+             * \throws out_of_range_exception if count is greater than packet_size
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param rays rays to march, their distance is the maximum distance
+             * \param count amount of rays, with 0 nothing is read or written
+             * \param shape shape to march against
+             * \param results output, at least count results
+             */
+            template <typename Sdf>
+            void march_packet(const ray* rays, const std::size_t count, const Sdf& shape,
+                              march_result* results) const
+            {
+                if (count > packet_size)
+                    throw exception::out_of_range_exception("count must not be greater than packet_size");
+                if (count == 0)
+                    return;
+
+                double ox[packet_size], oy[packet_size], oz[packet_size];
+                double dx[packet_size], dy[packet_size], dz[packet_size];
+                double t[packet_size], t_max[packet_size], sign[packet_size], omega[packet_size];
+                double previous_radius[packet_size], step_length[packet_size], radius[packet_size];
+                unsigned int steps[packet_size];
+                bool active[packet_size], hit[packet_size];
+
+                for (std::size_t lane = 0; lane < packet_size; ++lane)
+                {
+                    // unused lanes are inactive copies of the first ray
+                    const ray& lane_ray = rays[lane < count ? lane : 0];
+                    ox[lane] = lane_ray.get_position().x;
+                    oy[lane] = lane_ray.get_position().y;
+                    oz[lane] = lane_ray.get_position().z;
+                    dx[lane] = lane_ray.get_direction().x;
+                    dy[lane] = lane_ray.get_direction().y;
+                    dz[lane] = lane_ray.get_direction().z;
+                    t_max[lane] = lane_ray.get_distance();
+                    sign[lane] = shape.distance(point3d(ox[lane], oy[lane], oz[lane])) < 0 ? -1. : 1.;
+                    t[lane] = previous_radius[lane] = step_length[lane] = 0;
+                    omega[lane] = relaxation_;
+                    steps[lane] = 0;
+                    active[lane] = lane < count;
+                    hit[lane] = false;
+                }
+
+                for (unsigned int step = 0; step < max_steps_; ++step)
+                {
+                    bool any_active = false;
+                    for (std::size_t lane = 0; lane < packet_size; ++lane)
+                    {
+                        active[lane] = active[lane] && t[lane] <= t_max[lane];
+                        any_active = any_active || active[lane];
+                    }
+
+                    if (!any_active)
+                        break;
+
+                    for (std::size_t lane = 0; lane < packet_size; ++lane)
+                        radius[lane] = sign[lane] * shape.distance(point3d(ox[lane] + dx[lane] * t[lane],
+                                                                           oy[lane] + dy[lane] * t[lane],
+                                                                           oz[lane] + dz[lane] * t[lane]));
+
+                    for (std::size_t lane = 0; lane < packet_size; ++lane)
+                    {
+                        const double signed_radius = radius[lane];
+                        const double abs_radius = std::fabs(signed_radius);
+
+                        const bool relaxation_failed = omega[lane] > 1 &&
+                            abs_radius + previous_radius[lane] < step_length[lane];
+                        const bool lane_hit = !relaxation_failed && abs_radius < hit_epsilon_;
+
+                        const double back_step = -(step_length[lane] - step_length[lane] / omega[lane]);
+                        const double next_step = relaxation_failed ? back_step : signed_radius * omega[lane];
+
+                        steps[lane] += active[lane] ? 1 : 0;
+                        hit[lane] = hit[lane] || (active[lane] && lane_hit);
+                        omega[lane] = relaxation_failed ? 1. : omega[lane];
+                        previous_radius[lane] = abs_radius;
+                        step_length[lane] = next_step;
+                        t[lane] += active[lane] && !lane_hit ? next_step : 0.;
+                        active[lane] = active[lane] && !lane_hit;
+                    }
+                }
+
+                for (std::size_t lane = 0; lane < count; ++lane)
+                {
+                    results[lane].hit = hit[lane];
+                    results[lane].distance = hit[lane] ? t[lane] : (std::min)(t[lane], t_max[lane]);
+                    results[lane].steps = steps[lane];
+                }
+            }
+
+            /**
+             * \brief marches many rays against a shape, in packets, the packets are marched in parallel
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param rays rays to march
+             * \param count amount of rays
+             * \param shape shape to march against
+             * \param results output, room for count results
+             */
+            template <typename Sdf>
+            void march(const ray* rays, const std::size_t count, const Sdf& shape, march_result* results) const
+            {
+                const std::size_t packets = (count + packet_size - 1) / packet_size;
+
+                parallel::for_each_index(packets, [&](const std::size_t packet)
+                {
+                    const std::size_t begin = packet * packet_size;
+                    const std::size_t remaining = count - begin;
+                    march_packet(rays + begin, remaining < packet_size ? remaining : packet_size, shape,
+                                 results + begin);
+                }, 64);
+            }
+
+            /**
+             * \brief marches many rays against a shape, in packets, the packets are marched in parallel
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param rays rays to march
+             * \param shape shape to march against
+             * \return one result per ray
+             */
+            template <typename Sdf>
+            NODISCARD std::vector<march_result> march(const std::vector<ray>& rays, const Sdf& shape) const
+            {
+                std::vector<march_result> results(rays.size());
+                march(rays.data(), rays.size(), shape, results.data());
+                return results;
+            }
+
+            /**
+             * \brief marches many rays against a shape, the results are allocated in an arena
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param rays rays to march
+             * \param shape shape to march against
+             * \param arena arena for the results
+             * \return one result per ray
+             */
+            template <typename Sdf>
+            NODISCARD arena_vector<march_result> march(const std::vector<ray>& rays, const Sdf& shape,
+                                                       arena& arena) const
+            {
+                arena_vector<march_result> results(rays.size(), arena_allocator<march_result>(arena));
+                march(rays.data(), rays.size(), shape, results.data());
+                return results;
+            }
+
+            /**
+             * \brief shoots a ray through every pixel of a camera and marches them against a shape
+             * \note pixels are marched in packets of horizontal neighbours, rows are marched in parallel
+             * \tparam Sdf shape with a distance(point3d) function, see sdf
+             * \param camera camera to shoot the rays with
+             * \param distance distance (tmax) of every ray
+             * \param shape shape to march against
+             * \return one result per pixel, row major (index = y * width + x)
+             */
+            template <typename Sdf>
+            NODISCARD std::vector<march_result> march(const camera& camera, const double distance,
+                                                      const Sdf& shape) const
+            {
+                const unsigned int width = camera.get_screen_width();
+                const unsigned int height = camera.get_screen_height();
+                std::vector<march_result> results(static_cast<std::size_t>(width) * height);
+
+                parallel::for_each_index(height, [&](const std::size_t y)
+                {
+                    std::vector<ray> packet;
+                    packet.reserve(packet_size);
+
+                    for (unsigned int x = 0; x < width; x += packet_size)
+                    {
+                        packet.clear();
+                        for (unsigned int lane = x; lane < width && lane < x + packet_size; ++lane)
+                            packet.push_back(camera.shoot_ray(lane, static_cast<unsigned int>(y), distance));
+
+                        march_packet(packet.data(), packet.size(), shape, results.data() + y * width + x);
+                    }
+                }, 1);
+
+                return results;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_max_steps() const noexcept { return max_steps_; }
+            NODISCARD double get_hit_epsilon() const noexcept { return hit_epsilon_; }
+            NODISCARD double get_relaxation() const noexcept { return relaxation_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/sphere.h"
+#include "BardCore/utility/parallel.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief bounding spheres of many sub meshes that share one point array, the sub meshes run in parallel
+         * \note sub mesh i is [offsets[i], offsets[i + 1]) of the points, so there is one more offset than sub meshes
+         * \note this class only has static functions, it can't be constructed
+         */
+        class sphere_batch final
+        {
+        public:
+            sphere_batch() = delete;
+
+            /**
+             * \brief minimum amount of sub meshes per thread
+             */
+            INLINE static constexpr std::size_t grain = 16;
+
+        private:
+            /**
+             * \brief helper function for validating the offsets
+             * \throws out_of_range_exception if offsets is empty, decreasing or past the end of points
+             */
+            static void check_offsets(const std::vector<point3d>& points, const std::vector<std::size_t>& offsets)
+            {
+                if (offsets.empty())
+                    throw exception::out_of_range_exception("offsets needs at least one offset");
+
+                for (std::size_t index = 0; index < offsets.size(); ++index)
+                {
+                    if (offsets[index] > points.size())
+                        throw exception::out_of_range_exception("offset is past the end of points");
+                    if (index > 0 && offsets[index] < offsets[index - 1])
+                        throw exception::out_of_range_exception("offsets must not decrease");
+                }
+            }
+
+        public:
+            /**
+             * \brief calculates the Ritter sphere of every sub mesh, see sphere::ritter
+             * \throws out_of_range_exception if offsets is empty, decreasing or past the end of points
+             * \param points points of all sub meshes
+             * \param offsets start of every sub mesh, followed by the end of the last one
+             * \return one sphere per sub mesh
+             */
+            NODISCARD static std::vector<sphere> ritter(const std::vector<point3d>& points,
+                                                        const std::vector<std::size_t>& offsets)
+            {
+                check_offsets(points, offsets);
+
+                std::vector<sphere> spheres(offsets.size() - 1);
+                parallel::for_each_index(spheres.size(), [&](const std::size_t index)
+                {
+                    spheres[index] = sphere::ritter(points.data() + offsets[index],
+                                                    offsets[index + 1] - offsets[index]);
+                }, grain);
+
+                return spheres;
+            }
+
+            /**
+             * \brief calculates the smallest sphere of every sub mesh, see sphere::welzl
+             * \throws out_of_range_exception if offsets is empty, decreasing or past the end of points
+             * \param points points of all sub meshes
+             * \param offsets start of every sub mesh, followed by the end of the last one
+             * \return one sphere per sub mesh
+             */
+            NODISCARD static std::vector<sphere> welzl(const std::vector<point3d>& points,
+                                                       const std::vector<std::size_t>& offsets)
+            {
+                check_offsets(points, offsets);
+
+                std::vector<sphere> spheres(offsets.size() - 1);
+                parallel::for_each_index(spheres.size(), [&](const std::size_t index)
+                {
+                    spheres[index] = sphere::welzl(points.data() + offsets[index],
+                                                   offsets[index + 1] - offsets[index]);
+                }, grain);
+
+                return spheres;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/exception/zero_exception.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief reuses the shading of the previous frame when the camera moves a little (temporal reprojection)
+         *
+         * every frame starts with reproject: the hit positions of the previous frame are projected into the new camera
+         * and carry their color to the pixel they land on, the closest position wins when several land on one pixel.
+         * pixels that received nothing (disoccluded, or new at the border of the screen) are listed by get_retrace,
+         * together with a rolling 1 / refresh_interval of the screen, so every pixel is traced again at least once per
+         * refresh_interval frames (e.g. for moving objects), only those pixels are traced and stored again
+         * \note for a ray that hits nothing, store the end of the ray as position, so the background is reused too
+         * \note colors are rgb in a vector3d
+         */
+        class temporal_reprojection
+        {
+        public:
+            /**
+             * \brief default amount of frames in which every pixel is traced again once
+             */
+            INLINE static constexpr std::uint32_t default_refresh_interval = 32;
+
+            /**
+             * \brief pixel index for a position that isn't on the screen
+             */
+            INLINE static constexpr std::uint32_t no_pixel = 0xFFFFFFFFu;
+
+            /**
+             * \brief amount of positions per thread when projecting
+             */
+            INLINE static constexpr std::size_t grain = 4096;
+
+        protected:
+            unsigned int screen_width_ = 0, screen_height_ = 0;
+            std::uint32_t refresh_interval_ = default_refresh_interval;
+            std::uint32_t frame_ = 0; // frames since construction, selects the pixels that are refreshed
+
+            // current frame, per pixel, row major
+            std::vector<point3d> positions_{};
+            std::vector<vector3d> colors_{};
+            std::vector<std::uint32_t> samples_{}; // amount of samples in the color
+            std::vector<std::uint8_t> valid_{}; // 1 if the pixel has a position and color
+
+            // previous frame, swapped with the current frame by reproject
+            std::vector<point3d> previous_positions_{};
+            std::vector<vector3d> previous_colors_{};
+            std::vector<std::uint32_t> previous_samples_{};
+            std::vector<std::uint8_t> previous_valid_{};
+
+            std::vector<std::uint32_t> targets_{}; // pixel every previous pixel lands on
+            std::vector<std::uint32_t> second_targets_{}; // next nearest pixel, filled if nothing else lands there
+            std::vector<double> depths_{}; // squared distance of every previous position to the new camera
+            std::vector<std::uint32_t> retrace_{};
+
+        private:
+            /**
+             * \brief helper function for checking a pixel index
+             */
+            void check_pixel(const std::size_t pixel) const
+            {
+                if (pixel >= pixel_count())
+                    throw exception::out_of_range_exception("pixel is past the end of the screen");
+            }
+
+            /**
+             * \brief helper function for the nearest and the next nearest pixel of a screen position
+             */
+            void nearest_pixels(const double x, const double y, std::uint32_t& nearest,
+                                std::uint32_t& second) const noexcept
+            {
+                const long nearest_x = std::lround(x), nearest_y = std::lround(y);
+                nearest = static_cast<std::uint32_t>(nearest_y) * screen_width_ + static_cast<std::uint32_t>(nearest_x);
+
+                // the neighbour on the side of the axis the position is farthest off center
+                const double offset_x = x - static_cast<double>(nearest_x);
+                const double offset_y = y - static_cast<double>(nearest_y);
+                const bool horizontal = std::abs(offset_x) >= std::abs(offset_y);
+                const long second_x = horizontal ? nearest_x + (offset_x < 0 ? -1 : 1) : nearest_x;
+                const long second_y = horizontal ? nearest_y : nearest_y + (offset_y < 0 ? -1 : 1);
+                second = second_x >= 0 && second_x < static_cast<long>(screen_width_) && second_y >= 0 &&
+                         second_y < static_cast<long>(screen_height_)
+                             ? static_cast<std::uint32_t>(second_y) * screen_width_ + static_cast<std::uint32_t>(
+                                 second_x)
+                             : no_pixel;
+            }
+
+            /**
+             * \brief helper function for moving a previous pixel to a target, if nothing closer is there with the same mark
+             */
+            void splat(const std::size_t source, const std::uint32_t target, const std::uint8_t mark,
+                       const point3d& eye)
+            {
+                if (valid_[target] && (valid_[target] != mark || eye.distance_squared(positions_[target]) <=
+                    depths_[source]))
+                    return;
+
+                positions_[target] = previous_positions_[source];
+                colors_[target] = previous_colors_[source];
+                samples_[target] = previous_samples_[source];
+                valid_[target] = mark;
+            }
+
+        public:
+            temporal_reprojection() = default;
+
+            /**
+             * \brief constructor, nothing can be reused until the first frame is stored
+             * \throws zero_exception if width, height or refresh_interval is zero
+             * \param screen_width width of the screen, the same as the camera
+             * \param screen_height height of the screen, the same as the camera
+             * \param refresh_interval every pixel is traced again once in this amount of frames,
+             *                         e.g. to pick up moving objects and lighting changes
+             */
+            temporal_reprojection(const unsigned int screen_width, const unsigned int screen_height,
+                                  const std::uint32_t refresh_interval = default_refresh_interval) :
+                screen_width_(screen_width), screen_height_(screen_height), refresh_interval_(refresh_interval)
+            {
+                if (screen_width == 0 || screen_height == 0)
+                    throw exception::zero_exception("width and height must be greater than 0");
+                if (refresh_interval == 0)
+                    throw exception::zero_exception("refresh_interval must be greater than 0");
+
+                const std::size_t pixels = pixel_count();
+                positions_.resize(pixels);
+                colors_.resize(pixels);
+                samples_.resize(pixels, 0u);
+                valid_.resize(pixels, 0);
+                previous_positions_.resize(pixels);
+                previous_colors_.resize(pixels);
+                previous_samples_.resize(pixels, 0u);
+                previous_valid_.resize(pixels, 0);
+                targets_.resize(pixels);
+                second_targets_.resize(pixels);
+                depths_.resize(pixels, 0.);
+                retrace_.reserve(pixels);
+            }
+
+            /**
+             * \brief starts a new frame, moves the previous frame to the new camera, projections run in parallel
+             * \throws out_of_range_exception if the screen size of the camera is not the screen size of the reprojection
+             * \param camera camera of the new frame
+             * \return pixels to trace and store in this frame, see get_retrace
+             */
+            const std::vector<std::uint32_t>& reproject(const camera& camera)
+            {
+                if (camera.get_screen_width() != screen_width_ || camera.get_screen_height() != screen_height_)
+                    throw exception::out_of_range_exception("the camera must have the screen size of the reprojection");
+
+                positions_.swap(previous_positions_);
+                colors_.swap(previous_colors_);
+                samples_.swap(previous_samples_);
+                valid_.swap(previous_valid_);
+
+                const std::size_t pixels = pixel_count();
+                const point3d& eye = camera.get_position();
+                parallel::for_each_chunk(pixels, [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t pixel = begin; pixel < end; ++pixel)
+                    {
+                        double x = 0, y = 0;
+                        targets_[pixel] = second_targets_[pixel] = no_pixel;
+                        if (previous_valid_[pixel] && camera.project(previous_positions_[pixel], x, y))
+                            nearest_pixels(x, y, targets_[pixel], second_targets_[pixel]);
+                        depths_[pixel] = eye.distance_squared(previous_positions_[pixel]);
+                    }
+                }, grain);
+
+                // scatter, the closest position wins a pixel, positions behind it were occluded. when the camera
+                // turns or zooms, rounding lands some positions on the same pixel and leaves a neighbour empty,
+                // so the next nearest pixel is filled in a second pass if nothing landed there (marked with 2)
+                std::fill(valid_.begin(), valid_.end(), std::uint8_t{0});
+                for (std::size_t pixel = 0; pixel < pixels; ++pixel)
+                    if (targets_[pixel] != no_pixel)
+                        splat(pixel, targets_[pixel], 1, eye);
+                for (std::size_t pixel = 0; pixel < pixels; ++pixel)
+                    if (second_targets_[pixel] != no_pixel)
+                        splat(pixel, second_targets_[pixel], 2, eye);
+
+                // the refreshed pixels are spread over the screen, (pixel + frame) % refresh_interval == 0
+                retrace_.clear();
+                const std::uint32_t refresh = frame_++ % refresh_interval_;
+                for (std::size_t pixel = 0; pixel < pixels; ++pixel)
+                {
+                    if (valid_[pixel] && (pixel + refresh) % refresh_interval_ != 0)
+                    {
+                        valid_[pixel] = 1;
+                        continue;
+                    }
+
+                    valid_[pixel] = 0;
+                    retrace_.push_back(static_cast<std::uint32_t>(pixel));
+                }
+
+                return retrace_;
+            }
+
+            /**
+             * \brief stores the traced result of a pixel in the current frame
+             * \throws out_of_range_exception if pixel is past the end of the screen
+             * \param pixel pixel index (y * width + x)
+             * \param position hit position, or the end of the ray for a miss
+             * \param color shaded color
+             */
+            void store(const std::size_t pixel, const point3d& position, const vector3d& color)
+            {
+                check_pixel(pixel);
+
+                positions_[pixel] = position;
+                colors_[pixel] = color;
+                samples_[pixel] = 1;
+                valid_[pixel] = 1;
+            }
+
+            /**
+             * \brief adds a sample to the accumulated color of a valid pixel, e.g. a new jittered sample for a reused pixel
+             * \throws out_of_range_exception if pixel is past the end of the screen or the pixel isn't valid
+             * \param pixel pixel index (y * width + x)
+             * \param color shaded color of the sample
+             */
+            void add_sample(const std::size_t pixel, const vector3d& color)
+            {
+                check_pixel(pixel);
+                if (!valid_[pixel])
+                    throw exception::out_of_range_exception("the pixel must be stored before samples are added");
+
+                // running mean
+                ++samples_[pixel];
+                colors_[pixel] += (color - colors_[pixel]) / static_cast<double>(samples_[pixel]);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_screen_width() const noexcept { return screen_width_; }
+            NODISCARD unsigned int get_screen_height() const noexcept { return screen_height_; }
+            NODISCARD std::uint32_t get_refresh_interval() const noexcept { return refresh_interval_; }
+            NODISCARD std::size_t pixel_count() const noexcept
+            {
+                return static_cast<std::size_t>(screen_width_) * screen_height_;
+            }
+
+            NODISCARD const std::vector<std::uint32_t>& get_retrace() const noexcept { return retrace_; }
+            NODISCARD const std::vector<point3d>& get_positions() const noexcept { return positions_; }
+            NODISCARD const std::vector<vector3d>& get_colors() const noexcept { return colors_; }
+            NODISCARD const std::vector<std::uint32_t>& get_samples() const noexcept { return samples_; }
+            NODISCARD const std::vector<std::uint8_t>& get_valid() const noexcept { return valid_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/triangle.h"
+#include "BardCore/utility/arena.h"
+#include "BardCore/utility/bvh.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/triangle_pack.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief result of a closest point query on a mesh
+         */
+        struct closest_point_result
+        {
+            point3d point{}; // closest point on the mesh
+            double distance = math::inf; // unsigned distance from the query point to point
+            std::uint32_t triangle = bvh::no_primitive; // triangle containing point, no_primitive for an empty mesh
+        };
+
+        /**
+         * \brief result of intersecting a ray with a mesh
+         */
+        struct mesh_hit
+        {
+            bool hit = false; // true if a triangle was hit
+            double distance = 0; // distance along the ray
+            double u = 0, v = 0; // barycentric coordinates of the hit, see triangle::intersect
+            std::uint32_t triangle = bvh::no_primitive; // triangle that was hit
+        };
+
+        /**
+         * \brief indexed triangle mesh with a bvh for ray and closest point queries
+         * \note the mesh is immutable after construction, the bvh is built in the constructor
+         * \note ray and closest point queries share the bvh, its subtrees of up to pack_width triangles
+         *       (or max_leaf_size if smaller) are single leaves, so a closest point query may test a few more
+         *       triangles per leaf than with a bvh split down to single triangles, the results are the same
+         */
+        class triangle_mesh
+        {
+        public:
+            /**
+             * \brief amount of triangles per pack, the triangles of a bvh leaf are tested a pack at a time
+             */
+            INLINE static constexpr std::size_t pack_width = 4;
+
+        protected:
+            std::vector<point3d> vertices_; // vertex positions
+            std::vector<std::uint32_t> indices_; // three vertex indices per triangle
+            bvh bvh_{}; // bvh over the triangles
+            std::vector<triangle_pack<pack_width>> packs_{}; // triangles of the bvh leaves, leaf after leaf
+            std::vector<std::uint32_t> leaf_packs_{}; // first pack of a leaf, by the first primitive of the leaf
+
+        public:
+            /**
+             * \brief constructor for triangle mesh
+             * \throws out_of_range_exception if the amount of indices is not a multiple of 3
+             * \throws out_of_range_exception if an index is not a vertex
+             * \param vertices vertex positions
+             * \param indices three vertex indices per triangle
+             * \param max_leaf_size maximum amount of triangles per bvh leaf, a subtree with at most
+             *                      min(max_leaf_size, pack_width) triangles is always a single leaf
+             * \param node_options huge pages and NUMA placement of the bvh nodes
+             */
+            triangle_mesh(std::vector<point3d> vertices, std::vector<std::uint32_t> indices,
+                          const unsigned int max_leaf_size = 4,
+                          const page_options& node_options = bvh::default_node_options())
+                : vertices_(std::move(vertices)), indices_(std::move(indices))
+            {
+                if (indices_.size() % 3 != 0)
+                    throw exception::out_of_range_exception("amount of indices must be a multiple of 3");
+
+                for (const std::uint32_t index : indices_)
+                    if (index >= vertices_.size())
+                        throw exception::out_of_range_exception("index is not a vertex");
+
+                std::vector<aabb> bounds;
+                bounds.reserve(triangle_count());
+                for (std::size_t index = 0; index < triangle_count(); ++index)
+                    bounds.push_back(get_triangle(index).bounds());
+
+                bvh_.set_node_options(node_options);
+                // leaves that fit in a pack are never split, a pack tests them as fast as a single triangle
+                bvh_.build(bounds, max_leaf_size, bvh_layout::depth_first,
+                           max_leaf_size < pack_width ? max_leaf_size : static_cast<unsigned int>(pack_width));
+
+                leaf_packs_.assign(triangle_count(), 0);
+                for (const bvh_node& node : bvh_.get_nodes())
+                {
+                    if (!node.is_leaf())
+                        continue;
+
+                    leaf_packs_[node.first] = static_cast<std::uint32_t>(packs_.size());
+                    for (std::uint32_t first = node.first; first < node.first + node.count; first += pack_width)
+                    {
+                        triangle_pack<pack_width> pack;
+                        for (std::uint32_t index = first; index < node.first + node.count && index < first +
+                             pack_width; ++index)
+                        {
+                            const std::uint32_t primitive = bvh_.get_primitives()[index];
+                            pack.set(index - first, get_triangle(primitive), primitive);
+                        }
+                        packs_.push_back(pack);
+                    }
+                }
+            }
+
+            /**
+             * \brief gets a triangle
+             * \note no bounds check
+             * \param index index of the triangle
+             * \return triangle
+             */
+            NODISCARD triangle get_triangle(const std::size_t index) const noexcept
+            {
+                return {
+                    vertices_[indices_[3 * index]], vertices_[indices_[3 * index + 1]],
+                    vertices_[indices_[3 * index + 2]]
+                };
+            }
+
+            /**
+             * \brief finds the closest point on the mesh to a point
+             * \note children are visited nearest first, nodes farther than the current best are skipped
+             * \param point query point
+             * \param max_distance only points within this distance are considered
+             * \return closest point, triangle is no_primitive if nothing is within max_distance
+             */
+            NODISCARD closest_point_result closest_point(const point3d& point,
+                                                         const double max_distance = math::inf) const
+            {
+                closest_point_result result;
+                double best_distance_squared = max_distance * max_distance;
+
+                result.triangle = bvh_.nearest(point, [this, &point](const std::uint32_t primitive)
+                {
+                    return get_triangle(primitive).closest_point(point).distance_squared(point);
+                }, best_distance_squared);
+
+                if (result.triangle != bvh::no_primitive)
+                {
+                    result.point = get_triangle(result.triangle).closest_point(point);
+                    result.distance = std::sqrt(best_distance_squared);
+                }
+
+                return result;
+            }
+
+            /**
+             * \brief finds the closest point on the mesh for many points, the points are queried in parallel
+             * \param points query points
+             * \param count amount of query points
+             * \param results output, room for count results
+             * \param max_distance only points within this distance are considered
+             */
+            void closest_points(const point3d* points, const std::size_t count, closest_point_result* results,
+                                const double max_distance = math::inf) const
+            {
+                parallel::for_each_index(count, [&](const std::size_t index)
+                {
+                    results[index] = closest_point(points[index], max_distance);
+                }, 256);
+            }
+
+            /**
+             * \brief finds the closest point on the mesh for many points, the points are queried in parallel
+             * \param points query points
+             * \param max_distance only points within this distance are considered
+             * \return closest point per query point
+             */
+            NODISCARD std::vector<closest_point_result> closest_points(const std::vector<point3d>& points,
+                                                                       const double max_distance = math::inf) const
+            {
+                std::vector<closest_point_result> results(points.size());
+                closest_points(points.data(), points.size(), results.data(), max_distance);
+                return results;
+            }
+
+            /**
+             * \brief finds the closest point on the mesh for many points, the results are allocated in an arena
+             * \param points query points
+             * \param arena arena for the results
+             * \param max_distance only points within this distance are considered
+             * \return closest point per query point
+             */
+            NODISCARD arena_vector<closest_point_result> closest_points(const std::vector<point3d>& points,
+                                                                        arena& arena,
+                                                                        const double max_distance = math::inf) const
+            {
+                arena_vector<closest_point_result> results(points.size(),
+                                                           arena_allocator<closest_point_result>(arena));
+                closest_points(points.data(), points.size(), results.data(), max_distance);
+                return results;
+            }
+
+            /**
+             * \brief calculates the unsigned distance from a point to the mesh
+             * \param point query point
+             * \return distance, inf for an empty mesh
+             */
+            NODISCARD double distance(const point3d& point) const
+            {
+                return closest_point(point).distance;
+            }
+
+            /**
+             * \brief calculates the unsigned distance to the mesh for many points, the points are queried in parallel
+             * \param points query points
+             * \param count amount of query points
+             * \param distances output, room for count distances
+             */
+            void distances(const point3d* points, const std::size_t count, double* distances) const
+            {
+                parallel::for_each_index(count, [&](const std::size_t index)
+                {
+                    distances[index] = distance(points[index]);
+                }, 256);
+            }
+
+            /**
+             * \brief calculates the unsigned distance to the mesh for many points, the points are queried in parallel
+             * \param points query points
+             * \return distance per point
+             */
+            NODISCARD std::vector<double> distances(const std::vector<point3d>& points) const
+            {
+                std::vector<double> results(points.size());
+                distances(points.data(), points.size(), results.data());
+                return results;
+            }
+
+            /**
+             * \brief calculates the unsigned distance to the mesh for many points, the results are allocated in an arena
+             * \param points query points
+             * \param arena arena for the results
+             * \return distance per point
+             */
+            NODISCARD arena_vector<double> distances(const std::vector<point3d>& points, arena& arena) const
+            {
+                arena_vector<double> results(points.size(), arena_allocator<double>(arena));
+                distances(points.data(), points.size(), results.data());
+                return results;
+            }
+
+            /**
+             * \brief finds the closest triangle hit by a ray
+             * \note the triangles of a leaf are tested pack_width at a time, see triangle_pack
+             * \param ray ray to intersect, only [0, distance] is tested
+             * \return hit, hit is false if nothing was hit
+             */
+            NODISCARD mesh_hit intersect(const ray& ray) const
+            {
+                mesh_hit result;
+
+                result.triangle = bvh_.closest_hit_leaves(ray, [this, &ray, &result](const bvh_node& leaf,
+                                                                                    double& t_max)
+                {
+                    std::uint32_t closest = bvh::no_primitive;
+                    const triangle_pack<pack_width>* const first = packs_.data() + leaf_packs_[leaf.first];
+                    const triangle_pack<pack_width>* const last = first + (leaf.count + pack_width - 1) / pack_width;
+                    for (const triangle_pack<pack_width>* pack = first; pack != last; ++pack)
+                    {
+                        double t = 0, u = 0, v = 0;
+                        const std::size_t lane = pack->intersect(ray, t_max, t, u, v);
+                        if (lane == pack_width)
+                            continue;
+
+                        t_max = t;
+                        result.distance = t;
+                        result.u = u;
+                        result.v = v;
+                        closest = pack->triangles[lane];
+                    }
+                    return closest;
+                });
+
+                result.hit = result.triangle != bvh::no_primitive;
+                return result;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t triangle_count() const noexcept { return indices_.size() / 3; }
+            NODISCARD const std::vector<point3d>& get_vertices() const noexcept { return vertices_; }
+            NODISCARD const std::vector<std::uint32_t>& get_indices() const noexcept { return indices_; }
+            NODISCARD const bvh& get_bvh() const noexcept { return bvh_; }
+            NODISCARD const std::vector<triangle_pack<pack_width>>& get_packs() const noexcept { return packs_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
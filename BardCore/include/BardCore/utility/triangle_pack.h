@@ -0,0 +1,135 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/triangle.h"
+#include "BardCore/utility/hit_record.h"
+#include "BardCore/utility/ray.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief Width triangles stored as a structure of arrays, one ray is tested against all of them at once
+         *
+         * the intersection runs Möller–Trumbore for every lane without branches, so the compiler can map the lanes
+         * to simd registers (4 doubles for avx2, 8 for avx-512), the closest hit is then chosen by a horizontal
+         * minimum. bvh leaves hold a few triangles, so this gives simd for single incoherent rays
+         * \note unused lanes have no_primitive as triangle and are never hit
+         * \tparam Width amount of triangles, 4 or 8
+         */
+        template <std::size_t Width>
+        struct triangle_pack
+        {
+            static_assert(Width == 4 || Width == 8, "a triangle pack holds 4 or 8 triangles");
+
+            double a_x[Width], a_y[Width], a_z[Width]; // first vertex
+            double edge1_x[Width], edge1_y[Width], edge1_z[Width]; // b - a
+            double edge2_x[Width], edge2_y[Width], edge2_z[Width]; // c - a
+            std::uint32_t triangles[Width]; // triangle per lane, no_primitive for unused lanes
+
+            /**
+             * \brief constructs a pack with all lanes unused
+             */
+            triangle_pack() noexcept
+            {
+                for (std::size_t lane = 0; lane < Width; ++lane)
+                {
+                    a_x[lane] = a_y[lane] = a_z[lane] = 0;
+                    edge1_x[lane] = edge1_y[lane] = edge1_z[lane] = 0;
+                    edge2_x[lane] = edge2_y[lane] = edge2_z[lane] = 0;
+                    triangles[lane] = no_primitive;
+                }
+            }
+
+            /**
+             * \brief stores a triangle in a lane
+             * \throws out_of_range_exception if lane is not smaller than Width
+             * \param lane lane to store the triangle in
+             * \param triangle triangle to store
+             * \param index index of the triangle, returned by intersect
+             */
+            void set(const std::size_t lane, const triangle& triangle, const std::uint32_t index)
+            {
+                if (lane >= Width)
+                    throw exception::out_of_range_exception("lane must be smaller than the width of the pack");
+
+                const vector3d edge1 = triangle.a.get_vector(triangle.b);
+                const vector3d edge2 = triangle.a.get_vector(triangle.c);
+                a_x[lane] = triangle.a.x;
+                a_y[lane] = triangle.a.y;
+                a_z[lane] = triangle.a.z;
+                edge1_x[lane] = edge1.x;
+                edge1_y[lane] = edge1.y;
+                edge1_z[lane] = edge1.z;
+                edge2_x[lane] = edge2.x;
+                edge2_y[lane] = edge2.y;
+                edge2_z[lane] = edge2.z;
+                triangles[lane] = index;
+            }
+
+            /**
+             * \brief intersects a ray with all triangles (both faces), the same test as triangle::intersect
+             * \param ray ray to intersect
+             * \param t_max only hits in [0, t_max] are reported, e.g. the distance of the ray or the closest hit so far
+             * \param t output, distance along the ray of the closest hit
+             * \param u output, barycentric coordinate of b
+             * \param v output, barycentric coordinate of c
+             * \return lane of the closest hit, the first lane on a tie, Width if nothing was hit
+             */
+            NODISCARD std::size_t intersect(const ray& ray, const double t_max, double& t, double& u,
+                                            double& v) const noexcept
+            {
+                const double ox = ray.get_position().x, oy = ray.get_position().y, oz = ray.get_position().z;
+                const double dx = ray.get_direction().x, dy = ray.get_direction().y, dz = ray.get_direction().z;
+
+                double lane_t[Width], lane_u[Width], lane_v[Width];
+                for (std::size_t lane = 0; lane < Width; ++lane)
+                {
+                    // p = direction x edge2
+                    const double px = dy * edge2_z[lane] - dz * edge2_y[lane];
+                    const double py = dz * edge2_x[lane] - dx * edge2_z[lane];
+                    const double pz = dx * edge2_y[lane] - dy * edge2_x[lane];
+                    const double determinant = edge1_x[lane] * px + edge1_y[lane] * py + edge1_z[lane] * pz;
+                    const double inverse_determinant = 1. / determinant;
+
+                    // s = position - a, q = s x edge1
+                    const double sx = ox - a_x[lane], sy = oy - a_y[lane], sz = oz - a_z[lane];
+                    const double qx = sy * edge1_z[lane] - sz * edge1_y[lane];
+                    const double qy = sz * edge1_x[lane] - sx * edge1_z[lane];
+                    const double qz = sx * edge1_y[lane] - sy * edge1_x[lane];
+
+                    const double lu = (sx * px + sy * py + sz * pz) * inverse_determinant;
+                    const double lv = (dx * qx + dy * qy + dz * qz) * inverse_determinant;
+                    const double lt = (edge2_x[lane] * qx + edge2_y[lane] * qy + edge2_z[lane] * qz) *
+                        inverse_determinant;
+
+                    // & instead of && so the lane has no branches, nan from a zero determinant fails every test
+                    const bool hit = ((determinant <= -1e-12) | (determinant >= 1e-12)) & (lu >= 0) & (lu <= 1) &
+                        (lv >= 0) & (lu + lv <= 1) & (lt >= 0) & (lt <= t_max);
+                    lane_t[lane] = hit ? lt : math::inf;
+                    lane_u[lane] = lu;
+                    lane_v[lane] = lv;
+                }
+
+                // horizontal minimum, strictly smaller so the first lane wins a tie like a scalar loop
+                std::size_t closest = 0;
+                for (std::size_t lane = 1; lane < Width; ++lane)
+                    closest = lane_t[lane] < lane_t[closest] ? lane : closest;
+
+                if (lane_t[closest] == math::inf)
+                    return Width;
+
+                t = lane_t[closest];
+                u = lane_u[closest];
+                v = lane_v[closest];
+                return closest;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
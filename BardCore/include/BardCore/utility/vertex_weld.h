@@ -0,0 +1,243 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/flat_hash_map.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/point_hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief throughput of a welding pass
+         */
+        struct weld_statistics
+        {
+            std::size_t vertices = 0; // amount of input vertices
+            std::size_t unique_vertices = 0; // amount of vertices after welding
+            double seconds = 0; // time spent welding
+
+            /**
+             * \brief amount of input vertices welded per second
+             * \return vertices per second, 0 if no time was measured
+             */
+            NODISCARD double vertices_per_second() const noexcept
+            {
+                return seconds <= 0 ? 0. : static_cast<double>(vertices) / seconds;
+            }
+        };
+
+        /**
+         * \brief welded vertices with an index buffer into them
+         */
+        struct weld_result
+        {
+            std::vector<point3d> vertices; // unique vertices, in order of first occurrence
+            std::vector<std::uint32_t> indices; // index into vertices per input vertex or input index
+            weld_statistics statistics; // throughput of the welding
+        };
+
+        /**
+         * \brief merges duplicate vertices, vertices in the same epsilon cell become one vertex
+         *
+         * vertices are quantized with point_hash and divided in shards by their hash, every shard is welded by
+         * its own thread with a flat_hash_map, then the unique vertices are numbered in input order,
+         * so the result is the same as welding serially
+         * \note a welded vertex keeps the position of its first occurrence
+         * \note vertices closer than epsilon in neighbouring cells are not merged
+         * \note this class only has static functions, it can't be constructed
+         */
+        class vertex_weld final
+        {
+        private:
+            /**
+             * \brief helper function for the chunk of a range of count indices
+             */
+            NODISCARD static std::size_t chunk_begin(const std::size_t count, const std::size_t chunk,
+                                                     const std::size_t chunks) noexcept
+            {
+                return static_cast<std::size_t>(static_cast<unsigned long long>(count) * chunk / chunks);
+            }
+
+        public:
+            vertex_weld() = delete;
+
+            /**
+             * \brief minimum amount of vertices per thread
+             */
+            INLINE static constexpr std::size_t grain = 16384;
+
+            /**
+             * \brief amount of shards the vertices are divided in for welding in parallel, a power of two
+             */
+            INLINE static constexpr std::size_t shard_count = 64;
+
+            /**
+             * \brief welds vertices, e.g. the corners of a triangle soup, large batches run in parallel
+             * \throws zero_exception if epsilon is zero
+             * \throws negative_exception if epsilon is negative
+             * \throws out_of_range_exception if count doesn't fit in 32 bit indices
+             * \param points vertices
+             * \param count amount of vertices
+             * \param epsilon size of the welding cells
+             * \return unique vertices and an index per input vertex
+             */
+            NODISCARD static weld_result weld(const point3d* points, const std::size_t count, const double epsilon)
+            {
+                const point_hash hasher(epsilon);
+                if (count > (std::numeric_limits<std::uint32_t>::max)())
+                    throw exception::out_of_range_exception("count doesn't fit in 32 bit indices");
+
+                const auto start = std::chrono::steady_clock::now();
+
+                const std::size_t chunks = (std::min)(static_cast<std::size_t>(parallel::thread_count()) * 4,
+                                                      (count + grain - 1) / grain);
+                const std::size_t shards = chunks <= 1 ? 1 : shard_count;
+
+                // shard of every vertex, and a histogram of the shards per chunk
+                std::vector<std::uint8_t> shard_of(count);
+                std::vector<std::size_t> offsets(shards * chunks + 1, 0);
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    for (std::size_t index = chunk_begin(count, chunk, chunks);
+                         index < chunk_begin(count, chunk + 1, chunks); ++index)
+                    {
+                        const std::size_t shard = static_cast<std::size_t>(
+                            hasher.hash(hasher.quantize(points[index])) & (shards - 1));
+                        shard_of[index] = static_cast<std::uint8_t>(shard);
+                        ++offsets[shard * chunks + chunk + 1];
+                    }
+                }, 1);
+
+                for (std::size_t index = 1; index < offsets.size(); ++index)
+                    offsets[index] += offsets[index - 1];
+
+                // stable scatter, so every shard lists its vertices in increasing order
+                std::vector<std::uint32_t> order(count);
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    std::vector<std::size_t> cursor(shards);
+                    for (std::size_t shard = 0; shard < shards; ++shard)
+                        cursor[shard] = offsets[shard * chunks + chunk];
+
+                    for (std::size_t index = chunk_begin(count, chunk, chunks);
+                         index < chunk_begin(count, chunk + 1, chunks); ++index)
+                        order[cursor[shard_of[index]]++] = static_cast<std::uint32_t>(index);
+                }, 1);
+
+                // the first vertex of a cell represents all vertices of the cell
+                std::vector<std::uint32_t> representative(count);
+                parallel::for_each_index(shards, [&](const std::size_t shard)
+                {
+                    const std::size_t begin = offsets[shard * chunks];
+                    const std::size_t end = offsets[(shard + 1) * chunks];
+
+                    flat_hash_map<quantized_point, std::uint32_t, point_hash> cells(end - begin, hasher);
+                    for (std::size_t position = begin; position < end; ++position)
+                    {
+                        const std::uint32_t index = order[position];
+                        representative[index] = *cells.insert(hasher.quantize(points[index]), index).first;
+                    }
+                }, 1);
+
+                // number the representatives in input order
+                std::vector<std::size_t> firsts(chunks + 1, 0);
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    for (std::size_t index = chunk_begin(count, chunk, chunks);
+                         index < chunk_begin(count, chunk + 1, chunks); ++index)
+                        firsts[chunk + 1] += representative[index] == index;
+                }, 1);
+
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                    firsts[chunk + 1] += firsts[chunk];
+
+                weld_result result;
+                result.vertices.resize(firsts[chunks]);
+                result.indices.resize(count);
+                parallel::for_each_index(chunks, [&](const std::size_t chunk)
+                {
+                    std::size_t next = firsts[chunk];
+                    for (std::size_t index = chunk_begin(count, chunk, chunks);
+                         index < chunk_begin(count, chunk + 1, chunks); ++index)
+                    {
+                        if (representative[index] != index)
+                            continue;
+
+                        result.vertices[next] = points[index];
+                        result.indices[index] = static_cast<std::uint32_t>(next++);
+                    }
+                }, 1);
+
+                // the representative is numbered in the previous pass, possibly by another chunk
+                parallel::for_each_chunk(count, [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                        if (representative[index] != index)
+                            result.indices[index] = result.indices[representative[index]];
+                }, grain);
+
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                result.statistics.vertices = count;
+                result.statistics.unique_vertices = result.vertices.size();
+                result.statistics.seconds = elapsed.count();
+                return result;
+            }
+
+            /**
+             * \brief welds vertices, e.g. the corners of a triangle soup, large batches run in parallel
+             * \throws zero_exception if epsilon is zero
+             * \throws negative_exception if epsilon is negative
+             * \param points vertices
+             * \param epsilon size of the welding cells
+             * \return unique vertices and an index per input vertex
+             */
+            NODISCARD static weld_result weld(const std::vector<point3d>& points, const double epsilon)
+            {
+                return weld(points.data(), points.size(), epsilon);
+            }
+
+            /**
+             * \brief welds the vertices of an indexed mesh and remaps its index buffer
+             * \note unused vertices are kept
+             * \throws zero_exception if epsilon is zero
+             * \throws negative_exception if epsilon is negative
+             * \throws out_of_range_exception if an index is not a vertex
+             * \param points vertices
+             * \param indices index buffer, e.g. 3 per triangle
+             * \param epsilon size of the welding cells
+             * \return unique vertices and the remapped index buffer
+             */
+            NODISCARD static weld_result weld(const std::vector<point3d>& points,
+                                              const std::vector<std::uint32_t>& indices, const double epsilon)
+            {
+                for (const std::uint32_t index : indices)
+                    if (index >= points.size())
+                        throw exception::out_of_range_exception("index is not a vertex");
+
+                weld_result result = weld(points, epsilon);
+                const std::vector<std::uint32_t> remap = std::move(result.indices);
+
+                result.indices.resize(indices.size());
+                parallel::for_each_chunk(indices.size(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    for (std::size_t index = begin; index < end; ++index)
+                        result.indices[index] = remap[indices[index]];
+                }, grain);
+
+                return result;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
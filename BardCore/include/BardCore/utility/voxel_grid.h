@@ -0,0 +1,329 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/aabb.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief a cell visited by a ray, with the distances where the ray enters and leaves the cell
+         */
+        struct voxel_hit
+        {
+            unsigned int x = 0, y = 0, z = 0; // cell coordinates
+            std::size_t index = 0; // linear cell index, x + y * width + z * width * height
+            double t_enter = 0; // distance along the ray where it enters the cell
+            double t_exit = 0; // distance along the ray where it leaves the cell
+        };
+
+        /**
+         * \brief 3D-DDA of Amanatides and Woo over a regular grid of cubic cells
+         * \note read more at http://www.cse.yorku.ca/~amana/research/grid.pdf
+         * \note this class only has static functions, it can't be constructed
+         */
+        class grid_traversal final
+        {
+        public:
+            grid_traversal() = delete;
+
+            /**
+             * \brief walks every cell of a grid a ray segment passes through, in order
+             * \tparam Callback callable with signature bool(const voxel_hit&), return false to stop the traversal
+             * \param grid_origin minimum corner of the grid
+             * \param cell_size size of a cell
+             * \param width amount of cells in x
+             * \param height amount of cells in y
+             * \param depth amount of cells in z
+             * \param origin origin of the ray
+             * \param direction normalized direction of the ray
+             * \param t_min start of the segment along the ray
+             * \param t_max end of the segment along the ray
+             * \param callback function called per cell
+             * \return amount of visited cells
+             */
+            template <typename Callback>
+            static std::size_t traverse(const point3d& grid_origin, const double cell_size, const unsigned int width,
+                                        const unsigned int height, const unsigned int depth, const point3d& origin,
+                                        const vector3d& direction, const double t_min, const double t_max,
+                                        Callback&& callback)
+            {
+                const vector3d inverse_direction = {1. / direction.x, 1. / direction.y, 1. / direction.z};
+                const aabb bounds = {
+                    grid_origin,
+                    {
+                        grid_origin.x + width * cell_size, grid_origin.y + height * cell_size,
+                        grid_origin.z + depth * cell_size
+                    }
+                };
+
+                double t_enter = 0, t_exit = 0;
+                if (!bounds.intersect(origin, inverse_direction, t_max, t_enter, t_exit))
+                    return 0;
+
+                t_enter = (std::max)(t_enter, t_min);
+                if (t_enter > t_exit)
+                    return 0;
+
+                // start cell, clamped because the entry point can be on the far border due to rounding
+                const auto start_cell = [cell_size](const double position, const double axis_origin,
+                                                    const unsigned int cells)
+                {
+                    const double cell = std::floor((position - axis_origin) / cell_size);
+                    return static_cast<long long>((std::min)((std::max)(cell, 0.), static_cast<double>(cells - 1)));
+                };
+
+                const unsigned int dimensions[3] = {width, height, depth};
+                const double axis_origin[3] = {grid_origin.x, grid_origin.y, grid_origin.z};
+                const double ray_origin[3] = {origin.x, origin.y, origin.z};
+                const double ray_direction[3] = {direction.x, direction.y, direction.z};
+                const double ray_inverse[3] = {inverse_direction.x, inverse_direction.y, inverse_direction.z};
+
+                long long cell[3];
+                long long step[3];
+                double t_next[3]; // distance to the next cell border per axis
+                double t_delta[3]; // distance between two cell borders per axis
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const double entry = ray_origin[axis] + ray_direction[axis] * t_enter;
+                    cell[axis] = start_cell(entry, axis_origin[axis], dimensions[axis]);
+
+                    if (ray_direction[axis] > 0)
+                    {
+                        step[axis] = 1;
+                        const double border = axis_origin[axis] + static_cast<double>(cell[axis] + 1) * cell_size;
+                        t_next[axis] = (border - ray_origin[axis]) * ray_inverse[axis];
+                        t_delta[axis] = cell_size * ray_inverse[axis];
+                    }
+                    else if (ray_direction[axis] < 0)
+                    {
+                        step[axis] = -1;
+                        const double border = axis_origin[axis] + static_cast<double>(cell[axis]) * cell_size;
+                        t_next[axis] = (border - ray_origin[axis]) * ray_inverse[axis];
+                        t_delta[axis] = -cell_size * ray_inverse[axis];
+                    }
+                    else
+                    {
+                        step[axis] = 0;
+                        t_next[axis] = math::inf;
+                        t_delta[axis] = math::inf;
+                    }
+                }
+
+                std::size_t visited = 0;
+                double t = t_enter;
+
+                // a segment that ends on a border gives no zero length cell behind it
+                while (t < t_exit)
+                {
+                    // axis with the closest border
+                    const int axis = t_next[0] < t_next[1]
+                                         ? (t_next[0] < t_next[2] ? 0 : 2)
+                                         : (t_next[1] < t_next[2] ? 1 : 2);
+
+                    // a border at t (start on a border, or several borders crossed at once) gives no cell
+                    if (t_next[axis] > t)
+                    {
+                        voxel_hit hit;
+                        hit.x = static_cast<unsigned int>(cell[0]);
+                        hit.y = static_cast<unsigned int>(cell[1]);
+                        hit.z = static_cast<unsigned int>(cell[2]);
+                        hit.index = hit.x + static_cast<std::size_t>(width) *
+                            (hit.y + static_cast<std::size_t>(height) * hit.z);
+                        hit.t_enter = t;
+                        hit.t_exit = (std::min)(t_next[axis], t_exit);
+
+                        ++visited;
+                        if (!callback(static_cast<const voxel_hit&>(hit)))
+                            break;
+
+                        t = t_next[axis];
+                    }
+
+                    cell[axis] += step[axis];
+                    if (cell[axis] < 0 || cell[axis] >= static_cast<long long>(dimensions[axis]))
+                        break;
+
+                    t_next[axis] += t_delta[axis];
+                }
+
+                return visited;
+            }
+        };
+
+        /**
+         * \brief dense voxel grid, stores a value of type T per cell
+         *
+         * the grid starts at origin and every cell is a cube of cell_size,
+         * rays are traversed with the 3D-DDA of Amanatides and Woo (grid_traversal)
+         * \tparam T value per cell, e.g. unsigned char for occupancy (std::vector<bool> has no references)
+         */
+        template <typename T>
+        class voxel_grid
+        {
+        protected:
+            point3d origin_; // minimum corner of the grid
+            double cell_size_; // size of a cell on every axis
+            unsigned int width_, height_, depth_; // amount of cells in x, y and z
+            std::vector<T> cells_; // x + y * width + z * width * height
+
+        public:
+            /**
+             * \brief constructor for voxel grid
+             * \throws zero_exception if width, height or depth is zero
+             * \throws negative_exception if cell_size is zero or negative
+             * \param origin minimum corner of the grid
+             * \param cell_size size of a cell
+             * \param width amount of cells in x
+             * \param height amount of cells in y
+             * \param depth amount of cells in z
+             * \param value initial value of every cell
+             */
+            voxel_grid(const point3d& origin, const double cell_size, const unsigned int width,
+                       const unsigned int height, const unsigned int depth, const T& value = T()) :
+                origin_(origin), cell_size_(cell_size), width_(width), height_(height), depth_(depth)
+            {
+                if (width == 0 || height == 0 || depth == 0)
+                    throw exception::zero_exception("width, height and depth must be greater than 0");
+                if (cell_size <= 0)
+                    throw exception::negative_exception("cell_size must be greater than 0");
+
+                cells_.assign(static_cast<std::size_t>(width) * height * depth, value);
+            }
+
+            /**
+             * \brief calculates the linear index of a cell
+             * \note no bounds check
+             * \return x + y * width + z * width * height
+             */
+            NODISCARD std::size_t index(const unsigned int x, const unsigned int y, const unsigned int z) const noexcept
+            {
+                return x + static_cast<std::size_t>(width_) * (y + static_cast<std::size_t>(height_) * z);
+            }
+
+            /**
+             * \brief gets a cell
+             * \throws out_of_range_exception if the cell is outside the grid
+             * \return value of the cell
+             */
+            NODISCARD T& at(const unsigned int x, const unsigned int y, const unsigned int z)
+            {
+                if (x >= width_ || y >= height_ || z >= depth_)
+                    throw exception::out_of_range_exception("cell is outside the grid");
+
+                return cells_[index(x, y, z)];
+            }
+
+            /**
+             * \brief gets a cell
+             * \throws out_of_range_exception if the cell is outside the grid
+             * \return value of the cell
+             */
+            NODISCARD const T& at(const unsigned int x, const unsigned int y, const unsigned int z) const
+            {
+                if (x >= width_ || y >= height_ || z >= depth_)
+                    throw exception::out_of_range_exception("cell is outside the grid");
+
+                return cells_[index(x, y, z)];
+            }
+
+            /**
+             * \brief finds the cell containing a point
+             * \param point point to look up
+             * \param x output, cell x
+             * \param y output, cell y
+             * \param z output, cell z
+             * \return true if the point is inside the grid
+             */
+            NODISCARD bool cell_of(const point3d& point, unsigned int& x, unsigned int& y, unsigned int& z) const noexcept
+            {
+                const double fx = std::floor((point.x - origin_.x) / cell_size_);
+                const double fy = std::floor((point.y - origin_.y) / cell_size_);
+                const double fz = std::floor((point.z - origin_.z) / cell_size_);
+
+                if (fx < 0 || fy < 0 || fz < 0 || fx >= width_ || fy >= height_ || fz >= depth_)
+                    return false;
+
+                x = static_cast<unsigned int>(fx);
+                y = static_cast<unsigned int>(fy);
+                z = static_cast<unsigned int>(fz);
+                return true;
+            }
+
+            /**
+             * \brief calculates the bounds of the grid
+             * \return aabb from origin to origin + size
+             */
+            NODISCARD aabb get_bounds() const noexcept
+            {
+                return {
+                    origin_,
+                    {origin_.x + width_ * cell_size_, origin_.y + height_ * cell_size_, origin_.z + depth_ * cell_size_}
+                };
+            }
+
+            /**
+             * \brief walks every cell a ray passes through, in order, between 0 and the ray distance
+             * \tparam Callback callable with signature bool(const voxel_hit&), return false to stop the traversal
+             * \param ray ray to traverse
+             * \param callback function called per cell
+             * \return amount of visited cells
+             */
+            template <typename Callback>
+            std::size_t traverse(const ray& ray, Callback&& callback) const
+            {
+                return grid_traversal::traverse(origin_, cell_size_, width_, height_, depth_, ray.get_position(),
+                                                ray.get_direction(), 0, ray.get_distance(),
+                                                std::forward<Callback>(callback));
+            }
+
+            /**
+             * \brief traverses many rays, the rays are traversed in parallel
+             * \note callback is called from multiple threads, but never concurrently for the same ray
+             * \tparam Callback callable with signature bool(std::size_t ray_index, const voxel_hit&), return false to stop that ray
+             * \param rays rays to traverse
+             * \param callback function called per ray per cell
+             * \return amount of visited cells per ray
+             */
+            template <typename Callback>
+            std::vector<std::size_t> traverse(const std::vector<ray>& rays, Callback&& callback) const
+            {
+                std::vector<std::size_t> visited(rays.size());
+
+                parallel::for_each_index(rays.size(), [&](const std::size_t ray_index)
+                {
+                    visited[ray_index] = traverse(rays[ray_index], [&](const voxel_hit& hit)
+                    {
+                        return callback(ray_index, hit);
+                    });
+                }, 64);
+
+                return visited;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const point3d& get_origin() const noexcept { return origin_; }
+            NODISCARD double get_cell_size() const noexcept { return cell_size_; }
+            NODISCARD unsigned int get_width() const noexcept { return width_; }
+            NODISCARD unsigned int get_height() const noexcept { return height_; }
+            NODISCARD unsigned int get_depth() const noexcept { return depth_; }
+            NODISCARD std::size_t size() const noexcept { return cells_.size(); }
+            NODISCARD std::vector<T>& get_cells() noexcept { return cells_; }
+            NODISCARD const std::vector<T>& get_cells() const noexcept { return cells_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
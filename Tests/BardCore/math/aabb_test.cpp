@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "BardCore/math/aabb.h"
+
+namespace testing
+{
+    TEST(aabb_test, constructor)
+    {
+        constexpr aabb empty;
+        EXPECT_TRUE(empty.is_empty());
+        EXPECT_EQ(0.0, empty.surface_area());
+
+        constexpr aabb box = aabb::from_points({1, -2, 3}, {-1, 2, -3});
+        EXPECT_FALSE(box.is_empty());
+        EXPECT_EQ(point3d(-1, -2, -3), box.minimum);
+        EXPECT_EQ(point3d(1, 2, 3), box.maximum);
+        EXPECT_EQ(point3d(0, 0, 0), box.center());
+        EXPECT_EQ(vector3d(2, 4, 6), box.extent());
+        EXPECT_NEAR(2 * (8 + 24 + 12), box.surface_area(), ROUND_EPSILON);
+    }
+
+    TEST(aabb_test, expand)
+    {
+        aabb box;
+        box.expand(point3d(1, 1, 1));
+        EXPECT_EQ(aabb({1, 1, 1}, {1, 1, 1}), box);
+
+        box.expand(point3d(-1, 2, 0));
+        EXPECT_EQ(aabb({-1, 1, 0}, {1, 2, 1}), box);
+
+        box.expand(aabb({0, 0, 0}, {5, 0.5, 0.5}));
+        EXPECT_EQ(aabb({-1, 0, 0}, {5, 2, 1}), box);
+    }
+
+    TEST(aabb_test, contains_overlaps_distance)
+    {
+        constexpr aabb box({0, 0, 0}, {1, 1, 1});
+
+        EXPECT_TRUE(box.contains({0.5, 0.5, 0.5}));
+        EXPECT_TRUE(box.contains({1, 1, 1}));
+        EXPECT_FALSE(box.contains({1.5, 0.5, 0.5}));
+
+        EXPECT_TRUE(box.contains(aabb({0.2, 0.2, 0.2}, {1, 1, 0.8})));
+        EXPECT_FALSE(box.contains(aabb({0.2, 0.2, 0.2}, {1.1, 1, 0.8})));
+
+        EXPECT_TRUE(box.overlaps(aabb({1, 1, 1}, {2, 2, 2})));
+        EXPECT_FALSE(box.overlaps(aabb({1.1, 0, 0}, {2, 1, 1})));
+
+        EXPECT_EQ(0.0, box.distance_squared({0.5, 0.5, 0.5}));
+        EXPECT_NEAR(4.0, box.distance_squared({3, 0.5, 0.5}), ROUND_EPSILON);
+        EXPECT_NEAR(3.0, box.distance_squared({-1, -1, -1}), ROUND_EPSILON);
+    }
+
+    TEST(aabb_test, intersect_ray)
+    {
+        constexpr aabb box({-1, -1, 4}, {1, 1, 6});
+        double t_enter = 0, t_exit = 0;
+
+        // inverse directions, 1 / 0 is inf
+        EXPECT_TRUE(box.intersect({0, 0, 0}, {math::inf, math::inf, 1}, 10, t_enter, t_exit));
+        EXPECT_NEAR(4.0, t_enter, ROUND_EPSILON);
+        EXPECT_NEAR(6.0, t_exit, ROUND_EPSILON);
+
+        // too short
+        EXPECT_FALSE(box.intersect({0, 0, 0}, {math::inf, math::inf, 1}, 3, t_enter, t_exit));
+
+        // missing
+        EXPECT_FALSE(box.intersect({0, 0, 0}, {math::inf, 1, math::inf}, 10, t_enter, t_exit));
+
+        // starting inside
+        EXPECT_TRUE(box.intersect({0, 0, 5}, {1, math::inf, math::inf}, 10, t_enter, t_exit));
+        EXPECT_NEAR(0.0, t_enter, ROUND_EPSILON);
+        EXPECT_NEAR(1.0, t_exit, ROUND_EPSILON);
+    }
+} // namespace testing
@@ -214,4 +214,41 @@ namespace testing
 
         ASSERT_THROW(quaternion::mirror(point, mirror_vector), exception::zero_exception);
     }
+
+    //test rotate with a rotation quaternion, same result as rotate_radians
+    TEST(quaternion_test, rotate_quaternion_test)
+    {
+        const vector3d axis = {1, 2, 3};
+        const point3d point = {-4, 5, 6};
+
+        const quaternion rotation = quaternion::from_axis_radians(axis, 0.7);
+
+        const point3d expected = quaternion::rotate_radians(point, axis, 0.7);
+        const point3d result = quaternion::rotate_quaternion(point, rotation);
+
+        ASSERT_NEAR(expected.x, result.x, ROUND_EPSILON);
+        ASSERT_NEAR(expected.y, result.y, ROUND_EPSILON);
+        ASSERT_NEAR(expected.z, result.z, ROUND_EPSILON);
+
+        //zero stays zero
+        ASSERT_EQ(point3d::zero(), quaternion::rotate_quaternion(point3d::zero(), rotation));
+    }
+
+    //test chaining rotation quaternions
+    TEST(quaternion_test, rotate_quaternion_chain_test)
+    {
+        const quaternion a = quaternion::from_axis_radians({0, 1, 0}, math::pi_2);
+        const quaternion b = quaternion::from_axis_radians({1, 1, 0}, 0.3);
+        const vector3d vector = {1, -2, 3};
+
+        const vector3d chained = quaternion::rotate_quaternion(quaternion::rotate_quaternion(vector, a), b);
+        const vector3d combined = quaternion::rotate_quaternion(vector, a.multiply(b));
+
+        ASSERT_NEAR(chained.x, combined.x, ROUND_EPSILON);
+        ASSERT_NEAR(chained.y, combined.y, ROUND_EPSILON);
+        ASSERT_NEAR(chained.z, combined.z, ROUND_EPSILON);
+
+        ASSERT_EQ(vector, quaternion::rotate_quaternion(vector, quaternion::identity()));
+        ASSERT_THROW((void)quaternion::from_axis_radians({0, 0, 0}, 1), exception::zero_exception);
+    }
 } // namespace testing
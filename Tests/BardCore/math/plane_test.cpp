@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "BardCore/math/plane.h"
+
+namespace testing
+{
+    TEST(plane_test, constructor)
+    {
+        const plane plane({0, 0, 2}, -4);
+        EXPECT_EQ(vector3d(0, 0, 1), plane.get_normal());
+        EXPECT_NEAR(-2.0, plane.get_d(), ROUND_EPSILON);
+
+        EXPECT_EQ(plane, plane::from_point_normal({5, 5, 2}, {0, 0, 3}));
+        EXPECT_EQ(plane, plane::from_points({0, 0, 2}, {1, 0, 2}, {0, 1, 2}));
+        EXPECT_EQ(plane.flip(), plane::from_points({0, 0, 2}, {0, 1, 2}, {1, 0, 2}));
+
+        EXPECT_THROW(bardcore::plane({0, 0, 0}, 1), exception::zero_exception);
+        EXPECT_THROW((void)plane::from_points({0, 0, 0}, {1, 1, 1}, {2, 2, 2}), exception::zero_exception);
+    }
+
+    TEST(plane_test, distance_classify)
+    {
+        const plane plane = plane::from_point_normal({1, 1, 1}, {1, 1, 0});
+
+        EXPECT_NEAR(math::sqrt_2, plane.distance({2, 2, 7}), ROUND_EPSILON);
+        EXPECT_NEAR(-math::sqrt_2, plane.distance({0, 0, 7}), ROUND_EPSILON);
+        EXPECT_EQ(plane_side::front, plane.classify({2, 2, 7}));
+        EXPECT_EQ(plane_side::back, plane.classify({0, 0, 7}));
+        EXPECT_EQ(plane_side::on, plane.classify({2, 0, 7}));
+        EXPECT_EQ(plane_side::on, plane.classify({1.05, 1, 7}, 0.1));
+        EXPECT_EQ(point3d(1, 1, 7), plane.project({2, 2, 7}));
+    }
+
+    TEST(plane_test, split)
+    {
+        const plane plane({1, 0, 0}, 0);
+        triangle front[2], back[2];
+
+        // one vertex behind, a quad in front
+        const triangle triangle({-1, 0, 0}, {1, 0, 0}, {1, 2, 0});
+        const split_counts counts = plane.split(triangle, front, back);
+        ASSERT_EQ(2u, counts.front);
+        ASSERT_EQ(1u, counts.back);
+        EXPECT_NEAR(triangle.area(), front[0].area() + front[1].area() + back[0].area(), ROUND_EPSILON);
+        EXPECT_GE(front[0].normal().z, 0.0);
+        EXPECT_GE(front[1].normal().z, 0.0);
+
+        // in the plane goes to the front, the back part can be dropped
+        EXPECT_EQ(1u, plane.split(bardcore::triangle({0, 0, 0}, {0, 1, 0}, {0, 0, 1}), front, back).front);
+        EXPECT_EQ(0u, plane.split(bardcore::triangle({0, 0, 0}, {0, 1, 0}, {0, 0, 1}), front, back).back);
+        EXPECT_EQ(0u, plane.split(bardcore::triangle({-1, 0, 0}, {-2, 0, 0}, {-1, 1, 0}), front, nullptr).front);
+    }
+} // namespace testing
@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "BardCore/math/sphere.h"
+
+#include <random>
+
+namespace testing
+{
+    static std::vector<point3d> random_points(const std::size_t count, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-3, 5);
+
+        std::vector<point3d> points;
+        for (std::size_t index = 0; index < count; ++index)
+            points.emplace_back(coordinate(generator), coordinate(generator) * 0.5, coordinate(generator) * 2);
+        return points;
+    }
+
+    static void expect_encloses(const sphere& sphere, const std::vector<point3d>& points)
+    {
+        for (const point3d& point : points)
+            EXPECT_LE(sphere.center.distance(point), sphere.radius + ROUND_EPSILON);
+    }
+
+    TEST(sphere_test, properties)
+    {
+        constexpr sphere sphere({1, 2, 3}, 2);
+
+        EXPECT_TRUE(sphere.contains({1, 2, 5}));
+        EXPECT_FALSE(sphere.contains({1, 2, 5.1}));
+        EXPECT_TRUE(sphere.contains(bardcore::sphere({1, 2, 4}, 1)));
+        EXPECT_FALSE(sphere.contains(bardcore::sphere({1, 2, 4}, 1.1)));
+
+        EXPECT_TRUE(sphere.overlaps(bardcore::sphere({1, 2, 8}, 3)));
+        EXPECT_FALSE(sphere.overlaps(bardcore::sphere({1, 2, 8}, 2.9)));
+        EXPECT_TRUE(sphere.overlaps(aabb({2, 3, 4}, {5, 5, 5})));
+        EXPECT_FALSE(sphere.overlaps(aabb({3, 4, 5}, {5, 5, 6})));
+
+        EXPECT_EQ(aabb({-1, 0, 1}, {3, 4, 5}), sphere.bounds());
+        EXPECT_NEAR(32. / 3 * math::pi, sphere.volume(), ROUND_EPSILON);
+        EXPECT_NEAR(16 * math::pi, sphere.surface_area(), ROUND_EPSILON);
+
+        EXPECT_THROW(bardcore::sphere({0, 0, 0}, -1), exception::negative_exception);
+    }
+
+    TEST(sphere_test, expand)
+    {
+        bardcore::sphere sphere({0, 0, 0}, 1);
+
+        sphere.expand({0.5, 0, 0});
+        EXPECT_EQ(bardcore::sphere({0, 0, 0}, 1), sphere);
+
+        // the far side (-1, 0, 0) stays in place
+        sphere.expand({3, 0, 0});
+        EXPECT_EQ(bardcore::sphere({1, 0, 0}, 2), sphere);
+    }
+
+    TEST(sphere_test, welzl_known)
+    {
+        // cube corners
+        std::vector<point3d> cube;
+        for (int corner = 0; corner < 8; ++corner)
+            cube.emplace_back(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+        EXPECT_EQ(bardcore::sphere({0.5, 0.5, 0.5}, math::sqrt_3 / 2), sphere::welzl(cube));
+
+        // obtuse triangle, the longest side is the diameter
+        EXPECT_EQ(bardcore::sphere({0, 0, 0}, 1), sphere::welzl({{-1, 0, 0}, {1, 0, 0}, {0, 0.1, 0}}));
+
+        // acute triangle, the circumscribed circle
+        const sphere triangle = sphere::welzl({{-1, 0, 0}, {1, 0, 0}, {0, 1.5, 0}});
+        EXPECT_NEAR(triangle.center.distance({-1, 0, 0}), triangle.radius, ROUND_EPSILON);
+        EXPECT_NEAR(triangle.center.distance({0, 1.5, 0}), triangle.radius, ROUND_EPSILON);
+
+        // coplanar and duplicate points
+        EXPECT_EQ(bardcore::sphere({0.5, 0.5, 0}, math::sqrt_2 / 2),
+                  sphere::welzl({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 1, 0}, {0.5, 0.5, 0}}));
+
+        EXPECT_EQ(bardcore::sphere({2, 3, 4}, 0), sphere::welzl({{2, 3, 4}}));
+        EXPECT_EQ(bardcore::sphere(), sphere::welzl(std::vector<point3d>()));
+    }
+
+    TEST(sphere_test, welzl_ritter)
+    {
+        const std::vector<point3d> points = random_points(5000, 1);
+
+        const sphere exact = sphere::welzl(points);
+        const sphere approximate = sphere::ritter(points);
+
+        expect_encloses(exact, points);
+        expect_encloses(approximate, points);
+        EXPECT_LE(exact.radius, approximate.radius + ROUND_EPSILON);
+        EXPECT_LE(approximate.radius, exact.radius * 1.2);
+
+        // the smallest sphere is unique
+        EXPECT_NEAR(exact.radius, sphere::welzl(points, 7).radius, ROUND_EPSILON);
+
+        // points on a sphere
+        std::vector<point3d> surface;
+        for (const point3d& point : random_points(2000, 2))
+        {
+            const vector3d direction = point3d(1, 0.5, 2).get_vector(point).normalize();
+            surface.push_back(point3d(1, 2, 3) + direction * 4);
+        }
+        const sphere fitted = sphere::welzl(surface);
+        EXPECT_NEAR(4, fitted.radius, 0.01);
+        EXPECT_LE(fitted.radius, 4 + ROUND_EPSILON);
+
+        EXPECT_EQ(bardcore::sphere(), sphere::ritter(std::vector<point3d>()));
+    }
+} // namespace testing
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "BardCore/math/symmetric_matrix3.h"
+
+#include <random>
+
+namespace testing
+{
+    // A v = lambda v for every eigenpair, eigenvectors are orthonormal
+    static void expect_decomposition(const symmetric_matrix3& matrix, const symmetric_eigen& eigen)
+    {
+        EXPECT_LE(eigen.values[0], eigen.values[1]);
+        EXPECT_LE(eigen.values[1], eigen.values[2]);
+        EXPECT_NEAR(matrix.trace(), eigen.values[0] + eigen.values[1] + eigen.values[2], ROUND_EPSILON);
+
+        for (unsigned int index = 0; index < 3; ++index)
+        {
+            const vector3d product = matrix.multiply(eigen.vectors[index]);
+            const vector3d expected = eigen.vectors[index] * eigen.values[index];
+            EXPECT_NEAR(expected.x, product.x, ROUND_EPSILON);
+            EXPECT_NEAR(expected.y, product.y, ROUND_EPSILON);
+            EXPECT_NEAR(expected.z, product.z, ROUND_EPSILON);
+            EXPECT_NEAR(1.0, eigen.vectors[index].length(), ROUND_EPSILON);
+
+            for (unsigned int other = index + 1; other < 3; ++other)
+                EXPECT_NEAR(0.0, eigen.vectors[index].dot(eigen.vectors[other]), ROUND_EPSILON);
+        }
+    }
+
+    TEST(symmetric_matrix3_test, operations)
+    {
+        constexpr symmetric_matrix3 matrix(2, 1, 0, 3, 4, 5);
+
+        EXPECT_EQ(vector3d(3, 8, 9), matrix.multiply({1, 1, 1}));
+        EXPECT_NEAR(10.0, matrix.trace(), ROUND_EPSILON);
+        EXPECT_NEAR(-7.0, matrix.determinant(), ROUND_EPSILON);
+        EXPECT_EQ(symmetric_matrix3(3, 1, 0, 4, 4, 6), matrix + symmetric_matrix3::identity());
+        EXPECT_EQ(symmetric_matrix3(4, 2, 0, 6, 8, 10), matrix * 2);
+        EXPECT_EQ(symmetric_matrix3(1, 2, 3, 4, 6, 9), symmetric_matrix3::outer({1, 2, 3}));
+    }
+
+    TEST(symmetric_matrix3_test, eigen)
+    {
+        // diagonal, in any order
+        const symmetric_eigen diagonal = symmetric_matrix3(3, 0, 0, 1, 0, 2).eigen();
+        EXPECT_NEAR(1.0, diagonal.values[0], ROUND_EPSILON);
+        EXPECT_NEAR(2.0, diagonal.values[1], ROUND_EPSILON);
+        EXPECT_NEAR(3.0, diagonal.values[2], ROUND_EPSILON);
+        EXPECT_NEAR(1.0, std::abs(diagonal.vectors[0].y), ROUND_EPSILON);
+
+        const symmetric_matrix3 matrix(2, 1, 0, 3, 4, 5);
+        expect_decomposition(matrix, matrix.eigen());
+
+        // repeated eigenvalues and the zero matrix
+        expect_decomposition(symmetric_matrix3::identity(), symmetric_matrix3::identity().eigen());
+        expect_decomposition(symmetric_matrix3(), symmetric_matrix3().eigen());
+        expect_decomposition(symmetric_matrix3::outer({1, 2, 3}), symmetric_matrix3::outer({1, 2, 3}).eigen());
+    }
+
+    TEST(symmetric_matrix3_test, eigen_batch)
+    {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> element(-10, 10);
+
+        // not a multiple of the packet size
+        std::vector<symmetric_matrix3> matrices;
+        for (int index = 0; index < 1001; ++index)
+        {
+            matrices.emplace_back(element(generator), element(generator), element(generator), element(generator),
+                                  element(generator), element(generator));
+        }
+
+        const std::vector<symmetric_eigen> eigens = symmetric_matrix3::eigen(matrices);
+        ASSERT_EQ(matrices.size(), eigens.size());
+
+        for (std::size_t index = 0; index < matrices.size(); ++index)
+        {
+            expect_decomposition(matrices[index], eigens[index]);
+
+            const symmetric_eigen single = matrices[index].eigen();
+            for (unsigned int value = 0; value < 3; ++value)
+                EXPECT_NEAR(single.values[value], eigens[index].values[value], ROUND_EPSILON);
+        }
+    }
+} // namespace testing
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "BardCore/math/triangle.h"
+
+namespace testing
+{
+    TEST(triangle_test, properties)
+    {
+        constexpr triangle triangle({0, 0, 0}, {2, 0, 0}, {0, 2, 0});
+
+        EXPECT_EQ(aabb({0, 0, 0}, {2, 2, 0}), triangle.bounds());
+        EXPECT_EQ(point3d(2. / 3, 2. / 3, 0), triangle.centroid());
+        EXPECT_EQ(vector3d(0, 0, 4), triangle.normal());
+        EXPECT_NEAR(2.0, triangle.area(), ROUND_EPSILON);
+    }
+
+    TEST(triangle_test, closest_point)
+    {
+        constexpr triangle triangle({0, 0, 0}, {2, 0, 0}, {0, 2, 0});
+
+        // inside, above the face
+        EXPECT_EQ(point3d(0.5, 0.5, 0), triangle.closest_point({0.5, 0.5, 3}));
+
+        // corners
+        EXPECT_EQ(point3d(0, 0, 0), triangle.closest_point({-1, -1, 0}));
+        EXPECT_EQ(point3d(2, 0, 0), triangle.closest_point({3, -1, 1}));
+        EXPECT_EQ(point3d(0, 2, 0), triangle.closest_point({-1, 3, 0}));
+
+        // edges
+        EXPECT_EQ(point3d(1, 0, 0), triangle.closest_point({1, -1, 0}));
+        EXPECT_EQ(point3d(0, 1, 0), triangle.closest_point({-1, 1, 0}));
+        EXPECT_EQ(point3d(1, 1, 0), triangle.closest_point({2, 2, 0}));
+    }
+
+    TEST(triangle_test, intersect)
+    {
+        constexpr triangle triangle({0, 0, 5}, {2, 0, 5}, {0, 2, 5});
+        double t = 0, u = 0, v = 0;
+
+        EXPECT_TRUE(triangle.intersect({0.5, 0.5, 0}, {0, 0, 1}, 10, t, u, v));
+        EXPECT_NEAR(5.0, t, ROUND_EPSILON);
+        EXPECT_NEAR(0.25, u, ROUND_EPSILON);
+        EXPECT_NEAR(0.25, v, ROUND_EPSILON);
+
+        // back face, too short, outside and parallel
+        EXPECT_TRUE(triangle.intersect({0.5, 0.5, 10}, {0, 0, -1}, 10, t, u, v));
+        EXPECT_FALSE(triangle.intersect({0.5, 0.5, 0}, {0, 0, 1}, 4, t, u, v));
+        EXPECT_FALSE(triangle.intersect({1.5, 1.5, 0}, {0, 0, 1}, 10, t, u, v));
+        EXPECT_FALSE(triangle.intersect({0.5, 0.5, 0}, {1, 0, 0}, 10, t, u, v));
+    }
+} // namespace testing
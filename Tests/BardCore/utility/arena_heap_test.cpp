@@ -0,0 +1,146 @@
+#include "pch.h"
+#include "BardCore/utility/arena.h"
+
+#include "BardCore/utility/bvh.h"
+#include "BardCore/utility/plane_batch.h"
+#include "BardCore/utility/sdf.h"
+#include "BardCore/utility/triangle_mesh.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// the global operator new and delete are replaced for the whole test program,
+// heap allocations are only counted while counting_heap is true
+static std::atomic<bool> counting_heap{false};
+static std::atomic<std::size_t> heap_allocations{0};
+
+static void* counted_allocate(const std::size_t size)
+{
+    if (counting_heap.load(std::memory_order_relaxed))
+        heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size) { return counted_allocate(size); }
+void* operator new[](const std::size_t size) { return counted_allocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+#if defined(CXX17)
+static void* counted_allocate(const std::size_t size, const std::align_val_t alignment)
+{
+    if (counting_heap.load(std::memory_order_relaxed))
+        heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    void* memory = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* memory = std::aligned_alloc(align, ((size == 0 ? 1 : size) + align - 1) / align * align);
+#endif
+    if (memory)
+        return memory;
+    throw std::bad_alloc();
+}
+
+static void counted_free(void* memory, std::align_val_t) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    return counted_allocate(size, alignment);
+}
+
+void operator delete(void* memory, const std::align_val_t alignment) noexcept { counted_free(memory, alignment); }
+void operator delete[](void* memory, const std::align_val_t alignment) noexcept { counted_free(memory, alignment); }
+
+void operator delete(void* memory, std::size_t, const std::align_val_t alignment) noexcept
+{
+    counted_free(memory, alignment);
+}
+
+void operator delete[](void* memory, std::size_t, const std::align_val_t alignment) noexcept
+{
+    counted_free(memory, alignment);
+}
+#endif
+
+namespace testing
+{
+    TEST(arena_heap_test, steady_state_frames)
+    {
+        // batches below the grains of the batch functions, so no threads are started
+        std::vector<aabb> bounds;
+        std::vector<point3d> points;
+        std::vector<utility::ray> rays;
+        for (int index = 0; index < 200; ++index)
+        {
+            const point3d point(index % 10, index / 10 % 10, index / 100);
+            bounds.emplace_back(point, point + vector3d(0.5, 0.5, 0.5));
+            points.push_back(point);
+            rays.emplace_back(point3d(0, 0, 0), vector3d(0.01 * (index % 20 - 10), 0.01 * (index / 20), 1), 50);
+        }
+
+        const utility::triangle_mesh mesh({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, {0, 1, 2, 0, 1, 3});
+        const plane plane({1, 1, 0}, -5);
+        const utility::sdf::sphere shape{{0, 0, 10}, 3};
+        const utility::sphere_tracer tracer;
+        utility::bvh bvh;
+        utility::arena arena;
+
+        double checksum = 0;
+        const auto frame = [&]
+        {
+            arena.reset();
+            bvh.build(bounds, arena);
+            checksum += mesh.distances(points, arena).back();
+            checksum += mesh.closest_points(points, arena).back().distance;
+            checksum += utility::plane_batch::distances(plane, points, arena).back();
+            checksum += static_cast<double>(utility::plane_batch::classify(plane, points, arena).back());
+            checksum += tracer.march(rays, shape, arena).back().distance;
+        };
+
+        // the first frame allocates the arena blocks and the bvh nodes, the later frames reuse them
+        frame();
+        const std::size_t blocks = arena.get_block_count();
+        const std::size_t capacity = arena.capacity();
+        const std::size_t node_count = bvh.get_nodes().size();
+
+        heap_allocations = 0;
+        counting_heap = true;
+        for (int index = 0; index < 10; ++index)
+            frame();
+        counting_heap = false;
+
+        EXPECT_EQ(0u, heap_allocations.load());
+        EXPECT_EQ(blocks, arena.get_block_count());
+        EXPECT_EQ(capacity, arena.capacity());
+        EXPECT_EQ(node_count, bvh.get_nodes().size());
+        EXPECT_GT(checksum, 0.0);
+
+        // the same results as the heap versions
+        const utility::bvh heap_bvh(bounds);
+        EXPECT_EQ(heap_bvh.get_primitives(), bvh.get_primitives());
+        const std::vector<double> distances = mesh.distances(points);
+        const utility::arena_vector<double> arena_distances = mesh.distances(points, arena);
+        for (std::size_t index = 0; index < points.size(); ++index)
+            EXPECT_NEAR(distances[index], arena_distances[index], ROUND_EPSILON);
+    }
+} // namespace testing
@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "BardCore/utility/arena.h"
+
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+#include <thread>
+
+namespace testing
+{
+    // counts the blocks an arena takes, the blocks come from the heap
+    class counting_upstream final : public utility::arena_upstream
+    {
+    public:
+        std::size_t allocations = 0;
+
+        unsigned char* allocate(const std::size_t bytes) override
+        {
+            ++allocations;
+            return heap().allocate(bytes);
+        }
+
+        void deallocate(unsigned char* block, const std::size_t bytes) noexcept override
+        {
+            heap().deallocate(block, bytes);
+        }
+    };
+
+    TEST(arena_test, allocate)
+    {
+        utility::arena arena(1 << 16);
+        EXPECT_EQ(0u, arena.get_block_count());
+
+        auto* const first = static_cast<unsigned char*>(arena.allocate(3, 1));
+        auto* const second = static_cast<unsigned char*>(arena.allocate(8, 64));
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(second) % 64);
+        EXPECT_GE(second, first + 3);
+        EXPECT_EQ(1u, arena.get_block_count());
+
+        // larger than a region and larger than a block
+        auto* const large = static_cast<unsigned char*>(arena.allocate(utility::arena::region_size));
+        large[utility::arena::region_size - 1] = 1;
+        arena.allocate(1 << 17);
+        EXPECT_EQ(2u, arena.get_block_count());
+        const std::size_t capacity = arena.capacity();
+
+        // after a reset the same memory is handed out again
+        arena.reset();
+        EXPECT_EQ(first, arena.allocate(3, 1));
+        arena.allocate(1 << 17);
+        EXPECT_EQ(capacity, arena.capacity());
+
+        arena.release();
+        EXPECT_EQ(0u, arena.get_block_count());
+        EXPECT_EQ(0u, arena.capacity());
+
+        EXPECT_THROW(arena.allocate(8, 3), exception::out_of_range_exception);
+        EXPECT_THROW(utility::arena(16), exception::out_of_range_exception);
+    }
+
+    TEST(arena_test, threads)
+    {
+        // every thread writes its own pattern, no memory is handed out twice
+        utility::arena arena;
+        constexpr int thread_count = 4;
+        constexpr int allocation_count = 2000;
+
+        std::vector<std::vector<int*>> allocations(thread_count);
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < thread_count; ++thread)
+        {
+            threads.emplace_back([&, thread]
+            {
+                for (int index = 0; index < allocation_count; ++index)
+                {
+                    int* memory = static_cast<int*>(arena.allocate(sizeof(int) * (1 + index % 7), alignof(int)));
+                    for (int element = 0; element <= index % 7; ++element)
+                        memory[element] = thread * allocation_count + index;
+                    allocations[thread].push_back(memory);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (int thread = 0; thread < thread_count; ++thread)
+            for (int index = 0; index < allocation_count; ++index)
+                for (int element = 0; element <= index % 7; ++element)
+                    ASSERT_EQ(thread * allocation_count + index, allocations[thread][index][element]);
+    }
+
+    TEST(arena_test, alternating_arenas)
+    {
+        // a thread keeps its region in both arenas, so neither takes a region per switch
+        counting_upstream upstream;
+        utility::arena first(utility::arena::region_size * 4, upstream);
+        utility::arena second(utility::arena::region_size * 4, upstream);
+
+        for (int index = 0; index < 200; ++index)
+        {
+            first.allocate(16);
+            second.allocate(16);
+        }
+
+        EXPECT_EQ(1u, first.get_block_count());
+        EXPECT_EQ(1u, second.get_block_count());
+        EXPECT_EQ(2u, upstream.allocations);
+    }
+
+    TEST(arena_test, allocator)
+    {
+        utility::arena arena;
+
+        utility::arena_vector<point3d> points{utility::arena_allocator<point3d>(arena)};
+        for (int index = 0; index < 1000; ++index)
+            points.emplace_back(index, index, index);
+        EXPECT_EQ(point3d(999, 999, 999), points.back());
+        EXPECT_EQ(&arena, &points.get_allocator().get_arena());
+        EXPECT_TRUE(utility::arena_allocator<int>(arena) == utility::arena_allocator<double>(arena));
+
+#if defined(CXX17)
+        utility::arena_resource resource(arena);
+        std::pmr::vector<vector3d> vectors(&resource);
+        vectors.resize(100, vector3d(1, 2, 3));
+        EXPECT_EQ(vector3d(1, 2, 3), vectors[99]);
+        EXPECT_TRUE(resource.is_equal(utility::arena_resource(arena)));
+#endif
+    }
+} // namespace testing
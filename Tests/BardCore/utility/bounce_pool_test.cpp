@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "BardCore/utility/bounce_pool.h"
+
+#include <thread>
+
+namespace testing
+{
+    // bounces a ray between the planes z = 0 and z = 10, one pooled ray and hit per bounce
+    static unsigned int trace(utility::bounce_pool& pool, const utility::ray& ray, const unsigned int depth,
+                              const unsigned int max_depth)
+    {
+        const utility::object_pool<utility::hit_record>::handle hit = pool.make_hit(depth);
+        const double z = ray.get_direction().z > 0 ? 10 : 0;
+        hit->distance = (z - ray.get_position().z) / ray.get_direction().z;
+        hit->point = ray.get_position() + ray.get_direction() * hit->distance;
+        hit->normal = vector3d(0, 0, z > 0 ? -1 : 1);
+        hit->primitive = z > 0 ? 1 : 0;
+
+        if (depth + 1 == max_depth)
+            return depth + 1;
+
+        const vector3d& direction = ray.get_direction();
+        const utility::object_pool<utility::ray>::handle bounce = pool.make_ray(
+            hit->point, vector3d(direction.x, direction.y, -direction.z), 100);
+        return trace(pool, *bounce, depth + 1, max_depth);
+    }
+
+    TEST(bounce_pool_test, recursion)
+    {
+        utility::bounce_pool pool(8);
+        const utility::ray primary({0, 0, 5}, {1, 0, 1}, 100);
+
+        EXPECT_EQ(8u, trace(pool, primary, 0, 8));
+        EXPECT_TRUE(pool.get_rays().empty());
+        EXPECT_TRUE(pool.get_hits().empty());
+
+        // the same slots are used again
+        const utility::ray* first = pool.make_ray({0, 0, 0}, {0, 0, 1}, 1).get();
+        EXPECT_EQ(first, pool.make_ray({0, 0, 0}, {0, 0, 1}, 1).get());
+
+        // deeper than reserved
+        EXPECT_THROW(trace(pool, primary, 0, 9), exception::out_of_range_exception);
+        EXPECT_TRUE(pool.get_rays().empty());
+        EXPECT_TRUE(pool.get_hits().empty());
+
+        // a ray that can't be constructed doesn't take a slot
+        EXPECT_THROW((void)pool.make_ray({0, 0, 0}, {0, 0, 0}, 1), exception::zero_exception);
+        EXPECT_EQ(8u, pool.get_rays().available());
+
+        const utility::object_pool<utility::hit_record>::handle miss = pool.make_hit(3);
+        EXPECT_TRUE(miss->primitive == utility::no_primitive);
+        EXPECT_EQ(3u, miss->depth);
+    }
+
+    TEST(bounce_pool_test, local)
+    {
+        utility::bounce_pool& pool = utility::bounce_pool::local();
+        pool.reserve(4);
+        EXPECT_EQ(&pool, &utility::bounce_pool::local());
+
+        // every thread has its own pool
+        utility::bounce_pool* other = nullptr;
+        std::size_t other_capacity = 1;
+        std::thread thread([&]
+        {
+            other = &utility::bounce_pool::local();
+            other_capacity = other->get_rays().capacity();
+        });
+        thread.join();
+
+        EXPECT_NE(&pool, other);
+        EXPECT_EQ(0u, other_capacity);
+        EXPECT_EQ(4u, pool.get_rays().capacity());
+    }
+} // namespace testing
@@ -0,0 +1,146 @@
+#include "pch.h"
+#include "BardCore/utility/brick_map.h"
+
+namespace testing
+{
+    TEST(brick_map_test, constructor)
+    {
+        const utility::brick_map map({0, 0, 0}, 0.5, 2, 3, 4);
+
+        EXPECT_EQ(0u, map.brick_count());
+        EXPECT_EQ(0u, map.occupied_voxels());
+        EXPECT_EQ(aabb({0, 0, 0}, {8, 12, 16}), map.get_bounds());
+        EXPECT_FALSE(map.is_occupied(15, 23, 31));
+
+        EXPECT_THROW((void)map.is_occupied(16, 0, 0), exception::out_of_range_exception);
+        EXPECT_THROW(utility::brick_map({0, 0, 0}, 0, 1, 1, 1), exception::negative_exception);
+        EXPECT_THROW(utility::brick_map({0, 0, 0}, 1, 0, 1, 1), exception::zero_exception);
+    }
+
+    TEST(brick_map_test, build)
+    {
+        utility::brick_map map({0, 0, 0}, 1, 4, 4, 4);
+
+        const std::vector<point3d> samples = {
+            {0.5, 0.5, 0.5}, {0.6, 0.4, 0.5}, // same voxel
+            {9.5, 1.5, 2.5}, // second brick
+            {31.5, 31.5, 31.5}, // last voxel
+            {-1, 0, 0}, {32, 0, 0} // outside
+        };
+        map.build(samples);
+
+        EXPECT_EQ(3u, map.brick_count());
+        EXPECT_EQ(3u, map.occupied_voxels());
+        EXPECT_TRUE(map.is_occupied(0, 0, 0));
+        EXPECT_TRUE(map.is_occupied(9, 1, 2));
+        EXPECT_TRUE(map.is_occupied(31, 31, 31));
+        EXPECT_FALSE(map.is_occupied(1, 0, 0));
+
+        // coarse grid (64 * 4 bytes) and 3 bricks (3 * 64 bytes) for 3 voxels
+        EXPECT_EQ(64u * 4u + 3u * 64u, map.memory_usage());
+        EXPECT_NEAR((64.0 * 4 + 3 * 64) / 3, map.bytes_per_occupied_voxel(), ROUND_EPSILON);
+
+        // rebuilding replaces the content
+        map.build({{1.5, 1.5, 1.5}});
+        EXPECT_EQ(1u, map.brick_count());
+        EXPECT_FALSE(map.is_occupied(0, 0, 0));
+        EXPECT_TRUE(map.is_occupied(1, 1, 1));
+    }
+
+    TEST(brick_map_test, build_many_samples)
+    {
+        utility::brick_map map({0, 0, 0}, 1, 8, 8, 8);
+
+        // every third voxel of every other brick, enough samples to sort and bucket them in chunks
+        std::vector<point3d> samples;
+        std::size_t expected = 0;
+        for (unsigned int z = 0; z < 64; ++z)
+            for (unsigned int y = 0; y < 64; ++y)
+                for (unsigned int x = 0; x < 64; x += 3)
+                    if ((x / 8 + y / 8 + z / 8) % 2 == 0)
+                    {
+                        samples.emplace_back(x + 0.5, y + 0.5, z + 0.5);
+                        samples.emplace_back(x + 0.25, y + 0.75, z + 0.5); // same voxel
+                        ++expected;
+                    }
+        map.build(samples);
+
+        EXPECT_EQ(256u, map.brick_count());
+        EXPECT_EQ(expected, map.occupied_voxels());
+        EXPECT_TRUE(map.is_occupied(63, 56, 0));
+        EXPECT_FALSE(map.is_occupied(8, 0, 0));
+        EXPECT_FALSE(map.is_occupied(1, 0, 0));
+    }
+
+    TEST(brick_map_test, intersect)
+    {
+        utility::brick_map map({0, 0, 0}, 1, 4, 1, 1);
+
+        // a voxel in the third brick, the first two bricks are empty
+        map.build({{20.5, 3.5, 4.5}, {25.5, 3.5, 4.5}});
+
+        const utility::voxel_intersection hit = map.intersect(utility::ray({-2, 3.5, 4.5}, {1, 0, 0}, 100));
+        ASSERT_TRUE(hit.hit);
+        EXPECT_EQ(20u, hit.voxel.x);
+        EXPECT_EQ(3u, hit.voxel.y);
+        EXPECT_EQ(4u, hit.voxel.z);
+        EXPECT_EQ(20u + 32u * (3u + 8u * 4u), hit.voxel.index);
+        EXPECT_NEAR(22.0, hit.voxel.t_enter, ROUND_EPSILON);
+
+        // too short, passing next to the voxel, and starting behind it
+        EXPECT_FALSE(map.intersect(utility::ray({-2, 3.5, 4.5}, {1, 0, 0}, 10)).hit);
+        EXPECT_FALSE(map.intersect(utility::ray({-2, 2.5, 4.5}, {1, 0, 0}, 100)).hit);
+        EXPECT_EQ(25u, map.intersect(utility::ray({21.5, 3.5, 4.5}, {1, 0, 0}, 100)).voxel.x);
+
+        // ends exactly on the border of the third brick, in front of its first voxel
+        map.build({{16.5, 3.5, 4.5}});
+        EXPECT_FALSE(map.intersect(utility::ray({-2, 3.5, 4.5}, {1, 0, 0}, 18)).hit);
+        EXPECT_TRUE(map.intersect(utility::ray({-2, 3.5, 4.5}, {1, 0, 0}, 18.5)).hit);
+    }
+
+    TEST(brick_map_test, intersect_batch)
+    {
+        utility::brick_map map({0, 0, 0}, 1, 2, 2, 2);
+
+        std::vector<point3d> samples;
+        for (int y = 0; y < 16; ++y)
+            samples.emplace_back(10.5, y + 0.5, 3.5);
+        map.build(samples);
+
+        std::vector<utility::ray> rays;
+        for (int y = 0; y < 16; ++y)
+            rays.emplace_back(point3d(0, y + 0.5, 3.5), vector3d(1, 0.01, 0), 50);
+        rays.emplace_back(point3d(0, 0.5, 12.5), vector3d(1, 0, 0), 50);
+
+        const std::vector<utility::voxel_intersection> hits = map.intersect(rays);
+        ASSERT_EQ(rays.size(), hits.size());
+
+        for (int y = 0; y < 16; ++y)
+        {
+            EXPECT_TRUE(hits[y].hit);
+            EXPECT_EQ(10u, hits[y].voxel.x);
+        }
+        EXPECT_FALSE(hits.back().hit);
+    }
+
+    TEST(brick_map_test, voxel_statistics)
+    {
+        utility::brick_map map({0, 0, 0}, 1, 2, 2, 2);
+        map.build({{10.5, 3.5, 3.5}, {10.5, 4.5, 3.5}});
+
+        std::vector<utility::ray> rays;
+        for (int y = 0; y < 8; ++y)
+            rays.emplace_back(point3d(0, y + 0.5, 3.5), vector3d(1, 0, 0), 50);
+
+        std::vector<utility::voxel_intersection> results;
+        const utility::voxel_statistics statistics = utility::voxel_statistics::measure(
+            [&] { return map.intersect(rays); }, results);
+
+        EXPECT_EQ(rays.size(), results.size());
+        EXPECT_EQ(rays.size(), statistics.rays);
+        EXPECT_EQ(2u, statistics.hits);
+        EXPECT_GE(statistics.seconds, 0.0);
+        EXPECT_GE(statistics.rays_per_second(), 0.0);
+        EXPECT_EQ(0.0, utility::voxel_statistics().rays_per_second());
+    }
+} // namespace testing
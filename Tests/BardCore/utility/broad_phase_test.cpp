@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "BardCore/utility/broad_phase.h"
+
+#include <random>
+
+namespace testing
+{
+    // random boxes of size [0.1, 1.1) in a cube of 40
+    static std::vector<aabb> random_boxes(const std::size_t count, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> position(0, 40);
+        std::uniform_real_distribution<double> size(0.1, 1.1);
+
+        std::vector<aabb> boxes;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const point3d minimum(position(generator), position(generator), position(generator));
+            boxes.emplace_back(minimum, point3d(minimum.x + size(generator), minimum.y + size(generator),
+                                                minimum.z + size(generator)));
+        }
+        return boxes;
+    }
+
+    static std::vector<utility::collision_pair> brute_force_pairs(const std::vector<aabb>& boxes)
+    {
+        std::vector<utility::collision_pair> pairs;
+        for (std::uint32_t first = 0; first < boxes.size(); ++first)
+            for (std::uint32_t second = first + 1; second < boxes.size(); ++second)
+                if (boxes[first].overlaps(boxes[second]))
+                    pairs.emplace_back(first, second);
+        return pairs;
+    }
+
+    static std::vector<utility::collision_pair> sorted(std::vector<utility::collision_pair> pairs)
+    {
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    static void move_boxes(std::vector<aabb>& boxes, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> offset(-0.2, 0.2);
+
+        for (aabb& box : boxes)
+        {
+            const vector3d move(offset(generator), offset(generator), offset(generator));
+            box = aabb(box.minimum + move, box.maximum + move);
+        }
+    }
+
+    TEST(broad_phase_test, collision_pair)
+    {
+        constexpr utility::collision_pair pair(5, 2);
+
+        EXPECT_EQ(2u, pair.first);
+        EXPECT_EQ(5u, pair.second);
+        EXPECT_EQ(utility::collision_pair(2, 5), pair);
+        EXPECT_TRUE(utility::collision_pair(1, 9) < pair);
+        EXPECT_TRUE(utility::collision_pair(2, 4) < pair);
+    }
+
+    TEST(broad_phase_test, sweep_and_prune)
+    {
+        std::vector<aabb> boxes = random_boxes(2000, 1);
+        utility::sweep_and_prune sweep(boxes);
+
+        const std::vector<utility::collision_pair> expected = brute_force_pairs(boxes);
+        ASSERT_FALSE(expected.empty());
+        EXPECT_EQ(expected, sorted(sweep.find_pairs()));
+        EXPECT_EQ(0u, sweep.sort());
+
+        // moving a little keeps the order nearly sorted
+        move_boxes(boxes, 2);
+        sweep.update(boxes);
+        const std::vector<utility::collision_pair> pairs = sweep.find_pairs();
+
+        EXPECT_EQ(brute_force_pairs(boxes), sorted(pairs));
+        EXPECT_GT(sweep.get_last_swaps(), 0u);
+        EXPECT_LT(sweep.get_last_swaps(), boxes.size() * 10);
+        EXPECT_EQ(pairs, sweep.find_pairs_parallel());
+        EXPECT_EQ(boxes[7], sweep.get_bounds(7));
+    }
+
+    TEST(broad_phase_test, sweep_and_prune_update)
+    {
+        utility::sweep_and_prune sweep;
+
+        EXPECT_EQ(0u, sweep.add(aabb({0, 0, 0}, {1, 1, 1})));
+        EXPECT_EQ(1u, sweep.add(aabb({5, 0, 0}, {6, 1, 1})));
+        EXPECT_TRUE(sweep.find_pairs().empty());
+
+        sweep.update(1, aabb({0.5, 0.5, 0.5}, {1.5, 1.5, 1.5}));
+        EXPECT_EQ(std::vector<utility::collision_pair>({{0, 1}}), sweep.find_pairs());
+
+        // passing the other box on x
+        sweep.update(1, aabb({-2, 0, 0}, {-1, 1, 1}));
+        EXPECT_TRUE(sweep.find_pairs().empty());
+        EXPECT_EQ(1u, sweep.get_last_swaps());
+
+        EXPECT_THROW(sweep.update(2, aabb()), exception::out_of_range_exception);
+        EXPECT_THROW(sweep.update(std::vector<aabb>(3)), exception::out_of_range_exception);
+        EXPECT_THROW((void)sweep.get_bounds(2), exception::out_of_range_exception);
+    }
+
+    TEST(broad_phase_test, dynamic_aabb_tree)
+    {
+        std::vector<aabb> boxes = random_boxes(2000, 3);
+        utility::dynamic_aabb_tree tree(0.5);
+
+        // proxies are node indices, map them back to box indices
+        std::vector<std::uint32_t> proxies;
+        for (const aabb& box : boxes)
+            proxies.push_back(tree.insert(box));
+
+        EXPECT_EQ(boxes.size(), tree.size());
+        EXPECT_EQ(boxes[3], tree.get_bounds(proxies[3]));
+        EXPECT_TRUE(tree.get_fat_bounds(proxies[3]).contains(boxes[3]));
+
+        const auto to_boxes = [&](const std::vector<utility::collision_pair>& pairs)
+        {
+            std::vector<std::uint32_t> box_of(tree.get_nodes().size());
+            for (std::uint32_t index = 0; index < proxies.size(); ++index)
+                box_of[proxies[index]] = index;
+
+            std::vector<utility::collision_pair> result;
+            for (const utility::collision_pair& pair : pairs)
+                result.emplace_back(box_of[pair.first], box_of[pair.second]);
+            return sorted(result);
+        };
+
+        // balanced, 2000 leaves need at least 11 levels
+        EXPECT_LE(tree.height(), 25);
+
+        const std::vector<utility::collision_pair> pairs = tree.find_pairs();
+        EXPECT_EQ(brute_force_pairs(boxes), to_boxes(pairs));
+        EXPECT_EQ(pairs, tree.find_pairs_parallel());
+
+        // small moves stay inside the fat boxes
+        move_boxes(boxes, 4);
+        std::size_t reinserted = 0;
+        for (std::size_t index = 0; index < boxes.size(); ++index)
+            reinserted += tree.move(proxies[index], boxes[index]) ? 1 : 0;
+
+        EXPECT_LT(reinserted, boxes.size() / 2);
+        EXPECT_EQ(brute_force_pairs(boxes), to_boxes(tree.find_pairs_parallel()));
+    }
+
+    TEST(broad_phase_test, dynamic_aabb_tree_insert_remove)
+    {
+        utility::dynamic_aabb_tree tree(0);
+        EXPECT_TRUE(tree.is_empty());
+        EXPECT_EQ(0, tree.height());
+
+        // sorted insertion would give a list without balancing
+        std::vector<std::uint32_t> proxies;
+        for (int index = 0; index < 1024; ++index)
+            proxies.push_back(tree.insert(aabb({index * 2., 0, 0}, {index * 2. + 1, 1, 1})));
+
+        EXPECT_LE(tree.height(), 20);
+
+        const std::uint32_t overlapping = tree.insert(aabb({0.5, 0.5, 0.5}, {2.5, 1, 1}));
+        EXPECT_EQ(std::vector<utility::collision_pair>({{proxies[0], overlapping}, {proxies[1], overlapping}}),
+                  sorted(tree.find_pairs()));
+
+        std::vector<std::uint32_t> found;
+        tree.query(aabb({10, 0, 0}, {12, 1, 1}), [&](const std::uint32_t proxy)
+        {
+            found.push_back(proxy);
+            return true;
+        });
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(std::vector<std::uint32_t>({proxies[5], proxies[6]}), found);
+
+        tree.remove(proxies[1]);
+        EXPECT_EQ(std::vector<utility::collision_pair>({{proxies[0], overlapping}}), tree.find_pairs());
+        EXPECT_THROW(tree.remove(proxies[1]), exception::out_of_range_exception);
+        EXPECT_THROW((void)tree.move(5000, aabb()), exception::out_of_range_exception);
+
+        // moving far away reinserts the leaf
+        EXPECT_TRUE(tree.move(overlapping, aabb({-10, -10, -10}, {-9, -9, -9})));
+        EXPECT_TRUE(tree.find_pairs().empty());
+
+        // the freed node is reused
+        const std::size_t nodes = tree.get_nodes().size();
+        (void)tree.insert(aabb({100, 0, 0}, {101, 1, 1}));
+        EXPECT_EQ(nodes, tree.get_nodes().size());
+
+        EXPECT_THROW(utility::dynamic_aabb_tree(-1), exception::negative_exception);
+    }
+
+    TEST(broad_phase_test, pair_statistics)
+    {
+        const std::vector<aabb> boxes = random_boxes(1000, 5);
+        utility::sweep_and_prune sweep(boxes);
+
+        std::vector<utility::collision_pair> pairs;
+        const utility::pair_statistics statistics = utility::pair_statistics::measure(
+            [&] { return sweep.find_pairs_parallel(); }, pairs);
+
+        EXPECT_EQ(brute_force_pairs(boxes).size(), pairs.size());
+        EXPECT_EQ(pairs.size(), statistics.pairs);
+        EXPECT_GE(statistics.seconds, 0.0);
+        EXPECT_GE(statistics.pairs_per_second(), 0.0);
+        EXPECT_EQ(0.0, utility::pair_statistics().pairs_per_second());
+    }
+} // namespace testing
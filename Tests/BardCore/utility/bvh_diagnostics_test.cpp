@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "BardCore/utility/bvh_diagnostics.h"
+
+#include <sstream>
+
+namespace testing
+{
+    TEST(bvh_diagnostics_test, collect)
+    {
+        EXPECT_EQ(0u, utility::bvh_diagnostics::collect(utility::bvh()).nodes);
+
+        // a single leaf, its sah cost is its amount of primitives
+        const std::vector<aabb> boxes = {aabb({0, 0, 0}, {1, 1, 1}), aabb({2, 0, 0}, {3, 1, 1})};
+        utility::bvh_statistics statistics = utility::bvh_diagnostics::collect(
+            utility::bvh(boxes, 2, utility::bvh_layout::depth_first, 2));
+        EXPECT_EQ(1u, statistics.nodes);
+        EXPECT_EQ(1u, statistics.leaves);
+        EXPECT_EQ(1u, statistics.max_depth);
+        EXPECT_NEAR(2.0, statistics.sah_cost, ROUND_EPSILON);
+        EXPECT_EQ(std::vector<std::size_t>({0, 0, 1}), statistics.leaf_sizes);
+
+        // split in two leaves of one box, root area 2 * (3 + 1 + 3) = 14, leaf area 6
+        statistics = utility::bvh_diagnostics::collect(utility::bvh(boxes, 1), 2, 3);
+        EXPECT_EQ(3u, statistics.nodes);
+        EXPECT_EQ(2u, statistics.leaves);
+        EXPECT_EQ(2u, statistics.primitives);
+        EXPECT_EQ(2u, statistics.max_depth);
+        EXPECT_NEAR(2.0, statistics.average_leaf_depth, ROUND_EPSILON);
+        EXPECT_NEAR(1.0, statistics.average_leaf_size(), ROUND_EPSILON);
+        EXPECT_NEAR(2 + 2 * 3 * 6 / 14.0, statistics.sah_cost, ROUND_EPSILON);
+        EXPECT_NEAR(0.0, statistics.overlap, ROUND_EPSILON);
+
+        // overlapping siblings, the overlap is the unit cube around (1.5, 0.5, 0.5)
+        const std::vector<aabb> overlapping = {aabb({0, 0, 0}, {2, 1, 1}), aabb({1, 0, 0}, {3, 1, 1})};
+        statistics = utility::bvh_diagnostics::collect(utility::bvh(overlapping, 1));
+        EXPECT_NEAR(6 / 14.0, statistics.overlap, ROUND_EPSILON);
+    }
+
+    TEST(bvh_diagnostics_test, trace)
+    {
+        // a wall of boxes in front of the camera, the right half of the view sees nothing
+        std::vector<aabb> boxes;
+        for (int y = -5; y < 5; ++y)
+            for (int x = -5; x < 0; ++x)
+                boxes.emplace_back(point3d(x, y, 5), point3d(x + 1, y + 1, 6));
+
+        const utility::bvh bvh(boxes, 2);
+        const utility::camera camera({0, 0, 0}, {0, 0, 1}, 16, 8);
+        const utility::traversal_image image = utility::bvh_diagnostics::trace(
+            camera, 100, bvh, [&](const std::uint32_t primitive, double& t_max)
+            {
+                return utility::ray({0, 0, 0}, {0, 0, 1}, t_max).intersect(boxes[primitive], t_max, t_max);
+            });
+
+        ASSERT_EQ(16u * 8u, image.pixels.size());
+        EXPECT_LE(1u, image.max_node_visits());
+        EXPECT_LE(1u, image.max_primitive_tests());
+
+        // the counters match a single counted traversal
+        utility::traversal_counters counters;
+        (void)bvh.closest_hit(camera.shoot_ray(3, 4, 100), [](std::uint32_t, double&) { return false; }, counters);
+        EXPECT_EQ(counters.node_visits, image.pixels[4 * 16 + 3].node_visits);
+        EXPECT_EQ(counters.primitive_tests, image.pixels[4 * 16 + 3].primitive_tests);
+
+        // rays through one half of the view miss the root, the columns next to the middle are skipped
+        std::size_t first_half = 0, second_half = 0;
+        for (unsigned int y = 0; y < 8; ++y)
+        {
+            for (unsigned int x = 0; x < 7; ++x)
+            {
+                first_half += image.pixels[y * 16 + x].node_visits;
+                second_half += image.pixels[y * 16 + 15 - x].node_visits;
+            }
+        }
+        EXPECT_EQ(0u, (std::min)(first_half, second_half));
+        EXPECT_LT(0u, (std::max)(first_half, second_half));
+    }
+
+    TEST(bvh_diagnostics_test, write_heatmap)
+    {
+        utility::traversal_image image;
+        image.width = 2;
+        image.height = 1;
+        image.pixels.resize(2);
+        image.pixels[1].node_visits = 4;
+        image.pixels[1].primitive_tests = 2;
+
+        std::ostringstream stream;
+        utility::bvh_diagnostics::write_heatmap(stream, image);
+        const std::string header = "P6\n2 1\n255\n";
+        const std::string ppm = stream.str();
+        ASSERT_EQ(header.size() + 6, ppm.size());
+        EXPECT_EQ(header, ppm.substr(0, header.size()));
+
+        // no work is black, the most work is white
+        EXPECT_EQ(std::string(3, '\0'), ppm.substr(header.size(), 3));
+        EXPECT_EQ(std::string(3, '\xff'), ppm.substr(header.size() + 3, 3));
+
+        // a fixed maximum, half of it is red
+        std::ostringstream half;
+        utility::bvh_diagnostics::write_heatmap(half, image, utility::heatmap_channel::primitive_tests, 4);
+        const std::string pixel = half.str().substr(header.size() + 3, 3);
+        EXPECT_EQ(255, static_cast<unsigned char>(pixel[0]));
+        EXPECT_EQ(128, static_cast<unsigned char>(pixel[1]));
+        EXPECT_EQ(0, static_cast<unsigned char>(pixel[2]));
+
+        EXPECT_FALSE(utility::bvh_diagnostics::write_heatmap("/nonexistent/directory/heatmap.ppm", image));
+    }
+} // namespace testing
@@ -0,0 +1,78 @@
+#include "pch.h"
+
+// builds the traversal with child prefetching, which is off in the other tests
+#define BARDCORE_BVH_PREFETCH
+#include "BardCore/utility/bvh.h"
+
+namespace testing
+{
+    TEST(bvh_prefetch_test, closest_hit_and_nearest)
+    {
+        std::vector<aabb> boxes;
+        for (int x = 0; x < 10; ++x)
+            for (int y = 0; y < 10; ++y)
+                for (int z = 0; z < 10; ++z)
+                    boxes.emplace_back(point3d(2 * x, 2 * y, 2 * z), point3d(2 * x + 1, 2 * y + 1.5, 2 * z + 1));
+
+        for (const utility::bvh_layout layout : {
+                 utility::bvh_layout::depth_first, utility::bvh_layout::hot_first, utility::bvh_layout::breadth_first,
+                 utility::bvh_layout::van_emde_boas
+             })
+        {
+            const utility::bvh bvh(boxes, 2, layout);
+
+            for (int i = 0; i < 40; ++i)
+            {
+                // every box is tested, the nearest entry is the expected hit
+                const utility::ray ray({-5, 0.4 * i, 0.5 * i - 1}, {1, 0.1, 0.05 * (i % 5) - 0.1}, 100);
+                double expected_t = ray.get_distance();
+                std::uint32_t expected = utility::bvh::no_primitive;
+                for (std::uint32_t primitive = 0; primitive < boxes.size(); ++primitive)
+                {
+                    double t_enter = 0, t_exit = 0;
+                    if (utility::ray(ray.get_position(), ray.get_direction(), expected_t).intersect(
+                        boxes[primitive], t_enter, t_exit) && t_enter < expected_t)
+                    {
+                        expected_t = t_enter;
+                        expected = primitive;
+                    }
+                }
+
+                const std::uint32_t actual = bvh.closest_hit(ray, [&](const std::uint32_t primitive, double& t_max)
+                {
+                    double t_enter = 0, t_exit = 0;
+                    if (!utility::ray(ray.get_position(), ray.get_direction(), t_max).intersect(boxes[primitive],
+                        t_enter, t_exit))
+                        return false;
+
+                    t_max = t_enter;
+                    return true;
+                });
+
+                if (expected == utility::bvh::no_primitive)
+                    EXPECT_EQ(expected, actual);
+                else
+                {
+                    ASSERT_NE(utility::bvh::no_primitive, actual);
+                    double t_enter = 0, t_exit = 0;
+                    EXPECT_TRUE(ray.intersect(boxes[actual], t_enter, t_exit));
+                    EXPECT_NEAR(expected_t, t_enter, ROUND_EPSILON);
+                }
+
+                const point3d query = {0.5 * i, 20 - 0.4 * i, 0.3 * i};
+                double expected_distance = math::inf;
+                for (const aabb& box : boxes)
+                    expected_distance = (std::min)(expected_distance, box.distance_squared(query));
+
+                double distance = math::inf;
+                const std::uint32_t nearest = bvh.nearest(query, [&](const std::uint32_t primitive)
+                {
+                    return boxes[primitive].distance_squared(query);
+                }, distance);
+                ASSERT_NE(utility::bvh::no_primitive, nearest);
+                EXPECT_NEAR(expected_distance, distance, ROUND_EPSILON);
+                EXPECT_NEAR(expected_distance, boxes[nearest].distance_squared(query), ROUND_EPSILON);
+            }
+        }
+    }
+} // namespace testing
@@ -0,0 +1,311 @@
+#include "pch.h"
+#include "BardCore/utility/bvh.h"
+
+namespace testing
+{
+    // a row of unit boxes along x, box i goes from (2i, 0, 0) to (2i + 1, 1, 1)
+    static std::vector<aabb> box_row(const int count)
+    {
+        std::vector<aabb> boxes;
+        for (int i = 0; i < count; ++i)
+            boxes.emplace_back(point3d(2 * i, 0, 0), point3d(2 * i + 1, 1, 1));
+        return boxes;
+    }
+
+    TEST(bvh_test, build)
+    {
+        const std::vector<aabb> boxes = box_row(100);
+        const utility::bvh bvh(boxes, 2);
+
+        const utility::bvh::node_vector& nodes = bvh.get_nodes();
+        ASSERT_FALSE(nodes.empty());
+        EXPECT_EQ(aabb({0, 0, 0}, {199, 1, 1}), nodes[0].bounds);
+
+        // every primitive is in exactly one leaf and leaves are small enough
+        std::vector<int> seen(boxes.size(), 0);
+        for (const utility::bvh_node& node : nodes)
+        {
+            if (!node.is_leaf())
+                continue;
+
+            EXPECT_LE(node.count, 2u);
+            for (std::uint32_t index = node.first; index < node.first + node.count; ++index)
+            {
+                const std::uint32_t primitive = bvh.get_primitives()[index];
+                ++seen[primitive];
+                EXPECT_TRUE(node.bounds.overlaps(boxes[primitive]));
+            }
+        }
+
+        for (const int count : seen)
+            EXPECT_EQ(1, count);
+
+        EXPECT_THROW(utility::bvh(boxes, 0), exception::zero_exception);
+        EXPECT_TRUE(utility::bvh().is_empty());
+    }
+
+    TEST(bvh_test, build_min_leaf_size)
+    {
+        // nodes that fit in a leaf of min_leaf_size are never split
+        EXPECT_EQ(1u, utility::bvh(box_row(4), 4, utility::bvh_layout::depth_first, 4).get_nodes().size());
+        EXPECT_LT(1u, utility::bvh(box_row(4), 4).get_nodes().size());
+
+        const utility::bvh bvh(box_row(100), 4, utility::bvh_layout::depth_first, 4);
+        std::size_t leaves = 0, primitives = 0;
+        for (const utility::bvh_node& node : bvh.get_nodes())
+        {
+            if (!node.is_leaf())
+                continue;
+
+            EXPECT_LE(node.count, 4u);
+            ++leaves;
+            primitives += node.count;
+        }
+
+        EXPECT_EQ(100u, primitives);
+        EXPECT_GT(100.0 / leaves, 2.0);
+
+        EXPECT_THROW(utility::bvh(box_row(4), 2, utility::bvh_layout::depth_first, 3),
+                     exception::out_of_range_exception);
+    }
+
+    TEST(bvh_test, build_degenerate)
+    {
+        // identical boxes can't be separated by the heuristic
+        const std::vector<aabb> boxes(50, aabb({0, 0, 0}, {1, 1, 1}));
+        const utility::bvh bvh(boxes, 4);
+
+        for (const utility::bvh_node& node : bvh.get_nodes())
+        {
+            if (!node.is_leaf())
+                continue;
+
+            EXPECT_LE(node.count, 4u);
+        }
+    }
+
+    TEST(bvh_test, node_options)
+    {
+        const std::vector<aabb> boxes = box_row(100);
+        utility::bvh bvh(boxes, 2);
+        EXPECT_TRUE(utility::bvh::default_node_options() == bvh.get_node_options());
+
+        // the nodes move to pages spread over every NUMA node and keep their content
+        const utility::bvh::node_vector heap = bvh.get_nodes();
+        utility::page_options options;
+        options.huge_pages = false;
+        options.placement = utility::page_placement::interleaved;
+        bvh.set_node_options(options);
+        EXPECT_TRUE(options == bvh.get_node_options());
+        ASSERT_EQ(heap.size(), bvh.get_nodes().size());
+        for (std::size_t index = 0; index < heap.size(); ++index)
+        {
+            EXPECT_EQ(heap[index].bounds, bvh.get_nodes()[index].bounds);
+            EXPECT_EQ(heap[index].first, bvh.get_nodes()[index].first);
+        }
+
+        // a rebuild keeps the options
+        bvh.build(box_row(50), 2);
+        EXPECT_TRUE(options == bvh.get_node_options());
+        const auto intersect = [&](const std::uint32_t primitive, double& t_max)
+        {
+            double t_enter = 0, t_exit = 0;
+            if (!utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, t_max).intersect(boxes[primitive], t_enter, t_exit))
+                return false;
+
+            t_max = t_enter;
+            return true;
+        };
+        EXPECT_EQ(0u, bvh.closest_hit(utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, 1000), intersect));
+    }
+
+    TEST(bvh_test, refit)
+    {
+        std::vector<aabb> boxes = box_row(100);
+        utility::bvh bvh(boxes, 2, utility::bvh_layout::van_emde_boas);
+        const std::size_t node_count = bvh.get_nodes().size();
+
+        // every box moves up by 10, the last one moves to the front
+        for (aabb& box : boxes)
+            box = aabb(box.minimum + vector3d(0, 10, 0), box.maximum + vector3d(0, 10, 0));
+        boxes.back() = aabb({-3, 10, 0}, {-2, 11, 1});
+        bvh.refit(boxes);
+
+        EXPECT_EQ(node_count, bvh.get_nodes().size());
+        EXPECT_EQ(aabb({-3, 10, 0}, {197, 11, 1}), bvh.get_nodes()[0].bounds);
+        for (const utility::bvh_node& node : bvh.get_nodes())
+            if (!node.is_leaf())
+            {
+                EXPECT_TRUE(node.bounds.contains(bvh.get_nodes()[node.first].bounds));
+                EXPECT_TRUE(node.bounds.contains(bvh.get_nodes()[node.first + 1].bounds));
+            }
+
+        double best = math::inf;
+        const std::uint32_t nearest = bvh.nearest(point3d(-10, 10.5, 0.5), [&](const std::uint32_t primitive)
+        {
+            return boxes[primitive].distance_squared(point3d(-10, 10.5, 0.5));
+        }, best);
+        EXPECT_EQ(99u, nearest);
+        EXPECT_NEAR(49.0, best, ROUND_EPSILON);
+
+        EXPECT_THROW(bvh.refit(box_row(99)), exception::out_of_range_exception);
+    }
+
+    TEST(bvh_test, closest_hit)
+    {
+        const std::vector<aabb> boxes = box_row(100);
+        const utility::bvh bvh(boxes, 4);
+
+        std::size_t tested = 0;
+        const auto intersect = [&](const std::uint32_t primitive, double& t_max)
+        {
+            ++tested;
+            double t_enter = 0, t_exit = 0;
+            if (!utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, t_max).intersect(boxes[primitive], t_enter, t_exit))
+                return false;
+
+            t_max = t_enter;
+            return true;
+        };
+
+        EXPECT_EQ(0u, bvh.closest_hit(utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, 1000), intersect));
+
+        // front to back traversal, only the first few leaves are tested
+        EXPECT_LT(tested, 20u);
+
+        const auto never = [](std::uint32_t, double&) { return false; };
+        const std::uint32_t no_primitive = utility::bvh::no_primitive;
+        EXPECT_EQ(no_primitive, bvh.closest_hit(utility::ray({-10, 5, 0.5}, {1, 0, 0}, 1000), never));
+    }
+
+    TEST(bvh_test, nearest)
+    {
+        const std::vector<aabb> boxes = box_row(100);
+        const utility::bvh bvh(boxes, 4);
+
+        std::size_t tested = 0;
+        const point3d query = {100.5, 3, 0.5};
+        double best = math::inf;
+
+        const std::uint32_t nearest = bvh.nearest(query, [&](const std::uint32_t primitive)
+        {
+            ++tested;
+            return boxes[primitive].distance_squared(query);
+        }, best);
+
+        EXPECT_EQ(50u, nearest);
+        EXPECT_NEAR(4.0, best, ROUND_EPSILON);
+        EXPECT_LT(tested, 20u);
+
+        // nothing within the maximum distance
+        double limited = 1;
+        const std::uint32_t no_primitive = utility::bvh::no_primitive;
+        EXPECT_EQ(no_primitive, bvh.nearest(query, [&](const std::uint32_t primitive)
+        {
+            return boxes[primitive].distance_squared(query);
+        }, limited));
+    }
+
+    TEST(bvh_test, layouts)
+    {
+        // a grid of boxes, so the tree is a few levels deep in every direction
+        std::vector<aabb> boxes;
+        for (int x = 0; x < 12; ++x)
+            for (int y = 0; y < 12; ++y)
+                for (int z = 0; z < 12; ++z)
+                    boxes.emplace_back(point3d(2 * x, 2 * y, 2 * z), point3d(2 * x + 1, 2 * y + 1.5, 2 * z + 1));
+
+        const utility::bvh reference(boxes, 2);
+
+        const auto closest = [&](const utility::bvh& bvh, const utility::ray& ray)
+        {
+            return bvh.closest_hit(ray, [&](const std::uint32_t primitive, double& t_max)
+            {
+                double t_enter = 0, t_exit = 0;
+                if (!utility::ray(ray.get_position(), ray.get_direction(), t_max).intersect(boxes[primitive],
+                                                                                          t_enter, t_exit))
+                    return false;
+
+                t_max = t_enter;
+                return true;
+            });
+        };
+
+        for (const utility::bvh_layout layout : {
+                 utility::bvh_layout::depth_first, utility::bvh_layout::hot_first, utility::bvh_layout::breadth_first,
+                 utility::bvh_layout::van_emde_boas
+             })
+        {
+            const utility::bvh bvh(boxes, 2, layout);
+            EXPECT_TRUE(bvh.get_layout() == layout);
+
+            const utility::bvh::node_vector& nodes = bvh.get_nodes();
+            ASSERT_EQ(reference.get_nodes().size(), nodes.size());
+            EXPECT_EQ(reference.get_nodes()[0].bounds, nodes[0].bounds);
+
+            // children are stored after their parent and inside its bounds, every node is reached exactly once
+            std::vector<int> reached(nodes.size(), 0);
+            reached[0] = 1;
+            for (std::size_t index = 0; index < nodes.size(); ++index)
+            {
+                if (nodes[index].is_leaf())
+                    continue;
+
+                ASSERT_GT(nodes[index].first, index);
+                ASSERT_LT(nodes[index].first + 1, nodes.size());
+                for (std::uint32_t child = nodes[index].first; child < nodes[index].first + 2; ++child)
+                {
+                    ++reached[child];
+                    EXPECT_TRUE(nodes[index].bounds.overlaps(nodes[child].bounds));
+                }
+            }
+
+            for (const int count : reached)
+                EXPECT_EQ(1, count);
+
+            // the layout only changes the order in memory, not the results
+            for (int i = 0; i < 50; ++i)
+            {
+                const utility::ray ray({-5, 0.3 * i, 0.7 * i - 3}, {1, 0.1, 0.05 * (i % 7) - 0.1}, 100);
+                EXPECT_EQ(closest(reference, ray), closest(bvh, ray));
+
+                const point3d query = {0.5 * i, 25 - 0.4 * i, 0.3 * i};
+                const auto distance = [&](const std::uint32_t primitive)
+                {
+                    return boxes[primitive].distance_squared(query);
+                };
+                double expected = math::inf, actual = math::inf;
+                const std::uint32_t expected_primitive = reference.nearest(query, distance, expected);
+                const std::uint32_t actual_primitive = bvh.nearest(query, distance, actual);
+                EXPECT_NEAR(expected, actual, ROUND_EPSILON);
+                EXPECT_TRUE(boxes[expected_primitive].distance_squared(query) ==
+                    boxes[actual_primitive].distance_squared(query));
+            }
+        }
+
+        // the hot child comes first, the pair below it is stored right after the pair of the root
+        const utility::bvh hot(boxes, 2, utility::bvh_layout::hot_first);
+        const utility::bvh_node& left = hot.get_nodes()[1];
+        const utility::bvh_node& right = hot.get_nodes()[2];
+        const utility::bvh_node& hottest = left.bounds.surface_area() >= right.bounds.surface_area() ? left : right;
+        ASSERT_FALSE(hottest.is_leaf());
+        EXPECT_EQ(3u, hottest.first);
+
+        // breadth first, the grandchildren of the root follow its children
+        const utility::bvh breadth(boxes, 2, utility::bvh_layout::breadth_first);
+        EXPECT_EQ(3u, breadth.get_nodes()[1].first);
+        EXPECT_EQ(5u, breadth.get_nodes()[2].first);
+
+        // van emde boas on a balanced tree of 16 leaves, 4 levels of sibling pairs: the pair of the root and
+        // the 2 pairs below it come first, then each of the 4 pairs on the third level followed by its 2 leaf pairs
+        const utility::bvh van_emde_boas(box_row(16), 1, utility::bvh_layout::van_emde_boas);
+        const utility::bvh::node_vector& veb = van_emde_boas.get_nodes();
+        ASSERT_EQ(31u, veb.size());
+
+        std::vector<std::uint32_t> firsts;
+        for (const utility::bvh_node& node : veb)
+            if (!node.is_leaf())
+                firsts.push_back(node.first);
+        EXPECT_EQ(std::vector<std::uint32_t>({1, 3, 5, 7, 13, 19, 25, 9, 11, 15, 17, 21, 23, 27, 29}), firsts);
+    }
+} // namespace testing
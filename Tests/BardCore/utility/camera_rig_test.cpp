@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "BardCore/utility/camera_rig.h"
+
+namespace testing
+{
+    TEST(camera_rig_test, generate)
+    {
+        for (const utility::camera_projection projection : {
+                 utility::camera_projection::perspective, utility::camera_projection::orthographic,
+                 utility::camera_projection::equirectangular
+             })
+        {
+            // a 3 x 1 light field row, turned slightly towards the center
+            std::vector<utility::camera> views;
+            for (int view = 0; view < 3; ++view)
+            {
+                views.emplace_back(point3d(view - 1., 0, 0), vector3d(-0.1 * (view - 1), 0, 1), 12, 10, 80);
+                views.back().set_projection(projection);
+            }
+
+            const utility::camera_rig rig(views);
+            ASSERT_EQ(3u, rig.view_count());
+            ASSERT_EQ(120u, rig.pixel_count());
+
+            const std::vector<utility::ray> rays = rig.generate(40);
+            ASSERT_EQ(360u, rays.size());
+            for (unsigned int y = 0; y < 10; ++y)
+                for (unsigned int x = 0; x < 12; ++x)
+                    for (std::size_t view = 0; view < 3; ++view)
+                        EXPECT_EQ(views[view].shoot_ray(x, y, 40), rays[(y * 12 + x) * 3 + view]);
+        }
+    }
+
+    TEST(camera_rig_test, generate_shared_orientation)
+    {
+        for (const utility::camera_projection projection : {
+                 utility::camera_projection::perspective, utility::camera_projection::orthographic,
+                 utility::camera_projection::fisheye
+             })
+        {
+            // a 2 x 2 light field grid of parallel cameras and one turned camera
+            std::vector<utility::camera> views;
+            for (int view = 0; view < 4; ++view)
+                views.emplace_back(point3d(view % 2, view / 2, 0), vector3d(0.2, 0.1, 1), 9, 7, 70);
+            views.emplace_back(point3d(0, 0, 0), vector3d(-0.3, 0, 1), 9, 7, 70);
+            for (utility::camera& view : views)
+                view.set_projection(projection);
+
+            const std::vector<utility::ray> rays = utility::camera_rig(views).generate(25);
+            for (unsigned int y = 0; y < 7; ++y)
+                for (unsigned int x = 0; x < 9; ++x)
+                    for (std::size_t view = 0; view < views.size(); ++view)
+                        EXPECT_EQ(views[view].shoot_ray(x, y, 25), rays[(y * 9 + x) * views.size() + view]);
+        }
+    }
+
+    TEST(camera_rig_test, stereo)
+    {
+        const utility::camera center({1, 2, 3}, {0, 0, 1}, 8, 8, 90);
+        utility::camera_rig rig = utility::camera_rig::stereo(center, 0.064);
+        ASSERT_EQ(2u, rig.view_count());
+
+        // the eyes are parallel, left and right of the center
+        const vector3d between = rig.get_views()[0].get_position().get_vector(rig.get_views()[1].get_position());
+        EXPECT_NEAR(0.064, between.length(), ROUND_EPSILON);
+        EXPECT_NEAR(0.064, between.dot(center.get_right()), ROUND_EPSILON);
+        EXPECT_EQ(center.get_direction(), rig.get_views()[0].get_direction());
+
+        const std::vector<utility::ray> rays = rig.generate(10);
+        EXPECT_EQ(rays[2 * 13].get_direction(), rays[2 * 13 + 1].get_direction());
+
+        // moving an eye, the table still matches
+        utility::camera left = rig.get_views()[0];
+        left.set_position({0, 0, 0});
+        rig.set_views({left, rig.get_views()[1]});
+        EXPECT_TRUE(rig.get_lut().matches(left));
+        EXPECT_EQ(left.shoot_ray(4, 5, 10), rig.generate(10)[(5 * 8 + 4) * 2]);
+
+        EXPECT_THROW(utility::camera_rig::stereo(center, -1), exception::negative_exception);
+        EXPECT_THROW((void)rig.generate(-1), exception::negative_exception);
+    }
+
+    TEST(camera_rig_test, exceptions)
+    {
+        const utility::camera camera({0, 0, 0}, {0, 0, 1}, 8, 8, 90);
+        utility::camera fisheye = camera;
+        fisheye.set_projection(utility::camera_projection::fisheye);
+
+        EXPECT_THROW(utility::camera_rig(std::vector<utility::camera>()), exception::zero_exception);
+        EXPECT_THROW(utility::camera_rig({camera, fisheye}), exception::out_of_range_exception);
+        EXPECT_THROW(utility::camera_rig({camera, utility::camera({0, 0, 0}, {0, 0, 1}, 8, 8, 60)}),
+                     exception::out_of_range_exception);
+        EXPECT_THROW(utility::camera_rig({camera, utility::camera({0, 0, 0}, {0, 0, 1}, 8, 9, 90)}),
+                     exception::out_of_range_exception);
+    }
+} // namespace testing
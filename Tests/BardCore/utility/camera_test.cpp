@@ -131,5 +131,141 @@ namespace testing
         EXPECT_THROW(cam.shoot_ray(screen_width, screen_height, distance), exception::out_of_range_exception);
         EXPECT_NO_THROW(cam.shoot_ray(0, 0, distance));
         EXPECT_NO_THROW(cam.shoot_ray(screen_width - 1, screen_height - 1, distance));
+        // every projection checks the pixel
+        for (const utility::camera_projection projection : {
+                 utility::camera_projection::perspective, utility::camera_projection::orthographic,
+                 utility::camera_projection::fisheye, utility::camera_projection::equirectangular
+             })
+        {
+            utility::camera projected(position, direction, 10, 10);
+            projected.set_projection(projection);
+
+            EXPECT_THROW((void)projected.shoot_ray(50, 3, 1), exception::out_of_range_exception);
+            EXPECT_THROW((void)projected.shoot_ray(3, 10, 1), exception::out_of_range_exception);
+            EXPECT_THROW((void)projected.shoot_ray(10, 3, 1, 0.5, 0.5), exception::out_of_range_exception);
+            EXPECT_NO_THROW((void)projected.shoot_ray(9, 9, 1));
+        }
+    }
+
+    TEST(camera_test, thin_lens)
+    {
+        utility::camera cam({-1, 2, 0}, {9, 65, 24}, 100, 100, 60);
+        EXPECT_EQ(0.0, cam.get_aperture());
+        EXPECT_EQ(1.0, cam.get_focal_distance());
+
+        // a pinhole gives the same rays as shoot_ray
+        EXPECT_EQ(cam.shoot_ray(63, 65, 73), cam.shoot_ray(63, 65, 73, 0.3, 0.9));
+
+        cam.set_aperture(0.5);
+        cam.set_focal_distance(10);
+        EXPECT_NEAR(0.25, cam.get_lens_horizontal().length(), ROUND_EPSILON);
+        EXPECT_NEAR(0, cam.get_lens_horizontal().dot(cam.get_direction()), ROUND_EPSILON);
+        EXPECT_NEAR(0, cam.get_lens_vertical().dot(cam.get_lens_horizontal()), ROUND_EPSILON);
+
+        // every ray through a pixel starts on the lens and passes the focal point
+        const point3d focal_point = cam.get_focal_point(20, 70);
+        EXPECT_NEAR(10, cam.get_position().get_vector(focal_point).dot(cam.get_direction()), ROUND_EPSILON);
+        for (const double u : {0., 0.2, 0.5, 1.})
+        {
+            for (const double v : {0., 0.7, 1.})
+            {
+                const utility::ray ray = cam.shoot_ray(20, 70, 100, u, v);
+                const vector3d offset = cam.get_position().get_vector(ray.get_position());
+                EXPECT_LE(offset.length(), 0.25 + ROUND_EPSILON);
+                EXPECT_NEAR(0, offset.dot(cam.get_direction()), ROUND_EPSILON);
+
+                const vector3d to_focal = ray.get_position().get_vector(focal_point);
+                EXPECT_NEAR(to_focal.length(), to_focal.dot(ray.get_direction()), ROUND_EPSILON);
+            }
+        }
+
+        EXPECT_NE(cam, utility::camera({-1, 2, 0}, {9, 65, 24}, 100, 100, 60));
+        EXPECT_THROW((void)cam.shoot_ray(0, 0, 1, -0.1, 0), exception::out_of_range_exception);
+        EXPECT_THROW((void)cam.shoot_ray(0, 0, 1, 0, 1.1), exception::out_of_range_exception);
+        EXPECT_THROW((void)cam.get_focal_point(100, 0), exception::out_of_range_exception);
+        EXPECT_THROW(cam.set_aperture(-1), exception::negative_exception);
+        EXPECT_THROW(cam.set_focal_distance(0), exception::zero_exception);
+        EXPECT_THROW(cam.set_focal_distance(-1), exception::negative_exception);
+    }
+
+    TEST(camera_test, concentric_disk)
+    {
+        // the corners and edge centers of the square map to the circle, the center to the center
+        double x = 1, y = 1;
+        utility::camera::concentric_disk(0.5, 0.5, x, y);
+        EXPECT_EQ(0.0, x);
+        EXPECT_EQ(0.0, y);
+
+        utility::camera::concentric_disk(1, 0.5, x, y);
+        EXPECT_NEAR(1, x, ROUND_EPSILON);
+        EXPECT_NEAR(0, y, ROUND_EPSILON);
+
+        utility::camera::concentric_disk(0.5, 0, x, y);
+        EXPECT_NEAR(0, x, ROUND_EPSILON);
+        EXPECT_NEAR(-1, y, ROUND_EPSILON);
+
+        utility::camera::concentric_disk(1, 1, x, y);
+        EXPECT_NEAR(std::sqrt(0.5), x, ROUND_EPSILON);
+        EXPECT_NEAR(std::sqrt(0.5), y, ROUND_EPSILON);
+
+        // same as the mapping with trigonometry
+        for (double u = 0; u <= 1; u += 0.0625)
+        {
+            for (double v = 0; v <= 1; v += 0.0625)
+            {
+                const double a = 2 * u - 1, b = 2 * v - 1;
+                double radius = 0, angle = 0;
+                if (a * a > b * b)
+                {
+                    radius = a;
+                    angle = math::pi_4 * (b / a);
+                }
+                else if (b != 0)
+                {
+                    radius = b;
+                    angle = math::pi_2 - math::pi_4 * (a / b);
+                }
+
+                utility::camera::concentric_disk(u, v, x, y);
+                EXPECT_NEAR(radius * std::cos(angle), x, ROUND_EPSILON);
+                EXPECT_NEAR(radius * std::sin(angle), y, ROUND_EPSILON);
+            }
+        }
+    }
+
+    TEST(camera_test, projections)
+    {
+        utility::camera cam({1, 2, 3}, {0, 0, 1}, 100, 50, 120);
+        EXPECT_EQ(utility::camera_projection::perspective, cam.get_projection());
+        EXPECT_NEAR(0, cam.get_right().dot(cam.get_up()), ROUND_EPSILON);
+        EXPECT_NEAR(0, cam.get_right().dot(cam.get_direction()), ROUND_EPSILON);
+
+        // orthographic rays are parallel and start on the perspective screen
+        cam.set_projection(utility::camera_projection::orthographic);
+        EXPECT_NE(cam, utility::camera({1, 2, 3}, {0, 0, 1}, 100, 50, 120));
+        const utility::ray ortho = cam.shoot_ray(10, 40, 5);
+        EXPECT_EQ(cam.get_direction(), ortho.get_direction());
+        EXPECT_NEAR(0, cam.get_position().get_vector(ortho.get_position()).dot(cam.get_direction()), ROUND_EPSILON);
+        EXPECT_NEAR(1, cam.get_position().get_vector(cam.shoot_ray(50, 0, 5).get_position())
+                    .dot(cam.get_up()) / math::tan(math::degrees_to_radians(60.)), ROUND_EPSILON);
+
+        // fisheye, the angle to the direction grows linearly to half the fov at the left edge
+        cam.set_projection(utility::camera_projection::fisheye);
+        EXPECT_EQ(cam.get_direction(), cam.shoot_ray(50, 25, 5).get_direction());
+        EXPECT_NEAR(math::cos(math::degrees_to_radians(60.)),
+                    cam.shoot_ray(0, 25, 5).get_direction().dot(cam.get_direction()), ROUND_EPSILON);
+        EXPECT_NEAR(math::cos(math::degrees_to_radians(30.)),
+                    cam.shoot_ray(25, 25, 5).get_direction().dot(cam.get_direction()), ROUND_EPSILON);
+
+        // equirectangular, the center looks forward, the left edge backward and the top row up
+        cam.set_projection(utility::camera_projection::equirectangular);
+        EXPECT_EQ(cam.get_direction(), cam.shoot_ray(50, 25, 5).get_direction());
+        EXPECT_EQ(cam.get_direction() * -1, cam.shoot_ray(0, 25, 5).get_direction());
+        EXPECT_EQ(cam.get_right(), cam.shoot_ray(75, 25, 5).get_direction());
+        EXPECT_EQ(cam.get_up(), cam.shoot_ray(50, 0, 5).get_direction());
+
+        // the lens only exists for the perspective projection
+        cam.set_aperture(1);
+        EXPECT_EQ(cam.shoot_ray(10, 10, 5), cam.shoot_ray(10, 10, 5, 0.9, 0.1));
     }
 } // namespace testing
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "BardCore/utility/convex_hull.h"
+
+#include <random>
+
+namespace testing
+{
+    static std::vector<point3d> random_ball(const std::size_t count, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-1, 1);
+
+        std::vector<point3d> points;
+        while (points.size() < count)
+        {
+            const point3d point(coordinate(generator), coordinate(generator), coordinate(generator));
+            if (point.x * point.x + point.y * point.y + point.z * point.z <= 1)
+                points.push_back(point);
+        }
+        return points;
+    }
+
+    // closed, every edge is used once in both directions, and every vertex is behind every face
+    static void expect_valid_hull(const utility::convex_hull& hull, const std::vector<point3d>& points,
+                                  const std::size_t stride = 1)
+    {
+        const std::vector<std::uint32_t>& indices = hull.get_indices();
+        ASSERT_EQ(0u, indices.size() % 3);
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        for (std::size_t index = 0; index < indices.size(); index += 3)
+            for (std::size_t edge = 0; edge < 3; ++edge)
+                edges.emplace_back(indices[index + edge], indices[index + (edge + 1) % 3]);
+
+        std::sort(edges.begin(), edges.end());
+        for (const std::pair<std::uint32_t, std::uint32_t>& edge : edges)
+            EXPECT_TRUE(std::binary_search(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first)));
+        EXPECT_TRUE(std::adjacent_find(edges.begin(), edges.end()) == edges.end());
+
+        // euler characteristic of a closed triangle mesh of genus 0
+        EXPECT_EQ(2 * hull.get_vertices().size() - 4, hull.face_count());
+
+        for (std::size_t index = 0; index < hull.get_vertices().size(); ++index)
+            EXPECT_EQ(points[hull.get_point_indices()[index]], hull.get_vertices()[index]);
+
+        for (std::size_t index = 0; index < points.size(); index += stride)
+            EXPECT_TRUE(hull.contains(points[index], 1e-9));
+    }
+
+    TEST(convex_hull_test, cube)
+    {
+        std::vector<point3d> points = random_ball(500, 1);
+        for (point3d& point : points)
+            point = point3d(point.x * 0.4 + 0.5, point.y * 0.4 + 0.5, point.z * 0.4 + 0.5);
+        for (int corner = 0; corner < 8; ++corner)
+            points.emplace_back(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+
+        const utility::convex_hull hull(points);
+
+        EXPECT_EQ(8u, hull.get_vertices().size());
+        EXPECT_EQ(12u, hull.face_count());
+        EXPECT_NEAR(1.0, hull.volume(), ROUND_EPSILON);
+        EXPECT_TRUE(hull.contains({0.5, 0.5, 0.5}));
+        EXPECT_TRUE(hull.contains({1, 1, 1}));
+        EXPECT_FALSE(hull.contains({1.1, 0.5, 0.5}));
+
+        for (const std::uint32_t index : hull.get_point_indices())
+            EXPECT_GE(index, 500u);
+
+        expect_valid_hull(hull, points);
+    }
+
+    TEST(convex_hull_test, coplanar_points)
+    {
+        // a grid on every side of a cube, most points lie on a face of the hull
+        std::vector<point3d> points;
+        for (int i = 0; i <= 10; ++i)
+        {
+            for (int j = 0; j <= 10; ++j)
+            {
+                points.emplace_back(0, i / 10., j / 10.);
+                points.emplace_back(1, i / 10., j / 10.);
+                points.emplace_back(i / 10., 0, j / 10.);
+                points.emplace_back(i / 10., 1, j / 10.);
+                points.emplace_back(i / 10., j / 10., 0);
+                points.emplace_back(i / 10., j / 10., 1);
+            }
+        }
+
+        const utility::convex_hull hull(points);
+
+        EXPECT_NEAR(1.0, hull.volume(), ROUND_EPSILON);
+        expect_valid_hull(hull, points);
+    }
+
+    TEST(convex_hull_test, random_ball)
+    {
+        const std::vector<point3d> points = random_ball(20000, 2);
+        const utility::convex_hull hull(points);
+
+        EXPECT_FALSE(hull.is_empty());
+        EXPECT_LT(hull.get_vertices().size(), points.size());
+        EXPECT_LT(hull.volume(), 4. / 3 * math::pi);
+        EXPECT_GT(hull.volume(), 4.);
+
+        expect_valid_hull(hull, points);
+    }
+
+    TEST(convex_hull_test, large_cloud)
+    {
+        // large enough for the parallel passes, only the points moved to the unit sphere are on the hull
+        std::vector<point3d> points = random_ball(100000, 3);
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            const point3d& point = points[index];
+            const double length = index % 50 == 0
+                                      ? std::sqrt(point.x * point.x + point.y * point.y + point.z * point.z)
+                                      : 1.1;
+            points[index] = point3d(point.x / length, point.y / length, point.z / length);
+        }
+
+        const utility::convex_hull hull(points);
+
+        EXPECT_EQ(2000u, hull.get_vertices().size());
+        expect_valid_hull(hull, points, 7);
+    }
+
+    TEST(convex_hull_test, degenerate)
+    {
+        EXPECT_TRUE(utility::convex_hull().is_empty());
+        EXPECT_TRUE(utility::convex_hull({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}}).is_empty());
+
+        // coplanar
+        const utility::convex_hull plane({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0.5, 0.5, 0}});
+        EXPECT_TRUE(plane.is_empty());
+        EXPECT_FALSE(plane.contains({0, 0, 0}));
+        EXPECT_EQ(0.0, plane.volume());
+
+        // collinear
+        EXPECT_TRUE(utility::convex_hull({{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3}}).is_empty());
+
+        // a tetrahedron
+        const utility::convex_hull tetrahedron({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}});
+        EXPECT_EQ(4u, tetrahedron.face_count());
+        EXPECT_NEAR(1. / 6, tetrahedron.volume(), ROUND_EPSILON);
+    }
+} // namespace testing
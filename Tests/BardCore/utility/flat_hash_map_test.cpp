@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "BardCore/utility/flat_hash_map.h"
+
+#include <random>
+#include <unordered_map>
+
+namespace testing
+{
+    TEST(flat_hash_map_test, insert_find)
+    {
+        utility::flat_hash_map<int, int> map;
+        EXPECT_TRUE(map.empty());
+        EXPECT_EQ(nullptr, map.find(1));
+
+        const std::pair<int*, bool> inserted = map.insert(1, 10);
+        EXPECT_TRUE(inserted.second);
+        EXPECT_EQ(10, *inserted.first);
+
+        // an existing value is kept
+        const std::pair<int*, bool> existing = map.insert(1, 20);
+        EXPECT_FALSE(existing.second);
+        EXPECT_EQ(10, *existing.first);
+
+        map[2] = 30;
+        ++map[3];
+        EXPECT_EQ(3u, map.size());
+        EXPECT_EQ(30, *map.find(2));
+        EXPECT_EQ(1, *map.find(3));
+        EXPECT_TRUE(map.contains(1));
+        EXPECT_FALSE(map.contains(4));
+
+        int sum = 0;
+        map.for_each([&](const int key, const int value) { sum += key * value; });
+        EXPECT_EQ(10 + 60 + 3, sum);
+
+        map.clear();
+        EXPECT_TRUE(map.empty());
+        EXPECT_FALSE(map.contains(1));
+    }
+
+    TEST(flat_hash_map_test, random)
+    {
+        // compare with std::unordered_map, sequential keys test the mixing of a weak hash
+        std::mt19937 generator(1);
+        std::uniform_int_distribution<int> key(0, 5000);
+        std::uniform_int_distribution<int> operation(0, 2);
+
+        utility::flat_hash_map<int, int> map;
+        std::unordered_map<int, int> expected;
+
+        for (int step = 0; step < 50000; ++step)
+        {
+            const int current = key(generator);
+            switch (operation(generator))
+            {
+            case 0:
+                EXPECT_EQ(expected.emplace(current, step).second, map.insert(current, step).second);
+                break;
+            case 1:
+                EXPECT_EQ(expected.erase(current) == 1, map.erase(current));
+                break;
+            default:
+                {
+                    const auto found = expected.find(current);
+                    const int* value = map.find(current);
+                    ASSERT_EQ(found == expected.end(), value == nullptr);
+                    if (value != nullptr)
+                    {
+                        EXPECT_EQ(found->second, *value);
+                    }
+                }
+                break;
+            }
+        }
+
+        EXPECT_EQ(expected.size(), map.size());
+        EXPECT_LE(map.size() * 4, map.capacity() * 3);
+        for (const auto& entry : expected)
+            EXPECT_EQ(entry.second, *map.find(entry.first));
+    }
+
+    TEST(flat_hash_map_test, reserve)
+    {
+        utility::flat_hash_map<int, int> map(1000);
+        const std::size_t capacity = map.capacity();
+        EXPECT_GE(capacity * 3, 1000u * 4);
+
+        for (int index = 0; index < 1000; ++index)
+            map.insert(index * 1024, index);
+
+        EXPECT_EQ(capacity, map.capacity());
+        for (int index = 0; index < 1000; ++index)
+            EXPECT_EQ(index, *map.find(index * 1024));
+    }
+} // namespace testing
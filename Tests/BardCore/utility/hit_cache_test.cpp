@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "BardCore/utility/hit_cache.h"
+
+#include <atomic>
+
+namespace testing
+{
+    // the floor y = 0, primitive 0, everything else is a miss
+    static utility::hit_record trace_floor(const utility::ray& ray)
+    {
+        utility::hit_record hit;
+        const double direction_y = ray.get_direction().y;
+        if (direction_y >= 0)
+            return hit;
+
+        const double t = -ray.get_position().y / direction_y;
+        if (t > ray.get_distance())
+            return hit;
+
+        hit.point = ray.get_position() + ray.get_direction() * t;
+        hit.normal = vector3d(0, 1, 0);
+        hit.distance = t;
+        hit.primitive = 0;
+        return hit;
+    }
+
+    TEST(hit_cache_test, update)
+    {
+        const utility::camera camera({0, 4, 0}, {0, -1, 2}, 16, 12, 80);
+        utility::hit_cache cache(camera, 100);
+        EXPECT_FALSE(cache.is_valid());
+
+        std::atomic<std::size_t> traced{0};
+        const auto trace = [&traced](const utility::ray& ray)
+        {
+            ++traced;
+            return trace_floor(ray);
+        };
+
+        EXPECT_TRUE(cache.update(camera, trace));
+        EXPECT_EQ(cache.pixel_count(), traced.load());
+        ASSERT_EQ(16u * 12u, cache.get_hits().size());
+        EXPECT_EQ(trace_floor(camera.shoot_ray(3, 11, 100)).point, cache.get_hits()[11 * 16 + 3].point);
+        EXPECT_TRUE(cache.get_hits()[0].primitive == utility::no_primitive); // above the horizon
+
+        // the same camera, nothing is traced
+        traced = 0;
+        EXPECT_FALSE(cache.update(camera, trace));
+        EXPECT_EQ(0u, traced.load());
+
+        // the lens and the fov of an equirectangular camera don't change the rays
+        utility::camera lens = camera;
+        lens.set_aperture(0.5);
+        lens.set_focal_distance(3);
+        EXPECT_TRUE(cache.matches(lens));
+        EXPECT_FALSE(cache.update(lens, trace));
+
+        utility::camera panorama = camera;
+        panorama.set_projection(utility::camera_projection::equirectangular);
+        EXPECT_TRUE(cache.update(panorama, trace));
+        panorama.set_fov(120);
+        EXPECT_TRUE(cache.matches(panorama));
+        EXPECT_TRUE(cache.update(camera, trace));
+
+        // a moved camera, the geometry or the distance changed
+        utility::camera moved = camera;
+        moved.set_position({1, 4, 0});
+        EXPECT_TRUE(cache.update(moved, trace));
+        EXPECT_FALSE(cache.matches(camera));
+        cache.invalidate();
+        EXPECT_TRUE(cache.update(moved, trace));
+        cache.set_distance(100);
+        EXPECT_FALSE(cache.update(moved, trace));
+        cache.set_distance(2);
+        EXPECT_TRUE(cache.update(moved, trace));
+        EXPECT_TRUE(cache.get_hits()[11 * 16 + 3].primitive == utility::no_primitive);
+
+        EXPECT_THROW(cache.set_distance(-1), exception::negative_exception);
+        EXPECT_THROW(utility::hit_cache(camera, -1), exception::negative_exception);
+    }
+
+    TEST(hit_cache_test, relight)
+    {
+        const utility::camera camera({0, 4, 0}, {0, -1, 2}, 16, 12, 80);
+        utility::hit_cache cache(camera, 100);
+        const auto unoccluded = [](const utility::ray&) { return false; };
+        EXPECT_THROW((void)cache.relight({}, unoccluded), exception::out_of_range_exception);
+
+        std::atomic<std::size_t> traced{0};
+        (void)cache.update(camera, [&traced](const utility::ray& ray)
+        {
+            ++traced;
+            return trace_floor(ray);
+        });
+
+        // only the lights change, the shading runs without tracing
+        std::vector<utility::light> lights = {utility::light({0, 2, 3}, 10)};
+        for (const double intensity : {10., 20., 5.})
+        {
+            lights[0].intensity = intensity;
+            const std::vector<double> irradiance = cache.relight(lights, unoccluded);
+            ASSERT_EQ(cache.pixel_count(), irradiance.size());
+
+            const utility::hit_record& hit = cache.get_hits()[10 * 16 + 5];
+            const vector3d to_light = hit.point.get_vector(lights[0].position);
+            EXPECT_NEAR(to_light.y / to_light.length() * intensity / to_light.length_squared(), irradiance[10 * 16 + 5],
+                        ROUND_EPSILON);
+            EXPECT_EQ(0, irradiance[0]); // miss
+        }
+        EXPECT_EQ(cache.pixel_count(), traced.load());
+
+        // lights add up, a light below the floor adds nothing
+        lights.emplace_back(point3d(0, -2, 3), 50);
+        const std::vector<double> one = cache.relight({lights[0]}, unoccluded);
+        const std::vector<double> both = cache.relight(lights, unoccluded);
+        EXPECT_EQ(one, both);
+        lights.emplace_back(point3d(1, 3, 5), 5);
+        const std::vector<double> three = cache.relight(lights, unoccluded);
+        EXPECT_GT(three[10 * 16 + 5], one[10 * 16 + 5]);
+
+        // shadow rays start above the hit and end at the light
+        const std::vector<double> shadowed = cache.relight(lights, [&lights](const utility::ray& ray)
+        {
+            EXPECT_GT(ray.get_position().y, 0);
+            const point3d end = ray.get_position() + ray.get_direction() * ray.get_distance();
+            EXPECT_LT(end.distance(lights[0].position) * end.distance(lights[2].position), ROUND_EPSILON);
+            return true;
+        });
+        for (const double value : shadowed)
+            EXPECT_EQ(0, value);
+
+        // any shading, e.g. the depth
+        std::vector<double> depth(cache.pixel_count());
+        cache.shade([](const utility::hit_record& hit) { return hit.distance; }, depth.data());
+        EXPECT_EQ(cache.get_hits()[7].distance, depth[7]);
+    }
+} // namespace testing
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "BardCore/utility/lens_sampler.h"
+
+#include <random>
+
+namespace testing
+{
+    static utility::camera lens_camera()
+    {
+        utility::camera camera({1, -2, 3}, {2, 1, -4}, 24, 16, 70);
+        camera.set_aperture(0.4);
+        camera.set_focal_distance(6);
+        return camera;
+    }
+
+    TEST(lens_sampler_test, concentric_disk)
+    {
+        std::mt19937 random(5);
+        std::uniform_real_distribution<double> unit(0, 1);
+
+        std::vector<double> u(1000), v(1000), x(1000), y(1000);
+        for (std::size_t index = 0; index < u.size(); ++index)
+        {
+            u[index] = unit(random);
+            v[index] = unit(random);
+        }
+
+        utility::lens_sampler::concentric_disk(u.data(), v.data(), x.data(), y.data(), u.size());
+        for (std::size_t index = 0; index < u.size(); ++index)
+        {
+            double expected_x = 0, expected_y = 0;
+            utility::camera::concentric_disk(u[index], v[index], expected_x, expected_y);
+            EXPECT_EQ(expected_x, x[index]);
+            EXPECT_EQ(expected_y, y[index]);
+            EXPECT_LE(x[index] * x[index] + y[index] * y[index], 1 + ROUND_EPSILON);
+        }
+    }
+
+    TEST(lens_sampler_test, generate)
+    {
+        const utility::camera camera = lens_camera();
+        const utility::lens_sampler sampler(camera);
+        ASSERT_EQ(24u * 16u, sampler.pixel_count());
+        EXPECT_EQ(camera.get_focal_point(5, 9).x, sampler.get_focal_x()[9 * 24 + 5]);
+
+        const std::vector<double> u = {0, 0.25, 0.5, 0.9, 1};
+        const std::vector<double> v = {0.5, 1, 0.5, 0.1, 1};
+        const std::vector<utility::ray> rays = sampler.generate(5, 9, u, v, 50);
+        ASSERT_EQ(u.size(), rays.size());
+        for (std::size_t index = 0; index < u.size(); ++index)
+            EXPECT_EQ(camera.shoot_ray(5, 9, 50, u[index], v[index]), rays[index]);
+
+        EXPECT_THROW((void)sampler.generate(24, 0, u, v, 50), exception::out_of_range_exception);
+        EXPECT_THROW((void)sampler.generate(0, 0, u, {0.5}, 50), exception::out_of_range_exception);
+        EXPECT_THROW((void)sampler.generate(0, 0, {1.5}, {0.5}, 50), exception::out_of_range_exception);
+        EXPECT_THROW((void)sampler.generate(0, 0, u, v, -1), exception::negative_exception);
+    }
+
+    TEST(lens_sampler_test, generate_image)
+    {
+        const utility::camera camera = lens_camera();
+        const utility::lens_sampler sampler(camera);
+
+        const std::vector<double> u = {0.1, 0.6, 0.8};
+        const std::vector<double> v = {0.3, 0.5, 0.95};
+        const std::vector<utility::ray> rays = sampler.generate_image(u, v, 20);
+        ASSERT_EQ(sampler.pixel_count() * u.size(), rays.size());
+
+        // every pixel rotates the samples by its own offset
+        for (unsigned int y = 0; y < camera.get_screen_height(); ++y)
+        {
+            for (unsigned int x = 0; x < camera.get_screen_width(); ++x)
+            {
+                double offset_u = 0, offset_v = 0;
+                utility::lens_sampler::pixel_offset(y * camera.get_screen_width() + x, offset_u, offset_v);
+                for (std::size_t sample = 0; sample < u.size(); ++sample)
+                    EXPECT_EQ(camera.shoot_ray(x, y, 20, utility::lens_sampler::rotate(u[sample], offset_u),
+                                               utility::lens_sampler::rotate(v[sample], offset_v)),
+                              rays[(y * camera.get_screen_width() + x) * u.size() + sample]);
+            }
+        }
+
+        // neighbouring pixels don't start their rays at the same points on the lens
+        EXPECT_NE(rays[0].get_position(), rays[u.size()].get_position());
+        EXPECT_NE(rays[0].get_position(), rays[24 * u.size()].get_position());
+
+        double offset_u = 0, offset_v = 0;
+        for (std::size_t pixel = 0; pixel < 1000; ++pixel)
+        {
+            utility::lens_sampler::pixel_offset(pixel, offset_u, offset_v);
+            EXPECT_TRUE(offset_u >= 0 && offset_u < 1 && offset_v >= 0 && offset_v < 1);
+        }
+        EXPECT_NEAR(0.3, utility::lens_sampler::rotate(0.8, 0.5), ROUND_EPSILON);
+        EXPECT_LT(utility::lens_sampler::rotate(1, 0), 1.);
+
+        // a pinhole camera gives the pinhole rays for every sample
+        const utility::camera pinhole({1, -2, 3}, {2, 1, -4}, 24, 16, 70);
+        const std::vector<utility::ray> pinhole_rays = utility::lens_sampler(pinhole).generate_image(u, v, 20);
+        EXPECT_EQ(pinhole.shoot_ray(7, 3, 20), pinhole_rays[(3 * 24 + 7) * u.size() + 2]);
+
+        utility::camera fisheye = lens_camera();
+        fisheye.set_projection(utility::camera_projection::fisheye);
+        EXPECT_THROW(utility::lens_sampler{fisheye}, exception::out_of_range_exception);
+    }
+} // namespace testing
@@ -0,0 +1,165 @@
+#include "pch.h"
+#include "BardCore/math/sphere.h"
+#include "BardCore/utility/motion_bvh.h"
+
+#include <random>
+
+namespace testing
+{
+    // a sphere moving linearly from start to end over the shutter
+    struct moving_sphere
+    {
+        point3d start;
+        point3d end;
+        double radius;
+
+        NODISCARD sphere at(const double time) const
+        {
+            return {start + (end - start) * time, radius};
+        }
+
+        NODISCARD bool intersect(const utility::ray& ray, double& t_max) const
+        {
+            const sphere sphere = at(ray.get_time());
+            const vector3d offset = sphere.center.get_vector(ray.get_position());
+            const double b = offset.dot(ray.get_direction());
+            const double c = offset.dot(offset) - sphere.radius * sphere.radius;
+            const double discriminant = b * b - c;
+            if (discriminant < 0)
+                return false;
+
+            const double root = std::sqrt(discriminant);
+            const double t = -b - root >= 0 ? -b - root : -b + root;
+            if (t < 0 || t >= t_max)
+                return false;
+
+            t_max = t;
+            return true;
+        }
+    };
+
+    // bounds of the spheres at keys evenly spaced over the shutter
+    static std::vector<std::vector<aabb>> key_bounds(const std::vector<moving_sphere>& spheres, const int keys)
+    {
+        std::vector<std::vector<aabb>> bounds(keys);
+        for (int key = 0; key < keys; ++key)
+            for (const moving_sphere& sphere : spheres)
+                bounds[key].push_back(sphere.at(static_cast<double>(key) / (keys - 1)).bounds());
+        return bounds;
+    }
+
+    TEST(motion_bvh_test, build)
+    {
+        const std::vector<moving_sphere> spheres = {
+            {{0, 0, 0}, {10, 0, 0}, 1}, {{0, 5, 0}, {0, 5, 0}, 1}, {{-3, 0, 0}, {-3, 0, 4}, 0.5}
+        };
+        const utility::motion_bvh bvh(key_bounds(spheres, 2), 1);
+        EXPECT_EQ(2u, bvh.key_count());
+        EXPECT_EQ(2 * bvh.get_bvh().get_nodes().size(), bvh.get_key_bounds().size());
+
+        // the root is interpolated between the keys, the topology contains the whole shutter
+        EXPECT_EQ(aabb({-3.5, -1, -1}, {1, 6, 1}), bvh.get_bounds(0, 0));
+        EXPECT_EQ(aabb({-3.5, -1, -1}, {11, 6, 4.5}), bvh.get_bounds(0, 1));
+        EXPECT_EQ(aabb({-3.5, -1, -1}, {6, 6, 2.75}), bvh.get_bounds(0, 0.5));
+        EXPECT_EQ(aabb({-3.5, -1, -1}, {11, 6, 4.5}), bvh.get_bvh().get_nodes()[0].bounds);
+
+        // time is clamped to the shutter
+        EXPECT_EQ(bvh.get_bounds(0, 1), bvh.get_bounds(0, 2));
+        EXPECT_EQ(bvh.get_bounds(0, 0), bvh.get_bounds(0, -1));
+
+        EXPECT_THROW((void)bvh.get_bounds(static_cast<std::uint32_t>(bvh.get_bvh().get_nodes().size()), 0),
+                     exception::out_of_range_exception);
+        EXPECT_THROW(utility::motion_bvh(std::vector<std::vector<aabb>>()), exception::zero_exception);
+        EXPECT_THROW(utility::motion_bvh({{aabb()}, {}}), exception::out_of_range_exception);
+        EXPECT_TRUE(utility::motion_bvh().is_empty());
+    }
+
+    TEST(motion_bvh_test, closest_hit_time)
+    {
+        // a sphere moving along x and a ray along z through x = 5, only hit in the middle of the shutter
+        const std::vector<moving_sphere> spheres = {{{0, 0, 0}, {10, 0, 0}, 1}, {{0, 3, 0}, {0, 3, 0}, 1}};
+        const utility::motion_bvh bvh(key_bounds(spheres, 2), 1);
+        const auto intersect = [&](const std::uint32_t primitive, const utility::ray& ray, double& t_max)
+        {
+            return spheres[primitive].intersect(ray, t_max);
+        };
+
+        for (const double time : {0., 0.25, 0.5, 0.75, 1.})
+        {
+            const utility::ray ray({5, 0, -10}, {0, 0, 1}, 100, time);
+            const std::uint32_t hit = bvh.closest_hit(ray, [&](const std::uint32_t primitive, double& t_max)
+            {
+                return intersect(primitive, ray, t_max);
+            });
+            EXPECT_EQ(time == 0.5 ? 0u : utility::bvh::no_primitive, hit);
+        }
+
+        // the static sphere is hit at every time
+        const utility::ray ray({0, 3, -10}, {0, 0, 1}, 100, 0.8);
+        EXPECT_EQ(1u, bvh.closest_hit(ray, [&](const std::uint32_t primitive, double& t_max)
+        {
+            return intersect(primitive, ray, t_max);
+        }));
+    }
+
+    TEST(motion_bvh_test, closest_hit_brute_force)
+    {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<double> coordinate(0, 20);
+        std::uniform_real_distribution<double> unit(0, 1);
+
+        std::vector<moving_sphere> spheres;
+        for (int index = 0; index < 300; ++index)
+        {
+            const point3d start(coordinate(random), coordinate(random), coordinate(random));
+            const vector3d motion(unit(random) * 4 - 2, unit(random) * 4 - 2, unit(random) * 4 - 2);
+            spheres.push_back({start, start + motion, 0.2 + unit(random) * 0.5});
+        }
+
+        for (const int keys : {2, 3})
+        {
+            for (const utility::bvh_layout layout : {utility::bvh_layout::depth_first,
+                                                     utility::bvh_layout::van_emde_boas})
+            {
+                const utility::motion_bvh bvh(key_bounds(spheres, keys), 4, layout);
+
+                // the nodes contain their primitives at any time
+                const utility::bvh::node_vector& nodes = bvh.get_bvh().get_nodes();
+                for (std::uint32_t node = 0; node < nodes.size(); ++node)
+                {
+                    if (!nodes[node].is_leaf())
+                        continue;
+
+                    const double time = unit(random);
+                    for (std::uint32_t index = nodes[node].first; index < nodes[node].first + nodes[node].count; ++
+                         index)
+                    {
+                        const aabb bounds = spheres[bvh.get_bvh().get_primitives()[index]].at(time).bounds();
+                        const aabb node_bounds = bvh.get_bounds(node, time);
+                        EXPECT_LE(node_bounds.minimum.x, bounds.minimum.x + ROUND_EPSILON);
+                        EXPECT_GE(node_bounds.maximum.z, bounds.maximum.z - ROUND_EPSILON);
+                    }
+                }
+
+                for (int round = 0; round < 200; ++round)
+                {
+                    const point3d origin(coordinate(random), coordinate(random), -5);
+                    const point3d target(coordinate(random), coordinate(random), coordinate(random));
+                    const utility::ray ray(origin, origin.get_vector(target), 60, unit(random));
+
+                    double expected_t = ray.get_distance();
+                    std::uint32_t expected = utility::bvh::no_primitive;
+                    for (std::uint32_t primitive = 0; primitive < spheres.size(); ++primitive)
+                        if (spheres[primitive].intersect(ray, expected_t))
+                            expected = primitive;
+
+                    const std::uint32_t hit = bvh.closest_hit(ray, [&](const std::uint32_t primitive, double& t_max)
+                    {
+                        return spheres[primitive].intersect(ray, t_max);
+                    });
+                    EXPECT_EQ(expected, hit);
+                }
+            }
+        }
+    }
+} // namespace testing
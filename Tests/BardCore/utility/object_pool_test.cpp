@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "BardCore/utility/object_pool.h"
+
+#include "BardCore/math/point3d.h"
+
+namespace testing
+{
+    TEST(object_pool_test, acquire_release)
+    {
+        utility::object_pool<point3d> pool(3);
+        EXPECT_EQ(3u, pool.capacity());
+        EXPECT_TRUE(pool.empty());
+
+        point3d* first = pool.acquire(1, 2, 3);
+        point3d* second = pool.acquire();
+        EXPECT_EQ(point3d(1, 2, 3), *first);
+        EXPECT_EQ(point3d(0, 0, 0), *second);
+        EXPECT_EQ(second, first + 1);
+        EXPECT_EQ(2u, pool.size());
+        EXPECT_EQ(1u, pool.available());
+
+        // last in, first out
+        pool.release(first);
+        EXPECT_EQ(first, pool.acquire(4, 5, 6));
+
+        point3d* third = pool.acquire();
+        EXPECT_THROW((void)pool.acquire(), exception::out_of_range_exception);
+
+        pool.release(first);
+        pool.release(second);
+        pool.release(third);
+        EXPECT_TRUE(pool.empty());
+    }
+
+    TEST(object_pool_test, reserve)
+    {
+        utility::object_pool<point3d> pool;
+        EXPECT_THROW((void)pool.acquire(), exception::out_of_range_exception);
+
+        pool.reserve(2);
+        point3d* first = pool.acquire(1, 1, 1);
+        point3d* second = pool.acquire(2, 2, 2);
+
+        // growing keeps the acquired objects in place
+        pool.reserve(10);
+        EXPECT_EQ(10u, pool.capacity());
+        EXPECT_EQ(8u, pool.available());
+        EXPECT_EQ(point3d(1, 1, 1), *first);
+        EXPECT_EQ(point3d(2, 2, 2), *second);
+
+        pool.reserve(5);
+        EXPECT_EQ(10u, pool.capacity());
+    }
+
+    TEST(object_pool_test, handle)
+    {
+        utility::object_pool<point3d> pool(2);
+        {
+            utility::object_pool<point3d>::handle point = pool.make(1, 2, 3);
+            EXPECT_EQ(1.0, point->x);
+            EXPECT_EQ(1u, pool.size());
+
+            utility::object_pool<point3d>::handle moved = std::move(point);
+            EXPECT_FALSE(point);
+            EXPECT_TRUE(moved);
+            EXPECT_EQ(point3d(1, 2, 3), *moved);
+
+            moved.reset();
+            EXPECT_EQ(0u, pool.size());
+
+            utility::object_pool<point3d>::handle other = pool.make();
+            EXPECT_EQ(1u, pool.size());
+        }
+        EXPECT_TRUE(pool.empty());
+    }
+} // namespace testing
@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "BardCore/utility/page_memory.h"
+
+#include "BardCore/utility/bvh.h"
+
+#include <cstdint>
+#include <thread>
+
+namespace testing
+{
+    TEST(page_memory_test, allocate)
+    {
+        const std::size_t page = utility::page_memory::page_size();
+        EXPECT_GE(utility::page_memory::huge_page_size(), page);
+
+        const utility::page_placement placements[] = {
+            utility::page_placement::local, utility::page_placement::interleaved, utility::page_placement::node
+        };
+
+        for (const bool huge_pages : {false, true})
+        {
+            for (const utility::page_placement placement : placements)
+            {
+                utility::page_options options;
+                options.huge_pages = huge_pages;
+                options.placement = placement;
+
+                const std::size_t bytes = 3 * page + 5;
+                EXPECT_GE(utility::page_memory::allocation_size(bytes, options), bytes);
+                EXPECT_EQ(0u, utility::page_memory::allocation_size(bytes, options) % page);
+
+                auto* const memory = static_cast<unsigned char*>(utility::page_memory::allocate(bytes, options));
+                ASSERT_NE(nullptr, memory);
+                EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(memory) % page);
+
+                for (std::size_t index = 0; index < bytes; ++index)
+                    memory[index] = static_cast<unsigned char>(index);
+                EXPECT_EQ(static_cast<unsigned char>(bytes - 1), memory[bytes - 1]);
+
+                utility::page_memory::deallocate(memory, bytes, options);
+            }
+        }
+
+        utility::page_memory::deallocate(nullptr, 0);
+    }
+
+    TEST(page_memory_test, nodes)
+    {
+        EXPECT_EQ(std::vector<unsigned int>({0, 1, 2, 3, 8, 10, 11}),
+                  utility::page_memory::parse_cpu_list("0-3,8,10-11"));
+        EXPECT_EQ(std::vector<unsigned int>({0}), utility::page_memory::parse_cpu_list("0"));
+        EXPECT_TRUE(utility::page_memory::parse_cpu_list("").empty());
+
+        const unsigned int nodes = utility::page_memory::node_count();
+        EXPECT_GE(nodes, 1u);
+        EXPECT_LT(utility::page_memory::current_node(), nodes);
+
+        // a pinned thread runs on its node, pinned in its own thread so the other tests keep all cpus.
+        // pinning fails without NUMA information (e.g. no /sys/devices/system/node in a container)
+        bool pinned = false;
+        unsigned int node = 1;
+        unsigned int cached = 1;
+        std::thread thread([&]
+        {
+            pinned = utility::page_memory::pin_current_thread(0);
+            node = utility::page_memory::current_node();
+            cached = utility::page_memory::cached_node();
+        });
+        thread.join();
+
+        if (pinned)
+        {
+            EXPECT_EQ(0u, node);
+            EXPECT_EQ(0u, cached);
+        }
+        EXPECT_FALSE(utility::page_memory::pin_current_thread(100000));
+    }
+
+    TEST(page_memory_test, page_allocator)
+    {
+        utility::page_options options;
+        options.placement = utility::page_placement::interleaved;
+
+        std::vector<utility::bvh_node, utility::page_allocator<utility::bvh_node>> nodes{
+            utility::page_allocator<utility::bvh_node>(options)
+        };
+        for (std::uint32_t index = 0; index < 100000; ++index)
+        {
+            utility::bvh_node node;
+            node.first = index;
+            nodes.push_back(node);
+        }
+
+        EXPECT_EQ(99999u, nodes.back().first);
+        EXPECT_TRUE(nodes.get_allocator() == utility::page_allocator<int>(options));
+        EXPECT_TRUE(nodes.get_allocator() != utility::page_allocator<int>());
+    }
+
+    TEST(page_memory_test, replicated_buffer)
+    {
+        std::vector<double> data(10000);
+        for (std::size_t index = 0; index < data.size(); ++index)
+            data[index] = static_cast<double>(index) * 0.5;
+
+        const utility::replicated_buffer<double> buffer(data);
+        EXPECT_EQ(data.size(), buffer.size());
+        EXPECT_EQ(utility::page_memory::node_count(), buffer.copy_count());
+
+        for (unsigned int node = 0; node < buffer.copy_count(); ++node)
+        {
+            const double* copy = buffer.get(node);
+            EXPECT_EQ(0, std::memcmp(copy, data.data(), data.size() * sizeof(double)));
+        }
+        EXPECT_EQ(buffer.get(utility::page_memory::cached_node()), buffer.get());
+        EXPECT_THROW((void)buffer.get(buffer.copy_count()), exception::out_of_range_exception);
+
+        const utility::replicated_buffer<double> empty(nullptr, 0, false);
+        EXPECT_EQ(0u, empty.size());
+    }
+} // namespace testing
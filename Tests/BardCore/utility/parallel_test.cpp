@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "BardCore/utility/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace testing
+{
+    TEST(parallel_test, for_each_index_visits_every_index_once)
+    {
+        constexpr std::size_t count = 10'000;
+        std::vector<int> visits(count, 0);
+
+        utility::parallel::for_each_index(count, [&visits](const std::size_t index) { ++visits[index]; }, 16);
+
+        for (const int visit : visits)
+            ASSERT_EQ(1, visit);
+    }
+
+    TEST(parallel_test, for_each_chunk_covers_range)
+    {
+        std::atomic<std::size_t> total{0};
+
+        utility::parallel::for_each_chunk(1'000, [&total](const std::size_t begin, const std::size_t end)
+        {
+            ASSERT_LT(begin, end);
+            total += end - begin;
+        }, 1);
+
+        EXPECT_EQ(1'000u, total.load());
+    }
+
+    TEST(parallel_test, sort)
+    {
+        std::vector<unsigned int> values(10'007);
+        for (std::size_t index = 0; index < values.size(); ++index)
+            values[index] = static_cast<unsigned int>(index * 7919 % values.size());
+
+        std::vector<unsigned int> expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        utility::parallel::sort(values.begin(), values.end(), std::less<>(), 16);
+        EXPECT_EQ(expected, values);
+
+        utility::parallel::sort(values.begin(), values.end(), std::greater<>(), 16);
+        EXPECT_TRUE(std::is_sorted(values.rbegin(), values.rend()));
+    }
+
+    TEST(parallel_test, empty_range)
+    {
+        bool called = false;
+        utility::parallel::for_each_index(0, [&called](std::size_t) { called = true; });
+
+        EXPECT_FALSE(called);
+        EXPECT_GE(utility::parallel::thread_count(), 1u);
+    }
+} // namespace testing
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "BardCore/utility/pca.h"
+
+#include <random>
+
+namespace testing
+{
+    TEST(pca_test, covariance)
+    {
+        // points along x, far from the origin
+        const std::vector<point3d> points = {{1e6 - 1, 5, 5}, {1e6, 5, 5}, {1e6 + 1, 5, 5}};
+        const symmetric_matrix3 covariance = utility::pca::covariance(points);
+
+        EXPECT_NEAR(2. / 3, covariance.xx, ROUND_EPSILON);
+        EXPECT_NEAR(0.0, covariance.yy, ROUND_EPSILON);
+        EXPECT_NEAR(0.0, covariance.xy, ROUND_EPSILON);
+        EXPECT_EQ(symmetric_matrix3(), utility::pca::covariance(std::vector<point3d>()));
+    }
+
+    TEST(pca_test, normals)
+    {
+        // a grid on the plane through (0, 0, 1) with normal (1, 1, 1) plus a little noise
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> noise(-0.001, 0.001);
+
+        const vector3d normal = vector3d(1, 1, 1).normalize();
+        const vector3d u = vector3d(1, -1, 0).normalize();
+        const vector3d v = normal.cross(u);
+
+        constexpr int size = 40;
+        std::vector<point3d> points;
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                points.push_back(point3d(0, 0, 1) + u * (x * 0.1) + v * (y * 0.1) + normal * noise(generator));
+
+        // 3x3 neighbourhoods, clamped at the border
+        std::vector<std::uint32_t> neighbours;
+        std::vector<std::size_t> offsets = {0};
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        if (x + dx >= 0 && x + dx < size && y + dy >= 0 && y + dy < size)
+                            neighbours.push_back(static_cast<std::uint32_t>((y + dy) * size + x + dx));
+                offsets.push_back(neighbours.size());
+            }
+        }
+
+        const std::vector<vector3d> normals = utility::pca::normals(points, neighbours, offsets);
+        const std::vector<symmetric_matrix3> covariances = utility::pca::covariances(points, neighbours, offsets);
+        ASSERT_EQ(points.size(), normals.size());
+        ASSERT_EQ(points.size(), covariances.size());
+
+        for (std::size_t index = 0; index < normals.size(); ++index)
+        {
+            EXPECT_NEAR(1.0, std::abs(normals[index].dot(normal)), 0.01);
+
+            const symmetric_matrix3 expected = utility::pca::covariance(
+                points.data(), neighbours.data() + offsets[index], offsets[index + 1] - offsets[index]);
+            EXPECT_EQ(expected, covariances[index]);
+        }
+    }
+
+    TEST(pca_test, normals_small_neighbourhoods)
+    {
+        const std::vector<point3d> points = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+
+        const std::vector<vector3d> normals = utility::pca::normals(points, {0, 1, 0, 1, 2}, {0, 2, 2, 5});
+        ASSERT_EQ(3u, normals.size());
+        EXPECT_EQ(vector3d(0, 0, 0), normals[0]);
+        EXPECT_EQ(vector3d(0, 0, 0), normals[1]);
+        EXPECT_NEAR(1.0, std::abs(normals[2].z), ROUND_EPSILON);
+
+        EXPECT_THROW((void)utility::pca::normals(points, {0, 3}, {0, 2}), exception::out_of_range_exception);
+        EXPECT_THROW((void)utility::pca::normals(points, {0, 1}, {0, 3}), exception::out_of_range_exception);
+        EXPECT_THROW((void)utility::pca::covariances(points, {0, 1}, {}), exception::out_of_range_exception);
+    }
+} // namespace testing
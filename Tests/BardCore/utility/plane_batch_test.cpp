@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "BardCore/utility/plane_batch.h"
+
+#include <random>
+
+namespace testing
+{
+    static double total_area(const std::vector<triangle>& triangles, const std::size_t count)
+    {
+        double area = 0;
+        for (std::size_t index = 0; index < count; ++index)
+            area += triangles[index].area();
+        return area;
+    }
+
+    TEST(plane_batch_test, batch)
+    {
+        const plane plane = plane::from_point_normal({0.5, 0, 0}, {1, -2, 0.5});
+
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> coordinate(-1, 1);
+        std::vector<point3d> points;
+        for (int index = 0; index < 20000; ++index)
+            points.emplace_back(coordinate(generator), coordinate(generator), coordinate(generator));
+        points.emplace_back(0.5, 0, 0);
+
+        const std::vector<double> distances = utility::plane_batch::distances(plane, points);
+        const std::vector<plane_side> sides = utility::plane_batch::classify(plane, points, 0.01);
+        ASSERT_EQ(points.size(), distances.size());
+        ASSERT_EQ(points.size(), sides.size());
+
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            EXPECT_NEAR(plane.distance(points[index]), distances[index], ROUND_EPSILON);
+            EXPECT_EQ(plane.classify(points[index], 0.01), sides[index]);
+        }
+        EXPECT_EQ(plane_side::on, sides.back());
+    }
+
+    TEST(plane_batch_test, clip)
+    {
+        const plane plane({1, 0, 0}, 0);
+
+        const std::vector<triangle> triangles = {
+            triangle({1, 0, 0}, {2, 0, 0}, {1, 1, 0}), // front
+            triangle({-1, 0, 0}, {-2, 0, 0}, {-1, 1, 0}), // back
+            triangle({-1, 0, 0}, {1, 0, 0}, {1, 2, 0}), // one vertex behind, quad in front
+            triangle({-1, 0, 0}, {1, 0, 0}, {-1, 2, 0}), // two vertices behind
+            triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}), // touching with an edge
+            triangle({0, 0, 0}, {0, 1, 0}, {0, 0, 1}) // in the plane
+        };
+
+        std::vector<triangle> front(2 * triangles.size());
+        std::vector<triangle> back(2 * triangles.size());
+        const split_counts counts = utility::plane_batch::split(plane, triangles.data(), triangles.size(), front.data(), back.data());
+
+        EXPECT_EQ(6u, counts.front);
+        EXPECT_EQ(4u, counts.back);
+
+        // the parts add up to the original triangles
+        double area = 0;
+        for (const triangle& triangle : triangles)
+            area += triangle.area();
+        EXPECT_NEAR(area, total_area(front, counts.front) + total_area(back, counts.back), ROUND_EPSILON);
+
+        for (std::size_t index = 0; index < counts.front; ++index)
+        {
+            EXPECT_GE(plane.distance(front[index].a), -ROUND_EPSILON);
+            EXPECT_GE(plane.distance(front[index].b), -ROUND_EPSILON);
+            EXPECT_GE(plane.distance(front[index].c), -ROUND_EPSILON);
+            EXPECT_GE(front[index].normal().z, 0.0);
+        }
+        for (std::size_t index = 0; index < counts.back; ++index)
+        {
+            EXPECT_LE(plane.distance(back[index].a), ROUND_EPSILON);
+            EXPECT_LE(plane.distance(back[index].b), ROUND_EPSILON);
+            EXPECT_LE(plane.distance(back[index].c), ROUND_EPSILON);
+        }
+
+        std::vector<triangle> clipped(2 * triangles.size());
+        EXPECT_EQ(6u, utility::plane_batch::clip(plane, triangles.data(), triangles.size(), clipped.data()));
+        EXPECT_EQ(front, clipped);
+    }
+
+    TEST(plane_batch_test, clip_parallel)
+    {
+        const plane plane = plane::from_point_normal({0.1, 0.2, 0}, {1, 1, 1});
+
+        std::mt19937 generator(2);
+        std::uniform_real_distribution<double> coordinate(-1, 1);
+        std::vector<triangle> triangles;
+        for (int index = 0; index < 10000; ++index)
+        {
+            const point3d a(coordinate(generator), coordinate(generator), coordinate(generator));
+            triangles.emplace_back(a, a + vector3d(coordinate(generator), coordinate(generator), 0) * 0.2,
+                                   a + vector3d(0, coordinate(generator), coordinate(generator)) * 0.2);
+        }
+
+        std::vector<triangle> front(2 * triangles.size());
+        std::vector<triangle> back(2 * triangles.size());
+        const split_counts counts = utility::plane_batch::split(plane, triangles.data(), triangles.size(), front.data(), back.data());
+
+        // same output as splitting one by one
+        std::size_t front_count = 0, back_count = 0;
+        for (const triangle& triangle : triangles)
+        {
+            bardcore::triangle single_front[2], single_back[2];
+            const split_counts single = plane.split(triangle, single_front, single_back);
+
+            for (std::size_t index = 0; index < single.front; ++index)
+                EXPECT_EQ(single_front[index], front[front_count++]);
+            for (std::size_t index = 0; index < single.back; ++index)
+                EXPECT_EQ(single_back[index], back[back_count++]);
+        }
+
+        EXPECT_EQ(front_count, counts.front);
+        EXPECT_EQ(back_count, counts.back);
+        EXPECT_GT(counts.front + counts.back, triangles.size());
+    }
+} // namespace testing
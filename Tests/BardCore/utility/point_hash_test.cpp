@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "BardCore/utility/point_hash.h"
+
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+namespace testing
+{
+    TEST(point_hash_test, quantize)
+    {
+        const utility::point_hash hasher(0.5);
+        EXPECT_NEAR(0.5, hasher.get_cell_size(), ROUND_EPSILON);
+
+        EXPECT_EQ(utility::quantized_point({2, -4, 0}), hasher.quantize(point3d(1.1, -1.9, 0.2)));
+        EXPECT_EQ(hasher.quantize(point3d(1, 1, 1)), hasher.quantize(point3d(1.2, 0.9, 1.01)));
+        EXPECT_NE(hasher.quantize(point3d(1, 1, 1)), hasher.quantize(point3d(1.3, 1, 1)));
+        EXPECT_EQ(hasher.quantize(vector3d(3, 2, 1)), hasher.quantize(point3d(3, 2, 1)));
+
+        EXPECT_THROW(utility::point_hash(0), exception::zero_exception);
+        EXPECT_THROW(utility::point_hash(-1), exception::negative_exception);
+    }
+
+    TEST(point_hash_test, hash)
+    {
+        const utility::point_hash hasher(0.01);
+
+        EXPECT_EQ(hasher(point3d(1, 2, 3)), hasher(point3d(1.001, 2.001, 2.999)));
+        EXPECT_EQ(hasher(point3d(1, 2, 3)), hasher(hasher.quantize(point3d(1, 2, 3))));
+        EXPECT_NE(hasher(point3d(1, 2, 3)), hasher(point3d(3, 2, 1)));
+        EXPECT_NE(hasher(point3d(1, 2, 3)), hasher(point3d(-1, 2, 3)));
+
+        // neighbouring cells spread over the low bits, as used by hash maps and shards
+        std::vector<int> buckets(64, 0);
+        for (int x = 0; x < 16; ++x)
+            for (int y = 0; y < 16; ++y)
+                for (int z = 0; z < 16; ++z)
+                    ++buckets[hasher.hash({x, y, z}) & 63];
+
+        for (const int bucket : buckets)
+        {
+            EXPECT_GT(bucket, 32);
+            EXPECT_LT(bucket, 96);
+        }
+    }
+} // namespace testing
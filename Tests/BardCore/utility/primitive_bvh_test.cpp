@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "BardCore/utility/primitive_bvh.h"
+
+#include <random>
+
+namespace testing
+{
+    using scene_bvh = utility::primitive_bvh<triangle, sphere, utility::bounded_sdf<utility::sdf::sphere>>;
+
+    TEST(primitive_bvh_test, handles)
+    {
+        scene_bvh bvh;
+        EXPECT_TRUE(bvh.empty());
+
+        const std::uint32_t first = bvh.add(triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}));
+        const std::uint32_t second = bvh.add(sphere({0, 0, 5}, 1));
+        const std::uint32_t third = bvh.add(sphere({0, 0, 8}, 1));
+
+        EXPECT_EQ(0u, scene_bvh::kind(first));
+        EXPECT_EQ(1u, scene_bvh::kind(second));
+        EXPECT_EQ(1u, scene_bvh::index(third));
+        EXPECT_EQ(third, scene_bvh::make_handle(1, 1));
+        EXPECT_EQ(3u, bvh.size());
+        EXPECT_EQ(2u, bvh.get_primitives<sphere>().size());
+        EXPECT_EQ(sphere({0, 0, 8}, 1), bvh.get_primitives<sphere>()[scene_bvh::index(third)]);
+
+        // nothing is found before build
+        const utility::ray ray({0.25, 0.25, -1}, {0, 0, 1}, 20);
+        EXPECT_FALSE(bvh.intersect(ray).hit);
+
+        bvh.build();
+        const utility::primitive_hit hit = bvh.intersect(ray);
+        ASSERT_TRUE(hit.hit);
+        EXPECT_EQ(first, hit.handle);
+        EXPECT_NEAR(1.0, hit.distance, ROUND_EPSILON);
+    }
+
+    TEST(primitive_bvh_test, kinds)
+    {
+        scene_bvh bvh;
+        bvh.add(sphere({0, 0, 5}, 1));
+        bvh.add(triangle({-1, -1, 10}, {1, -1, 10}, {0, 1, 10}));
+        const std::uint32_t marched = bvh.add(utility::bounded_sdf<utility::sdf::sphere>{
+            {{0, 0, 2}, 0.5}, aabb({-0.5, -0.5, 1.5}, {0.5, 0.5, 2.5})
+        });
+        bvh.build(1);
+
+        // the marched sphere is in front
+        utility::primitive_hit hit = bvh.intersect(utility::ray({0, 0, 0}, {0, 0, 1}, 20));
+        ASSERT_TRUE(hit.hit);
+        EXPECT_EQ(marched, hit.handle);
+        EXPECT_NEAR(1.5, hit.distance, 0.001);
+
+        // only the sphere, from inside it is hit on the way out
+        hit = bvh.intersect(utility::ray({0, 0, 5}, {0, 0, 1}, 20));
+        ASSERT_TRUE(hit.hit);
+        EXPECT_EQ(1u, scene_bvh::kind(hit.handle));
+        EXPECT_NEAR(1.0, hit.distance, ROUND_EPSILON);
+
+        // the triangle behind the sphere
+        hit = bvh.intersect(utility::ray({0, 0, 7}, {0, 0, 1}, 20));
+        ASSERT_TRUE(hit.hit);
+        EXPECT_EQ(0u, scene_bvh::kind(hit.handle));
+        EXPECT_NEAR(3.0, hit.distance, ROUND_EPSILON);
+
+        EXPECT_FALSE(bvh.intersect(utility::ray({0, 0, 0}, {0, 0, 1}, 1)).hit);
+        EXPECT_FALSE(bvh.intersect(utility::ray({5, 0, 0}, {0, 0, 1}, 20)).hit);
+
+        // a hit exactly at the distance of the ray counts, like triangle::intersect
+        EXPECT_TRUE(bvh.intersect(utility::ray({0, 0, 7}, {0, 0, 1}, 3)).hit);
+        EXPECT_TRUE(bvh.intersect(utility::ray({0, 0, 3}, {0, 0, 1}, 1)).hit);
+    }
+
+    TEST(primitive_bvh_test, brute_force)
+    {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<double> coordinate(0, 10);
+        const auto random_point = [&] { return point3d(coordinate(random), coordinate(random), coordinate(random)); };
+
+        // spheres and triangles mixed, large leaves so leaves hold both kinds
+        utility::primitive_bvh<sphere, triangle> bvh;
+        for (int i = 0; i < 300; ++i)
+        {
+            const point3d center = random_point();
+            if (i % 3 == 0)
+                bvh.add(sphere(center, 0.3));
+            else
+                bvh.add(triangle(center, center + vector3d(0.5, 0, 0.2), center + vector3d(0, 0.5, 0.3)));
+        }
+        bvh.build(8);
+
+        for (int round = 0; round < 300; ++round)
+        {
+            const point3d origin(coordinate(random), coordinate(random), -1);
+            const utility::ray ray(origin, origin.get_vector(random_point()), 30);
+
+            double expected = math::inf;
+            for (const sphere& sphere : bvh.get_primitives<sphere>())
+            {
+                double t = 0;
+                if (utility::primitive_traits<bardcore::sphere>::intersect(sphere, ray, expected, t))
+                    expected = t;
+            }
+            for (const triangle& triangle : bvh.get_primitives<triangle>())
+            {
+                double t = 0;
+                if (utility::primitive_traits<bardcore::triangle>::intersect(triangle, ray, expected, t))
+                    expected = t;
+            }
+
+            const utility::primitive_hit hit = bvh.intersect(ray);
+            ASSERT_EQ(expected != math::inf, hit.hit);
+            if (!hit.hit)
+                continue;
+
+            EXPECT_NEAR(expected, hit.distance, ROUND_EPSILON);
+        }
+    }
+} // namespace testing
@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "BardCore/utility/projection_lut.h"
+
+namespace testing
+{
+    TEST(projection_lut_test, generate)
+    {
+        for (const utility::camera_projection projection : {
+                 utility::camera_projection::perspective, utility::camera_projection::orthographic,
+                 utility::camera_projection::fisheye, utility::camera_projection::equirectangular
+             })
+        {
+            utility::camera camera({1, -2, 3}, {2, 1, -4}, 32, 20, 100);
+            camera.set_projection(projection);
+
+            const utility::projection_lut lut(camera);
+            ASSERT_TRUE(lut.matches(camera));
+            ASSERT_EQ(32u * 20u, lut.pixel_count());
+
+            const std::vector<utility::ray> rays = lut.generate(camera, 25);
+            ASSERT_EQ(lut.pixel_count(), rays.size());
+            for (unsigned int y = 0; y < camera.get_screen_height(); ++y)
+                for (unsigned int x = 0; x < camera.get_screen_width(); ++x)
+                    EXPECT_EQ(camera.shoot_ray(x, y, 25), rays[y * camera.get_screen_width() + x]);
+        }
+    }
+
+    TEST(projection_lut_test, update)
+    {
+        utility::camera camera({0, 0, 0}, {0, 0, 1}, 16, 8, 90);
+        camera.set_projection(utility::camera_projection::equirectangular);
+        utility::projection_lut lut;
+        EXPECT_FALSE(lut.matches(camera));
+        EXPECT_TRUE(lut.update(camera));
+        EXPECT_FALSE(lut.update(camera));
+
+        // the table is relative to the camera, moving and turning it reuses the table
+        camera.set_position({5, 1, -2});
+        camera.set_direction({1, 1, 0});
+        EXPECT_FALSE(lut.update(camera));
+        EXPECT_EQ(camera.shoot_ray(3, 5, 10), lut.generate(camera, 10)[5 * 16 + 3]);
+        EXPECT_EQ(camera.shoot_ray(3, 5, 10), lut.pixel_ray(5 * 16 + 3, utility::projection_lut::basis(camera), 10));
+
+        camera.set_projection(utility::camera_projection::fisheye);
+        EXPECT_FALSE(lut.matches(camera));
+        EXPECT_THROW((void)lut.generate(camera, 10), exception::out_of_range_exception);
+        EXPECT_TRUE(lut.update(camera));
+        EXPECT_EQ(utility::camera_projection::fisheye, lut.get_projection());
+
+        camera.set_fov(120);
+        EXPECT_TRUE(lut.update(camera));
+        EXPECT_THROW((void)lut.generate(camera, -1), exception::negative_exception);
+    }
+} // namespace testing
@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "BardCore/utility/ray_stream.h"
+
+namespace testing
+{
+    TEST(ray_stream_test, conversion)
+    {
+        const std::vector<utility::ray> rays = {
+            {{1, 2, 3}, {0, 0, 2}, 5}, {{-1, 0, 0}, {1, 1, 0}, 10}, {{0, 0, 0}, {0, -3, 0}, 0.5}
+        };
+
+        const utility::ray_stream stream(rays);
+        ASSERT_EQ(3u, stream.size());
+        EXPECT_EQ(3u, stream.active_count());
+        EXPECT_EQ(rays, stream.to_rays());
+        EXPECT_EQ(rays[1], stream.get_ray(1));
+
+        // structure of arrays, directions are normalized
+        EXPECT_NEAR(1 / std::sqrt(2), stream.get_direction_x()[1], ROUND_EPSILON);
+        EXPECT_EQ(-1.0, stream.get_direction_y()[2]);
+        EXPECT_EQ(2.0, stream.get_origin_y()[0]);
+        EXPECT_EQ(10.0, stream.get_t_max()[1]);
+        EXPECT_EQ(0.0, stream.get_t_min()[1]);
+        EXPECT_EQ(std::vector<std::uint32_t>({0, 1, 2}), stream.get_ids());
+
+        EXPECT_THROW((void)stream.get_ray(3), exception::out_of_range_exception);
+        EXPECT_TRUE(utility::ray_stream().empty());
+    }
+
+    TEST(ray_stream_test, push_back)
+    {
+        utility::ray_stream stream;
+        EXPECT_EQ(0u, stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}, 1));
+        EXPECT_EQ(1u, stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}));
+        EXPECT_EQ(1.0, stream.get_t_min()[0]);
+
+        // the time of the ray is kept
+        EXPECT_EQ(2u, stream.push_back({{0, 0, 0}, {1, 0, 0}, 5, 0.75}));
+        EXPECT_EQ(0.75, stream.get_time()[2]);
+        EXPECT_EQ(0.75, stream.get_ray(2).get_time());
+
+        EXPECT_THROW(stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}, -1), exception::negative_exception);
+        EXPECT_THROW(stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}, 6), exception::out_of_range_exception);
+
+        // ids keep counting after a clear
+        stream.clear();
+        EXPECT_TRUE(stream.empty());
+        EXPECT_EQ(3u, stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}));
+
+        stream.set_t_max(0, 3);
+        EXPECT_EQ(3.0, stream.get_t_max()[0]);
+        EXPECT_THROW(stream.set_t_max(1, 3), exception::out_of_range_exception);
+    }
+
+    TEST(ray_stream_test, within_range)
+    {
+        utility::ray_stream stream;
+        stream.push_back({{0, 0, 0}, {1, 0, 0}, 5});
+        stream.push_back({{0, 0, 0}, {1, 0, 0}, 5}, 2);
+        stream.push_back({{0, 0, 0}, {1, 0, 0}, 5});
+        stream.terminate(2);
+
+        const std::vector<double> lengths = {5, 1, 3};
+        EXPECT_EQ(std::vector<std::uint8_t>({1, 0, 0}), stream.within_range(lengths));
+
+        // the same answers as ray::within_range for active rays with t_min 0
+        const utility::ray ray = stream.get_ray(0);
+        EXPECT_EQ(ray.within_range(5.0), stream.within_range({5, 3, 3})[0] == 1);
+        EXPECT_EQ(ray.within_range(6.0), stream.within_range({6, 3, 3})[0] == 1);
+
+        EXPECT_THROW((void)stream.within_range({1, -1, 1}), exception::negative_exception);
+        EXPECT_THROW((void)stream.within_range({1, 1}), exception::out_of_range_exception);
+        EXPECT_THROW(stream.terminate(3), exception::out_of_range_exception);
+    }
+
+    TEST(ray_stream_test, get_points)
+    {
+        // enough rays for the batch to be split over threads
+        std::vector<utility::ray> rays;
+        std::vector<double> distances;
+        for (int i = 0; i < 20000; ++i)
+        {
+            rays.emplace_back(point3d(i, 0, 0), vector3d(i % 3 - 1, 1, 1), 10);
+            distances.push_back(i % 12);
+        }
+
+        const utility::ray_stream stream(rays);
+        std::vector<std::uint8_t> valid;
+        const std::vector<point3d> points = stream.get_points(distances, valid);
+        ASSERT_EQ(rays.size(), points.size());
+
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            point3d expected;
+            EXPECT_EQ(rays[i].try_get_point(distances[i], expected), valid[i] == 1);
+            EXPECT_EQ(rays[i].get_position() + rays[i].get_direction() * distances[i], points[i]);
+        }
+
+        EXPECT_THROW((void)stream.get_points({1}, valid), exception::out_of_range_exception);
+    }
+
+    TEST(ray_stream_test, compact)
+    {
+        std::vector<utility::ray> rays;
+        for (int i = 0; i < 10; ++i)
+            rays.emplace_back(point3d(i, 0, 0), vector3d(0, 0, 1), i + 1);
+
+        utility::ray_stream stream(rays);
+        for (std::size_t index = 0; index < stream.size(); index += 3)
+            stream.terminate(index);
+        EXPECT_EQ(6u, stream.active_count());
+
+        // active rays keep their order and ids
+        EXPECT_EQ(6u, stream.compact());
+        EXPECT_EQ(6u, stream.size());
+        EXPECT_EQ(6u, stream.active_count());
+        EXPECT_EQ(std::vector<std::uint32_t>({1, 2, 4, 5, 7, 8}), stream.get_ids());
+        for (std::size_t index = 0; index < stream.size(); ++index)
+            EXPECT_EQ(rays[stream.get_ids()[index]], stream.get_ray(index));
+
+        // everything terminated
+        for (std::size_t index = 0; index < stream.size(); ++index)
+            stream.terminate(index);
+        EXPECT_EQ(0u, stream.compact());
+        EXPECT_TRUE(stream.empty());
+    }
+} // namespace testing
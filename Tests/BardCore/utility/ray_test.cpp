@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "BardCore/utility/ray.h"
 
+#include <sstream>
+
 namespace testing
 {
     //test constructor
@@ -188,6 +190,28 @@ namespace testing
         ASSERT_EQ(7.0, ray.get_distance());
     }
 
+    //test time
+    TEST(ray_test, time_test)
+    {
+        constexpr utility::ray ray = {{1, 2, 3}, {4, 5, 6}, 7, 0.25};
+        ASSERT_EQ(0.25, ray.get_time());
+        ASSERT_EQ(0.0, utility::ray(vector3d::up()).get_time());
+
+        //copies keep the time, the time is compared
+        utility::ray ray1 = ray;
+        ASSERT_EQ(ray, ray1);
+        ray1.set_time(0.5);
+        ASSERT_EQ(0.5, ray1.get_time());
+        ASSERT_NE(ray, ray1);
+
+        //the time is printed, so rays that only differ in time don't look the same
+        std::ostringstream output, output1;
+        output << ray;
+        output1 << ray1;
+        EXPECT_NE(std::string::npos, output.str().find("time: 0.25}"));
+        EXPECT_NE(output.str(), output1.str());
+    }
+
     //test setter throw
     TEST(ray_test, setters_throw_test)
     {
@@ -302,4 +326,54 @@ namespace testing
         ASSERT_THROW(ray.get_point(-1), exception::negative_exception);
         ASSERT_THROW(ray.get_point(-10), exception::negative_exception);
     }
+
+    //test get point without allocating
+    TEST(ray_test, try_get_point_test)
+    {
+        constexpr utility::ray ray = {{1, 2, 3}, {4, 5, 6}, 7};
+
+        point3d point = {9, 9, 9};
+        ASSERT_TRUE(ray.try_get_point(1, point));
+        ASSERT_NEAR(1.456, point.x, ROUND_THREE_DECIMALS);
+        ASSERT_NEAR(2.570, point.y, ROUND_THREE_DECIMALS);
+        ASSERT_NEAR(3.684, point.z, ROUND_THREE_DECIMALS);
+
+        // out of range, the point is not written
+        ASSERT_FALSE(ray.try_get_point(10, point));
+        ASSERT_NEAR(1.456, point.x, ROUND_THREE_DECIMALS);
+
+        ASSERT_THROW((void)ray.try_get_point(-1, point), exception::negative_exception);
+    }
+
+    //test intersection with an aabb, only [0, distance] of the ray counts
+    TEST(ray_test, intersect_aabb_test)
+    {
+        constexpr aabb box({-1, -1, 4}, {1, 1, 6});
+        double t_enter = 0, t_exit = 0;
+
+        ASSERT_TRUE(utility::ray({0, 0, 0}, {0, 0, 1}, 10).intersect(box, t_enter, t_exit));
+        ASSERT_NEAR(4.0, t_enter, ROUND_EPSILON);
+        ASSERT_NEAR(6.0, t_exit, ROUND_EPSILON);
+
+        ASSERT_TRUE(utility::ray({0, 0, 5}, {0, 0, 1}, 0.5).intersect(box, t_enter, t_exit));
+        ASSERT_NEAR(0.0, t_enter, ROUND_EPSILON);
+        ASSERT_NEAR(0.5, t_exit, ROUND_EPSILON);
+
+        ASSERT_FALSE(utility::ray({0, 0, 0}, {0, 0, 1}, 3).intersect(box, t_enter, t_exit));
+        ASSERT_FALSE(utility::ray({0, 0, 0}, {0, 1, 0}, 10).intersect(box, t_enter, t_exit));
+    }
+
+    //test intersection with a triangle, only [0, distance] of the ray counts
+    TEST(ray_test, intersect_triangle_test)
+    {
+        constexpr triangle triangle({0, 0, 5}, {2, 0, 5}, {0, 2, 5});
+        double t = 0, u = 0, v = 0;
+
+        ASSERT_TRUE(utility::ray({0.5, 0.5, 0}, {0, 0, 2}, 10).intersect(triangle, t, u, v));
+        ASSERT_NEAR(5.0, t, ROUND_EPSILON);
+        ASSERT_NEAR(0.25, u, ROUND_EPSILON);
+        ASSERT_NEAR(0.25, v, ROUND_EPSILON);
+
+        ASSERT_FALSE(utility::ray({0.5, 0.5, 0}, {0, 0, 1}, 4).intersect(triangle, t, u, v));
+    }
 } // namespace testing
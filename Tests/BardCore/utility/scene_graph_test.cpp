@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "BardCore/utility/scene_graph.h"
+
+#include "BardCore/utility/bvh.h"
+
+namespace testing
+{
+    TEST(scene_graph_test, add_node)
+    {
+        utility::scene_graph graph;
+
+        const std::size_t root = graph.add_node(quaternion::identity(), {1, 2, 3});
+        const std::size_t child = graph.add_node(quaternion::identity(), {1, 0, 0}, root);
+
+        const std::size_t no_parent = utility::scene_graph::no_parent;
+
+        EXPECT_EQ(2u, graph.size());
+        EXPECT_EQ(2u, graph.get_depth_count());
+        EXPECT_EQ(no_parent, graph.get_parent(root));
+        EXPECT_EQ(root, graph.get_parent(child));
+        EXPECT_TRUE(graph.is_dirty(child));
+    }
+
+    TEST(scene_graph_test, add_node_exceptions)
+    {
+        utility::scene_graph graph;
+
+        EXPECT_THROW(graph.add_node(quaternion::identity(), {0, 0, 0}, 0), exception::out_of_range_exception);
+        EXPECT_THROW((void)graph.get_world_position(0), exception::out_of_range_exception);
+        EXPECT_THROW(graph.set_local_position(0, {0, 0, 0}), exception::out_of_range_exception);
+    }
+
+    TEST(scene_graph_test, update_world_transform)
+    {
+        utility::scene_graph graph;
+
+        // root rotated 90 degrees around y
+        const quaternion rotation = quaternion::from_axis_radians({0, 1, 0}, math::pi_2);
+        const std::size_t root = graph.add_node(rotation, {10, 0, 0});
+        const std::size_t child = graph.add_node(quaternion::identity(), {1, 0, 0}, root);
+        const std::size_t grand_child = graph.add_node(rotation, {0, 0, 2}, child);
+
+        EXPECT_EQ(3u, graph.update());
+
+        const point3d expected_child = point3d(10, 0, 0) + quaternion::rotate_quaternion(point3d(1, 0, 0), rotation);
+        EXPECT_EQ(expected_child, graph.get_world_position(child));
+
+        const point3d expected_grand_child = expected_child +
+            quaternion::rotate_quaternion(point3d(0, 0, 2), rotation);
+        EXPECT_EQ(expected_grand_child, graph.get_world_position(grand_child));
+
+        // two 90 degree rotations around the same axis
+        const vector3d expected_direction = quaternion::rotate_radians(vector3d(1, 0, 0), {0, 1, 0}, math::pi);
+        EXPECT_EQ(expected_direction, graph.to_world(grand_child, vector3d(1, 0, 0)));
+        EXPECT_EQ(expected_grand_child + expected_direction, graph.to_world(grand_child, point3d(1, 0, 0)));
+    }
+
+    TEST(scene_graph_test, update_only_dirty_subtrees)
+    {
+        utility::scene_graph graph;
+
+        const std::size_t root = graph.add_node(quaternion::identity(), {0, 0, 0});
+        const std::size_t left = graph.add_node(quaternion::identity(), {-1, 0, 0}, root);
+        const std::size_t right = graph.add_node(quaternion::identity(), {1, 0, 0}, root);
+        const std::size_t left_leaf = graph.add_node(quaternion::identity(), {0, 1, 0}, left);
+        const std::size_t right_leaf = graph.add_node(quaternion::identity(), {0, 1, 0}, right);
+
+        EXPECT_EQ(5u, graph.update());
+        EXPECT_EQ(0u, graph.update());
+        EXPECT_TRUE(graph.get_updated_nodes().empty());
+
+        graph.set_local_position(right, {2, 0, 0});
+        EXPECT_EQ(2u, graph.update());
+
+        const std::vector<std::size_t> expected_updated = {right, right_leaf};
+        EXPECT_EQ(expected_updated, graph.get_updated_nodes());
+        EXPECT_EQ(point3d(2, 1, 0), graph.get_world_position(right_leaf));
+        EXPECT_EQ(point3d(-1, 1, 0), graph.get_world_position(left_leaf));
+
+        graph.set_local_position(root, {0, 0, 5});
+        EXPECT_EQ(5u, graph.update());
+        EXPECT_EQ(point3d(2, 1, 5), graph.get_world_positions()[right_leaf]);
+
+        // dirty nodes inside a dirty subtree are recalculated once
+        graph.set_local_position(left_leaf, {0, 2, 0});
+        graph.set_local_position(left, {-3, 0, 0});
+        EXPECT_EQ(2u, graph.update());
+
+        const std::vector<std::size_t> expected_left = {left, left_leaf};
+        EXPECT_EQ(expected_left, graph.get_updated_nodes());
+        EXPECT_EQ(point3d(-3, 2, 5), graph.get_world_position(left_leaf));
+        EXPECT_FALSE(graph.is_dirty(left_leaf));
+    }
+
+    TEST(scene_graph_test, update_single_dirty_root_per_level)
+    {
+        utility::scene_graph graph;
+
+        // one root with enough nodes per depth to split the levels over threads
+        const std::size_t child_count = 4 * utility::scene_graph::level_grain;
+        const std::size_t root = graph.add_node(quaternion::identity(), {0, 0, 0});
+
+        std::vector<std::size_t> leaves;
+        for (std::size_t i = 0; i < child_count; ++i)
+        {
+            const std::size_t child = graph.add_node(quaternion::identity(), {static_cast<double>(i), 0, 0}, root);
+            leaves.push_back(graph.add_node(quaternion::identity(), {0, 1, 0}, child));
+        }
+
+        EXPECT_EQ(1 + 2 * child_count, graph.update());
+
+        // only the root is dirty, every node below it is recalculated
+        const quaternion rotation = quaternion::from_axis_radians({0, 0, 1}, math::pi_2);
+        graph.set_local_rotation(root, rotation);
+        graph.set_local_position(root, {0, 0, 3});
+        EXPECT_EQ(1 + 2 * child_count, graph.update());
+        EXPECT_EQ(1 + 2 * child_count, graph.get_updated_nodes().size());
+
+        for (std::size_t i = 0; i < child_count; ++i)
+        {
+            const point3d expected = point3d(0, 0, 3) +
+                quaternion::rotate_quaternion(point3d(static_cast<double>(i), 1, 0), rotation);
+            EXPECT_EQ(expected, graph.get_world_position(leaves[i]));
+            EXPECT_FALSE(graph.is_dirty(leaves[i]));
+        }
+    }
+
+    TEST(scene_graph_test, update_instance_bounds)
+    {
+        utility::scene_graph graph;
+
+        // a row of unit boxes, instance i is placed at (2i, 0, 0)
+        std::vector<std::size_t> nodes;
+        for (int i = 0; i < 16; ++i)
+            nodes.push_back(graph.add_node(quaternion::identity(), {2. * i, 0, 0}));
+        graph.update();
+
+        const std::vector<aabb> local(nodes.size(), aabb({0, 0, 0}, {1, 1, 1}));
+        std::vector<aabb> world;
+        graph.update_instance_bounds(local, world);
+        ASSERT_EQ(nodes.size(), world.size());
+        EXPECT_EQ(aabb({30, 0, 0}, {31, 1, 1}), world[15]);
+
+        utility::bvh bvh(world, 2);
+        EXPECT_THROW(graph.update_instance_bounds({}, world), exception::out_of_range_exception);
+
+        // the last instance turns 90 degrees around z and moves in front of the first one
+        graph.set_local_rotation(nodes[15], quaternion::from_axis_radians({0, 0, 1}, math::pi_2));
+        graph.set_local_position(nodes[15], {-5, 1, 0});
+        EXPECT_EQ(1u, graph.update());
+
+        world[0] = aabb(); // not updated, so not recalculated
+        graph.update_instance_bounds(local, world);
+        EXPECT_TRUE(world[0].is_empty());
+        EXPECT_EQ(aabb({-5, 0, 0}, {-4, 1, 1}), world[15]);
+
+        world[0] = local[0];
+        bvh.refit(world);
+        EXPECT_TRUE(bvh.get_nodes()[0].bounds.contains(world[15]));
+
+        const auto intersect = [&](const std::uint32_t primitive, double& t_max)
+        {
+            double t_enter = 0, t_exit = 0;
+            if (!utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, t_max).intersect(world[primitive], t_enter, t_exit))
+                return false;
+
+            t_max = t_enter;
+            return true;
+        };
+        EXPECT_EQ(15u, bvh.closest_hit(utility::ray({-10, 0.5, 0.5}, {1, 0, 0}, 1000), intersect));
+    }
+} // namespace testing
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "BardCore/utility/sdf.h"
+
+namespace testing
+{
+    TEST(sdf_test, primitives)
+    {
+        const utility::sdf::sphere sphere{{0, 0, 0}, 1};
+        EXPECT_NEAR(1.0, sphere.distance({2, 0, 0}), ROUND_EPSILON);
+        EXPECT_NEAR(-1.0, sphere.distance({0, 0, 0}), ROUND_EPSILON);
+
+        const utility::sdf::box box{{0, 0, 0}, {1, 1, 1}};
+        EXPECT_NEAR(1.0, box.distance({2, 0, 0}), ROUND_EPSILON);
+        EXPECT_NEAR(math::sqrt_3, box.distance({2, 2, 2}), ROUND_EPSILON);
+        EXPECT_NEAR(-0.5, box.distance({0.5, 0, 0}), ROUND_EPSILON);
+
+        const utility::sdf::plane plane{{0, 1, 0}, -1};
+        EXPECT_NEAR(3.0, plane.distance({5, 2, 5}), ROUND_EPSILON);
+
+        const utility::sdf::torus torus{{0, 0, 0}, 2, 0.5};
+        EXPECT_NEAR(0.0, torus.distance({2.5, 0, 0}), ROUND_EPSILON);
+        EXPECT_NEAR(1.5, torus.distance({0, 0, 0}), ROUND_EPSILON);
+    }
+
+    TEST(sdf_test, csg)
+    {
+        const utility::sdf::sphere a{{-1, 0, 0}, 1};
+        const utility::sdf::sphere b{{1, 0, 0}, 1};
+
+        const auto csg_union = utility::sdf::make_union(a, b);
+        EXPECT_NEAR(-1.0, csg_union.distance({1, 0, 0}), ROUND_EPSILON);
+
+        const auto intersection = utility::sdf::make_intersection(a, b);
+        EXPECT_NEAR(0.0, intersection.distance({0, 0, 0}), ROUND_EPSILON);
+
+        const auto difference = utility::sdf::make_difference(a, b);
+        EXPECT_NEAR(1.0, difference.distance({1, 0, 0}), ROUND_EPSILON);
+
+        const auto smooth = utility::sdf::make_smooth_union(a, b, 0.5);
+        EXPECT_LT(smooth.distance({0, 0.5, 0}), csg_union.distance({0, 0.5, 0}));
+        EXPECT_THROW((void)utility::sdf::make_smooth_union(a, b, 0), exception::zero_exception);
+
+        const auto moved = utility::sdf::make_translation(a, {0, 5, 0});
+        EXPECT_NEAR(-1.0, moved.distance({-1, 5, 0}), ROUND_EPSILON);
+    }
+
+    TEST(sdf_test, tracer_exceptions)
+    {
+        EXPECT_THROW(utility::sphere_tracer(0), exception::zero_exception);
+        EXPECT_THROW(utility::sphere_tracer(10, 0), exception::negative_exception);
+        EXPECT_THROW(utility::sphere_tracer(10, 0.001, 0.5), exception::out_of_range_exception);
+        EXPECT_THROW(utility::sphere_tracer(10, 0.001, 2), exception::out_of_range_exception);
+    }
+
+    TEST(sdf_test, march_single)
+    {
+        const auto shape = utility::sdf::make_union(utility::sdf::sphere{{0, 0, 10}, 2},
+                                                    utility::sdf::box{{5, 0, 10}, {1, 1, 1}});
+
+        const utility::sphere_tracer relaxed;
+        const utility::sphere_tracer plain(128, 0.0001, 1);
+
+        const utility::ray ray({0, 0, 0}, {0, 0, 1}, 100);
+
+        const utility::march_result relaxed_result = relaxed.march(ray, shape);
+        const utility::march_result plain_result = plain.march(ray, shape);
+
+        EXPECT_TRUE(relaxed_result.hit);
+        EXPECT_TRUE(plain_result.hit);
+        EXPECT_NEAR(8.0, relaxed_result.distance, ROUND_THREE_DECIMALS);
+        EXPECT_NEAR(8.0, plain_result.distance, ROUND_THREE_DECIMALS);
+        EXPECT_GT(relaxed_result.steps, 0u);
+
+        // the ray distance is the maximum distance
+        const utility::march_result short_result = relaxed.march(utility::ray({0, 0, 0}, {0, 0, 1}, 5), shape);
+        EXPECT_FALSE(short_result.hit);
+        EXPECT_NEAR(5.0, short_result.distance, ROUND_EPSILON);
+
+        const utility::march_result miss = relaxed.march(utility::ray({0, 0, 0}, {0, 1, 0}, 100), shape);
+        EXPECT_FALSE(miss.hit);
+    }
+
+    TEST(sdf_test, march_packet_matches_single)
+    {
+        const utility::sdf::sphere shape{{0, 0, 10}, 3};
+        const utility::sphere_tracer tracer;
+
+        std::vector<utility::ray> rays;
+        for (int i = 0; i < 21; ++i)
+            rays.emplace_back(point3d(0, 0, 0), vector3d(0.02 * (i - 10), 0.01 * i, 1), 50);
+
+        const std::vector<utility::march_result> results = tracer.march(rays, shape);
+        ASSERT_EQ(rays.size(), results.size());
+
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            const utility::march_result single = tracer.march(rays[i], shape);
+            EXPECT_EQ(single.hit, results[i].hit);
+            EXPECT_NEAR(single.distance, results[i].distance, ROUND_EPSILON);
+            EXPECT_EQ(single.steps, results[i].steps);
+        }
+
+        EXPECT_THROW(tracer.march_packet(rays.data(), utility::sphere_tracer::packet_size + 1, shape, nullptr),
+                     exception::out_of_range_exception);
+        EXPECT_NO_THROW(tracer.march_packet(static_cast<const utility::ray*>(nullptr), 0, shape, nullptr));
+    }
+
+    TEST(sdf_test, march_camera)
+    {
+        const utility::camera camera({0, 0, 0}, {0, 0, 1}, 21, 11);
+        const utility::sdf::sphere shape{{0, 0, 10}, 2};
+        const utility::sphere_tracer tracer;
+
+        const std::vector<utility::march_result> results = tracer.march(camera, 100, shape);
+        ASSERT_EQ(21u * 11u, results.size());
+
+        // corners miss, a pixel near the center hits
+        EXPECT_FALSE(results.front().hit);
+        EXPECT_FALSE(results.back().hit);
+        EXPECT_TRUE(results[5 * 21 + 10].hit);
+
+        const utility::march_statistics statistics = utility::march_statistics::collect(results);
+        EXPECT_EQ(results.size(), statistics.rays);
+        EXPECT_GT(statistics.hits, 0u);
+        EXPECT_LT(statistics.hits, statistics.rays);
+        EXPECT_GE(statistics.max_steps, statistics.average_steps());
+    }
+} // namespace testing
@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "BardCore/utility/sphere_batch.h"
+
+#include <random>
+
+namespace testing
+{
+    static std::vector<point3d> random_cloud(const std::size_t count, const unsigned int seed)
+    {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<double> coordinate(-3, 5);
+
+        std::vector<point3d> points;
+        for (std::size_t index = 0; index < count; ++index)
+            points.emplace_back(coordinate(generator), coordinate(generator) * 0.5, coordinate(generator) * 2);
+        return points;
+    }
+
+    TEST(sphere_batch_test, ritter_and_welzl)
+    {
+        const std::vector<point3d> points = random_cloud(10000, 3);
+
+        std::vector<std::size_t> offsets = {0};
+        while (offsets.back() < points.size())
+            offsets.push_back((std::min)(offsets.back() + 7 + offsets.size() % 50, points.size()));
+
+        const std::vector<sphere> ritter = utility::sphere_batch::ritter(points, offsets);
+        const std::vector<sphere> welzl = utility::sphere_batch::welzl(points, offsets);
+        ASSERT_EQ(offsets.size() - 1, ritter.size());
+        ASSERT_EQ(offsets.size() - 1, welzl.size());
+
+        for (std::size_t index = 0; index < ritter.size(); ++index)
+        {
+            const std::vector<point3d> sub_mesh(points.begin() + offsets[index], points.begin() + offsets[index + 1]);
+            EXPECT_EQ(sphere::ritter(sub_mesh), ritter[index]);
+            EXPECT_EQ(sphere::welzl(sub_mesh), welzl[index]);
+        }
+
+        EXPECT_THROW((void)utility::sphere_batch::ritter(points, {}), exception::out_of_range_exception);
+        EXPECT_THROW((void)utility::sphere_batch::ritter(points, {0, 10, 5}), exception::out_of_range_exception);
+        EXPECT_THROW((void)utility::sphere_batch::welzl(points, {0, 10001}), exception::out_of_range_exception);
+    }
+} // namespace testing
@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "BardCore/math/sphere.h"
+#include "BardCore/utility/temporal_reprojection.h"
+
+namespace testing
+{
+    // a sphere in front of a wall at z = 10, the color is the hit position
+    static point3d trace_scene(const utility::ray& ray)
+    {
+        const sphere ball({0, 0, 5}, 1);
+        const vector3d offset = ball.center.get_vector(ray.get_position());
+        const double b = offset.dot(ray.get_direction());
+        const double discriminant = b * b - (offset.dot(offset) - ball.radius * ball.radius);
+        const double t = discriminant >= 0 && -b - std::sqrt(discriminant) > 0
+                             ? -b - std::sqrt(discriminant)
+                             : (10 - ray.get_position().z) / ray.get_direction().z;
+        return ray.get_position() + ray.get_direction() * t;
+    }
+
+    static void trace_retrace(utility::temporal_reprojection& reprojection, const utility::camera& camera)
+    {
+        for (const std::uint32_t pixel : reprojection.get_retrace())
+        {
+            const point3d hit = trace_scene(camera.shoot_ray(pixel % camera.get_screen_width(),
+                                                             pixel / camera.get_screen_width(), 100));
+            reprojection.store(pixel, hit, vector3d(hit.x, hit.y, hit.z));
+        }
+    }
+
+    TEST(temporal_reprojection_test, reproject)
+    {
+        utility::camera camera({0, 0, 0}, {0, 0, 1}, 64, 48, 60);
+        utility::temporal_reprojection reprojection(64, 48, 100000);
+
+        // nothing to reuse in the first frame
+        EXPECT_EQ(64u * 48u, reprojection.reproject(camera).size());
+        trace_retrace(reprojection, camera);
+
+        // a camera that didn't move reuses everything
+        EXPECT_TRUE(reprojection.reproject(camera).empty());
+
+        // slow motion, only a few pixels are traced again
+        std::size_t traced = 0;
+        for (int frame = 1; frame <= 10; ++frame)
+        {
+            camera.set_position({0.01 * frame, 0.005 * frame, 0});
+            traced += reprojection.reproject(camera).size();
+            trace_retrace(reprojection, camera);
+
+            // the reused positions are near what the new camera sees, apart from the silhouette of the sphere
+            std::size_t far = 0;
+            for (unsigned int y = 0; y < 48; ++y)
+            {
+                for (unsigned int x = 0; x < 64; ++x)
+                {
+                    const point3d hit = trace_scene(camera.shoot_ray(x, y, 100));
+                    const std::size_t pixel = y * 64 + x;
+                    ASSERT_TRUE(reprojection.get_valid()[pixel]);
+                    EXPECT_EQ(reprojection.get_positions()[pixel].x, reprojection.get_colors()[pixel].x);
+                    far += hit.distance(reprojection.get_positions()[pixel]) > 0.5;
+                }
+            }
+            EXPECT_LT(far, 64u * 48u / 100);
+        }
+
+        // an order of magnitude fewer rays than tracing every frame
+        EXPECT_LT(traced, 64u * 48u * 10 / 10);
+    }
+
+    TEST(temporal_reprojection_test, disocclusion)
+    {
+        utility::camera camera({0, 0, 0}, {0, 0, 1}, 64, 48, 60);
+        utility::temporal_reprojection reprojection(64, 48, 100000);
+        (void)reprojection.reproject(camera);
+        trace_retrace(reprojection, camera);
+
+        // moving sideways reveals the wall behind one side of the sphere, those pixels received nothing
+        camera.set_position({0.3, 0, 0});
+        const std::vector<std::uint32_t>& retrace = reprojection.reproject(camera);
+        ASSERT_FALSE(retrace.empty());
+        for (const std::uint32_t pixel : retrace)
+            EXPECT_FALSE(reprojection.get_valid()[pixel]);
+
+        std::size_t revealed = 0;
+        for (const std::uint32_t pixel : retrace)
+            revealed += trace_scene(camera.shoot_ray(pixel % 64, pixel / 64, 100)).z > 9;
+        EXPECT_LT(0u, revealed);
+    }
+
+    TEST(temporal_reprojection_test, refresh)
+    {
+        const utility::camera camera({0, 0, 0}, {0, 0, 1}, 16, 16, 60);
+        utility::temporal_reprojection reprojection(16, 16, 4);
+        (void)reprojection.reproject(camera);
+        trace_retrace(reprojection, camera);
+
+        // with a still camera every pixel is traced again once per refresh interval, spread over the frames
+        std::vector<int> traced(256, 0);
+        for (int frame = 0; frame < 4; ++frame)
+        {
+            EXPECT_EQ(64u, reprojection.reproject(camera).size());
+            for (const std::uint32_t pixel : reprojection.get_retrace())
+                ++traced[pixel];
+            trace_retrace(reprojection, camera);
+        }
+
+        for (const int count : traced)
+            EXPECT_EQ(1, count);
+    }
+
+    TEST(temporal_reprojection_test, samples)
+    {
+        const utility::camera camera({0, 0, 0}, {0, 0, 1}, 4, 4, 60);
+        utility::temporal_reprojection reprojection(4, 4);
+        (void)reprojection.reproject(camera);
+        EXPECT_THROW(reprojection.add_sample(3, {1, 1, 1}), exception::out_of_range_exception);
+
+        const utility::ray ray = camera.shoot_ray(3, 0, 10);
+        reprojection.store(3, ray.get_position() + ray.get_direction() * 10, {1, 0, 0});
+        reprojection.add_sample(3, {0, 1, 0});
+        reprojection.add_sample(3, {0, 0, 1});
+        EXPECT_EQ(3u, reprojection.get_samples()[3]);
+        EXPECT_NEAR(1. / 3, reprojection.get_colors()[3].x, ROUND_EPSILON);
+        EXPECT_NEAR(1. / 3, reprojection.get_colors()[3].z, ROUND_EPSILON);
+
+        // the accumulated color moves with the pixel
+        (void)reprojection.reproject(camera);
+        EXPECT_EQ(3u, reprojection.get_samples()[3]);
+
+        EXPECT_THROW(reprojection.store(16, {0, 0, 0}, {0, 0, 0}), exception::out_of_range_exception);
+        EXPECT_THROW((void)reprojection.reproject(utility::camera({0, 0, 0}, {0, 0, 1}, 4, 5)),
+                     exception::out_of_range_exception);
+        EXPECT_THROW(utility::temporal_reprojection(0, 4), exception::zero_exception);
+        EXPECT_THROW(utility::temporal_reprojection(4, 4, 0), exception::zero_exception);
+    }
+} // namespace testing
@@ -0,0 +1,141 @@
+#include "pch.h"
+#include "BardCore/utility/triangle_mesh.h"
+
+namespace testing
+{
+    // grid of size x size quads in the xy plane at z = 0, from (0, 0) to (size, size)
+    static utility::triangle_mesh grid_mesh(const std::uint32_t size)
+    {
+        std::vector<point3d> vertices;
+        std::vector<std::uint32_t> indices;
+
+        for (std::uint32_t y = 0; y <= size; ++y)
+            for (std::uint32_t x = 0; x <= size; ++x)
+                vertices.emplace_back(x, y, 0);
+
+        for (std::uint32_t y = 0; y < size; ++y)
+        {
+            for (std::uint32_t x = 0; x < size; ++x)
+            {
+                const std::uint32_t corner = y * (size + 1) + x;
+                indices.insert(indices.end(), {corner, corner + 1, corner + size + 1});
+                indices.insert(indices.end(), {corner + 1, corner + size + 2, corner + size + 1});
+            }
+        }
+
+        return {vertices, indices};
+    }
+
+    TEST(triangle_mesh_test, constructor)
+    {
+        const utility::triangle_mesh mesh = grid_mesh(4);
+
+        EXPECT_EQ(32u, mesh.triangle_count());
+        EXPECT_EQ(25u, mesh.get_vertices().size());
+        EXPECT_EQ(triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}), mesh.get_triangle(0));
+
+        EXPECT_THROW(utility::triangle_mesh({{0, 0, 0}}, {0, 0}), exception::out_of_range_exception);
+        EXPECT_THROW(utility::triangle_mesh({{0, 0, 0}}, {0, 0, 1}), exception::out_of_range_exception);
+
+        utility::page_options options;
+        options.placement = utility::page_placement::interleaved;
+        const utility::triangle_mesh interleaved(mesh.get_vertices(), mesh.get_indices(), 4, options);
+        EXPECT_TRUE(options == interleaved.get_bvh().get_node_options());
+        EXPECT_EQ(mesh.get_bvh().get_nodes().size(), interleaved.get_bvh().get_nodes().size());
+    }
+
+    TEST(triangle_mesh_test, closest_point)
+    {
+        const utility::triangle_mesh mesh = grid_mesh(16);
+
+        const utility::closest_point_result above = mesh.closest_point({3.3, 7.6, 2});
+        EXPECT_EQ(point3d(3.3, 7.6, 0), above.point);
+        EXPECT_NEAR(2.0, above.distance, ROUND_EPSILON);
+        EXPECT_TRUE(mesh.get_triangle(above.triangle).bounds().contains(above.point));
+
+        const utility::closest_point_result outside = mesh.closest_point({20, 8, -3});
+        EXPECT_EQ(point3d(16, 8, 0), outside.point);
+        EXPECT_NEAR(5.0, outside.distance, ROUND_EPSILON);
+
+        // nothing within the maximum distance
+        const std::uint32_t no_primitive = utility::bvh::no_primitive;
+        EXPECT_EQ(no_primitive, mesh.closest_point({20, 8, -3}, 1).triangle);
+
+        const utility::triangle_mesh empty({}, {});
+        EXPECT_TRUE(std::isinf(empty.distance({0, 0, 0})));
+    }
+
+    TEST(triangle_mesh_test, closest_points_batch)
+    {
+        const utility::triangle_mesh mesh = grid_mesh(8);
+
+        std::vector<point3d> points;
+        for (int i = 0; i < 1000; ++i)
+            points.emplace_back((i % 37) * 0.3 - 1, (i % 23) * 0.4 - 1, (i % 7) - 3);
+
+        const std::vector<utility::closest_point_result> results = mesh.closest_points(points);
+        const std::vector<double> distances = mesh.distances(points);
+        ASSERT_EQ(points.size(), results.size());
+        ASSERT_EQ(points.size(), distances.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            // brute force over every triangle
+            double expected = math::inf;
+            for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+                expected = (std::min)(expected, mesh.get_triangle(t).closest_point(points[i]).distance(points[i]));
+
+            EXPECT_NEAR(expected, results[i].distance, ROUND_EPSILON);
+            EXPECT_NEAR(expected, distances[i], ROUND_EPSILON);
+        }
+    }
+
+    TEST(triangle_mesh_test, leaf_sizes)
+    {
+        const utility::triangle_mesh grid = grid_mesh(8);
+
+        std::vector<point3d> points;
+        for (int i = 0; i < 200; ++i)
+            points.emplace_back((i % 37) * 0.3 - 1, (i % 23) * 0.4 - 1, (i % 7) - 3);
+
+        for (const unsigned int max_leaf_size : {1u, 2u, 4u, 8u})
+        {
+            const utility::triangle_mesh mesh(grid.get_vertices(), grid.get_indices(), max_leaf_size);
+            const utility::bvh::node_vector& nodes = mesh.get_bvh().get_nodes();
+
+            // triangles below every node, children are stored after their parent so walk backwards
+            std::vector<std::uint32_t> below(nodes.size(), 0);
+            for (std::size_t index = nodes.size(); index-- > 0;)
+                below[index] = nodes[index].is_leaf()
+                                   ? nodes[index].count
+                                   : below[nodes[index].first] + below[nodes[index].first + 1];
+
+            // subtrees that fit in a pack are single leaves, no leaf is larger than max_leaf_size
+            const std::uint32_t min_leaf_size = (std::min)(max_leaf_size, 4u);
+            for (std::size_t index = 0; index < nodes.size(); ++index)
+            {
+                if (nodes[index].is_leaf())
+                    EXPECT_LE(nodes[index].count, max_leaf_size);
+                else
+                    EXPECT_GT(below[index], min_leaf_size);
+            }
+
+            // the same closest points as the default mesh
+            for (const point3d& point : points)
+                EXPECT_NEAR(grid.distance(point), mesh.distance(point), ROUND_EPSILON);
+        }
+    }
+
+    TEST(triangle_mesh_test, intersect)
+    {
+        const utility::triangle_mesh mesh = grid_mesh(8);
+
+        const utility::mesh_hit hit = mesh.intersect(utility::ray({2.25, 3.5, 5}, {0, 0, -1}, 10));
+        ASSERT_TRUE(hit.hit);
+        EXPECT_NEAR(5.0, hit.distance, ROUND_EPSILON);
+        EXPECT_TRUE(mesh.get_triangle(hit.triangle).bounds().contains({2.25, 3.5, 0}));
+
+        EXPECT_FALSE(mesh.intersect(utility::ray({2.25, 3.5, 5}, {0, 0, -1}, 4)).hit);
+        EXPECT_FALSE(mesh.intersect(utility::ray({-2, 3.5, 5}, {0, 0, -1}, 10)).hit);
+    }
+} // namespace testing
@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "BardCore/utility/triangle_mesh.h"
+#include "BardCore/utility/triangle_pack.h"
+
+#include <random>
+
+namespace testing
+{
+    // tests a pack against triangle::intersect for random triangles and rays
+    template <std::size_t Width>
+    static void compare_with_scalar()
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<double> coordinate(-2, 2);
+        const auto random_point = [&] { return point3d(coordinate(random), coordinate(random), coordinate(random)); };
+
+        for (int round = 0; round < 200; ++round)
+        {
+            utility::triangle_pack<Width> pack;
+            std::vector<triangle> triangles;
+            for (std::size_t lane = 0; lane < Width; ++lane)
+            {
+                triangles.emplace_back(random_point(), random_point(), random_point());
+                pack.set(lane, triangles.back(), static_cast<std::uint32_t>(100 + lane));
+            }
+
+            // aimed at the triangles, so about half of the rays hit
+            const point3d origin(coordinate(random), coordinate(random), -5);
+            const utility::ray ray(origin, origin.get_vector(random_point()), 10);
+
+            // scalar, the first triangle wins a tie
+            std::size_t expected = Width;
+            double expected_t = math::inf, expected_u = 0, expected_v = 0;
+            for (std::size_t lane = 0; lane < Width; ++lane)
+            {
+                double t = 0, u = 0, v = 0;
+                if (ray.intersect(triangles[lane], t, u, v) && t < expected_t && t <= ray.get_distance())
+                {
+                    expected = lane;
+                    expected_t = t;
+                    expected_u = u;
+                    expected_v = v;
+                }
+            }
+
+            double t = 0, u = 0, v = 0;
+            const std::size_t lane = pack.intersect(ray, ray.get_distance(), t, u, v);
+            ASSERT_EQ(expected, lane);
+            if (lane == Width)
+                continue;
+
+            EXPECT_EQ(100 + lane, pack.triangles[lane]);
+            EXPECT_NEAR(expected_t, t, ROUND_EPSILON);
+            EXPECT_NEAR(expected_u, u, ROUND_EPSILON);
+            EXPECT_NEAR(expected_v, v, ROUND_EPSILON);
+
+            // nothing closer than the hit
+            EXPECT_EQ(Width, pack.intersect(ray, t * (1 - 1e-9), t, u, v));
+        }
+    }
+
+    TEST(triangle_pack_test, intersect)
+    {
+        compare_with_scalar<4>();
+        compare_with_scalar<8>();
+    }
+
+    TEST(triangle_pack_test, unused_lanes)
+    {
+        utility::triangle_pack<4> pack;
+        const std::uint32_t no_primitive = utility::bvh::no_primitive;
+        EXPECT_EQ(no_primitive, pack.triangles[3]);
+
+        double t = 0, u = 0, v = 0;
+        const utility::ray ray({0.25, 0.25, 1}, {0, 0, -1}, 10);
+        EXPECT_EQ(4u, pack.intersect(ray, 10, t, u, v));
+
+        // two triangles at the same distance, the first lane wins
+        pack.set(2, triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}), 7);
+        pack.set(1, triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}), 5);
+        EXPECT_EQ(1u, pack.intersect(ray, 10, t, u, v));
+        EXPECT_NEAR(1.0, t, ROUND_EPSILON);
+        EXPECT_NEAR(0.25, u, ROUND_EPSILON);
+        EXPECT_NEAR(0.25, v, ROUND_EPSILON);
+
+        // a hit exactly at t_max counts, like triangle::intersect
+        double scalar_t = 0, scalar_u = 0, scalar_v = 0;
+        EXPECT_TRUE(triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}).intersect(ray.get_position(), ray.get_direction(), 1,
+                                                                        scalar_t, scalar_u, scalar_v));
+        EXPECT_EQ(1u, pack.intersect(ray, 1, t, u, v));
+        EXPECT_EQ(4u, pack.intersect(ray, 0.5, t, u, v));
+
+        EXPECT_THROW(pack.set(4, triangle({0, 0, 0}, {1, 0, 0}, {0, 1, 0}), 0), exception::out_of_range_exception);
+    }
+
+    TEST(triangle_pack_test, mesh)
+    {
+        // random triangle soup, large leaves so every leaf has several packs
+        std::mt19937 random(3);
+        std::uniform_real_distribution<double> coordinate(0, 10);
+        std::vector<point3d> vertices;
+        std::vector<std::uint32_t> indices;
+        for (std::uint32_t index = 0; index < 600; ++index)
+        {
+            const point3d corner(coordinate(random), coordinate(random), coordinate(random));
+            vertices.push_back(corner);
+            vertices.push_back(corner + vector3d(coordinate(random), coordinate(random), 0) * 0.1);
+            vertices.push_back(corner + vector3d(0, coordinate(random), coordinate(random)) * 0.1);
+            indices.insert(indices.end(), {3 * index, 3 * index + 1, 3 * index + 2});
+        }
+
+        const utility::triangle_mesh mesh(vertices, indices, 10);
+        EXPECT_LE(mesh.triangle_count() / utility::triangle_mesh::pack_width, mesh.get_packs().size());
+
+        for (int round = 0; round < 200; ++round)
+        {
+            const utility::ray ray({coordinate(random), coordinate(random), -1},
+                                   vector3d(coordinate(random) - 5, coordinate(random) - 5, 10), 30);
+
+            // brute force over every triangle
+            double expected = math::inf;
+            for (std::size_t index = 0; index < mesh.triangle_count(); ++index)
+            {
+                double t = 0, u = 0, v = 0;
+                if (ray.intersect(mesh.get_triangle(index), t, u, v) && t < expected)
+                    expected = t;
+            }
+
+            const utility::mesh_hit hit = mesh.intersect(ray);
+            ASSERT_EQ(expected != math::inf, hit.hit);
+            if (!hit.hit)
+                continue;
+
+            EXPECT_NEAR(expected, hit.distance, ROUND_EPSILON);
+
+            double t = 0, u = 0, v = 0;
+            EXPECT_TRUE(ray.intersect(mesh.get_triangle(hit.triangle), t, u, v));
+            EXPECT_NEAR(t, hit.distance, ROUND_EPSILON);
+            EXPECT_NEAR(u, hit.u, ROUND_EPSILON);
+            EXPECT_NEAR(v, hit.v, ROUND_EPSILON);
+        }
+    }
+} // namespace testing
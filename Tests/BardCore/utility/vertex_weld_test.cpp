@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "BardCore/utility/vertex_weld.h"
+
+#include <random>
+
+namespace testing
+{
+    // every input vertex maps to a welded vertex in the same cell
+    static void expect_welded(const std::vector<point3d>& points, const utility::weld_result& result,
+                              const double epsilon)
+    {
+        const utility::point_hash hasher(epsilon);
+        ASSERT_EQ(points.size(), result.indices.size());
+
+        std::vector<bool> used(result.vertices.size(), false);
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            ASSERT_LT(result.indices[index], result.vertices.size());
+            EXPECT_EQ(hasher.quantize(points[index]), hasher.quantize(result.vertices[result.indices[index]]));
+            used[result.indices[index]] = true;
+        }
+
+        // welded vertices are unique and used
+        utility::flat_hash_map<utility::quantized_point, std::uint32_t, utility::point_hash> cells(0, hasher);
+        for (std::size_t index = 0; index < result.vertices.size(); ++index)
+        {
+            EXPECT_TRUE(used[index]);
+            EXPECT_TRUE(cells.insert(hasher.quantize(result.vertices[index]), 0).second);
+        }
+    }
+
+    TEST(vertex_weld_test, triangle_soup)
+    {
+        // two triangles of a quad, with a slightly moved duplicate
+        const std::vector<point3d> soup = {
+            {0, 0, 0}, {1, 0, 0}, {1, 1, 0},
+            {0, 0, 0}, {1.0001, 1, 0}, {0, 1, 0}
+        };
+
+        const utility::weld_result result = utility::vertex_weld::weld(soup, 0.001);
+        EXPECT_EQ(std::vector<point3d>({{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}}), result.vertices);
+        EXPECT_EQ(std::vector<std::uint32_t>({0, 1, 2, 0, 2, 3}), result.indices);
+        EXPECT_EQ(6u, result.statistics.vertices);
+        EXPECT_EQ(4u, result.statistics.unique_vertices);
+
+        // an indexed mesh with duplicate vertices
+        const utility::weld_result mesh = utility::vertex_weld::weld(soup, {0, 1, 2, 3, 4, 5, 5}, 0.001);
+        EXPECT_EQ(result.vertices, mesh.vertices);
+        EXPECT_EQ(std::vector<std::uint32_t>({0, 1, 2, 0, 2, 3, 3}), mesh.indices);
+
+        EXPECT_TRUE(utility::vertex_weld::weld(std::vector<point3d>(), 0.1).vertices.empty());
+        EXPECT_THROW((void)utility::vertex_weld::weld(soup, 0), exception::zero_exception);
+        EXPECT_THROW((void)utility::vertex_weld::weld(soup, -1), exception::negative_exception);
+        EXPECT_THROW((void)utility::vertex_weld::weld(soup, {0, 6}, 0.1), exception::out_of_range_exception);
+    }
+
+    TEST(vertex_weld_test, parallel)
+    {
+        // a grid of vertices, every vertex is repeated with noise in shuffled order
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<double> noise(-0.0004, 0.0004);
+
+        std::vector<point3d> grid;
+        for (int x = 0; x < 50; ++x)
+            for (int y = 0; y < 50; ++y)
+                for (int z = 0; z < 20; ++z)
+                    grid.emplace_back(x * 0.01, y * 0.01, z * 0.01);
+
+        std::vector<point3d> points;
+        for (int copy = 0; copy < 4; ++copy)
+            for (const point3d& point : grid)
+                points.emplace_back(point.x + noise(generator), point.y + noise(generator), point.z + noise(generator));
+        std::shuffle(points.begin(), points.end(), generator);
+
+        const utility::weld_result result = utility::vertex_weld::weld(points, 0.001);
+        EXPECT_EQ(grid.size(), result.vertices.size());
+        expect_welded(points, result, 0.001);
+        EXPECT_GE(result.statistics.vertices_per_second(), 0.0);
+
+        // first occurrences are kept, in input order
+        std::vector<bool> seen(result.vertices.size(), false);
+        std::uint32_t next = 0;
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            if (seen[result.indices[index]])
+                continue;
+
+            EXPECT_EQ(next++, result.indices[index]);
+            EXPECT_EQ(points[index], result.vertices[result.indices[index]]);
+            seen[result.indices[index]] = true;
+        }
+    }
+} // namespace testing
@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "BardCore/utility/voxel_grid.h"
+
+#include <atomic>
+
+namespace testing
+{
+    TEST(voxel_grid_test, constructor)
+    {
+        const utility::voxel_grid<unsigned char> grid({0, 0, 0}, 0.5, 4, 3, 2, 7);
+
+        EXPECT_EQ(24u, grid.size());
+        EXPECT_EQ(7, grid.at(3, 2, 1));
+        EXPECT_EQ(3u + 4u * (2u + 3u * 1u), grid.index(3, 2, 1));
+        EXPECT_EQ(aabb({0, 0, 0}, {2, 1.5, 1}), grid.get_bounds());
+
+        EXPECT_THROW((void)grid.at(4, 0, 0), exception::out_of_range_exception);
+        EXPECT_THROW(utility::voxel_grid<int>({0, 0, 0}, 1, 0, 1, 1), exception::zero_exception);
+        EXPECT_THROW(utility::voxel_grid<int>({0, 0, 0}, 0, 1, 1, 1), exception::negative_exception);
+    }
+
+    TEST(voxel_grid_test, cell_of)
+    {
+        const utility::voxel_grid<int> grid({-1, -1, -1}, 1, 2, 2, 2);
+        unsigned int x = 0, y = 0, z = 0;
+
+        EXPECT_TRUE(grid.cell_of({0.5, -0.5, 0.1}, x, y, z));
+        EXPECT_EQ(1u, x);
+        EXPECT_EQ(0u, y);
+        EXPECT_EQ(1u, z);
+
+        EXPECT_FALSE(grid.cell_of({1.5, 0, 0}, x, y, z));
+        EXPECT_FALSE(grid.cell_of({-1.5, 0, 0}, x, y, z));
+    }
+
+    TEST(voxel_grid_test, traverse_axis_aligned)
+    {
+        const utility::voxel_grid<int> grid({0, 0, 0}, 1, 5, 1, 1);
+        std::vector<utility::voxel_hit> hits;
+
+        const std::size_t visited = grid.traverse(utility::ray({-1, 0.5, 0.5}, {1, 0, 0}, 100),
+                                                  [&hits](const utility::voxel_hit& hit)
+                                                  {
+                                                      hits.push_back(hit);
+                                                      return true;
+                                                  });
+
+        ASSERT_EQ(5u, visited);
+        for (unsigned int i = 0; i < 5; ++i)
+        {
+            EXPECT_EQ(i, hits[i].x);
+            EXPECT_NEAR(1.0 + i, hits[i].t_enter, ROUND_EPSILON);
+            EXPECT_NEAR(2.0 + i, hits[i].t_exit, ROUND_EPSILON);
+        }
+    }
+
+    TEST(voxel_grid_test, traverse_diagonal)
+    {
+        const utility::voxel_grid<int> grid({0, 0, 0}, 1, 4, 4, 4);
+        std::vector<utility::voxel_hit> hits;
+
+        // the ray ends inside the grid
+        grid.traverse(utility::ray({0.5, 0.1, 0.5}, {1, 1, 0}, 2), [&hits](const utility::voxel_hit& hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+
+        // consecutive cells are neighbours and the distances are continuous
+        ASSERT_GE(hits.size(), 2u);
+        EXPECT_EQ(0u, hits.front().x);
+        EXPECT_EQ(0u, hits.front().y);
+        EXPECT_NEAR(0.0, hits.front().t_enter, ROUND_EPSILON);
+        EXPECT_NEAR(2.0, hits.back().t_exit, ROUND_EPSILON);
+
+        for (std::size_t i = 1; i < hits.size(); ++i)
+        {
+            const int change = std::abs(static_cast<int>(hits[i].x) - static_cast<int>(hits[i - 1].x)) +
+                std::abs(static_cast<int>(hits[i].y) - static_cast<int>(hits[i - 1].y)) +
+                std::abs(static_cast<int>(hits[i].z) - static_cast<int>(hits[i - 1].z));
+            EXPECT_EQ(1, change);
+            EXPECT_NEAR(hits[i - 1].t_exit, hits[i].t_enter, ROUND_EPSILON);
+        }
+    }
+
+    TEST(voxel_grid_test, traverse_from_cell_border)
+    {
+        const utility::voxel_grid<int> grid({0, 0, 0}, 1, 4, 4, 1);
+        std::vector<utility::voxel_hit> hits;
+
+        // starts on the border between cell 2 and 1 and passes through a corner, no cell is zero length
+        grid.traverse(utility::ray({2, 2, 0.5}, {-1, -1, 0}, 100), [&hits](const utility::voxel_hit& hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+
+        ASSERT_EQ(2u, hits.size());
+        EXPECT_EQ(1u, hits[0].x);
+        EXPECT_EQ(1u, hits[0].y);
+        EXPECT_NEAR(0.0, hits[0].t_enter, ROUND_EPSILON);
+        EXPECT_EQ(0u, hits[1].x);
+        EXPECT_EQ(0u, hits[1].y);
+
+        for (const utility::voxel_hit& hit : hits)
+            EXPECT_GT(hit.t_exit, hit.t_enter);
+    }
+
+    TEST(voxel_grid_test, traverse_ends_on_cell_border)
+    {
+        const utility::voxel_grid<int> grid({0, 0, 0}, 1, 4, 1, 1);
+        std::vector<utility::voxel_hit> hits;
+
+        // ends on the border between cell 1 and 2, cell 2 is not reached
+        grid.traverse(utility::ray({0.5, 0.5, 0.5}, {1, 0, 0}, 1.5), [&hits](const utility::voxel_hit& hit)
+        {
+            hits.push_back(hit);
+            return true;
+        });
+
+        ASSERT_EQ(2u, hits.size());
+        EXPECT_EQ(0u, hits[0].x);
+        EXPECT_EQ(1u, hits[1].x);
+        EXPECT_NEAR(1.5, hits[1].t_exit, ROUND_EPSILON);
+
+        for (const utility::voxel_hit& hit : hits)
+            EXPECT_GT(hit.t_exit, hit.t_enter);
+    }
+
+    TEST(voxel_grid_test, traverse_early_termination_and_miss)
+    {
+        utility::voxel_grid<unsigned char> grid({0, 0, 0}, 1, 8, 1, 1);
+        grid.at(3, 0, 0) = 1;
+
+        utility::voxel_hit found;
+        const std::size_t visited = grid.traverse(utility::ray({0.5, 0.5, 0.5}, {1, 0, 0}, 100),
+                                                  [&grid, &found](const utility::voxel_hit& hit)
+                                                  {
+                                                      found = hit;
+                                                      return grid.get_cells()[hit.index] == 0;
+                                                  });
+
+        EXPECT_EQ(4u, visited);
+        EXPECT_EQ(3u, found.x);
+        EXPECT_NEAR(2.5, found.t_enter, ROUND_EPSILON);
+
+        EXPECT_EQ(0u, grid.traverse(utility::ray({0.5, 5, 0.5}, {1, 0, 0}, 100),
+                                    [](const utility::voxel_hit&) { return true; }));
+    }
+
+    TEST(voxel_grid_test, traverse_batch)
+    {
+        const utility::voxel_grid<int> grid({0, 0, 0}, 1, 10, 10, 1);
+
+        std::vector<utility::ray> rays;
+        for (int i = 0; i < 100; ++i)
+            rays.emplace_back(point3d(-1, (i % 10) + 0.5, 0.5), vector3d(1, 0, 0), 100);
+
+        std::atomic<std::size_t> total{0};
+        const std::vector<std::size_t> visited = grid.traverse(rays, [&total](std::size_t, const utility::voxel_hit&)
+        {
+            ++total;
+            return true;
+        });
+
+        ASSERT_EQ(rays.size(), visited.size());
+        for (const std::size_t count : visited)
+            EXPECT_EQ(10u, count);
+        EXPECT_EQ(1000u, total.load());
+    }
+} // namespace testing